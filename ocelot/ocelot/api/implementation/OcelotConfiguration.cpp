@@ -40,6 +40,11 @@ void api::OcelotConfiguration::destroy() {
         ocelotConfiguration = 0;
 }
 
+void api::OcelotConfiguration::set(OcelotConfiguration* configuration) {
+	delete ocelotConfiguration;
+	ocelotConfiguration = configuration;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 api::OcelotConfiguration::Checkpoint::Checkpoint():
@@ -74,6 +79,15 @@ api::OcelotConfiguration::TraceGeneration::Debugger::Debugger():
 
 }
 
+api::OcelotConfiguration::TraceGeneration::Window::Window():
+	skipLaunches(0),
+	traceLaunches(0),
+	skipCtas(0),
+	traceCtas(0)
+{
+
+}
+
 api::OcelotConfiguration::TraceGeneration::TraceGeneration():
 	memoryChecker(false)
 {
@@ -96,11 +110,33 @@ static void initializeTrace(api::OcelotConfiguration::TraceGeneration &trace,
             trace.debugger.kernelFilter = debugConfig.parse<std::string>("kernelFilter", "");
             trace.debugger.alwaysAttach = debugConfig.parse<bool>("alwaysAttach", false);
     }
+	
+	trace.windows.clear();
+	if (config.find("windows")) {
+		hydrazine::json::Visitor windows = config["windows"];
+		hydrazine::json::Object *object = 
+			static_cast<hydrazine::json::Object *>(windows.value);
+
+		for (hydrazine::json::Object::Dictionary::iterator 
+			it = object->begin(); it != object->end(); ++it) {
+			hydrazine::json::Visitor windowConfig(it->second);
+			api::OcelotConfiguration::TraceGeneration::Window window;
+			
+			window.skipLaunches = windowConfig.parse<int>("skipLaunches", 0);
+			window.traceLaunches = windowConfig.parse<int>("traceLaunches", 0);
+			window.skipCtas = windowConfig.parse<int>("skipCtas", 0);
+			window.traceCtas = windowConfig.parse<int>("traceCtas", 0);
+			
+			trace.windows.insert(std::make_pair(it->first, window));
+		}
+	}
 }
 
 api::OcelotConfiguration::CudaRuntimeImplementation::CudaRuntimeImplementation():
 	implementation("CudaRuntime"),
-	runtimeApiTrace("trace/CudaAPI.trace")
+	runtimeApiTrace("trace/CudaAPI.trace"),
+	traceTransfers(false),
+	transferTrace("trace/CudaTransfers.trace")
 {
 
 }
@@ -113,6 +149,9 @@ static void initializeCudaRuntimeImplementation(
 		"implementation", "CudaRuntime");
 	cuda.runtimeApiTrace = config.parse<std::string>(
 		"runtimeApiTrace", "trace/CudaAPI.trace");
+	cuda.traceTransfers = config.parse<bool>("traceTransfers", false);
+	cuda.transferTrace = config.parse<std::string>(
+		"transferTrace", "trace/CudaTransfers.trace");
 }
 
 api::OcelotConfiguration::Executive::Executive():
@@ -125,7 +164,41 @@ api::OcelotConfiguration::Executive::Executive():
 	enableNVIDIA(true),
 	enableAMD(true),
 	workerThreadLimit(-1),
-	warpSize(-1)
+	warpSize(-1),
+	zeroCopy(false),
+	dirtyPageTracking(false),
+	ctaOrder("rowMajor"),
+	ctaTileSize(4),
+	workerAffinity("none"),
+	partitionAllocations(false),
+	threadBundleWidth(1),
+	threadLoops(false),
+	kernelCache(""),
+	kernelCacheSize(256),
+	backgroundTranslation(false),
+	translationThreads(0),
+	tieredCompilation(false),
+	tierUpLaunches(16),
+	tierUpMilliseconds(100),
+	launchSpecialization(false),
+	specializationVariants(4),
+	specializationLaunches(2),
+	jitCpu("host"),
+	jitAttributes(""),
+	jitOptimizationLevel(2),
+	fastMath(false),
+	inlineRuntime(false),
+	runtimeLibrary(""),
+	hybridExecution(false),
+	hybridPromoteLaunches(4),
+	hybridCalibration(false),
+	branchProfiles(""),
+	autotuning(false),
+	autotuningFile(""),
+	ctaSampling("none"),
+	ctaSamples(64),
+	ctaSamplingSeed(0),
+	ctaSamplingReport("")
 {
 
 }
@@ -204,6 +277,85 @@ static void initializeExecutive(api::OcelotConfiguration::Executive &executive,
 	executive.enableAMD = config.parse<bool>("enableAMD", true);
 	executive.workerThreadLimit = config.parse<int>("workerThreadLimit", -1);
 	executive.warpSize = config.parse<int>("warpSize", -1);
+	executive.zeroCopy = config.parse<bool>("zeroCopy", false);
+	executive.dirtyPageTracking = config.parse<bool>(
+		"dirtyPageTracking", false);
+	executive.ctaTileSize = config.parse<int>("ctaTileSize", 4);
+
+	executive.ctaOrder = config.parse<std::string>("ctaOrder", "rowMajor");
+	executive.workerAffinity = config.parse<std::string>(
+		"workerAffinity", "none");
+
+	executive.workerCpus.clear();
+	if (config.find("workerCpus")) {
+		hydrazine::json::Visitor cpus = config["workerCpus"];
+		hydrazine::json::Array *array = 
+			static_cast<hydrazine::json::Array *>(cpus.value);
+
+		for (hydrazine::json::Array::ValueVector::iterator it = array->begin();
+			it != array->end(); ++it) {
+			hydrazine::json::Visitor cpu(*it);
+			executive.workerCpus.push_back((int)cpu);
+		}
+	}
+
+	executive.partitionAllocations = config.parse<bool>(
+		"partitionAllocations", false);
+	executive.threadBundleWidth = config.parse<int>("threadBundleWidth", 1);
+	executive.threadLoops = config.parse<bool>("threadLoops", false);
+	executive.kernelCache = config.parse<std::string>("kernelCache", "");
+	executive.kernelCacheSize = config.parse<int>("kernelCacheSize", 256);
+	executive.backgroundTranslation = config.parse<bool>(
+		"backgroundTranslation", false);
+	executive.translationThreads = config.parse<int>(
+		"translationThreads", 0);
+	executive.tieredCompilation = config.parse<bool>(
+		"tieredCompilation", false);
+	executive.tierUpLaunches = config.parse<int>("tierUpLaunches", 16);
+	executive.tierUpMilliseconds = config.parse<int>(
+		"tierUpMilliseconds", 100);
+	executive.launchSpecialization = config.parse<bool>(
+		"launchSpecialization", false);
+	executive.specializationVariants = config.parse<int>(
+		"specializationVariants", 4);
+	executive.specializationLaunches = config.parse<int>(
+		"specializationLaunches", 2);
+	executive.jitCpu = config.parse<std::string>("jitCpu", "host");
+	executive.jitAttributes = config.parse<std::string>("jitAttributes", "");
+	executive.jitOptimizationLevel = config.parse<int>(
+		"jitOptimizationLevel", 2);
+	executive.fastMath = config.parse<bool>("fastMath", false);
+	executive.inlineRuntime = config.parse<bool>("inlineRuntime", false);
+	executive.runtimeLibrary = config.parse<std::string>("runtimeLibrary", "");
+	executive.hybridExecution = config.parse<bool>("hybridExecution", false);
+	executive.hybridPromoteLaunches = config.parse<int>(
+		"hybridPromoteLaunches", 4);
+	executive.hybridCalibration = config.parse<bool>("hybridCalibration",
+		false);
+	executive.branchProfiles = config.parse<std::string>("branchProfiles",
+		"");
+	executive.autotuning = config.parse<bool>("autotuning", false);
+	executive.autotuningFile = config.parse<std::string>("autotuningFile",
+		"");
+	executive.ctaSampling = config.parse<std::string>("ctaSampling", "none");
+	executive.ctaSamples = config.parse<int>("ctaSamples", 64);
+	executive.ctaSamplingSeed = config.parse<int>("ctaSamplingSeed", 0);
+	executive.ctaSamplingReport = config.parse<std::string>(
+		"ctaSamplingReport", "");
+	
+	executive.nativeKernels.clear();
+	if (config.find("nativeKernels")) {
+		hydrazine::json::Visitor kernels = config["nativeKernels"];
+		hydrazine::json::Object *object = 
+			static_cast<hydrazine::json::Object *>(kernels.value);
+
+		for (hydrazine::json::Object::Dictionary::iterator 
+			it = object->begin(); it != object->end(); ++it) {
+			hydrazine::json::Visitor library(it->second);
+			executive.nativeKernels.insert(
+				std::make_pair(it->first, (std::string)library));
+		}
+	}
 	
 	if (config.find("devices")) {
 		hydrazine::json::Visitor devices = config["devices"];
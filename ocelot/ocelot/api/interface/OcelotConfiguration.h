@@ -12,6 +12,8 @@
 // C++ stdlib includes
 #include <string>
 #include <fstream>
+#include <vector>
+#include <map>
 
 namespace api {
 
@@ -62,6 +64,31 @@ namespace api {
 					bool alwaysAttach;
 			};
 			
+			/*! \brief when trace generators are attached to the launches and
+				CTAs of one kernel, everything else runs untraced */
+			class Window
+			{
+			public:
+					Window();
+				
+			public:
+					//! \brief launches of the kernel run untraced first
+					int skipLaunches;
+
+					//! \brief launches traced after that, 0 for all
+					int traceLaunches;
+				
+					//! \brief CTAs of a traced launch run untraced first,
+					//	in launch order
+					int skipCtas;
+
+					//! \brief CTAs traced after that, 0 for all
+					int traceCtas;
+			};
+			
+			//! \brief maps a kernel name to its trace window
+			typedef std::map<std::string, Window> WindowMap;
+			
 			/*! \brief configuration properties for trace::RaceDetector */
 			class RaceDetector
 			{
@@ -89,6 +116,10 @@ namespace api {
                         
             //! \brief Interactive Debugger
             Debugger debugger;
+			
+			//! \brief Fast-forward windows of kernels, kernels that are
+			//	not listed are always traced
+			WindowMap windows;
 		};
 
 		class CudaRuntimeImplementation {
@@ -103,9 +134,20 @@ namespace api {
 			
 			//! \brief for TraceGeneratingRuntime, path to output file
 			std::string runtimeApiTrace;
+			
+			//! \brief record the bandwidth of each memory transfer
+			bool traceTransfers;
+			
+			//! \brief path to the transfer trace, kept apart from the
+			//         runtime api trace
+			std::string transferTrace;
 		};
 
 		class Executive {
+		public:
+			//! \brief maps a kernel name to a native library and symbol
+			typedef std::map<std::string, std::string> NativeKernelMap;
+
 		public:
 			Executive();
 
@@ -144,6 +186,149 @@ namespace api {
 
 			//! \brief suggested warp size
 			int warpSize;
+
+			//! \brief if true, CPU devices map pinned host allocations 
+			//         directly into the device address space
+			bool zeroCopy;
+
+			//! \brief if true, CPU devices skip copies of pinned host pages
+			//         that have not been written since they were last copied
+			bool dirtyPageTracking;
+
+			/*! \brief order that LLVM workers walk the CTAs in a grid -
+				rowMajor, tiled, morton, or hilbert */
+			std::string ctaOrder;
+
+			//! \brief width and height of a tile for the tiled CTA order
+			int ctaTileSize;
+
+			/*! \brief policy for pinning CPU worker threads to cores -
+				none, compact, scatter, or explicit */
+			std::string workerAffinity;
+
+			//! \brief the core for each worker with the explicit policy
+			std::vector<int> workerCpus;
+
+			//! \brief if true, CPU device allocations are split across the
+			//         NUMA nodes of the workers that will touch them
+			bool partitionAllocations;
+
+			//! \brief number of consecutive threads that LLVM kernels run
+			//         together in one call as scalar lanes that share
+			//         uniform values - 1 disables bundling
+			int threadBundleWidth;
+
+			//! \brief run LLVM kernels with barriers as loops over threads 
+			//         between barriers instead of re-entering each thread
+			bool threadLoops;
+
+			//! \brief directory of the on-disk cache of translated LLVM
+			//         kernels - empty disables the cache
+			std::string kernelCache;
+
+			//! \brief size limit of the kernel cache in megabytes
+			int kernelCacheSize;
+
+			//! \brief translate every kernel of a module for the LLVM device
+			//         on background threads as soon as it is loaded
+			bool backgroundTranslation;
+
+			//! \brief number of background translation threads - 0 uses 
+			//         one per hardware thread
+			int translationThreads;
+
+			//! \brief start LLVM kernels unoptimized and recompile hot 
+			//         kernels at the device level, or full optimization
+			//         if the device is unoptimized, on a background thread
+			bool tieredCompilation;
+
+			//! \brief launches before a kernel is recompiled
+			int tierUpLaunches;
+
+			//! \brief milliseconds spent in launches before a kernel is
+			//         recompiled
+			int tierUpMilliseconds;
+
+			//! \brief compile LLVM kernels again with the CTA and grid 
+			//         dimensions and unchanged parameters of common
+			//         launches as constants
+			bool launchSpecialization;
+
+			//! \brief the most specialized variants kept for a kernel
+			int specializationVariants;
+
+			//! \brief launches with the same values before a variant is
+			//         compiled for them
+			int specializationLaunches;
+
+			//! \brief the cpu that the LLVM JIT generates code for - "host" 
+			//         detects the cpu of this machine, empty uses the LLVM 
+			//         default
+			std::string jitCpu;
+
+			//! \brief comma separated cpu features to add or remove for the
+			//         LLVM JIT, e.g. "+sse41,-avx"
+			std::string jitAttributes;
+
+			//! \brief code generation optimization level of the LLVM JIT 
+			//         from 0 to 3
+			int jitOptimizationLevel;
+
+			//! \brief lower single precision .approx and div.full PTX 
+			//         instructions to fast LLVM intrinsics
+			bool fastMath;
+
+			//! \brief link the bitcode runtime library into translated 
+			//         kernels so that its helpers can be inlined
+			bool inlineRuntime;
+
+			//! \brief path to the runtime library bitcode, empty uses the
+			//         installed library
+			std::string runtimeLibrary;
+
+			//! \brief start kernels on the emulator and move them to the 
+			//         LLVM JIT once they are hot
+			bool hybridExecution;
+
+			//! \brief launches without trace generators before a kernel 
+			//         moves to the LLVM JIT in hybrid execution
+			int hybridPromoteLaunches;
+
+			//! \brief time moved kernels on both backends and keep each on
+			//         the faster one in hybrid execution
+			bool hybridCalibration;
+
+			//! \brief directory of prof.<kernel>.txt branch profiles used
+			//         to weight the branches of LLVM kernels, empty for none
+			std::string branchProfiles;
+
+			//! \brief time different worker counts and CTA chunk sizes 
+			//         over the first launches of each kernel and grid size
+			//         on the LLVM JIT, then keep the fastest
+			bool autotuning;
+
+			//! \brief file that tuned configurations are loaded from and
+			//         saved to, empty to keep them for this run only
+			std::string autotuningFile;
+
+			//! \brief run only a sample of the CTAs of each launch and
+			//         extrapolate the counters, "none", "random", "strided"
+			//         or "clustered"
+			std::string ctaSampling;
+
+			//! \brief the number of CTAs traced by a sampled launch
+			int ctaSamples;
+
+			//! \brief seed for random sampling and clustering
+			int ctaSamplingSeed;
+
+			//! \brief file that the estimates of sampled launches are 
+			//         appended to, empty for none
+			std::string ctaSamplingReport;
+
+			//! \brief kernels replaced by native code, each maps to 
+			//         "library:symbol" or just "library"
+			NativeKernelMap nativeKernels;
 		};
 
 	public:
@@ -167,6 +352,10 @@ namespace api {
         //! \brief destroys the singleton
         static void destroy();
 
+        //! \brief replaces the singleton, takes ownership of the new one
+        //	so that tests can try several configurations in one process
+        static void set(OcelotConfiguration* configuration);
+
 	public:
 		//! \brief path to configuration file for reparsing 
 		std::string path;
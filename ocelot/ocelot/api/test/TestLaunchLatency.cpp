@@ -0,0 +1,175 @@
+/*! \file TestLaunchLatency.cpp
+	\date October 18, 2026
+	\author agent
+	\brief The source file for the TestLaunchLatency class.
+*/
+
+#ifndef TEST_LAUNCH_LATENCY_CPP_INCLUDED
+#define TEST_LAUNCH_LATENCY_CPP_INCLUDED
+
+#include <ocelot/api/test/TestLaunchLatency.h>
+#include <ocelot/api/interface/ocelot.h>
+
+#include <ocelot/cuda/interface/cuda_runtime.h>
+
+#include <hydrazine/implementation/ArgumentParser.h>
+#include <hydrazine/implementation/Timer.h>
+#include <hydrazine/implementation/debug.h>
+
+#include <sstream>
+
+#ifdef REPORT_BASE
+#undef REPORT_BASE
+#endif
+
+#define REPORT_BASE 0
+
+namespace test
+{
+	static void registerKernel( unsigned int instructions )
+	{
+		std::stringstream ptx;
+
+		ptx << ".version 1.4\n";
+		ptx << ".target sm_13, sm_10\n\n";
+		ptx << ".global .u32 counter;\n\n";
+		ptx << ".entry increment( .param .u64 result )\n";
+		ptx << "{\n";
+		ptx << "	.reg .u64 %lr<1>;\n";
+		ptx << "	.reg .u32 %r<2>;\n";
+		ptx << "	Entry:\n";
+		ptx << "		ld.global.u32 %r0, [counter];\n";
+		ptx << "		mov.u32 %r1, 0;\n";
+
+		for( unsigned int i = 0; i < instructions; ++i )
+		{
+			ptx << "		add.u32 %r0, %r0, %r1;\n";
+		}
+
+		ptx << "		add.u32 %r0, %r0, 1;\n";
+		ptx << "		st.global.u32 [counter], %r0;\n";
+		ptx << "		ld.param.u64 %lr0, [result];\n";
+		ptx << "		st.global.u32 [%lr0], %r0;\n";
+		ptx << "	Exit:\n";
+		ptx << "		exit;\n";
+		ptx << "}\n";
+
+		ocelot::registerPTXModule( ptx, "latencyKernels" );
+	}
+
+	static std::string getDeviceName( int device )
+	{
+		cudaDeviceProp deviceProp;
+		cudaGetDeviceProperties( &deviceProp, device );
+		return deviceProp.name;
+	}
+
+	bool TestLaunchLatency::testLatency( int device )
+	{
+		cudaSetDevice( device );
+
+		unsigned int* result = 0;
+		cudaMalloc( (void**) &result, sizeof( unsigned int ) );
+
+		long long unsigned int p = (long long unsigned int)result;
+
+		// the first launch pays for translation and setup
+		cudaConfigureCall( dim3( 1, 1, 1 ), dim3( 1, 1, 1 ), 0, 0 );
+		cudaSetupArgument( &p, sizeof( long long unsigned int ), 0 );
+		ocelot::launch( "latencyKernels", "increment" );
+
+		unsigned int first = 0;
+		cudaMemcpy( &first, result, sizeof( unsigned int ),
+			cudaMemcpyDeviceToHost );
+
+		hydrazine::Timer timer;
+		timer.start();
+
+		for( unsigned int i = 0; i < launches; ++i )
+		{
+			cudaConfigureCall( dim3( 1, 1, 1 ), dim3( 1, 1, 1 ), 0, 0 );
+			cudaSetupArgument( &p, sizeof( long long unsigned int ), 0 );
+			ocelot::launch( "latencyKernels", "increment" );
+		}
+
+		cudaThreadSynchronize();
+		timer.stop();
+
+		unsigned int last = 0;
+		cudaMemcpy( &last, result, sizeof( unsigned int ),
+			cudaMemcpyDeviceToHost );
+		cudaFree( result );
+
+		if( last != first + launches )
+		{
+			status << "Test Point 1 FAILED:\n";
+			status << " Expected counter " << ( first + launches )
+				<< " on device " << device << " (" << getDeviceName( device )
+				<< "), but got " << last << "\n";
+			return false;
+		}
+
+		double microseconds = launches > 0
+			? ( timer.seconds() * 1.0e6 ) / launches : 0.0;
+
+		status << " " << getDeviceName( device ) << ": " << microseconds
+			<< " us per launch (" << instructions << " instructions)\n";
+
+		return true;
+	}
+
+	bool TestLaunchLatency::doTest()
+	{
+		ocelot::reset();
+		registerKernel( instructions );
+
+		int devices = 0;
+		cudaGetDeviceCount( &devices );
+
+		for( int device = 0; device != devices; ++device )
+		{
+			if( !testLatency( device ) ) return false;
+		}
+
+		status << "Test Point 1 Passed\n";
+		return true;
+	}
+
+	TestLaunchLatency::TestLaunchLatency()
+	{
+		name = "TestLaunchLatency";
+
+		description = "A microbenchmark for the cost of back to back \
+			launches of a small kernel with a long instruction stream \
+		\
+		Test Points:\
+			1) Launch a single thread kernel that increments a global\
+				variable many times in a row on each device.  Check that\
+				every launch saw the previous launch's update and report\
+				the average time per launch.";
+	}
+}
+
+int main(int argc, char** argv)
+{
+	hydrazine::ArgumentParser parser( argc, argv );
+	test::TestLaunchLatency test;
+	parser.description( test.testDescription() );
+
+	parser.parse( "-s", "--seed", test.seed, 0,
+		"Random number generator seed, 0 implies seed with time." );
+	parser.parse( "-v", "--verbose", test.verbose, false,
+		"Print out information after the test has finished." );
+	parser.parse( "-n", "--instructions", test.instructions, 10000,
+		"The number of instructions in the kernel body." );
+	parser.parse( "-l", "--launches", test.launches, 1000,
+		"The number of back to back launches." );
+	parser.parse();
+
+	test.test();
+
+	return test.passed();
+}
+
+#endif
+
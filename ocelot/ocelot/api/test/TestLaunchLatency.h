@@ -0,0 +1,47 @@
+/*! \file TestLaunchLatency.h
+	\date October 18, 2026
+	\author agent
+	\brief The header file for the TestLaunchLatency class.
+*/
+
+#ifndef TEST_LAUNCH_LATENCY_H_INCLUDED
+#define TEST_LAUNCH_LATENCY_H_INCLUDED
+
+#include <hydrazine/interface/Test.h>
+
+namespace test
+{
+	/*! \brief A microbenchmark for the cost of back to back launches of a
+		small kernel with a long instruction stream
+	
+		Test Points:
+			1) Launch a single thread kernel that increments a global
+				variable many times in a row on each device.  Check that
+				every launch saw the previous launch's update and report 
+				the average time per launch.
+	*/
+	class TestLaunchLatency : public Test
+	{
+		public:
+			/*! \brief The number of instructions in the kernel body */
+			unsigned int instructions;
+			/*! \brief The number of back to back launches */
+			unsigned int launches;
+	
+		private:
+			/*! \brief Time back to back launches on a single device */
+			bool testLatency(int device);
+	
+			/*! \brief Dispatch function fot the unit tests */
+			bool doTest();
+	
+		public:
+			/*! \brief The constructor sets the description */
+			TestLaunchLatency();
+	};
+}
+
+int main(int argc, char** argv);
+
+#endif
+
@@ -0,0 +1,319 @@
+/*! \file TestThreadScaling.cpp
+	\date October 18, 2026
+	\author agent
+	\brief The source file for the TestThreadScaling class.
+*/
+
+#ifndef TEST_THREAD_SCALING_CPP_INCLUDED
+#define TEST_THREAD_SCALING_CPP_INCLUDED
+
+#include <ocelot/api/test/TestThreadScaling.h>
+#include <ocelot/api/interface/ocelot.h>
+
+#include <ocelot/cuda/interface/cuda_runtime.h>
+
+#include <hydrazine/interface/Thread.h>
+#include <hydrazine/implementation/ArgumentParser.h>
+#include <hydrazine/implementation/Timer.h>
+#include <hydrazine/implementation/debug.h>
+
+#include <vector>
+
+#ifdef REPORT_BASE
+#undef REPORT_BASE
+#endif
+
+#define REPORT_BASE 0
+
+namespace test
+{
+	static void registerKernel()
+	{
+		std::string ptx = ".version 1.4\n";
+		ptx += ".target sm_13, sm_10\n\n";
+		ptx += ".entry increment( .param .u64 memory )\n";
+		ptx += "{\n";
+		ptx += "	.reg .u64 %lr<1>;\n";
+		ptx += "	.reg .u32 %r<2>;\n";
+		ptx += "	Entry:\n";
+		ptx += "		ld.param.u64 %lr0, [memory];\n";
+		ptx += "		ld.global.u32 %r0, [%lr0];\n";
+		ptx += "		add.u32 %r1, %r0, 1;\n";
+		ptx += "		st.global.u32 [%lr0], %r1;\n";
+		ptx += "	Exit:\n";
+		ptx += "		exit;\n";
+		ptx += "}\n\n";
+		ptx += ".entry idle( .param .u64 memory )\n";
+		ptx += "{\n";
+		ptx += "	Entry:\n";
+		ptx += "	Exit:\n";
+		ptx += "		exit;\n";
+		ptx += "}\n";
+
+		std::stringstream stream( ptx );
+		ocelot::registerPTXModule( stream, "scalingKernels" );
+	}
+
+	class Thread : public hydrazine::Thread
+	{
+		public:
+			int device;
+			unsigned int iterations;
+			unsigned int errors;
+
+		private:
+			void execute()
+			{
+				errors = 0;
+				cudaSetDevice( device );
+
+				for( unsigned int i = 0; i < iterations; ++i )
+				{
+					unsigned int* pointer = 0;
+					unsigned int value = i;
+
+					cudaMalloc( (void**) &pointer, sizeof( unsigned int ) );
+					cudaMemcpy( pointer, &value, sizeof( unsigned int ),
+						cudaMemcpyHostToDevice );
+
+					cudaConfigureCall( dim3( 1, 1, 1 ), dim3( 1, 1, 1 ), 0, 0 );
+					long long unsigned int p = (long long unsigned int)pointer;
+					cudaSetupArgument( &p, sizeof( long long unsigned int ), 0 );
+					ocelot::launch( "scalingKernels", "increment" );
+
+					cudaMemcpy( &value, pointer, sizeof( unsigned int ),
+						cudaMemcpyDeviceToHost );
+					cudaFree( pointer );
+
+					if( value != i + 1 ) ++errors;
+				}
+			}
+	};
+
+	class LaunchThread : public hydrazine::Thread
+	{
+		public:
+			int device;
+			unsigned int iterations;
+			unsigned int errors;
+
+		private:
+			void execute()
+			{
+				errors = 0;
+				cudaSetDevice( device );
+
+				for( unsigned int i = 0; i < iterations; ++i )
+				{
+					cudaConfigureCall( dim3( 1, 1, 1 ), dim3( 1, 1, 1 ), 0, 0 );
+					long long unsigned int p = 0;
+					cudaSetupArgument( &p, sizeof( long long unsigned int ), 0 );
+
+					try
+					{
+						ocelot::launch( "scalingKernels", "idle" );
+					}
+					catch( ... )
+					{
+						++errors;
+						continue;
+					}
+
+					// the devices may be destroyed between the checks
+					cudaError_t error = cudaGetLastError();
+					if( error != cudaSuccess && error != cudaErrorNoDevice )
+					{
+						++errors;
+					}
+				}
+			}
+	};
+
+	bool TestThreadScaling::testScaling( unsigned int threadCount,
+		double& callsPerSecond )
+	{
+		typedef std::vector< Thread > ThreadVector;
+
+		int devices = 0;
+		cudaGetDeviceCount( &devices );
+
+		if( devices == 0 )
+		{
+			status << "Test Point 1 FAILED:\n";
+			status << " No devices found.\n";
+			return false;
+		}
+
+		ThreadVector threadVector( threadCount );
+
+		hydrazine::Timer timer;
+		timer.start();
+
+		for( ThreadVector::iterator thread = threadVector.begin();
+			thread != threadVector.end(); ++thread )
+		{
+			unsigned int index = std::distance( threadVector.begin(), thread );
+			thread->device = index % devices;
+			thread->iterations = iterations;
+			thread->start();
+		}
+
+		for( ThreadVector::iterator thread = threadVector.begin();
+			thread != threadVector.end(); ++thread )
+		{
+			thread->join();
+		}
+
+		timer.stop();
+
+		for( ThreadVector::iterator thread = threadVector.begin();
+			thread != threadVector.end(); ++thread )
+		{
+			if( thread->errors != 0 )
+			{
+				status << "Test Point 1 FAILED:\n";
+				status << " Thread "
+					<< std::distance( threadVector.begin(), thread )
+					<< " on device " << thread->device << " saw "
+					<< thread->errors << " wrong results.\n";
+				return false;
+			}
+		}
+
+		// malloc, two copies, configure, setup, launch, and free
+		double calls = 7.0 * threadCount * iterations;
+		callsPerSecond = timer.seconds() > 0.0 ? calls / timer.seconds() : 0.0;
+
+		return true;
+	}
+
+	bool TestThreadScaling::testThreadExit()
+	{
+		typedef std::vector< LaunchThread > ThreadVector;
+
+		int devices = 0;
+		cudaGetDeviceCount( &devices );
+
+		if( devices == 0 )
+		{
+			status << "Test Point 2 FAILED:\n";
+			status << " No devices found.\n";
+			return false;
+		}
+
+		ThreadVector threadVector( threads );
+
+		for( ThreadVector::iterator thread = threadVector.begin();
+			thread != threadVector.end(); ++thread )
+		{
+			unsigned int index = std::distance( threadVector.begin(), thread );
+			thread->device = index % devices;
+			thread->iterations = iterations;
+			thread->start();
+		}
+
+		for( unsigned int i = 0; i < iterations; ++i )
+		{
+			cudaThreadExit();
+		}
+
+		for( ThreadVector::iterator thread = threadVector.begin();
+			thread != threadVector.end(); ++thread )
+		{
+			thread->join();
+		}
+
+		for( ThreadVector::iterator thread = threadVector.begin();
+			thread != threadVector.end(); ++thread )
+		{
+			if( thread->errors != 0 )
+			{
+				status << "Test Point 2 FAILED:\n";
+				status << " Thread "
+					<< std::distance( threadVector.begin(), thread )
+					<< " on device " << thread->device << " saw "
+					<< thread->errors << " failed launches.\n";
+				return false;
+			}
+		}
+
+		// the devices created after the last exit still run the module
+		Thread thread;
+		thread.device = 0;
+		thread.iterations = 1;
+		thread.start();
+		thread.join();
+
+		if( thread.errors != 0 )
+		{
+			status << "Test Point 2 FAILED:\n";
+			status << " A launch after cudaThreadExit gave a wrong result.\n";
+			return false;
+		}
+
+		status << "Test Point 2 Passed\n";
+		return true;
+	}
+
+	bool TestThreadScaling::doTest()
+	{
+		ocelot::reset();
+		registerKernel();
+
+		for( unsigned int count = 1; count <= threads; count *= 2 )
+		{
+			double callsPerSecond = 0.0;
+			if( !testScaling( count, callsPerSecond ) ) return false;
+
+			status << " " << count << " host threads: " << callsPerSecond
+				<< " runtime calls per second\n";
+		}
+
+		status << "Test Point 1 Passed\n";
+
+		return testThreadExit();
+	}
+
+	TestThreadScaling::TestThreadScaling()
+	{
+		name = "TestThreadScaling";
+
+		description = "A stress test and benchmark for the CUDA runtime when \
+			it is called from many host threads at once \
+		\
+		Test Points:\
+			1) Launch an increasing number of host threads, each spread\
+				round robin across the devices.  Each thread repeatedly\
+				allocates memory, copies to it, launches a kernel, copies\
+				the result back, and frees it.  Check every result and\
+				report the achieved calls per second for each thread count.\
+			2) Launch a kernel repeatedly from several host threads while\
+				another thread calls cudaThreadExit over and over.  Check\
+				that every launch either succeeds or finds no device, and\
+				that a launch after the last exit gives the right result.";
+	}
+}
+
+int main(int argc, char** argv)
+{
+	hydrazine::ArgumentParser parser( argc, argv );
+	test::TestThreadScaling test;
+	parser.description( test.testDescription() );
+
+	parser.parse( "-s", "--seed", test.seed, 0,
+		"Random number generator seed, 0 implies seed with time." );
+	parser.parse( "-v", "--verbose", test.verbose, false,
+		"Print out information after the test has finished." );
+	parser.parse( "-t", "--threads", test.threads, 8,
+		"The maximum number of host threads." );
+	parser.parse( "-i", "--iterations", test.iterations, 100,
+		"The number of iterations for each host thread." );
+	parser.parse();
+
+	test.test();
+
+	return test.passed();
+}
+
+#endif
+
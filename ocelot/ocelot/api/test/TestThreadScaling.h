@@ -0,0 +1,55 @@
+/*! \file TestThreadScaling.h
+	\date October 18, 2026
+	\author agent
+	\brief The header file for the TestThreadScaling class.
+*/
+
+#ifndef TEST_THREAD_SCALING_H_INCLUDED
+#define TEST_THREAD_SCALING_H_INCLUDED
+
+#include <hydrazine/interface/Test.h>
+
+namespace test
+{
+	/*! \brief A stress test and benchmark for the CUDA runtime when it is
+		called from many host threads at once
+	
+		Test Points:
+			1) Launch an increasing number of host threads, each spread
+				round robin across the devices.  Each thread repeatedly
+				allocates memory, copies to it, launches a kernel, copies
+				the result back, and frees it.  Check every result and
+				report the achieved calls per second for each thread count.
+			2) Launch a kernel repeatedly from several host threads while
+				another thread calls cudaThreadExit over and over.  Check
+				that every launch either succeeds or finds no device, and
+				that a launch after the last exit gives the right result.
+	*/
+	class TestThreadScaling : public Test
+	{
+		public:
+			/*! \brief The maximum number of host threads */
+			unsigned int threads;
+			/*! \brief The number of iterations per host thread */
+			unsigned int iterations;
+	
+		private:
+			/*! \brief Run the stress test with a set number of threads */
+			bool testScaling(unsigned int threads, double& callsPerSecond);
+			/*! \brief Launch from many threads while the devices are
+				destroyed */
+			bool testThreadExit();
+	
+			/*! \brief Dispatch function fot the unit tests */
+			bool doTest();
+	
+		public:
+			/*! \brief The constructor sets the description */
+			TestThreadScaling();
+	};
+}
+
+int main(int argc, char** argv);
+
+#endif
+
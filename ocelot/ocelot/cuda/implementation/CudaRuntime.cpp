@@ -253,26 +253,39 @@ void cuda::CudaRuntime::_memoryError(const void* address, size_t count,
 	throw hydrazine::Exception(stream.str());
 }
 
+void cuda::CudaRuntime::_traceTransfer(const std::string& function, 
+	size_t count, const hydrazine::Timer& timer) {
+	if (!_transferTrace.is_open()) return;
+	
+	double bandwidth = timer.seconds() > 0.0 
+		? (count / timer.seconds()) / 1.0e9 : 0.0;
+	
+	boost::mutex::scoped_lock lock(_traceMutex);
+	_transferTrace << function << " size = " << count << " time = " 
+		<< timer.seconds() << " bandwidth = " << bandwidth << " GB/s\n";
+}
+
 void cuda::CudaRuntime::_enumerateDevices() {
 	if(_devicesLoaded) return;
 	report("Creating devices.");
+	DeviceVector devices;
 	if(config::get().executive.enableNVIDIA) {
 		executive::DeviceVector d = 
 			executive::Device::createDevices(ir::Instruction::SASS, _flags);
 		report(" - Added " << d.size() << " nvidia gpu devices." );
-		_devices.insert(_devices.end(), d.begin(), d.end());
+		devices.insert(devices.end(), d.begin(), d.end());
 	}
 	if(config::get().executive.enableEmulated) {
 		executive::DeviceVector d = 
 			executive::Device::createDevices(ir::Instruction::Emulated, _flags);
 		report(" - Added " << d.size() << " emulator devices." );
-		_devices.insert(_devices.end(), d.begin(), d.end());
+		devices.insert(devices.end(), d.begin(), d.end());
 	}
 	if(config::get().executive.enableLLVM) {
 		executive::DeviceVector d = 
 			executive::Device::createDevices(ir::Instruction::LLVM, _flags);
 		report(" - Added " << d.size() << " llvm-cpu devices." );
-		_devices.insert(_devices.end(), d.begin(), d.end());
+		devices.insert(devices.end(), d.begin(), d.end());
 		
 		if (config::get().executive.workerThreadLimit > 0) {
 			for (executive::DeviceVector::iterator d_it = d.begin(); d_it != d.end(); ++d_it) {
@@ -284,7 +297,26 @@ void cuda::CudaRuntime::_enumerateDevices() {
 		executive::DeviceVector d =
 			executive::Device::createDevices(ir::Instruction::CAL, _flags);
 		report(" - Added " << d.size() << " amd gpu devices." );
-		_devices.insert(_devices.end(), d.begin(), d.end());
+		devices.insert(devices.end(), d.begin(), d.end());
+	}
+	
+	// threads bound to a device read both vectors while holding only its
+	//  lock, so they only change while every device is locked
+	size_t locked = _deviceMutexes.size();
+	_lockDevices();
+	_devices.insert(_devices.end(), devices.begin(), devices.end());
+	while(_deviceMutexes.size() < _devices.size()) {
+		_deviceMutexes.push_back(new boost::mutex);
+	}
+	for(size_t i = 0; i < locked; ++i) {
+		_deviceMutexes[i]->unlock();
+	}
+	
+	// devices created again after cudaThreadExit need the modules that
+	//  were already registered
+	for(ModuleMap::iterator module = _modules.begin(); 
+		module != _modules.end(); ++module) {
+		if(module->second.loaded()) _loadModule(module);
 	}
 	_devicesLoaded = true;
 	
@@ -307,6 +339,19 @@ void cuda::CudaRuntime::_unlock() {
 	_mutex.unlock();
 }
 
+void cuda::CudaRuntime::_lockDevices() {
+	for(MutexVector::iterator mutex = _deviceMutexes.begin(); 
+		mutex != _deviceMutexes.end(); ++mutex) {
+		(*mutex)->lock();
+	}
+}
+
+void cuda::CudaRuntime::_unlockDevices() {
+	for(MutexVector::iterator mutex = _deviceMutexes.begin(); 
+		mutex != _deviceMutexes.end(); ++mutex) {
+		(*mutex)->unlock();
+	}
+}
 
 //! sets the last error state for the CudaRuntime object
 cudaError_t cuda::CudaRuntime::_setLastError(cudaError_t result) {
@@ -316,13 +361,15 @@ cudaError_t cuda::CudaRuntime::_setLastError(cudaError_t result) {
 }
 
 cuda::HostThreadContext& cuda::CudaRuntime::_bind() {
-	_enumerateDevices();
-
+	// the caller holds _mutex, so the devices cannot be destroyed here
 	HostThreadContext& thread = _getCurrentThread();
 
 	if (_devices.empty()) return thread;
 	
-	_selectedDevice = thread.selectedDevice;
+	assert(thread.selectedDevice >= 0);
+	assert(thread.selectedDevice < (int)_deviceMutexes.size());
+	_deviceMutexes[thread.selectedDevice]->lock();
+	
 	executive::Device& device = _getDevice();
 
 	assert(!device.selected());
@@ -334,28 +381,69 @@ cuda::HostThreadContext& cuda::CudaRuntime::_bind() {
 void cuda::CudaRuntime::_unbind() {
 	HostThreadContext& thread = _getCurrentThread();
 	executive::Device& device = _getDevice();
-	assert(thread.selectedDevice == _selectedDevice);
 	
-	_selectedDevice = -1;
 	assert(device.selected());
 	device.unselect();
+	
+	_deviceMutexes[thread.selectedDevice]->unlock();
 }
 
-void cuda::CudaRuntime::_acquire() {
+bool cuda::CudaRuntime::_acquire() {
 	_lock();
-	_bind();
-	if (_devices.empty()) _unlock();
+	_enumerateDevices();
+	if (_devices.empty()) {
+		_unlock();
+		return false;
+	}
+	
+	HostThreadContext& thread = _getCurrentThread();
+	assert(thread.selectedDevice >= 0);
+	assert(thread.selectedDevice < (int)_deviceMutexes.size());
+	boost::mutex* mutex = _deviceMutexes[thread.selectedDevice];
+	_unlock();
+	
+	mutex->lock();
+	
+	// cudaThreadExit may have destroyed the devices before the lock was
+	//  taken, they only change while every device is locked
+	if (thread.selectedDevice >= (int)_devices.size()) {
+		mutex->unlock();
+		return false;
+	}
+	
+	executive::Device& device = _getDevice();
+
+	assert(!device.selected());
+	device.select();
+	
+	return true;
 }
 
 void cuda::CudaRuntime::_release() {
 	_unbind();
+}
+
+bool cuda::CudaRuntime::_acquireAll() {
+	_lock();
+	_enumerateDevices();
+	if (_devices.empty()) {
+		_unlock();
+		return false;
+	}
+	_bind();
+	return true;
+}
+
+void cuda::CudaRuntime::_releaseAll() {
+	_unbind();
 	_unlock();
 }
 
 executive::Device& cuda::CudaRuntime::_getDevice() {
-	assert(_selectedDevice >= 0);
-	assert(_selectedDevice < (int)_devices.size());
-	return *_devices[_selectedDevice];
+	HostThreadContext& thread = _getCurrentThread();
+	assert(thread.selectedDevice >= 0);
+	assert(thread.selectedDevice < (int)_devices.size());
+	return *_devices[thread.selectedDevice];
 }
 
 std::string cuda::CudaRuntime::_formatError( const std::string& message ) {
@@ -371,6 +459,10 @@ std::string cuda::CudaRuntime::_formatError( const std::string& message ) {
 }
 
 cuda::HostThreadContext& cuda::CudaRuntime::_getCurrentThread() {
+	HostThreadContext* context = _currentThread.get();
+	if (context != 0) return *context;
+	
+	boost::mutex::scoped_lock lock(_threadMutex);
 	HostThreadContextMap::iterator t = _threads.find(
 		boost::this_thread::get_id());
 	if (t == _threads.end()) {
@@ -379,6 +471,9 @@ cuda::HostThreadContext& cuda::CudaRuntime::_getCurrentThread() {
 		t = _threads.insert(std::make_pair(boost::this_thread::get_id(), 
 			HostThreadContext())).first;
 	}
+	
+	// map nodes are never erased, so the context can be cached
+	_currentThread.reset(&t->second);
 	return t->second;
 }
 
@@ -394,12 +489,17 @@ void cuda::CudaRuntime::_registerModule(ModuleMap::iterator module) {
 		tex->normalizedFloat = texture->second.norm;
 	}
 	
-	for(DeviceVector::iterator device = _devices.begin(); 
-		device != _devices.end(); ++device) {
-		(*device)->select();
-		(*device)->load(&module->second);
-		(*device)->setOptimizationLevel(_optimization);
-		(*device)->unselect();
+	_loadModule(module);
+}
+
+void cuda::CudaRuntime::_loadModule(ModuleMap::iterator module) {
+	for(unsigned int i = 0; i < _devices.size(); ++i) {
+		boost::mutex::scoped_lock lock(*_deviceMutexes[i]);
+		executive::Device* device = _devices[i];
+		device->select();
+		device->load(&module->second);
+		device->setOptimizationLevel(_optimization);
+		device->unselect();
 	}
 }
 
@@ -419,8 +519,12 @@ void cuda::CudaRuntime::_registerAllModules() {
 
 //////////////////////////////////////////////////////////////////////////////////////////////////
 
-cuda::CudaRuntime::CudaRuntime() : _deviceCount(0), _devicesLoaded(false), 
-	_selectedDevice(-1), _nextSymbol(1), _flags(0), 
+static void keepThreadContext(cuda::HostThreadContext*) {
+	// thread contexts are owned by the runtime's thread map
+}
+
+cuda::CudaRuntime::CudaRuntime() : _currentThread(keepThreadContext), 
+	_deviceCount(0), _devicesLoaded(false), _nextSymbol(1), _flags(0), 
 	_optimization((translator::Translator::OptimizationLevel)
 		config::get().executive.optimizationLevel) {
 
@@ -437,6 +541,10 @@ cuda::CudaRuntime::CudaRuntime() : _deviceCount(0), _devicesLoaded(false),
 	if(config::get().executive.enableAMD) {
 		_deviceCount += executive::Device::deviceCount(ir::Instruction::CAL);
 	}
+	
+	if(config::get().cuda.traceTransfers) {
+		_transferTrace.open(config::get().cuda.transferTrace.c_str());
+	}
 }
 
 cuda::CudaRuntime::~CudaRuntime() {
@@ -450,6 +558,10 @@ cuda::CudaRuntime::~CudaRuntime() {
 	}
 	
 	// mutex
+	for (MutexVector::iterator mutex = _deviceMutexes.begin(); 
+		mutex != _deviceMutexes.end(); ++mutex) {
+		delete *mutex;
+	}
 
 	// thread contexts
 	
@@ -660,8 +772,7 @@ void cuda::CudaRuntime::cudaRegisterFunction(
 
 cudaError_t cuda::CudaRuntime::cudaMalloc(void **devPtr, size_t size) {
 	cudaError_t result = cudaErrorMemoryAllocation;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 	
 	try {
 		executive::Device::MemoryAllocation* 
@@ -683,8 +794,7 @@ cudaError_t cuda::CudaRuntime::cudaMalloc(void **devPtr, size_t size) {
 
 cudaError_t cuda::CudaRuntime::cudaMallocHost(void **ptr, size_t size) {
 	cudaError_t result = cudaErrorMemoryAllocation;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 	
 	try {
 		executive::Device::MemoryAllocation* 
@@ -707,8 +817,7 @@ cudaError_t cuda::CudaRuntime::cudaMallocPitch(void **devPtr, size_t *pitch,
 	size_t width, size_t height) {
 	cudaError_t result = cudaErrorMemoryAllocation;
 	
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquireAll()) return _setLastError(cudaErrorNoDevice);
 
 	*pitch = width;
 
@@ -726,7 +835,7 @@ cudaError_t cuda::CudaRuntime::cudaMallocPitch(void **devPtr, size_t *pitch,
 	report("cudaMallocPitch( *devPtr = " << (void *)*devPtr 
 		<< ", pitch = " << *pitch << ")");
 
-	_release();
+	_releaseAll();
 	
 	return _setLastError(result);
 }
@@ -734,8 +843,7 @@ cudaError_t cuda::CudaRuntime::cudaMallocPitch(void **devPtr, size_t *pitch,
 cudaError_t cuda::CudaRuntime::cudaMallocArray(struct cudaArray **array, 
 	const struct cudaChannelFormatDesc *desc, size_t width, size_t height) {
 	cudaError_t result = cudaErrorMemoryAllocation;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquireAll()) return _setLastError(cudaErrorNoDevice);
 	
 	size_t size = width * height * ( desc->x 
 		+ desc->y + desc->z + desc->w ) / 8;
@@ -753,15 +861,14 @@ cudaError_t cuda::CudaRuntime::cudaMallocArray(struct cudaArray **array,
 	
 	report("cudaMallocArray( *array = " << (void *)*array << ")");
 
-	_release();
+	_releaseAll();
 	
 	return _setLastError(result);
 }
 
 cudaError_t cuda::CudaRuntime::cudaFree(void *devPtr) {
 	cudaError_t result = cudaErrorMemoryAllocation;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 
 	report("cudaFree(" << devPtr << ")");
 	
@@ -781,8 +888,7 @@ cudaError_t cuda::CudaRuntime::cudaFree(void *devPtr) {
 
 cudaError_t cuda::CudaRuntime::cudaFreeHost(void *ptr) {
 	cudaError_t result = cudaErrorMemoryAllocation;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 
 	report("cudaFreeHost(" << ptr << ")");	
 	
@@ -802,8 +908,7 @@ cudaError_t cuda::CudaRuntime::cudaFreeHost(void *ptr) {
 
 cudaError_t cuda::CudaRuntime::cudaFreeArray(struct cudaArray *array) {
 	cudaError_t result = cudaErrorMemoryAllocation;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 
 	try {
 		if (array) {
@@ -824,8 +929,7 @@ cudaError_t cuda::CudaRuntime::cudaFreeArray(struct cudaArray *array) {
 cudaError_t cuda::CudaRuntime::cudaMalloc3D(struct cudaPitchedPtr* devPtr, 
 	struct cudaExtent extent) {
 	cudaError_t result = cudaErrorMemoryAllocation;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquireAll()) return _setLastError(cudaErrorNoDevice);
 
 	report("cudaMalloc3D() extent - width " << extent.width 
 		<< " - height " << extent.height << " - depth " << extent.depth );
@@ -848,7 +952,7 @@ cudaError_t cuda::CudaRuntime::cudaMalloc3D(struct cudaPitchedPtr* devPtr,
 	
 	}
 	
-	_release();
+	_releaseAll();
 	return _setLastError(result);
 }
 
@@ -856,8 +960,7 @@ cudaError_t cuda::CudaRuntime::cudaMalloc3DArray(struct cudaArray** arrayPtr,
 	const struct cudaChannelFormatDesc* desc, struct cudaExtent extent) {
 
 	cudaError_t result = cudaErrorMemoryAllocation;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquireAll()) return _setLastError(cudaErrorNoDevice);
 
 	size_t size = extent.width * extent.height * extent.depth * ( desc->x 
 		+ desc->y + desc->z + desc->w ) / 8;
@@ -876,15 +979,14 @@ cudaError_t cuda::CudaRuntime::cudaMalloc3DArray(struct cudaArray** arrayPtr,
 
 	report("cudaMalloc3DArray() - *arrayPtr = " << (void *)(*arrayPtr));
 	
-	_release();
+	_releaseAll();
 	return _setLastError(result);
 }
 
 cudaError_t cuda::CudaRuntime::cudaHostAlloc(void **pHost, size_t bytes, 
 	unsigned int flags) {
 	cudaError_t result = cudaErrorMemoryAllocation;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 	
 	try {
 		executive::Device::MemoryAllocation* 
@@ -907,8 +1009,7 @@ cudaError_t cuda::CudaRuntime::cudaHostGetDevicePointer(void **pDevice,
 	void *pHost, unsigned int flags) {
 
 	cudaError_t result = cudaErrorInvalidHostPointer;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 	
 	executive::Device::MemoryAllocation* 
 		allocation = _getDevice().getMemoryAllocation(pHost, 
@@ -930,8 +1031,7 @@ cudaError_t cuda::CudaRuntime::cudaHostGetFlags(unsigned int *pFlags,
 	void *pHost) {
 
 	cudaError_t result = cudaErrorInvalidValue;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 
 	executive::Device::MemoryAllocation* 
 		allocation = _getDevice().getMemoryAllocation(pHost, 
@@ -953,11 +1053,14 @@ cudaError_t cuda::CudaRuntime::cudaMemcpy(void *dst, const void *src,
 	size_t count, enum cudaMemcpyKind kind) {
 	cudaError_t result = cudaErrorInvalidDevicePointer;
 	if (kind >= 0 && kind <= 3) {
-		_acquire();
-		if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+		if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 
 		report("cudaMemcpy(" << dst << ", " << src << ", " << count << ")");
+		hydrazine::Timer timer;
+		timer.start();
 		_memcpy(dst, src, count, kind);
+		timer.stop();
+		_traceTransfer("cudaMemcpy", count, timer);
 		result = cudaSuccess;
 
 		_release();
@@ -1010,7 +1113,7 @@ cudaError_t cuda::CudaRuntime::cudaMemcpyToSymbol(const char *symbol,
 	if (allocation != 0) {
 		if (!_getDevice().checkMemoryAccess((char*)allocation->pointer() 
 			+ offset, count)) {
-			_release();
+			_releaseAll();
 			_memoryError((char*)allocation->pointer() + offset, 
 				count, "cudaMemcpyToSymbol");
 		}
@@ -1019,7 +1122,7 @@ cudaError_t cuda::CudaRuntime::cudaMemcpyToSymbol(const char *symbol,
 		result = cudaSuccess;
 	}
 	
-	_release();
+	_releaseAll();
 	return _setLastError(result);
 }
 
@@ -1064,7 +1167,7 @@ cudaError_t cuda::CudaRuntime::cudaMemcpyFromSymbol(void *dst,
 	if (allocation != 0) {
 		if (!_getDevice().checkMemoryAccess((char*)allocation->pointer() 
 			+ offset, count)) {
-			_release();
+			_releaseAll();
 			_memoryError((char*)allocation->pointer() + offset, 
 				count, "cudaMemcpyFromSymbol");
 		}
@@ -1073,7 +1176,7 @@ cudaError_t cuda::CudaRuntime::cudaMemcpyFromSymbol(void *dst,
 		result = cudaSuccess;
 	}
 	
-	_release();
+	_releaseAll();
 	return _setLastError(result);
 }
 
@@ -1087,8 +1190,7 @@ cudaError_t cuda::CudaRuntime::cudaMemcpyToArray(struct cudaArray *dst,
 	enum cudaMemcpyKind kind) {
 
 	cudaError_t result = cudaErrorInvalidValue ;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquireAll()) return _setLastError(cudaErrorNoDevice);
 
 	report("cudaMemcpyToArray("<< dst << ", " << src << ", " << wOffset 
 		<< ", " << hOffset << ", " << count << ")");
@@ -1102,7 +1204,7 @@ cudaError_t cuda::CudaRuntime::cudaMemcpyToArray(struct cudaArray *dst,
 			size_t offset = wOffset + hOffset * dimension.pitch();
 			void* address = (char*)allocation->pointer() + offset;
 			if (!_getDevice().checkMemoryAccess(address, count)) {
-				_release();
+				_releaseAll();
 				_memoryError(address, count, "cudaMemcpyToArray");
 			}
 			allocation->copy(offset, src, count);
@@ -1110,7 +1212,7 @@ cudaError_t cuda::CudaRuntime::cudaMemcpyToArray(struct cudaArray *dst,
 		}
 		else
 		{
-			_release();
+			_releaseAll();
 			_memoryError(dst, count, "cudaMemcpyToArray");
 		}
 	}
@@ -1124,11 +1226,11 @@ cudaError_t cuda::CudaRuntime::cudaMemcpyToArray(struct cudaArray *dst,
 			size_t offset = wOffset + hOffset * dimension.pitch();
 			void* address = (char*)destination->pointer() + offset;
 			if (!_getDevice().checkMemoryAccess(address, count)) {
-				_release();
+				_releaseAll();
 				_memoryError(address, count, "cudaMemcpyToArray");
 			}
 			if (!_getDevice().checkMemoryAccess(src, count)) {
-				_release();
+				_releaseAll();
 				_memoryError(src, count, "cudaMemcpyToArray");
 			}
 			size_t sourceOffset = (char*)src - (char*)source->pointer();
@@ -1137,7 +1239,7 @@ cudaError_t cuda::CudaRuntime::cudaMemcpyToArray(struct cudaArray *dst,
 		}
 		else
 		{
-			_release();
+			_releaseAll();
 			if(destination == 0)
 			{
 				_memoryError(dst, count, "cudaMemcpyToArray");
@@ -1149,7 +1251,7 @@ cudaError_t cuda::CudaRuntime::cudaMemcpyToArray(struct cudaArray *dst,
 		}
 	}
 
-	_release();
+	_releaseAll();
 	return _setLastError(result);
 }
 
@@ -1158,8 +1260,7 @@ cudaError_t cuda::CudaRuntime::cudaMemcpyFromArray(void *dst,
 	enum cudaMemcpyKind kind) {
 
 	cudaError_t result = cudaErrorInvalidValue ;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquireAll()) return _setLastError(cudaErrorNoDevice);
 
 	report("cudaMemcpyFromArray("<< dst << ", " << src << ", " << wOffset 
 		<< ", " << hOffset << ", " << count << ")");
@@ -1174,7 +1275,7 @@ cudaError_t cuda::CudaRuntime::cudaMemcpyFromArray(void *dst,
 			size_t offset = wOffset + hOffset * dimension.pitch();
 			void* address = (char*)allocation->pointer() + offset;
 			if (!_getDevice().checkMemoryAccess(address, count)) {
-				_release();
+				_releaseAll();
 				_memoryError(address, count, "cudaMemcpyFromArray");
 			}
 			allocation->copy(dst, offset, count);
@@ -1182,7 +1283,7 @@ cudaError_t cuda::CudaRuntime::cudaMemcpyFromArray(void *dst,
 		}
 		else
 		{
-			_release();
+			_releaseAll();
 			_memoryError(src, count, "cudaMemcpyFromArray");
 		}
 	}
@@ -1196,11 +1297,11 @@ cudaError_t cuda::CudaRuntime::cudaMemcpyFromArray(void *dst,
 			size_t offset = wOffset + hOffset * dimension.pitch();
 			void* address = (char*)destination->pointer() + offset;
 			if (!_getDevice().checkMemoryAccess(address, count)) {
-				_release();
+				_releaseAll();
 				_memoryError(address, count, "cudaMemcpyFromArray");
 			}
 			if (!_getDevice().checkMemoryAccess(dst, count)) {
-				_release();
+				_releaseAll();
 				_memoryError(src, count, "cudaMemcpyFromArray");
 			}
 			size_t destinationOffset = (char*)dst 
@@ -1210,7 +1311,7 @@ cudaError_t cuda::CudaRuntime::cudaMemcpyFromArray(void *dst,
 		}
 		else
 		{
-			_release();
+			_releaseAll();
 			 if(destination == 0)
 			 {
 			 	_memoryError(dst, count, "cudaMemcpyFromArray");
@@ -1222,7 +1323,7 @@ cudaError_t cuda::CudaRuntime::cudaMemcpyFromArray(void *dst,
 		}
 	}
 
-	_release();
+	_releaseAll();
 	return _setLastError(result);
 }
 
@@ -1234,20 +1335,19 @@ cudaError_t cuda::CudaRuntime::cudaMemcpyArrayToArray(struct cudaArray *dst,
 	cudaError_t result = cudaErrorInvalidValue;
 	report("cudaMemcpyArrayToArray()");
 
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquireAll()) return _setLastError(cudaErrorNoDevice);
 	
 	if (kind == cudaMemcpyDeviceToDevice) {
 		executive::Device::MemoryAllocation* 
 			destination = _getDevice().getMemoryAllocation(dst);
 		if (destination->pointer() != dst) {
-			_release();
+			_releaseAll();
 			_memoryError(dst, count, "cudaMemcpyArrayToArray");
 		}
 		executive::Device::MemoryAllocation* 
 			source = _getDevice().getMemoryAllocation(src);
 		if (source->pointer() != src) {
-			_release();
+			_releaseAll();
 			_memoryError(src, count, "cudaMemcpyArrayToArray");
 		}
 		if (destination != 0 && source != 0) {
@@ -1264,11 +1364,11 @@ cudaError_t cuda::CudaRuntime::cudaMemcpyArrayToArray(struct cudaArray *dst,
 			void* destinationAddress = (char*)destination->pointer() 
 				+ destinationOffset;
 			if (!_getDevice().checkMemoryAccess(sourceAddress, count)) {
-				_release();
+				_releaseAll();
 				_memoryError(sourceAddress, count, "cudaMemcpyArrayToArray");
 			}
 			if (!_getDevice().checkMemoryAccess(destinationAddress, count)) {
-				_release();
+				_releaseAll();
 				_memoryError(destinationAddress, 
 					count, "cudaMemcpyArrayToArray");
 			}
@@ -1277,10 +1377,22 @@ cudaError_t cuda::CudaRuntime::cudaMemcpyArrayToArray(struct cudaArray *dst,
 		}	
 	}
 	
-	_release();
+	_releaseAll();
 	return _setLastError(result);	
 }
 
+/*!
+	\brief merge the rows of a pitched copy into a single span if they are 
+		densely packed
+*/
+static void collapseRows(size_t& rows, size_t& width, size_t dstPitch, 
+	size_t srcPitch) {
+	if (rows > 1 && width == dstPitch && width == srcPitch) {
+		width *= rows;
+		rows = 1;
+	}
+}
+
 /*!
 	\brief perform a 2D memcpy from a dense buffer
 */
@@ -1289,18 +1401,23 @@ cudaError_t cuda::CudaRuntime::cudaMemcpy2D(void *dst, size_t dpitch,
 	enum cudaMemcpyKind kind) {
 
 	cudaError_t result = cudaErrorInvalidValue;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquireAll()) return _setLastError(cudaErrorNoDevice);
 
 	report("cudaMemcpy2D()");	
 
+	hydrazine::Timer timer;
+	timer.start();
+
 	switch (kind) {
 		case cudaMemcpyHostToHost:
 		{
-			for (size_t row = 0; row < height; row++) {
+			size_t rows = height;
+			size_t span = width;
+			collapseRows(rows, span, dpitch, spitch);
+			for (size_t row = 0; row < rows; row++) {
 				char* dstPtr = (char*)dst + dpitch * row;
 				char* srcPtr = (char*)src + spitch * row;
-				std::memcpy(dstPtr, srcPtr, width);
+				std::memcpy(dstPtr, srcPtr, span);
 			}
 			result = cudaSuccess;
 		}
@@ -1310,23 +1427,26 @@ cudaError_t cuda::CudaRuntime::cudaMemcpy2D(void *dst, size_t dpitch,
 			executive::Device::MemoryAllocation* source = 
 				_getDevice().getMemoryAllocation(src);
 			if (source != 0) {
-				for (size_t row = 0; row < height; row++) {
+				size_t rows = height;
+				size_t span = width;
+				collapseRows(rows, span, dpitch, spitch);
+				for (size_t row = 0; row < rows; row++) {
 					void* dstPtr = (char *)dst + dpitch * row;
 					size_t srcOffset = spitch * row;
 
 					if (!_getDevice().checkMemoryAccess(
-						(char*)source->pointer() + srcOffset, width)) {
-						_release();
+						(char*)source->pointer() + srcOffset, span)) {
+						_releaseAll();
 						_memoryError((char*)source->pointer() + srcOffset, 
-							width, "cudaMemcpy2D");
+							span, "cudaMemcpy2D");
 					}
 					
-					source->copy(dstPtr, srcOffset, width);
+					source->copy(dstPtr, srcOffset, span);
 				}
 				result = cudaSuccess;
 			}
 			else {
-				_release();
+				_releaseAll();
 				_memoryError(src, width * height, "cudaMemcpy2D");
 			}
 		}
@@ -1337,23 +1457,26 @@ cudaError_t cuda::CudaRuntime::cudaMemcpy2D(void *dst, size_t dpitch,
 				_getDevice().getMemoryAllocation(dst);
 			size_t dstPitch = _dimensions[destination->pointer()].pitch();
 			if (destination != 0) {
-				for (size_t row = 0; row < height; row++) {
+				size_t rows = height;
+				size_t span = width;
+				collapseRows(rows, span, dstPitch, spitch);
+				for (size_t row = 0; row < rows; row++) {
 					void* srcPtr = (char *)src + spitch * row;
 					size_t dstOffset = dstPitch * row;
 
 					if (!_getDevice().checkMemoryAccess(
-						(char*)destination->pointer() + dstOffset, width)) {
-						_release();
+						(char*)destination->pointer() + dstOffset, span)) {
+						_releaseAll();
 						_memoryError((char*)destination->pointer() + dstOffset, 
-							width, "cudaMemcpy2D");
+							span, "cudaMemcpy2D");
 					}
 					
-					destination->copy(dstOffset, srcPtr, width);
+					destination->copy(dstOffset, srcPtr, span);
 				}
 				result = cudaSuccess;
 			}
 			else {
-				_release();
+				_releaseAll();
 				_memoryError(dst, width * height, "cudaMemcpy2D");
 			}
 		}
@@ -1365,29 +1488,32 @@ cudaError_t cuda::CudaRuntime::cudaMemcpy2D(void *dst, size_t dpitch,
 			executive::Device::MemoryAllocation* source = 
 				_getDevice().getMemoryAllocation(src);
 			if (destination != 0 && source != 0) {
-				for (size_t row = 0; row < height; row++) {
+				size_t rows = height;
+				size_t span = width;
+				collapseRows(rows, span, dpitch, spitch);
+				for (size_t row = 0; row < rows; row++) {
 					size_t srcOffset = spitch * row;
 					size_t dstOffset = dpitch * row;
 
 					if (!_getDevice().checkMemoryAccess(
-						(char*)destination->pointer() + dstOffset, width)) {
-						_release();
+						(char*)destination->pointer() + dstOffset, span)) {
+						_releaseAll();
 						_memoryError((char*)destination->pointer() + dstOffset, 
-							width, "cudaMemcpy2D");
+							span, "cudaMemcpy2D");
 					}
 					if (!_getDevice().checkMemoryAccess(
-						(char*)source->pointer() + srcOffset, width)) {
-						_release();
+						(char*)source->pointer() + srcOffset, span)) {
+						_releaseAll();
 						_memoryError((char*)source->pointer() + srcOffset, 
-							width, "cudaMemcpy2D");
+							span, "cudaMemcpy2D");
 					}
 					
-					source->copy(destination, dstOffset, srcOffset, width);
+					source->copy(destination, dstOffset, srcOffset, span);
 				}
 				result = cudaSuccess;
 			}
 			else {
-				_release();
+				_releaseAll();
 				if (destination == 0) {
 					_memoryError(dst, width * height, "cudaMemcpy2D");
 				}
@@ -1400,7 +1526,12 @@ cudaError_t cuda::CudaRuntime::cudaMemcpy2D(void *dst, size_t dpitch,
 		default: break;
 	}
 	
-	_release();
+	timer.stop();
+	if (result == cudaSuccess) {
+		_traceTransfer("cudaMemcpy2D", width * height, timer);
+	}
+	
+	_releaseAll();
 	return _setLastError(result);	
 }
 
@@ -1412,8 +1543,7 @@ cudaError_t cuda::CudaRuntime::cudaMemcpy2DToArray(struct cudaArray *dst,
 	size_t width, size_t height, enum cudaMemcpyKind kind) {
 
 	cudaError_t result = cudaErrorInvalidValue;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquireAll()) return _setLastError(cudaErrorNoDevice);
 
 	report("cudaMemcpy2DtoArray(dst = " << (void *)dst 
 		<< ", src = " << (void *)src);
@@ -1423,24 +1553,27 @@ cudaError_t cuda::CudaRuntime::cudaMemcpy2DToArray(struct cudaArray *dst,
 			_getDevice().getMemoryAllocation(dst);
 		
 		if (destination == 0) {
-			_release();
+			_releaseAll();
 			_memoryError(dst, width * height, "cudaMemcpy2DtoArray");
 		}
 		
 		size_t dstPitch = _dimensions[destination->pointer()].pitch();
+		size_t rows = height;
+		size_t span = width;
+		collapseRows(rows, span, dstPitch, spitch);
 
-		for (size_t row = 0; row < height; ++row) {
+		for (size_t row = 0; row < rows; ++row) {
 			void* srcPtr = (char*)src + row * spitch;
 			size_t dstOffset = (row + hOffset) * dstPitch + wOffset;
 			
 			if (!_getDevice().checkMemoryAccess((char*)destination->pointer() 
-				+ dstOffset, width)) {
-				_release();
+				+ dstOffset, span)) {
+				_releaseAll();
 				_memoryError((char*)destination->pointer() + dstOffset, 
-					width, "cudaMemcpy2DtoArray");
+					span, "cudaMemcpy2DtoArray");
 			}
 			
-			destination->copy(dstOffset, srcPtr, width);
+			destination->copy(dstOffset, srcPtr, span);
 		}
 		
 		result = cudaSuccess;
@@ -1452,42 +1585,45 @@ cudaError_t cuda::CudaRuntime::cudaMemcpy2DToArray(struct cudaArray *dst,
 			_getDevice().getMemoryAllocation(src);
 		
 		if (destination == 0) {
-			_release();
+			_releaseAll();
 			_memoryError(dst, width * height, "cudaMemcpy2DtoArray");
 		}
 
 		if (source == 0) {
-			_release();
+			_releaseAll();
 			_memoryError(src, width * height, "cudaMemcpy2DtoArray");
 		}
 		
 		size_t dstPitch = _dimensions[destination->pointer()].pitch();
+		size_t rows = height;
+		size_t span = width;
+		collapseRows(rows, span, dstPitch, spitch);
 		
-		for (size_t row = 0; row < height; ++row) {
+		for (size_t row = 0; row < rows; ++row) {
 			size_t srcOffset = row * spitch;
 			size_t dstOffset = (row + hOffset) * dstPitch + wOffset;
 			
 			if (!_getDevice().checkMemoryAccess((char*)destination->pointer() 
-				+ dstOffset, width)) {
-				_release();
+				+ dstOffset, span)) {
+				_releaseAll();
 				_memoryError((char*)destination->pointer() 
-					+ dstOffset, width, "cudaMemcpy2DtoArray");
+					+ dstOffset, span, "cudaMemcpy2DtoArray");
 			}
 
 			if (!_getDevice().checkMemoryAccess((char*)source->pointer() 
-				+ srcOffset, width)) {
-				_release();
+				+ srcOffset, span)) {
+				_releaseAll();
 				_memoryError((char*)source->pointer() + srcOffset, 
-					width, "cudaMemcpy2DtoArray");
+					span, "cudaMemcpy2DtoArray");
 			}
 			
-			source->copy(destination, dstOffset, srcOffset, width);
+			source->copy(destination, dstOffset, srcOffset, span);
 		}
 		
 		result = cudaSuccess;
 	}
 	
-	_release();
+	_releaseAll();
 	return _setLastError(result);
 }
 
@@ -1499,8 +1635,7 @@ cudaError_t cuda::CudaRuntime::cudaMemcpy2DFromArray(void *dst, size_t dpitch,
 	size_t height, enum cudaMemcpyKind kind) {
 
 	cudaError_t result = cudaErrorInvalidValue;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquireAll()) return _setLastError(cudaErrorNoDevice);
 
 	report("cudaMemcpy2DfromArray(dst = " << (void *)dst 
 		<< ", src = " << (void *)src);
@@ -1510,25 +1645,28 @@ cudaError_t cuda::CudaRuntime::cudaMemcpy2DFromArray(void *dst, size_t dpitch,
 			_getDevice().getMemoryAllocation(dst);
 		
 		if (source == 0) {
-			_release();
+			_releaseAll();
 			_memoryError(src, width * height, "cudaMemcpy2DfromArray");
 		}
 		
 		assert(_dimensions.count(source->pointer()) != 0);
 		size_t srcPitch = _dimensions[source->pointer()].pitch();
+		size_t rows = height;
+		size_t span = width;
+		collapseRows(rows, span, dpitch, srcPitch);
 
-		for (size_t row = 0; row < height; ++row) {
+		for (size_t row = 0; row < rows; ++row) {
 			void* dstPtr = (char*)dst + row * dpitch;
 			size_t srcOffset = (row + hOffset) * srcPitch + wOffset;
 			
 			if (!_getDevice().checkMemoryAccess((char*)source->pointer() 
-				+ srcOffset, width)) {
-				_release();
+				+ srcOffset, span)) {
+				_releaseAll();
 				_memoryError((char*)source->pointer() 
-					+ srcOffset, width, "cudaMemcpy2DfromArray");
+					+ srcOffset, span, "cudaMemcpy2DfromArray");
 			}
 			
-			source->copy(dstPtr, srcOffset, width);
+			source->copy(dstPtr, srcOffset, span);
 		}
 		
 		result = cudaSuccess;
@@ -1540,42 +1678,45 @@ cudaError_t cuda::CudaRuntime::cudaMemcpy2DFromArray(void *dst, size_t dpitch,
 			_getDevice().getMemoryAllocation(src);
 		
 		if (destination == 0) {
-			_release();
+			_releaseAll();
 			_memoryError(dst, width * height, "cudaMemcpy2DfromArray");
 		}
 
 		if (source == 0) {
-			_release();
+			_releaseAll();
 			_memoryError(src, width * height, "cudaMemcpy2DfromArray");
 		}
 		
 		size_t srcPitch = _dimensions[source->pointer()].pitch();
+		size_t rows = height;
+		size_t span = width;
+		collapseRows(rows, span, dpitch, srcPitch);
 		
-		for (size_t row = 0; row < height; ++row) {
+		for (size_t row = 0; row < rows; ++row) {
 			size_t dstOffset = row * dpitch;
 			size_t srcOffset = (row + hOffset) * srcPitch + wOffset;
 			
 			if (!_getDevice().checkMemoryAccess((char*)destination->pointer() 
-				+ dstOffset, width)) {
-				_release();
+				+ dstOffset, span)) {
+				_releaseAll();
 				_memoryError((char*)destination->pointer() 
-					+ dstOffset, width, "cudaMemcpy2DfromArray");
+					+ dstOffset, span, "cudaMemcpy2DfromArray");
 			}
 
 			if (!_getDevice().checkMemoryAccess((char*)source->pointer() 
-				+ srcOffset, width)) {
-				_release();
-				_memoryError((char*)source->pointer() + srcOffset, width, 
+				+ srcOffset, span)) {
+				_releaseAll();
+				_memoryError((char*)source->pointer() + srcOffset, span, 
 					"cudaMemcpy2DfromArray");
 			}
 			
-			destination->copy(source, srcOffset, dstOffset, width);
+			destination->copy(source, srcOffset, dstOffset, span);
 		}
 		
 		result = cudaSuccess;
 	}
 	
-	_release();
+	_releaseAll();
 	return _setLastError(result);
 }
 
@@ -1587,6 +1728,7 @@ cudaError_t cuda::CudaRuntime::cudaMemcpy3D(const struct cudaMemcpy3DParms *p) {
 	cudaPitchedPtr src;
 	const cudaExtent& extent = p->extent;
 
+	_lock();
 	if (p->dstArray) {
 		dst.ptr = (void *)p->dstArray;
 		dst.pitch = _dimensions[p->dstArray].pitch();
@@ -1606,26 +1748,42 @@ cudaError_t cuda::CudaRuntime::cudaMemcpy3D(const struct cudaMemcpy3DParms *p) {
 	else {
 		src = p->srcPtr;
 	}
+	_unlock();
 
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 
 	report("cudaMemcpy3D() - dstPtr = (" << (void *)dst.ptr << ", " 
 		<< dst.xsize << ", " << dst.ysize << ") - srcPtr = (" 
 		<< (void *)src.ptr << ", " << src.xsize << ", " 
 		<< src.ysize << ")");
 
+	// dense rows and slices are copied as a single span
+	size_t slices = extent.depth;
+	size_t rows = extent.height;
+	size_t span = extent.width;
+	if (extent.width == dst.xsize && extent.width == src.xsize) {
+		span *= rows;
+		rows = 1;
+		if (extent.height == dst.ysize && extent.height == src.ysize) {
+			span *= slices;
+			slices = 1;
+		}
+	}
+
+	hydrazine::Timer timer;
+	timer.start();
+
 	switch(p->kind) {
 		case cudaMemcpyHostToHost:
 		{
-			for (size_t z = 0; z < extent.depth; ++z) {
-				for (size_t y = 0; y < extent.height; ++y) {
+			for (size_t z = 0; z < slices; ++z) {
+				for (size_t y = 0; y < rows; ++y) {
 					void* dstPtr = (char*)dst.ptr + p->dstPos.x + dst.xsize 
 						* ((p->dstPos.y+y) + (z+p->dstPos.z) * dst.ysize);
 					void* srcPtr = (char*)src.ptr + p->srcPos.x + src.xsize 
 						* ((p->srcPos.y+y) + (z+p->srcPos.z) * src.ysize);
 
-					std::memcpy(dstPtr, srcPtr, extent.width);
+					std::memcpy(dstPtr, srcPtr, span);
 				}
 			}
 			result = cudaSuccess;
@@ -1642,21 +1800,21 @@ cudaError_t cuda::CudaRuntime::cudaMemcpy3D(const struct cudaMemcpy3DParms *p) {
 					* extent.height * extent.depth, "cudaMemcpy3D");
 			}
 			
-			for (size_t z = 0; z < extent.depth; ++z) {
-				for (size_t y = 0; y < extent.height; ++y) {
+			for (size_t z = 0; z < slices; ++z) {
+				for (size_t y = 0; y < rows; ++y) {
 					size_t dstPtr = p->dstPos.x + dst.xsize 
 						* ((p->dstPos.y+y) + (z+p->dstPos.z) * dst.ysize);
 					void* srcPtr = (char*)src.ptr + p->srcPos.x + src.xsize 
 						* ((p->srcPos.y+y) + (z+p->srcPos.z) * src.ysize);
 
 					if (!_getDevice().checkMemoryAccess(
-						(char*)destination->pointer() + dstPtr, extent.width)) {
+						(char*)destination->pointer() + dstPtr, span)) {
 						_release();
 						_memoryError((char*)destination->pointer() + dstPtr, 
-							extent.width, "cudaMemcpy3D");
+							span, "cudaMemcpy3D");
 					}
 
-					destination->copy(dstPtr, srcPtr, extent.width);
+					destination->copy(dstPtr, srcPtr, span);
 				}
 			}
 			result = cudaSuccess;
@@ -1673,21 +1831,21 @@ cudaError_t cuda::CudaRuntime::cudaMemcpy3D(const struct cudaMemcpy3DParms *p) {
 					* extent.height * extent.depth, "cudaMemcpy3D");
 			}
 			
-			for (size_t z = 0; z < extent.depth; ++z) {
-				for (size_t y = 0; y < extent.height; ++y) {
+			for (size_t z = 0; z < slices; ++z) {
+				for (size_t y = 0; y < rows; ++y) {
 					void* dstPtr = (char*)dst.ptr + p->dstPos.x + dst.xsize 
 						* ((p->dstPos.y+y) + (z+p->dstPos.z) * dst.ysize);
 					size_t srcPtr = p->srcPos.x + src.xsize 
 						* ((p->srcPos.y+y) + (z+p->srcPos.z) * src.ysize);
 
 					if (!_getDevice().checkMemoryAccess(
-						(char*)source->pointer() + srcPtr, extent.width)) {
+						(char*)source->pointer() + srcPtr, span)) {
 						_release();
 						_memoryError((char*)source->pointer() + srcPtr, 
-							extent.width, "cudaMemcpy3D");
+							span, "cudaMemcpy3D");
 					}
 
-					source->copy(dstPtr, srcPtr, extent.width);
+					source->copy(dstPtr, srcPtr, span);
 				}
 			}
 			result = cudaSuccess;
@@ -1713,28 +1871,28 @@ cudaError_t cuda::CudaRuntime::cudaMemcpy3D(const struct cudaMemcpy3DParms *p) {
 					* extent.height * extent.depth, "cudaMemcpy3D");
 			}
 			
-			for (size_t z = 0; z < extent.depth; ++z) {
-				for (size_t y = 0; y < extent.height; ++y) {
+			for (size_t z = 0; z < slices; ++z) {
+				for (size_t y = 0; y < rows; ++y) {
 					size_t dstPtr = p->dstPos.x + dst.xsize 
 						* ((p->dstPos.y+y) + (z+p->dstPos.z) * dst.ysize);
 					size_t srcPtr = p->srcPos.x + src.xsize 
 						* ((p->srcPos.y+y) + (z+p->srcPos.z) * src.ysize);
 
 					if (!_getDevice().checkMemoryAccess(
-						(char*)source->pointer() + srcPtr, extent.width)) {
+						(char*)source->pointer() + srcPtr, span)) {
 						_release();
 						_memoryError((char*)source->pointer() + srcPtr,
-							extent.width, "cudaMemcpy3D");
+							span, "cudaMemcpy3D");
 					}
 
 					if (!_getDevice().checkMemoryAccess(
-						(char*)destination->pointer() + dstPtr, extent.width)) {
+						(char*)destination->pointer() + dstPtr, span)) {
 						_release();
 						_memoryError((char*)destination->pointer() + dstPtr, 
-							extent.width, "cudaMemcpy3D");
+							span, "cudaMemcpy3D");
 					}
 
-					source->copy(destination, dstPtr, srcPtr, extent.width);
+					source->copy(destination, dstPtr, srcPtr, span);
 				}
 			}
 			result = cudaSuccess;
@@ -1742,6 +1900,12 @@ cudaError_t cuda::CudaRuntime::cudaMemcpy3D(const struct cudaMemcpy3DParms *p) {
 		break;
 	}
 	
+	timer.stop();
+	if (result == cudaSuccess) {
+		_traceTransfer("cudaMemcpy3D", 
+			extent.width * extent.height * extent.depth, timer);
+	}
+	
 	_release();
 	return _setLastError(result);	
 }
@@ -1759,8 +1923,7 @@ cudaError_t cuda::CudaRuntime::cudaMemcpy3DAsync(const struct cudaMemcpy3DParms
 cudaError_t cuda::CudaRuntime::cudaMemset(void *devPtr, int value, size_t count) {
 	cudaError_t result = cudaErrorInvalidDevicePointer;
 	
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 	
 	executive::Device::MemoryAllocation* allocation = 
 		_getDevice().getMemoryAllocation(devPtr);
@@ -1777,7 +1940,11 @@ cudaError_t cuda::CudaRuntime::cudaMemset(void *devPtr, int value, size_t count)
 	
 	size_t offset = (char*)devPtr - (char*)allocation->pointer();
 	
+	hydrazine::Timer timer;
+	timer.start();
 	allocation->memset(offset, value, count);
+	timer.stop();
+	_traceTransfer("cudaMemset", count, timer);
 	result = cudaSuccess;
 	
 	_release();
@@ -1789,8 +1956,7 @@ cudaError_t cuda::CudaRuntime::cudaMemset2D(void *devPtr, size_t pitch,
 	int value, size_t width, size_t height) {
 
 	cudaError_t result = cudaErrorInvalidValue;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 
 	executive::Device::MemoryAllocation* allocation = 
 		_getDevice().getMemoryAllocation(devPtr);
@@ -1802,6 +1968,9 @@ cudaError_t cuda::CudaRuntime::cudaMemset2D(void *devPtr, size_t pitch,
 		
 	size_t offset = (char*)devPtr - (char*)allocation->pointer();
 	
+	hydrazine::Timer timer;
+	timer.start();
+	
 	if (pitch == width) {
 		if (!_getDevice().checkMemoryAccess(devPtr, width * height)) {
 			_release();
@@ -1823,6 +1992,8 @@ cudaError_t cuda::CudaRuntime::cudaMemset2D(void *devPtr, size_t pitch,
 		}
 	}
 
+	timer.stop();
+	_traceTransfer("cudaMemset2D", width * height, timer);
 	result = cudaSuccess;
 	
 	_release();
@@ -1834,8 +2005,7 @@ cudaError_t cuda::CudaRuntime::cudaMemset3D(struct cudaPitchedPtr pitchedDevPtr,
 	int value, struct cudaExtent extent) {
 
 	cudaError_t result = cudaErrorNotYetImplemented;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 
 	assert(0 && "unimplemented");
 	
@@ -1888,7 +2058,7 @@ cudaError_t cuda::CudaRuntime::cudaGetSymbolAddress(void **devPtr,
 	*devPtr = allocation->pointer();
 	report("devPtr: " << *devPtr);	
 	
-	_release();
+	_releaseAll();
 	return _setLastError(result);	
 }
 
@@ -1930,7 +2100,7 @@ cudaError_t cuda::CudaRuntime::cudaGetSymbolSize(size_t *size, const char *symbo
 	*size = allocation->size();
 	report("size: " << *size);	
 	
-	_release();
+	_releaseAll();
 	return _setLastError(result);	
 }
 
@@ -2027,8 +2197,6 @@ cudaError_t cuda::CudaRuntime::cudaChooseDevice(int *device,
 cudaError_t cuda::CudaRuntime::cudaSetDevice(int device) {
 	cudaError_t result = cudaErrorInvalidDevice;
 	
-	_lock();
-
 	if ((int)_deviceCount > device && device >= 0) {
 		HostThreadContext& thread = _getCurrentThread();
 		thread.selectedDevice = device;
@@ -2037,30 +2205,24 @@ cudaError_t cuda::CudaRuntime::cudaSetDevice(int device) {
 		result = cudaSuccess;
 	}
 
-	_unlock();
 	return _setLastError(result);
 }
 
 cudaError_t cuda::CudaRuntime::cudaGetDevice(int *device) {
 	cudaError_t result = cudaSuccess;
 	
-	_lock();
 	HostThreadContext& thread = _getCurrentThread();
 	*device = thread.selectedDevice;
-	_unlock();
-	
 	return _setLastError(result);
 }
 
 cudaError_t cuda::CudaRuntime::cudaSetValidDevices(int *device_arr, int len) {
 	cudaError_t result = cudaSuccess;
-	_lock();
 	HostThreadContext& thread = _getCurrentThread();
 	thread.validDevices.resize(len);
 	for (int i = 0 ; i < len; i++) {
 		thread.validDevices[i] = device_arr[i];
 	}
-	_unlock();
 	return _setLastError(result);
 }
 
@@ -2312,7 +2474,6 @@ cudaError_t cuda::CudaRuntime::cudaGetLastError(void) {
 cudaError_t cuda::CudaRuntime::cudaConfigureCall(dim3 gridDim, dim3 blockDim, 
 	size_t sharedMem, cudaStream_t stream) {
 
-	_lock();
 	report("cudaConfigureCall()");
 	
 	cudaError_t result = cudaErrorInvalidConfiguration;
@@ -2322,8 +2483,6 @@ cudaError_t cuda::CudaRuntime::cudaConfigureCall(dim3 gridDim, dim3 blockDim,
 	thread.launchConfigurations.push_back(launch);
 	result = cudaSuccess;
 	
-	_unlock();
-	
 	return _setLastError(result);
 }
 
@@ -2331,8 +2490,6 @@ cudaError_t cuda::CudaRuntime::cudaSetupArgument(const void *arg, size_t size,
 	size_t offset) {
 	cudaError_t result = cudaSuccess;
 	
-	_lock();
-	
 	HostThreadContext &thread = _getCurrentThread();
 
 	report("cudaSetupArgument() - offset " << offset << ", size " << size);
@@ -2342,8 +2499,6 @@ cudaError_t cuda::CudaRuntime::cudaSetupArgument(const void *arg, size_t size,
 	thread.parameterIndices.push_back(offset);
 	thread.parameterSizes.push_back(size);
 	
-	_unlock();
-	
 	return _setLastError(result);
 }
 
@@ -2375,7 +2530,9 @@ cudaError_t cuda::CudaRuntime::_launchKernel(const std::string& moduleName,
 	ir::Kernel* k = module->second.getKernel(kernelName);
 	assert(k != 0);
 
-	_bind();
+	// the launch itself only needs the device
+	_unlock();
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 
 	HostThreadContext& thread = _getCurrentThread();
 	cudaError_t result = cudaSuccess;
@@ -2471,7 +2628,7 @@ cudaError_t cuda::CudaRuntime::cudaFuncGetAttributes(
 		*attr = _getDevice().getAttributes(kernel->second.module, 
 			kernel->second.kernel);
 		result = cudaSuccess;
-		_release();
+		_releaseAll();
 	}
 	
 	return _setLastError(result);
@@ -2484,8 +2641,7 @@ cudaError_t cuda::CudaRuntime::cudaFuncGetAttributes(
 cudaError_t cuda::CudaRuntime::cudaEventCreate(cudaEvent_t *event) {
 	cudaError_t result = cudaSuccess;
 	
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 	
 	*event = _getDevice().createEvent( 0 );
 	
@@ -2498,8 +2654,7 @@ cudaError_t cuda::CudaRuntime::cudaEventCreateWithFlags(cudaEvent_t *event,
 	int flags) {
 	cudaError_t result = cudaSuccess;
 	
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 	
 	*event = _getDevice().createEvent(flags);
 	
@@ -2512,8 +2667,7 @@ cudaError_t cuda::CudaRuntime::cudaEventRecord(cudaEvent_t event,
 	cudaStream_t stream) {
 	cudaError_t result = cudaErrorInvalidValue;
 	
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 	
 	try {
 		_getDevice().recordEvent(event, stream);
@@ -2531,8 +2685,7 @@ cudaError_t cuda::CudaRuntime::cudaEventRecord(cudaEvent_t event,
 cudaError_t cuda::CudaRuntime::cudaEventQuery(cudaEvent_t event) {
 	cudaError_t result = cudaErrorInvalidValue;
 
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 	
 	try {
 		_getDevice().queryEvent(event);
@@ -2550,8 +2703,7 @@ cudaError_t cuda::CudaRuntime::cudaEventQuery(cudaEvent_t event) {
 cudaError_t cuda::CudaRuntime::cudaEventSynchronize(cudaEvent_t event) {
 	cudaError_t result = cudaErrorInvalidValue;
 	
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 	
 	try {
 		_getDevice().synchronizeEvent(event);
@@ -2569,8 +2721,7 @@ cudaError_t cuda::CudaRuntime::cudaEventSynchronize(cudaEvent_t event) {
 cudaError_t cuda::CudaRuntime::cudaEventDestroy(cudaEvent_t event) {
 	cudaError_t result = cudaErrorInvalidValue;
 	
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 	
 	try {
 		_getDevice().destroyEvent(event);
@@ -2589,8 +2740,7 @@ cudaError_t cuda::CudaRuntime::cudaEventElapsedTime(float *ms,
 	cudaEvent_t start, cudaEvent_t end) {
 	cudaError_t result = cudaErrorInvalidValue;
 	
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 	
 	try {
 		*ms = _getDevice().getEventTime(start, end);
@@ -2613,8 +2763,7 @@ cudaError_t cuda::CudaRuntime::cudaEventElapsedTime(float *ms,
 cudaError_t cuda::CudaRuntime::cudaStreamCreate(cudaStream_t *pStream) {
 	cudaError_t result = cudaErrorInvalidValue;
 	
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 	
 	try {
 		*pStream = _getDevice().createStream();
@@ -2631,8 +2780,7 @@ cudaError_t cuda::CudaRuntime::cudaStreamCreate(cudaStream_t *pStream) {
 cudaError_t cuda::CudaRuntime::cudaStreamDestroy(cudaStream_t stream) {
 	cudaError_t result = cudaErrorInvalidValue;
 	
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 	
 	try {
 		_getDevice().destroyStream(stream);
@@ -2649,8 +2797,7 @@ cudaError_t cuda::CudaRuntime::cudaStreamDestroy(cudaStream_t stream) {
 cudaError_t cuda::CudaRuntime::cudaStreamSynchronize(cudaStream_t stream) {
 	cudaError_t result = cudaErrorInvalidValue;
 
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 	
 	try {
 		_getDevice().synchronizeStream(stream);
@@ -2668,8 +2815,7 @@ cudaError_t cuda::CudaRuntime::cudaStreamSynchronize(cudaStream_t stream) {
 cudaError_t cuda::CudaRuntime::cudaStreamQuery(cudaStream_t stream) {
 	cudaError_t result = cudaErrorInvalidValue;
 
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 	
 	try {
 		_getDevice().queryStream(stream);
@@ -2753,6 +2899,7 @@ cudaError_t cuda::CudaRuntime::cudaThreadExit(void) {
 	cudaError_t result = cudaSuccess;
 	
 	_lock();
+	_lockDevices();
 	
 	report("Destroying " << _devices.size() << " devices");
 	for (DeviceVector::iterator device = _devices.begin(); 
@@ -2763,6 +2910,7 @@ cudaError_t cuda::CudaRuntime::cudaThreadExit(void) {
 	_devices.clear();
 	
 	_devicesLoaded = false;
+	_unlockDevices();
 	_unlock();
 	
 	return _setLastError(result);
@@ -2770,8 +2918,7 @@ cudaError_t cuda::CudaRuntime::cudaThreadExit(void) {
 
 cudaError_t cuda::CudaRuntime::cudaThreadSynchronize(void) {
 	cudaError_t result = cudaSuccess;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 
 	_getDevice().synchronize();
 
@@ -2790,8 +2937,7 @@ cudaError_t cuda::CudaRuntime::cudaGLMapBufferObject(void **devPtr,
 cudaError_t cuda::CudaRuntime::cudaGLMapBufferObjectAsync(void **devPtr, 
 	GLuint bufObj, cudaStream_t stream) {
 	cudaError_t result = cudaSuccess;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquireAll()) return _setLastError(cudaErrorNoDevice);
 
 	report("cudaGLMapBufferObjectAsync(" << bufObj << ", " << stream << ")");
 	GLBufferMap::iterator buffer = _buffers.find(bufObj);
@@ -2802,15 +2948,14 @@ cudaError_t cuda::CudaRuntime::cudaGLMapBufferObjectAsync(void **devPtr,
 			bytes, buffer->second);
 		result = cudaSuccess;
 	}	
-	_release();
+	_releaseAll();
 	
 	return _setLastError(result);
 }
 
 cudaError_t cuda::CudaRuntime::cudaGLRegisterBufferObject(GLuint bufObj) {
 	cudaError_t result = cudaErrorInvalidValue;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquireAll()) return _setLastError(cudaErrorNoDevice);
 
 	report("cudaGLRegisterBufferObject(" << bufObj << ")");	
 
@@ -2820,7 +2965,7 @@ cudaError_t cuda::CudaRuntime::cudaGLRegisterBufferObject(GLuint bufObj) {
 		result = cudaSuccess;
 	}
 	
-	_release();
+	_releaseAll();
 	
 	return _setLastError(result);
 }
@@ -2828,8 +2973,7 @@ cudaError_t cuda::CudaRuntime::cudaGLRegisterBufferObject(GLuint bufObj) {
 cudaError_t cuda::CudaRuntime::cudaGLSetBufferObjectMapFlags(GLuint bufObj, 
 	unsigned int flags) {
 	cudaError_t result = cudaErrorInvalidValue;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquireAll()) return _setLastError(cudaErrorNoDevice);
 
 	report("cudaGLRegisterBufferObjectMapFlags(" << bufObj << ")");	
 
@@ -2839,7 +2983,7 @@ cudaError_t cuda::CudaRuntime::cudaGLSetBufferObjectMapFlags(GLuint bufObj,
 		result = cudaSuccess;
 	}
 	
-	_release();
+	_releaseAll();
 	
 	return _setLastError(result);
 
@@ -2852,8 +2996,7 @@ cudaError_t cuda::CudaRuntime::cudaGLSetGLDevice(int device) {
 
 cudaError_t cuda::CudaRuntime::cudaGLUnmapBufferObject(GLuint bufObj) {
 	cudaError_t result = cudaErrorInvalidValue;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquireAll()) return _setLastError(cudaErrorNoDevice);
 	
 	report("cudaGLUnmapBufferObject(" << bufObj << ")");
 	
@@ -2863,7 +3006,7 @@ cudaError_t cuda::CudaRuntime::cudaGLUnmapBufferObject(GLuint bufObj) {
 		result = cudaSuccess;
 	}
 	
-	_release();
+	_releaseAll();
 	
 	return _setLastError(result);
 }
@@ -2874,8 +3017,7 @@ cudaError_t cuda::CudaRuntime::cudaGLUnmapBufferObjectAsync(GLuint bufObj,
 }
 
 cudaError_t cuda::CudaRuntime::cudaGLUnregisterBufferObject(GLuint bufObj) {
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquireAll()) return _setLastError(cudaErrorNoDevice);
 	
 	cudaError_t result = cudaErrorInvalidValue;
 
@@ -2888,7 +3030,7 @@ cudaError_t cuda::CudaRuntime::cudaGLUnregisterBufferObject(GLuint bufObj) {
 		result = cudaSuccess;
 	}
 	
-	_release();
+	_releaseAll();
 	
 	return _setLastError(result);
 }
@@ -2898,8 +3040,7 @@ cudaError_t cuda::CudaRuntime::cudaGLUnregisterBufferObject(GLuint bufObj) {
 cudaError_t cuda::CudaRuntime::cudaGraphicsGLRegisterBuffer(
 	struct cudaGraphicsResource **resource, GLuint buffer, unsigned int flags) {
 	cudaError_t result = cudaSuccess;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 	
 	report("cudaGraphicsGLRegisterBuffer");
 	
@@ -2915,8 +3056,7 @@ cudaError_t cuda::CudaRuntime::cudaGraphicsGLRegisterImage(
 	struct cudaGraphicsResource **resource, GLuint image, int target, 
 	unsigned int flags) {
 	cudaError_t result = cudaSuccess;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 	
 	report("cudaGraphicsGLRegisterImage");
 	
@@ -2931,8 +3071,7 @@ cudaError_t cuda::CudaRuntime::cudaGraphicsGLRegisterImage(
 cudaError_t cuda::CudaRuntime::cudaGraphicsUnregisterResource(
 	struct cudaGraphicsResource *resource) {
 	cudaError_t result = cudaSuccess;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 	
 	report("cudaGraphicsUnregisterResource");
 	
@@ -2946,8 +3085,7 @@ cudaError_t cuda::CudaRuntime::cudaGraphicsUnregisterResource(
 cudaError_t cuda::CudaRuntime::cudaGraphicsResourceSetMapFlags(
 	struct cudaGraphicsResource *resource, unsigned int flags) {
 	cudaError_t result = cudaSuccess;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 	
 	report("cudaGraphicsResourceSetMapFlags");
 	
@@ -2961,8 +3099,7 @@ cudaError_t cuda::CudaRuntime::cudaGraphicsResourceSetMapFlags(
 cudaError_t cuda::CudaRuntime::cudaGraphicsMapResources(int count, 
 	struct cudaGraphicsResource **resource, cudaStream_t stream) {
 	cudaError_t result = cudaSuccess;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 	
 	report("mapGraphicsResource");
 	
@@ -2976,8 +3113,7 @@ cudaError_t cuda::CudaRuntime::cudaGraphicsMapResources(int count,
 cudaError_t cuda::CudaRuntime::cudaGraphicsUnmapResources(int count, 
 	struct cudaGraphicsResource **resources, cudaStream_t stream) {
 	cudaError_t result = cudaSuccess;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 	
 	report("cudaGraphicsUnmapResources");
 	
@@ -2991,8 +3127,7 @@ cudaError_t cuda::CudaRuntime::cudaGraphicsUnmapResources(int count,
 cudaError_t cuda::CudaRuntime::cudaGraphicsResourceGetMappedPointer(
 	void **devPtr, size_t *size, struct cudaGraphicsResource *resource) {
 	cudaError_t result = cudaSuccess;
-	_acquire();
-	if (_devices.empty()) return _setLastError(cudaErrorNoDevice);
+	if (!_acquire()) return _setLastError(cudaErrorNoDevice);
 	
 	report("cudaGraphicsResourceGetMappedPointer");
 	
@@ -3015,7 +3150,6 @@ cudaError_t cuda::CudaRuntime::cudaGraphicsSubResourceGetMappedArray(
 void cuda::CudaRuntime::addTraceGenerator( trace::TraceGenerator& gen, 
 	bool persistent ) {
 
-	_lock();
 	HostThreadContext& thread = _getCurrentThread();
 	if (persistent) {
 		thread.persistentTraceGenerators.push_back(&gen);
@@ -3023,24 +3157,24 @@ void cuda::CudaRuntime::addTraceGenerator( trace::TraceGenerator& gen,
 	else {
 		thread.nextTraceGenerators.push_back(&gen);
 	}
-	_unlock();
 }
 
 void cuda::CudaRuntime::clearTraceGenerators() {
-	_lock();
 	HostThreadContext& thread = _getCurrentThread();
 	thread.persistentTraceGenerators.clear();
 	thread.nextTraceGenerators.clear();
-	_unlock();
 }
 
 void cuda::CudaRuntime::limitWorkerThreads(unsigned int limit) {
-	_acquire();
+	_lock();
+	_enumerateDevices();
+	_lockDevices();
 	for (DeviceVector::iterator device = _devices.begin(); 
 		device != _devices.end(); ++device) {
 		(*device)->limitWorkerThreads(limit);
 	}
-	_release();
+	_unlockDevices();
+	_unlock();
 }
 
 void cuda::CudaRuntime::registerPTXModule(std::istream& ptx, 
@@ -3074,14 +3208,13 @@ void cuda::CudaRuntime::registerPTXModule(std::istream& ptx,
 }
 
 void cuda::CudaRuntime::clearErrors() {
-	_lock();
 	HostThreadContext& thread = _getCurrentThread();
 	thread.lastError = cudaSuccess;
-	_unlock();
 }
 
 void cuda::CudaRuntime::reset() {
 	_lock();
+	_lockDevices();
 	report("Resetting cuda runtime.");
 	HostThreadContext& thread = _getCurrentThread();
 	thread.clear();
@@ -3126,6 +3259,7 @@ void cuda::CudaRuntime::reset() {
 			++module;
 		}
 	}
+	_unlockDevices();
 	_unlock();
 }
 
@@ -3137,25 +3271,26 @@ ocelot::PointerMap cuda::CudaRuntime::contextSwitch(unsigned int destinationId,
 	
 	ocelot::PointerMap mappings;
 
-	_acquire();
+	_lock();
+	_lockDevices();
 	
 	if(sourceId >= _devices.size())
 	{
-		_release();
+		_unlockDevices();
+		_unlock();
 		Ocelot_Exception("Invalid source device - " << sourceId);
 	}
 	
 	if(destinationId >= _devices.size())
 	{
-		_release();
+		_unlockDevices();
+		_unlock();
 		Ocelot_Exception("Invalid destination device - " << destinationId);
 	}
 	
 	executive::Device& source = *_devices[sourceId];
 	executive::Device& destination = *_devices[destinationId];
 	
-	_unbind();
-	
 	source.select();
 	executive::Device::MemoryAllocationVector sourceAllocations = 
 		source.getAllAllocations();
@@ -3235,6 +3370,7 @@ ocelot::PointerMap cuda::CudaRuntime::contextSwitch(unsigned int destinationId,
 		}
 	}
 		
+	_unlockDevices();
 	_unlock();
 	
 	return mappings;	
@@ -3250,11 +3386,13 @@ void cuda::CudaRuntime::unregisterModule(const std::string& name) {
 	
 	_modules.erase(module);
 	
+	_lockDevices();
 	for (DeviceVector::iterator device = _devices.begin(); 
 		device != _devices.end(); ++device) {
 		(*device)->unload(name);
 	}
 	
+	_unlockDevices();
 	_unlock();
 }
 
@@ -3266,6 +3404,7 @@ void cuda::CudaRuntime::launch(const std::string& moduleName,
 void cuda::CudaRuntime::setOptimizationLevel(
 	translator::Translator::OptimizationLevel l) {
 	_lock();
+	_lockDevices();
 
 	_optimization = l;
 	for (DeviceVector::iterator device = _devices.begin(); 
@@ -3275,6 +3414,7 @@ void cuda::CudaRuntime::setOptimizationLevel(
 		(*device)->unselect();
 	}
 
+	_unlockDevices();
 	_unlock();
 }
 
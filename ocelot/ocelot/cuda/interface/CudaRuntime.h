@@ -12,9 +12,11 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <fstream>
 
 // Boost libs
 #include <boost/thread/thread.hpp>
+#include <boost/thread/tss.hpp>
 
 // Ocelot libs
 #include <ocelot/cuda/interface/CudaRuntimeInterface.h>
@@ -106,6 +108,9 @@ namespace cuda {
 	
 	typedef std::map< boost::thread::id, HostThreadContext > HostThreadContextMap;
 	
+	/*!	\brief One lock per device */
+	typedef std::vector< boost::mutex* > MutexVector;
+	
 	//! references a kernel registered to CUDA runtime
 	class RegisteredKernel {
 	public:
@@ -204,22 +209,43 @@ namespace cuda {
 		/*! \brief Report a memory error and throw an exception */
 		void _memoryError(const void* address, size_t count, 
 			const std::string& function = "");		
-		/*! \brief Create devices if they do not already exist */
+		/*! \brief Record the achieved bandwidth of a memory transfer */
+		void _traceTransfer(const std::string& function, size_t count, 
+			const hydrazine::Timer& timer);
+		/*! \brief Create devices if they do not already exist, the runtime
+			must be locked */
 		void _enumerateDevices();
-		//! \brief acquires mutex and locks the runtime
+		//! \brief acquires mutex and locks the runtime tables
 		void _lock();
 		//! \brief releases mutex
 		void _unlock();
+		//! \brief locks every device, the runtime must be locked
+		void _lockDevices();
+		//! \brief unlocks every device
+		void _unlockDevices();
 		//! \brief sets the last error state for the CudaRuntime object
 		cudaError_t _setLastError(cudaError_t result);
-		//! \brief Bind the current thread to a device context
+		/*! \brief Lock the thread's device and bind the thread to it, the
+			runtime must be locked */
 		HostThreadContext& _bind();
-		//! \brief Unbind the current thread
+		//! \brief Unbind the current thread and unlock its device
 		void _unbind();
-		//! \brief Lock the mutex and bind the the thread
-		void _acquire();
-		/*! \brief Unbind the thread and unlock the mutex */
+		/*! \brief Lock and bind only the thread's device, for calls that do
+			not touch the runtime tables
+			
+			\return false if there is no device, nothing is locked then
+		*/
+		bool _acquire();
+		/*! \brief Unbind the thread and unlock its device */
 		void _release();
+		/*! \brief Lock the runtime tables, then lock and bind the thread's
+			device
+			
+			\return false if there is no device, nothing is locked then
+		*/
+		bool _acquireAll();
+		/*! \brief Unbind the thread, then unlock its device and the tables */
+		void _releaseAll();
 		//! \brief gets the current device for the current thread
 		executive::Device& _getDevice();
 		//! \brief returns an Ocelot-formatted error message
@@ -230,13 +256,32 @@ namespace cuda {
 		void _registerModule(ModuleMap::iterator module);
 		// Load module and register it with all devices
 		void _registerModule(const std::string& name);
+		// Load a registered module onto all devices, the runtime must be locked
+		void _loadModule(ModuleMap::iterator module);
 		// Load all modules and register them with all devices
 		void _registerAllModules();
 
 	private:
-		//! locking object for cuda runtime
+		/*! \brief locking object for the runtime tables (modules, symbols,
+			dimensions, buffers, and the device vector).
+			
+			Lock order is always _mutex before any device lock, a thread
+			holding a device lock must never wait on _mutex.
+		*/
 		boost::mutex _mutex;
 		
+		//! locking objects for each device, indexed like _devices
+		MutexVector _deviceMutexes;
+		
+		//! locking object for the thread context map
+		boost::mutex _threadMutex;
+		
+		//! locking object for the transfer trace
+		boost::mutex _traceMutex;
+		
+		//! cached pointer to the calling thread's context
+		boost::thread_specific_ptr< HostThreadContext > _currentThread;
+		
 		//! Registered modules
 		ModuleMap _modules;
 		
@@ -264,11 +309,12 @@ namespace cuda {
 		//! Device vector
 		DeviceVector _devices;
 		
-		//! Have the devices been loaded?
-		bool _devicesLoaded;
+		/*! \brief Have the devices been loaded?
 		
-		//! Currently selected device
-		int _selectedDevice;
+			Only read or written while holding _mutex, the hacks in
+			cudaGetDeviceProperties and friends can reset it to false.
+		*/
+		bool _devicesLoaded;
 		
 		//! the next symbol for dynamically registered kernels
 		int _nextSymbol;
@@ -281,6 +327,9 @@ namespace cuda {
 		
 		//! optimization level
 		translator::Translator::OptimizationLevel _optimization;
+		
+		//! trace of memory transfer bandwidth, if enabled
+		std::ofstream _transferTrace;
 	
 	private:
 		cudaError_t _launchKernel(const std::string& module, 
@@ -0,0 +1,438 @@
+/*! \file BulkTransfer.cpp
+	\author agent
+	\date October 18, 2026
+	\brief The source file for the BulkTransfer class.
+*/
+
+#ifndef BULK_TRANSFER_CPP_INCLUDED
+#define BULK_TRANSFER_CPP_INCLUDED
+
+// ocelot includes
+#include <ocelot/executive/interface/BulkTransfer.h>
+#include <ocelot/api/interface/OcelotConfiguration.h>
+
+// hydrazine includes
+#include <hydrazine/implementation/debug.h>
+#include <hydrazine/implementation/Timer.h>
+#include <hydrazine/interface/WindowsCompatibility.h>
+
+// boost includes
+#include <boost/thread.hpp>
+#include <boost/function.hpp>
+#include <boost/bind.hpp>
+
+// Standard library includes
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <deque>
+
+// Linux includes
+#include <unistd.h>
+
+// SSE includes
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#ifdef REPORT_BASE
+#undef REPORT_BASE
+#endif
+
+// Turn on report messages
+#define REPORT_BASE 0
+
+// Transfers smaller than this are always done by the calling thread
+#define PARALLEL_THRESHOLD (1 << 22)
+
+// Each thread should move at least this many bytes
+#define MINIMUM_CHUNK (1 << 20)
+
+// Assume this cache size if the OS can not tell us
+#define DEFAULT_CACHE_SIZE (1 << 23)
+
+// Chunks are split on cache line boundaries
+#define LINE_SIZE 64
+
+namespace executive
+{
+	static void streamCopy(char* destination, const char* source,
+		size_t bytes)
+	{
+		#ifdef __SSE2__
+		size_t head = (16 - ((size_t)destination & 15)) & 15;
+		head = std::min(head, bytes);
+		std::memcpy(destination, source, head);
+
+		destination += head;
+		source      += head;
+		bytes       -= head;
+
+		size_t body = bytes & ~(size_t)(LINE_SIZE - 1);
+
+		for(size_t i = 0; i < body; i += LINE_SIZE)
+		{
+			__m128i a = _mm_loadu_si128((const __m128i*)(source + i));
+			__m128i b = _mm_loadu_si128((const __m128i*)(source + i + 16));
+			__m128i c = _mm_loadu_si128((const __m128i*)(source + i + 32));
+			__m128i d = _mm_loadu_si128((const __m128i*)(source + i + 48));
+			_mm_stream_si128((__m128i*)(destination + i),      a);
+			_mm_stream_si128((__m128i*)(destination + i + 16), b);
+			_mm_stream_si128((__m128i*)(destination + i + 32), c);
+			_mm_stream_si128((__m128i*)(destination + i + 48), d);
+		}
+
+		std::memcpy(destination + body, source + body, bytes - body);
+		_mm_sfence();
+		#else
+		std::memcpy(destination, source, bytes);
+		#endif
+	}
+
+	static void streamSet(char* destination, int value, size_t bytes)
+	{
+		#ifdef __SSE2__
+		size_t head = (16 - ((size_t)destination & 15)) & 15;
+		head = std::min(head, bytes);
+		std::memset(destination, value, head);
+
+		destination += head;
+		bytes       -= head;
+
+		size_t body = bytes & ~(size_t)(LINE_SIZE - 1);
+		__m128i v = _mm_set1_epi8((char)value);
+
+		for(size_t i = 0; i < body; i += LINE_SIZE)
+		{
+			_mm_stream_si128((__m128i*)(destination + i),      v);
+			_mm_stream_si128((__m128i*)(destination + i + 16), v);
+			_mm_stream_si128((__m128i*)(destination + i + 32), v);
+			_mm_stream_si128((__m128i*)(destination + i + 48), v);
+		}
+
+		std::memset(destination + body, value, bytes - body);
+		_mm_sfence();
+		#else
+		std::memset(destination, value, bytes);
+		#endif
+	}
+
+	/*! \brief Copies one chunk of a parallel transfer */
+	class CopyChunk
+	{
+		public:
+			char* destination;
+			const char* source;
+			size_t bytes;
+			bool nonTemporal;
+
+		public:
+			CopyChunk slice(size_t offset, size_t size) const
+			{
+				CopyChunk chunk = *this;
+				chunk.destination += offset;
+				chunk.source      += offset;
+				chunk.bytes        = size;
+				return chunk;
+			}
+			
+			void operator()()
+			{
+				if(nonTemporal) streamCopy(destination, source, bytes);
+				else std::memcpy(destination, source, bytes);
+			}
+	};
+
+	/*! \brief Sets one chunk of a parallel transfer */
+	class SetChunk
+	{
+		public:
+			char* destination;
+			int value;
+			size_t bytes;
+			bool nonTemporal;
+
+		public:
+			SetChunk slice(size_t offset, size_t size) const
+			{
+				SetChunk chunk = *this;
+				chunk.destination += offset;
+				chunk.bytes        = size;
+				return chunk;
+			}
+			
+			void operator()()
+			{
+				if(nonTemporal) streamSet(destination, value, bytes);
+				else std::memset(destination, value, bytes);
+			}
+	};
+
+	/*! \brief Threads that run the chunks of parallel transfers.
+
+		The threads are started the first time that a transfer needs them
+		and stay parked on a condition variable between transfers, so a
+		transfer only pays for waking them.  Several host threads may
+		transfer at the same time, each waits only for its own chunks.
+	*/
+	class TransferPool
+	{
+		public:
+			typedef boost::function<void ()> Task;
+
+		private:
+			/*! \brief The chunks of one transfer still running */
+			class Batch
+			{
+				public:
+					unsigned int remaining;
+					boost::condition_variable finished;
+			};
+
+			/*! \brief A chunk waiting for a thread */
+			class Job
+			{
+				public:
+					Task task;
+					Batch* batch;
+			};
+
+			typedef std::deque<Job> JobQueue;
+
+		private:
+			boost::mutex _mutex;
+			boost::condition_variable _ready;
+			boost::thread_group _threads;
+			unsigned int _threadCount;
+			JobQueue _jobs;
+			bool _exit;
+
+		private:
+			void _work()
+			{
+				boost::mutex::scoped_lock lock(_mutex);
+
+				while(true)
+				{
+					while(_jobs.empty() && !_exit) _ready.wait(lock);
+					if(_jobs.empty()) return;
+
+					Job job = _jobs.front();
+					_jobs.pop_front();
+
+					lock.unlock();
+					job.task();
+					lock.lock();
+
+					if(--job.batch->remaining == 0)
+					{
+						job.batch->finished.notify_one();
+					}
+				}
+			}
+
+		public:
+			TransferPool() : _threadCount(0), _exit(false)
+			{
+
+			}
+
+			~TransferPool()
+			{
+				{
+					boost::mutex::scoped_lock lock(_mutex);
+					_exit = true;
+				}
+				_ready.notify_all();
+				_threads.join_all();
+			}
+
+		public:
+			/*! \brief Run the first task on the calling thread and the rest
+				on the pool, return once all of them are done */
+			void run(const std::vector<Task>& tasks)
+			{
+				if(tasks.empty()) return;
+
+				Batch batch;
+				batch.remaining = tasks.size() - 1;
+
+				{
+					boost::mutex::scoped_lock lock(_mutex);
+
+					while(_threadCount < tasks.size() - 1)
+					{
+						report("Starting bulk transfer thread "
+							<< _threadCount);
+						_threads.create_thread(
+							boost::bind(&TransferPool::_work, this));
+						++_threadCount;
+					}
+
+					for(unsigned int i = 1; i < tasks.size(); ++i)
+					{
+						Job job;
+						job.task = tasks[i];
+						job.batch = &batch;
+						_jobs.push_back(job);
+					}
+				}
+
+				_ready.notify_all();
+
+				tasks.front()();
+
+				boost::mutex::scoped_lock lock(_mutex);
+				while(batch.remaining != 0) batch.finished.wait(lock);
+			}
+	};
+
+	static TransferPool& pool()
+	{
+		static TransferPool transferPool;
+		return transferPool;
+	}
+
+	/*! \brief Run the first chunk on the calling thread, the rest on
+		the transfer pool */
+	template<typename Chunk>
+	static void split(const Chunk& chunk, unsigned int threads)
+	{
+		size_t total = chunk.bytes;
+		size_t step  = (total / threads + LINE_SIZE - 1)
+			& ~(size_t)(LINE_SIZE - 1);
+
+		std::vector<TransferPool::Task> tasks;
+
+		for(size_t offset = 0; offset < total; offset += step)
+		{
+			tasks.push_back(chunk.slice(offset,
+				std::min(step, total - offset)));
+		}
+
+		pool().run(tasks);
+	}
+
+	BulkTransfer::Statistics::Statistics() : bytes(0), seconds(0.0),
+		threads(1), nonTemporal(false)
+	{
+
+	}
+
+	double BulkTransfer::Statistics::bandwidth() const
+	{
+		if(seconds <= 0.0) return 0.0;
+		return (bytes / seconds) / 1.0e9;
+	}
+
+	BulkTransfer::Statistics BulkTransfer::copy(void* destination,
+		const void* source, size_t bytes)
+	{
+		Statistics statistics;
+		statistics.bytes = bytes;
+		statistics.threads = threads(bytes);
+		statistics.nonTemporal = bytes > cacheSize();
+
+		hydrazine::Timer timer;
+		timer.start();
+
+		if(statistics.threads == 1 && !statistics.nonTemporal)
+		{
+			std::memcpy(destination, source, bytes);
+		}
+		else
+		{
+			CopyChunk chunk;
+			chunk.destination = (char*)destination;
+			chunk.source      = (const char*)source;
+			chunk.bytes       = bytes;
+			chunk.nonTemporal = statistics.nonTemporal;
+
+			if(statistics.threads == 1) chunk();
+			else split(chunk, statistics.threads);
+		}
+
+		timer.stop();
+		statistics.seconds = timer.seconds();
+
+		report("Copied " << bytes << " bytes with " << statistics.threads
+			<< " threads" << (statistics.nonTemporal ? " (non-temporal)" : "")
+			<< " at " << statistics.bandwidth() << " GB/s");
+
+		return statistics;
+	}
+
+	BulkTransfer::Statistics BulkTransfer::memset(void* destination,
+		int value, size_t bytes)
+	{
+		Statistics statistics;
+		statistics.bytes = bytes;
+		statistics.threads = threads(bytes);
+		statistics.nonTemporal = bytes > cacheSize();
+
+		hydrazine::Timer timer;
+		timer.start();
+
+		if(statistics.threads == 1 && !statistics.nonTemporal)
+		{
+			std::memset(destination, value, bytes);
+		}
+		else
+		{
+			SetChunk chunk;
+			chunk.destination = (char*)destination;
+			chunk.value       = value;
+			chunk.bytes       = bytes;
+			chunk.nonTemporal = statistics.nonTemporal;
+
+			if(statistics.threads == 1) chunk();
+			else split(chunk, statistics.threads);
+		}
+
+		timer.stop();
+		statistics.seconds = timer.seconds();
+
+		report("Set " << bytes << " bytes with " << statistics.threads
+			<< " threads" << (statistics.nonTemporal ? " (non-temporal)" : "")
+			<< " at " << statistics.bandwidth() << " GB/s");
+
+		return statistics;
+	}
+
+	size_t BulkTransfer::cacheSize()
+	{
+		static size_t size = 0;
+
+		if(size == 0)
+		{
+			long bytes = -1;
+			#ifdef _SC_LEVEL3_CACHE_SIZE
+			bytes = sysconf(_SC_LEVEL3_CACHE_SIZE);
+			#endif
+			#ifdef _SC_LEVEL2_CACHE_SIZE
+			if(bytes <= 0) bytes = sysconf(_SC_LEVEL2_CACHE_SIZE);
+			#endif
+			size = bytes > 0 ? bytes : DEFAULT_CACHE_SIZE;
+
+			report("Last level cache size is " << size << " bytes");
+		}
+
+		return size;
+	}
+
+	unsigned int BulkTransfer::threads(size_t bytes)
+	{
+		if(bytes < PARALLEL_THRESHOLD) return 1;
+
+		size_t threads = hydrazine::getHardwareThreadCount();
+		int limit = api::OcelotConfiguration::get().executive.workerThreadLimit;
+
+		if(limit > 0) threads = std::min(threads, (size_t)limit);
+		threads = std::min(threads, bytes / MINIMUM_CHUNK);
+
+		return std::max(threads, (size_t)1);
+	}
+}
+
+#endif
+
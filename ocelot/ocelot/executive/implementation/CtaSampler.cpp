@@ -0,0 +1,658 @@
+/*! \file CtaSampler.cpp
+	\author agent
+	\date October 18, 2026
+	\brief The source file for the CtaSampler class.
+*/
+
+#ifndef CTA_SAMPLER_CPP_INCLUDED
+#define CTA_SAMPLER_CPP_INCLUDED
+
+// ocelot includes
+#include <ocelot/executive/interface/CtaSampler.h>
+#include <ocelot/trace/interface/TraceEvent.h>
+#include <ocelot/api/interface/OcelotConfiguration.h>
+
+// hydrazine includes
+#include <hydrazine/implementation/debug.h>
+
+// Standard library includes
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <set>
+#include <cmath>
+
+#ifdef REPORT_BASE
+#undef REPORT_BASE
+#endif
+
+// Turn on report messages
+#define REPORT_BASE 0
+
+// Clustering profiles this many CTAs for each sampled CTA
+#define CLUSTER_PROFILE_FACTOR 4
+
+// Rounds of k-means over the profiled CTAs
+#define CLUSTER_ITERATIONS 16
+
+// The normal quantile of the 95% confidence bound
+#define CONFIDENCE_Z 1.96
+
+namespace executive
+{
+	/*! \brief The counters kept for each CTA */
+	enum Metric
+	{
+		Instructions,
+		ThreadInstructions,
+		MemoryInstructions,
+		MemoryAccesses,
+		Branches,
+		DivergentBranches,
+		Metrics
+	};
+
+	static const char* metricNames[] = { "instructions",
+		"threadInstructions", "memoryInstructions", "memoryAccesses",
+		"branches", "divergentBranches" };
+
+	typedef std::vector<double> Point;
+	typedef std::vector<Point> PointVector;
+
+	static double distance(const Point& a, const Point& b)
+	{
+		double sum = 0.0;
+		for(unsigned int i = 0; i < a.size(); ++i)
+		{
+			sum += (a[i] - b[i]) * (a[i] - b[i]);
+		}
+		return sum;
+	}
+
+	static unsigned int nearest(const Point& point,
+		const PointVector& centers)
+	{
+		unsigned int best = 0;
+		double bestDistance = std::numeric_limits<double>::max();
+
+		for(unsigned int c = 0; c < centers.size(); ++c)
+		{
+			double d = distance(point, centers[c]);
+			if(d < bestDistance)
+			{
+				bestDistance = d;
+				best = c;
+			}
+		}
+
+		return best;
+	}
+
+	static void strided(CtaSampler::IdVector& ids, unsigned int ctas,
+		unsigned int samples)
+	{
+		ids.clear();
+		for(long long unsigned int i = 0; i < samples; ++i)
+		{
+			// the middle of each stride
+			ids.push_back(((2 * i + 1) * ctas) / (2 * samples));
+		}
+	}
+
+	CtaSampler::Estimate::Estimate() : total(0.0), error(0.0)
+	{
+
+	}
+
+	CtaSampler::Counter::Counter(CtaSampler& s) : _sampler(s)
+	{
+
+	}
+
+	void CtaSampler::Counter::event(const trace::TraceEvent& event)
+	{
+		_sampler._count(event);
+	}
+
+	void CtaSampler::Counter::postEvent(const trace::TraceEvent& event)
+	{
+		_sampler._post(event);
+	}
+
+	CtaSampler::Mode CtaSampler::configuredMode()
+	{
+		const std::string& mode =
+			api::OcelotConfiguration::get().executive.ctaSampling;
+
+		if(mode == "random") return RandomSampling;
+		if(mode == "strided") return StridedSampling;
+		if(mode == "clustered") return ClusteredSampling;
+
+		if(!mode.empty() && mode != "none")
+		{
+			std::cerr << "==Ocelot== WARNING: Unknown CTA sampling mode "
+				<< mode << ", running every CTA.\n";
+		}
+
+		return NoSampling;
+	}
+
+	std::string CtaSampler::toString(Mode mode)
+	{
+		switch(mode)
+		{
+			case RandomSampling: return "random";
+			case StridedSampling: return "strided";
+			case ClusteredSampling: return "clustered";
+			default: break;
+		}
+		return "none";
+	}
+
+	CtaSampler::CtaSampler(unsigned int ctas, Mode mode) : _ctas(ctas),
+		_mode(mode), _profiling(false)
+	{
+		const api::OcelotConfiguration::Executive& configuration =
+			api::OcelotConfiguration::get().executive;
+
+		_seed = configuration.ctaSamplingSeed;
+
+		unsigned int samples = std::min(_ctas,
+			(unsigned int)std::max(configuration.ctaSamples, 1));
+
+		if(_mode == NoSampling) samples = _ctas;
+
+		if(_mode == RandomSampling)
+		{
+			// Floyd's algorithm picks distinct CTAs without a table
+			std::mt19937 generator(_seed);
+			std::set<unsigned int> picked;
+
+			for(unsigned int j = _ctas - samples; j < _ctas; ++j)
+			{
+				std::uniform_int_distribution<unsigned int>
+					distribution(0, j);
+				unsigned int t = distribution(generator);
+				if(!picked.insert(t).second) picked.insert(j);
+			}
+
+			_sampled.assign(picked.begin(), picked.end());
+		}
+		else if(_mode == ClusteredSampling)
+		{
+			unsigned int profiled = std::min(_ctas,
+				samples * CLUSTER_PROFILE_FACTOR);
+			strided(_profiled, _ctas, profiled);
+			_profiling = true;
+		}
+		else
+		{
+			strided(_sampled, _ctas, samples);
+		}
+
+		if(!_sampled.empty())
+		{
+			_weights.assign(_sampled.size(),
+				(double)_ctas / _sampled.size());
+		}
+
+		report("Sampling " << (_profiling ? _profiled.size() :
+			_sampled.size()) << " of " << _ctas << " CTAs ("
+			<< toString(_mode) << ").");
+	}
+
+	const CtaSampler::IdVector& CtaSampler::profiled() const
+	{
+		return _profiled;
+	}
+
+	void CtaSampler::cluster()
+	{
+		_profiling = false;
+		if(_profiled.empty()) return;
+
+		const api::OcelotConfiguration::Executive& configuration =
+			api::OcelotConfiguration::get().executive;
+
+		unsigned int clusters = std::min((unsigned int)_profiled.size(),
+			(unsigned int)std::max(configuration.ctaSamples, 1));
+
+		// the PC histograms become dense points that sum to one
+		typedef std::map<ir::PTXU64, unsigned int> IndexMap;
+
+		IndexMap dimensions;
+		for(CtaMap::const_iterator cta = _profile.begin();
+			cta != _profile.end(); ++cta)
+		{
+			for(FeatureMap::const_iterator feature = cta->second.features.begin();
+				feature != cta->second.features.end(); ++feature)
+			{
+				dimensions.insert(std::make_pair(feature->first,
+					dimensions.size()));
+			}
+		}
+
+		PointVector points(_profiled.size(), Point(dimensions.size(), 0.0));
+
+		for(unsigned int i = 0; i < _profiled.size(); ++i)
+		{
+			const FeatureMap& features = _profile[_profiled[i]].features;
+
+			double sum = 0.0;
+			for(FeatureMap::const_iterator feature = features.begin();
+				feature != features.end(); ++feature)
+			{
+				sum += feature->second;
+			}
+
+			if(sum == 0.0) continue;
+
+			for(FeatureMap::const_iterator feature = features.begin();
+				feature != features.end(); ++feature)
+			{
+				points[i][dimensions[feature->first]] = feature->second / sum;
+			}
+		}
+
+		// k-means++ seeding, then a fixed number of rounds
+		std::mt19937 generator(_seed);
+		PointVector centers;
+
+		std::uniform_int_distribution<unsigned int>
+			first(0, points.size() - 1);
+		centers.push_back(points[first(generator)]);
+
+		while(centers.size() < clusters)
+		{
+			std::vector<double> distances(points.size());
+			double total = 0.0;
+
+			for(unsigned int i = 0; i < points.size(); ++i)
+			{
+				distances[i] = distance(points[i],
+					centers[nearest(points[i], centers)]);
+				total += distances[i];
+			}
+
+			// every remaining CTA is a copy of a center
+			if(total == 0.0) break;
+
+			std::uniform_real_distribution<double> pick(0.0, total);
+			double target = pick(generator);
+
+			unsigned int chosen = 0;
+			for(; chosen + 1 < points.size(); ++chosen)
+			{
+				target -= distances[chosen];
+				if(target <= 0.0) break;
+			}
+
+			centers.push_back(points[chosen]);
+		}
+
+		_clusters.assign(points.size(), 0);
+
+		for(unsigned int iteration = 0; iteration < CLUSTER_ITERATIONS;
+			++iteration)
+		{
+			for(unsigned int i = 0; i < points.size(); ++i)
+			{
+				_clusters[i] = nearest(points[i], centers);
+			}
+
+			PointVector sums(centers.size(), Point(dimensions.size(), 0.0));
+			std::vector<unsigned int> sizes(centers.size(), 0);
+
+			for(unsigned int i = 0; i < points.size(); ++i)
+			{
+				Point& sum = sums[_clusters[i]];
+				for(unsigned int d = 0; d < sum.size(); ++d)
+				{
+					sum[d] += points[i][d];
+				}
+				++sizes[_clusters[i]];
+			}
+
+			for(unsigned int c = 0; c < centers.size(); ++c)
+			{
+				if(sizes[c] == 0) continue;
+				for(unsigned int d = 0; d < sums[c].size(); ++d)
+				{
+					centers[c][d] = sums[c][d] / sizes[c];
+				}
+			}
+		}
+
+		for(unsigned int i = 0; i < points.size(); ++i)
+		{
+			_clusters[i] = nearest(points[i], centers);
+		}
+
+		// trace the CTA closest to each center for its whole cluster
+		typedef std::map<unsigned int, double> WeightMap;
+		WeightMap representatives;
+
+		for(unsigned int c = 0; c < centers.size(); ++c)
+		{
+			unsigned int closest = points.size();
+			unsigned int size = 0;
+			double closestDistance = std::numeric_limits<double>::max();
+
+			for(unsigned int i = 0; i < points.size(); ++i)
+			{
+				if(_clusters[i] != c) continue;
+				++size;
+
+				double d = distance(points[i], centers[c]);
+				if(d < closestDistance)
+				{
+					closestDistance = d;
+					closest = i;
+				}
+			}
+
+			if(size == 0) continue;
+
+			representatives[_profiled[closest]] =
+				(double)_ctas * size / _profiled.size();
+		}
+
+		_sampled.clear();
+		_weights.clear();
+
+		for(WeightMap::const_iterator representative =
+			representatives.begin(); representative != representatives.end();
+			++representative)
+		{
+			_sampled.push_back(representative->first);
+			_weights.push_back(representative->second);
+		}
+
+		// only the representatives are replayed
+		for(CtaMap::iterator cta = _profile.begin(); cta != _profile.end();
+			++cta)
+		{
+			if(representatives.count(cta->first) != 0) continue;
+			EventVector().swap(cta->second.events);
+		}
+
+		report("Clustered " << _profiled.size() << " profiled CTAs into "
+			<< _sampled.size() << " groups.");
+	}
+
+	const CtaSampler::IdVector& CtaSampler::sampled() const
+	{
+		return _sampled;
+	}
+
+	double CtaSampler::weight(unsigned int cta) const
+	{
+		IdVector::const_iterator position = std::lower_bound(
+			_sampled.begin(), _sampled.end(), cta);
+
+		if(position == _sampled.end() || *position != cta) return 0.0;
+
+		return _weights[std::distance(_sampled.begin(), position)];
+	}
+
+	double CtaSampler::scale() const
+	{
+		// clustering runs the profiled CTAs and replays the representatives
+		const IdVector& ran = _mode == ClusteredSampling ? _profiled : _sampled;
+		if(ran.empty()) return 0.0;
+
+		return (double)_ctas / ran.size();
+	}
+
+	void CtaSampler::replay(unsigned int id,
+		const trace::TraceGeneratorVector& generators) const
+	{
+		CtaMap::const_iterator cta = _profile.find(id);
+		if(cta == _profile.end()) return;
+
+		for(EventVector::const_iterator recorded = cta->second.events.begin();
+			recorded != cta->second.events.end(); ++recorded)
+		{
+			for(trace::TraceGeneratorVector::const_iterator generator =
+				generators.begin(); generator != generators.end(); ++generator)
+			{
+				if(recorded->post) (*generator)->postEvent(recorded->event);
+				else (*generator)->event(recorded->event);
+			}
+		}
+	}
+
+	unsigned int CtaSampler::ctas() const
+	{
+		return _ctas;
+	}
+
+	CtaSampler::Mode CtaSampler::mode() const
+	{
+		return _mode;
+	}
+
+	CtaSampler::EstimateMap CtaSampler::estimates() const
+	{
+		EstimateMap estimates;
+
+		if(_traced.empty() && _profile.empty()) return estimates;
+
+		const double infinity = std::numeric_limits<double>::infinity();
+		double N = _ctas;
+
+		for(unsigned int m = 0; m < Metrics; ++m)
+		{
+			Estimate& estimate = estimates[metricNames[m]];
+
+			// CTAs that ran no instructions are never seen by the counter
+			std::vector<double> values(_sampled.size(), 0.0);
+			for(unsigned int i = 0; i < _sampled.size(); ++i)
+			{
+				CtaMap::const_iterator cta = _traced.find(_sampled[i]);
+				if(cta != _traced.end())
+				{
+					values[i] = cta->second.metrics[m];
+					continue;
+				}
+
+				cta = _profile.find(_sampled[i]);
+				if(cta != _profile.end()) values[i] = cta->second.metrics[m];
+			}
+
+			if(_mode != ClusteredSampling)
+			{
+				double n = values.size();
+				double mean = 0.0;
+				for(unsigned int i = 0; i < values.size(); ++i)
+				{
+					mean += values[i];
+				}
+				mean /= n;
+
+				double variance = 0.0;
+				for(unsigned int i = 0; i < values.size(); ++i)
+				{
+					variance += (values[i] - mean) * (values[i] - mean);
+				}
+
+				estimate.total = N * mean;
+
+				if(n == N) estimate.error = 0.0;
+				else if(n < 2) estimate.error = infinity;
+				else
+				{
+					variance /= n - 1;
+					estimate.error = CONFIDENCE_Z * N
+						* std::sqrt(variance / n * (1.0 - n / N));
+				}
+
+				continue;
+			}
+
+			// stratified by cluster, with the spread of each cluster and of
+			//  the whole grid taken from the profile
+			std::vector<double> profile(_profiled.size(), 0.0);
+			for(unsigned int i = 0; i < _profiled.size(); ++i)
+			{
+				CtaMap::const_iterator cta = _profile.find(_profiled[i]);
+				if(cta != _profile.end()) profile[i] = cta->second.metrics[m];
+			}
+
+			double variance = 0.0;
+
+			for(unsigned int i = 0; i < _sampled.size(); ++i)
+			{
+				estimate.total += _weights[i] * values[i];
+
+				IdVector::const_iterator representative = std::find(
+					_profiled.begin(), _profiled.end(), _sampled[i]);
+				unsigned int cluster = _clusters[std::distance(
+					_profiled.begin(), representative)];
+
+				double mean = 0.0;
+				double size = 0.0;
+				for(unsigned int j = 0; j < profile.size(); ++j)
+				{
+					if(_clusters[j] != cluster) continue;
+					mean += profile[j];
+					size += 1.0;
+				}
+				mean /= size;
+
+				if(size < 2.0) continue;
+
+				double spread = 0.0;
+				for(unsigned int j = 0; j < profile.size(); ++j)
+				{
+					if(_clusters[j] != cluster) continue;
+					spread += (profile[j] - mean) * (profile[j] - mean);
+				}
+
+				variance += _weights[i] * _weights[i] * spread / (size - 1.0);
+			}
+
+			double P = profile.size();
+
+			if(P < N)
+			{
+				if(P < 2)
+				{
+					estimate.error = infinity;
+					continue;
+				}
+
+				double mean = 0.0;
+				for(unsigned int j = 0; j < profile.size(); ++j)
+				{
+					mean += profile[j];
+				}
+				mean /= P;
+
+				double spread = 0.0;
+				for(unsigned int j = 0; j < profile.size(); ++j)
+				{
+					spread += (profile[j] - mean) * (profile[j] - mean);
+				}
+
+				variance += N * N * spread / (P - 1.0) / P * (1.0 - P / N);
+			}
+
+			estimate.error = CONFIDENCE_Z * std::sqrt(variance);
+		}
+
+		return estimates;
+	}
+
+	void CtaSampler::write(std::ostream& out, const std::string& kernel) const
+	{
+		out << kernel << " " << toString(_mode) << " " << _ctas << " "
+			<< _sampled.size();
+
+		EstimateMap estimates = this->estimates();
+
+		for(EstimateMap::const_iterator estimate = estimates.begin();
+			estimate != estimates.end(); ++estimate)
+		{
+			out << " " << estimate->first << " " << estimate->second.total
+				<< " " << estimate->second.error;
+		}
+
+		out << "\n";
+	}
+
+	void CtaSampler::save(const std::string& kernel) const
+	{
+		const std::string& path =
+			api::OcelotConfiguration::get().executive.ctaSamplingReport;
+		if(path.empty()) return;
+
+		std::ofstream file(path.c_str(), std::ios::app);
+
+		if(!file.is_open())
+		{
+			std::cerr << "==Ocelot== WARNING: Failed to write CTA sampling "
+				<< "report " << path << "\n";
+			return;
+		}
+
+		write(file, kernel);
+	}
+
+	void CtaSampler::_count(const trace::TraceEvent& event)
+	{
+		unsigned int id = event.blockId.x + event.blockId.y * event.gridDim.x;
+
+		Cta& cta = _profiling ? _profile[id] : _traced[id];
+		if(cta.metrics.empty()) cta.metrics.assign(Metrics, 0.0);
+
+		cta.metrics[Instructions] += 1.0;
+		cta.metrics[ThreadInstructions] += event.active.count();
+
+		if(!event.memory_addresses.empty())
+		{
+			cta.metrics[MemoryInstructions] += 1.0;
+			cta.metrics[MemoryAccesses] += event.memory_addresses.size();
+		}
+
+		if(event.instruction != 0
+			&& event.instruction->opcode == ir::PTXInstruction::Bra)
+		{
+			cta.metrics[Branches] += 1.0;
+			if(event.taken.any() && event.fallthrough.any())
+			{
+				cta.metrics[DivergentBranches] += 1.0;
+			}
+		}
+
+		if(!_profiling) return;
+
+		cta.features[event.PC] += 1.0;
+
+		RecordedEvent recorded;
+		recorded.post = false;
+		recorded.event = event;
+		cta.events.push_back(recorded);
+	}
+
+	void CtaSampler::_post(const trace::TraceEvent& event)
+	{
+		if(!_profiling) return;
+
+		unsigned int id = event.blockId.x + event.blockId.y * event.gridDim.x;
+
+		// a committed event follows the event that it commits
+		CtaMap::iterator cta = _profile.find(id);
+		if(cta == _profile.end()) return;
+
+		RecordedEvent recorded;
+		recorded.post = true;
+		recorded.event = event;
+		cta->second.events.push_back(recorded);
+	}
+}
+
+#endif
+
@@ -9,6 +9,8 @@
 #include <ocelot/executive/interface/ATIGPUDevice.h>
 #include <ocelot/executive/interface/EmulatorDevice.h>
 #include <ocelot/executive/interface/MulticoreCPUDevice.h>
+#include <ocelot/executive/interface/HybridDevice.h>
+#include <ocelot/api/interface/OcelotConfiguration.h>
 
 #include <hydrazine/implementation/debug.h>
 
@@ -72,7 +74,12 @@ executive::DeviceVector executive::Device::createDevices(
 		{
 			DeviceVector cpus;
 			#ifdef HAVE_LLVM
-			cpus.push_back(new MulticoreCPUDevice(flags));
+			if(api::OcelotConfiguration::get().executive.hybridExecution) {
+				cpus.push_back(new HybridDevice(flags));
+			}
+			else {
+				cpus.push_back(new MulticoreCPUDevice(flags));
+			}
 			#endif
 			return cpus;
 		}
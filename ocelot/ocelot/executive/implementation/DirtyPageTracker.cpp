@@ -0,0 +1,590 @@
+/*! \file DirtyPageTracker.cpp
+	\author agent
+	\date October 18, 2026
+	\brief The source file for the DirtyPageTracker class.
+*/
+
+#ifndef DIRTY_PAGE_TRACKER_CPP_INCLUDED
+#define DIRTY_PAGE_TRACKER_CPP_INCLUDED
+
+// ocelot includes
+#include <ocelot/executive/interface/DirtyPageTracker.h>
+#include <ocelot/executive/interface/BulkTransfer.h>
+#include <ocelot/api/interface/OcelotConfiguration.h>
+
+// hydrazine includes
+#include <hydrazine/implementation/debug.h>
+
+// boost includes
+#include <boost/thread/mutex.hpp>
+
+// Standard library includes
+#include <list>
+#include <map>
+#include <cstring>
+#include <cassert>
+#include <vector>
+#include <algorithm>
+
+// Linux includes
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#ifdef REPORT_BASE
+#undef REPORT_BASE
+#endif
+
+// Turn on report messages
+#define REPORT_BASE 0
+
+// Copies smaller than this are never tracked
+#define MINIMUM_TRACKED_BYTES (1 << 16)
+
+// Slots in the page table, at most half of them are ever filled
+#define PAGE_TABLE_SLOTS (1 << 20)
+
+namespace executive
+{
+	/*! \brief A copy from a pinned host range to a device range */
+	class TrackedCopy
+	{
+		public:
+			typedef std::vector<unsigned int> WriteVector;
+
+		public:
+			/*! \brief The destination of the copy */
+			char* device;
+			/*! \brief The source of the copy */
+			const char* host;
+			/*! \brief The size of the copy */
+			size_t bytes;
+
+			/*! \brief Host pages completely covered by the copy */
+			char* hostBegin;
+			char* hostEnd;
+			/*! \brief Device pages completely covered by the copy */
+			char* deviceBegin;
+			char* deviceEnd;
+
+			/*! \brief The write count of each covered host page when the
+				copy was last made */
+			WriteVector hostWrites;
+			/*! \brief The write count of each covered device page */
+			WriteVector deviceWrites;
+			/*! \brief Can a write to this chunk always be detected? */
+			std::vector<char> tracked;
+	};
+
+	typedef std::list<TrackedCopy> CopyList;
+	typedef std::map<char*, unsigned int> PageCountMap;
+	typedef std::map<const char*, size_t> HostMap;
+
+	/*! \brief State of the tracked copies, only touched with the mutex 
+		held and never by the fault handler.  It is never destroyed so 
+		that devices may release memory during static destruction. */
+	class TrackerState
+	{
+		public:
+			/*! \brief Guards everything else */
+			boost::mutex mutex;
+			/*! \brief All tracked copies */
+			CopyList copies;
+			/*! \brief The number of copies that protect each page */
+			PageCountMap pages;
+			/*! \brief Pinned host allocations that may be tracked */
+			HostMap hosts;
+			/*! \brief Running totals */
+			DirtyPageTracker::Statistics statistics;
+	};
+	
+	static TrackerState* _state = new TrackerState;
+
+	/*! \brief Every page that has ever been protected, and how many times
+		it was written while protected.
+
+		This is all that the fault handler touches.  It is allocated once
+		before the handler is installed, lookups are lock free, and slots
+		are only ever added, with the mutex held, before their page is 
+		protected.  A slot holds the page number plus one, 0 is empty.
+	*/
+	class PageTable
+	{
+		public:
+			volatile size_t* pages;
+			volatile unsigned int* writes;
+			/*! \brief Filled slots, only touched with the mutex held */
+			size_t used;
+	};
+	
+	static PageTable _table = { 0, 0, 0 };
+
+	/*! \brief The page size, set before the handler is installed */
+	static size_t _pageSize = 0;
+
+	/*! \brief Has the fault handler been installed? */
+	static bool _installed = false;
+	/*! \brief The handler that was replaced */
+	static struct sigaction _previous;
+
+	static size_t pageSize()
+	{
+		if(_pageSize == 0) _pageSize = getpagesize();
+		return _pageSize;
+	}
+
+	static char* pageDown(const void* pointer)
+	{
+		return (char*)((size_t)pointer & ~(pageSize() - 1));
+	}
+
+	static char* pageUp(const void* pointer)
+	{
+		return pageDown((const char*)pointer + pageSize() - 1);
+	}
+
+	static size_t hashPage(size_t page)
+	{
+		return (page * 0x9e3779b97f4a7c15ULL) & (PAGE_TABLE_SLOTS - 1);
+	}
+
+	/*! \brief Find the slot of a page, -1 if it was never protected.
+		Safe in the fault handler. */
+	static long findSlot(size_t page)
+	{
+		if(_table.pages == 0) return -1;
+
+		for(size_t i = 0, slot = hashPage(page); i < PAGE_TABLE_SLOTS;
+			++i, slot = (slot + 1) & (PAGE_TABLE_SLOTS - 1))
+		{
+			size_t entry = _table.pages[slot];
+			if(entry == 0) return -1;
+			if(entry == page + 1) return slot;
+		}
+
+		return -1;
+	}
+
+	/*! \brief Add a page to the table, the mutex must be held */
+	static void insertSlot(size_t page)
+	{
+		if(findSlot(page) != -1) return;
+
+		size_t slot = hashPage(page);
+		while(_table.pages[slot] != 0)
+		{
+			slot = (slot + 1) & (PAGE_TABLE_SLOTS - 1);
+		}
+
+		_table.writes[slot] = 0;
+		__sync_synchronize();
+		_table.pages[slot] = page + 1;
+		++_table.used;
+	}
+
+	static unsigned int writeCount(char* page)
+	{
+		long slot = findSlot((size_t)page / pageSize());
+		assert(slot != -1);
+
+		return _table.writes[slot];
+	}
+
+	/*! \brief Can the table hold this many more pages? */
+	static bool roomFor(size_t pages)
+	{
+		return _table.used + pages <= PAGE_TABLE_SLOTS / 2;
+	}
+
+	/*! \brief A protected page is about to be written, count the write so
+		that the copies depending on it see it as dirty, and unprotect it.
+
+		The mutex must be held.
+	*/
+	static void invalidate(char* page)
+	{
+		if(_state->pages.count(page) == 0) return;
+
+		long slot = findSlot((size_t)page / pageSize());
+		assert(slot != -1);
+
+		__sync_fetch_and_add(&_table.writes[slot], 1);
+		mprotect(page, pageSize(), PROT_READ | PROT_WRITE);
+	}
+
+	/*! \brief Invalidate all protected pages in a range, the mutex must
+		be held */
+	static void invalidate(const void* pointer, size_t bytes)
+	{
+		PageCountMap::iterator page = _state->pages.lower_bound(
+			pageDown(pointer));
+		PageCountMap::iterator end  = _state->pages.lower_bound(
+			(char*)pointer + bytes);
+
+		for(; page != end; ++page)
+		{
+			invalidate(page->first);
+		}
+	}
+
+	static void protect(char* begin, char* end)
+	{
+		if(begin < end) mprotect(begin, end - begin, PROT_READ);
+	}
+
+	static void addPages(char* begin, char* end)
+	{
+		for(char* page = begin; page < end; page += pageSize())
+		{
+			insertSlot((size_t)page / pageSize());
+			++_state->pages[page];
+		}
+	}
+
+	static void removePages(char* begin, char* end)
+	{
+		for(char* page = begin; page < end; page += pageSize())
+		{
+			PageCountMap::iterator count = _state->pages.find(page);
+			assert(count != _state->pages.end());
+
+			if(--count->second == 0)
+			{
+				mprotect(page, pageSize(), PROT_READ | PROT_WRITE);
+				_state->pages.erase(count);
+			}
+		}
+	}
+
+	/*! \brief Record the write counts of a range of pages */
+	static void snapshot(TrackedCopy::WriteVector& writes, char* begin,
+		char* end)
+	{
+		writes.clear();
+		for(char* page = begin; page < end; page += pageSize())
+		{
+			writes.push_back(writeCount(page));
+		}
+	}
+
+	/*! \brief Has a chunk of a copy been written since it was copied? */
+	static bool dirty(const TrackedCopy& copy, size_t chunk)
+	{
+		if(!copy.tracked[chunk]) return true;
+
+		char* page = pageDown(copy.host) + chunk * pageSize();
+
+		if(writeCount(page)
+			!= copy.hostWrites[(page - copy.hostBegin) / pageSize()])
+		{
+			return true;
+		}
+
+		size_t begin = page - copy.host;
+		size_t end = std::min(begin + pageSize(), copy.bytes);
+
+		for(char* devicePage = pageDown(copy.device + begin);
+			devicePage < copy.device + end; devicePage += pageSize())
+		{
+			if(writeCount(devicePage) != copy.deviceWrites[
+				(devicePage - copy.deviceBegin) / pageSize()])
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	/*! \brief Only async-signal-safe work happens here: a lock free 
+		lookup, an atomic increment, and a raw system call */
+	static void handleFault(int signal, siginfo_t* info, void* context)
+	{
+		size_t page = (size_t)info->si_addr / _pageSize;
+		long slot = findSlot(page);
+
+		if(slot != -1)
+		{
+			__sync_fetch_and_add(&_table.writes[slot], 1);
+			
+			// fails if the page was unmapped, which is a real fault
+			if(syscall(SYS_mprotect, page * _pageSize, _pageSize,
+				PROT_READ | PROT_WRITE) == 0) return;
+		}
+
+		// pass anything else on to whoever was there first
+		if(_previous.sa_flags & SA_SIGINFO)
+		{
+			_previous.sa_sigaction(signal, info, context);
+		}
+		else if(_previous.sa_handler == SIG_DFL
+			|| _previous.sa_handler == SIG_IGN)
+		{
+			sigaction(SIGSEGV, &_previous, 0);
+		}
+		else
+		{
+			_previous.sa_handler(signal);
+		}
+	}
+
+	/*! \brief Allocate the page table and install the handler, the mutex
+		must be held */
+	static bool install()
+	{
+		if(_installed) return true;
+
+		pageSize();
+
+		void* pages = mmap(0, PAGE_TABLE_SLOTS * sizeof(size_t), 
+			PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		void* writes = mmap(0, PAGE_TABLE_SLOTS * sizeof(unsigned int), 
+			PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+		if(pages == MAP_FAILED || writes == MAP_FAILED)
+		{
+			if(pages != MAP_FAILED) 
+			{
+				munmap(pages, PAGE_TABLE_SLOTS * sizeof(size_t));
+			}
+			if(writes != MAP_FAILED)
+			{
+				munmap(writes, PAGE_TABLE_SLOTS * sizeof(unsigned int));
+			}
+			
+			report("Failed to allocate the dirty page table.");
+			return false;
+		}
+
+		_table.pages = (volatile size_t*)pages;
+		_table.writes = (volatile unsigned int*)writes;
+		__sync_synchronize();
+
+		struct sigaction action;
+		action.sa_sigaction = handleFault;
+		sigemptyset(&action.sa_mask);
+		action.sa_flags = SA_SIGINFO;
+
+		sigaction(SIGSEGV, &action, &_previous);
+		_installed = true;
+		
+		return true;
+	}
+
+	/*! \brief Report the totals when the program exits */
+	class StatisticsReporter
+	{
+		public:
+			~StatisticsReporter()
+			{
+				report("Dirty page tracking copied "
+					<< _state->statistics.copied << " bytes, elided "
+					<< _state->statistics.elided << " bytes");
+			}
+	};
+
+	static StatisticsReporter _reporter;
+
+	DirtyPageTracker::Statistics::Statistics() : copied(0), elided(0)
+	{
+
+	}
+
+	bool DirtyPageTracker::enabled()
+	{
+		return api::OcelotConfiguration::get().executive.dirtyPageTracking;
+	}
+
+	void DirtyPageTracker::registerHost(const void* pointer, size_t bytes)
+	{
+		boost::mutex::scoped_lock lock(_state->mutex);
+		_state->hosts[(const char*)pointer] = bytes;
+	}
+
+	void DirtyPageTracker::release(const void* pointer, size_t bytes)
+	{
+		if(!enabled()) return;
+
+		const char* begin = (const char*)pointer;
+		const char* end   = begin + bytes;
+
+		boost::mutex::scoped_lock lock(_state->mutex);
+
+		for(HostMap::iterator host = _state->hosts.begin(); host != _state->hosts.end();)
+		{
+			if(host->first < end && host->first + host->second > begin)
+			{
+				_state->hosts.erase(host++);
+			}
+			else
+			{
+				++host;
+			}
+		}
+
+		for(CopyList::iterator copy = _state->copies.begin(); copy != _state->copies.end();)
+		{
+			bool hostOverlaps = copy->host < end
+				&& copy->host + copy->bytes > begin;
+			bool deviceOverlaps = copy->device < end
+				&& copy->device + copy->bytes > begin;
+
+			if(hostOverlaps || deviceOverlaps)
+			{
+				report("Releasing tracked copy from " << (void*)copy->host
+					<< " to " << (void*)copy->device);
+				removePages(copy->hostBegin, copy->hostEnd);
+				removePages(copy->deviceBegin, copy->deviceEnd);
+				_state->copies.erase(copy++);
+			}
+			else
+			{
+				++copy;
+			}
+		}
+	}
+
+	void DirtyPageTracker::touch(const void* pointer, size_t bytes)
+	{
+		if(!enabled()) return;
+
+		boost::mutex::scoped_lock lock(_state->mutex);
+		invalidate(pointer, bytes);
+	}
+
+	bool DirtyPageTracker::copy(void* device, const void* host, size_t bytes)
+	{
+		if(bytes < MINIMUM_TRACKED_BYTES) return false;
+		if(!enabled()) return false;
+
+		boost::mutex::scoped_lock lock(_state->mutex);
+
+		HostMap::iterator region = _state->hosts.upper_bound((const char*)host);
+		if(region == _state->hosts.begin()) return false;
+		--region;
+
+		if((const char*)host + bytes > region->first + region->second)
+		{
+			return false;
+		}
+
+		if(!install()) return false;
+
+		CopyList::iterator copy = _state->copies.begin();
+		for(; copy != _state->copies.end(); ++copy)
+		{
+			if(copy->device == device && copy->host == host
+				&& copy->bytes == bytes) break;
+		}
+
+		if(copy == _state->copies.end())
+		{
+			if(!roomFor(2 * (bytes / pageSize() + 1)))
+			{
+				report("The dirty page table is full, not tracking a copy "
+					"of " << bytes << " bytes.");
+				return false;
+			}
+			
+			// anything else depending on the destination is now stale
+			invalidate(device, bytes);
+
+			BulkTransfer::copy(device, host, bytes);
+			_state->statistics.copied += bytes;
+
+			TrackedCopy tracked;
+			tracked.device      = (char*)device;
+			tracked.host        = (const char*)host;
+			tracked.bytes       = bytes;
+			tracked.hostBegin   = pageUp(host);
+			tracked.hostEnd     = std::max(tracked.hostBegin,
+				pageDown((const char*)host + bytes));
+			tracked.deviceBegin = pageUp(device);
+			tracked.deviceEnd   = std::max(tracked.deviceBegin,
+				pageDown((char*)device + bytes));
+
+			char* first = pageDown(host);
+			size_t chunks = (pageUp((const char*)host + bytes) - first)
+				/ pageSize();
+
+			tracked.tracked.resize(chunks);
+			for(size_t chunk = 0; chunk < chunks; ++chunk)
+			{
+				char* page = first + chunk * pageSize();
+				size_t begin = std::max(page, (char*)host) - (char*)host;
+				size_t end = std::min(page + pageSize(),
+					(char*)host + bytes) - (char*)host;
+
+				tracked.tracked[chunk] = page >= tracked.hostBegin
+					&& page < tracked.hostEnd
+					&& tracked.device + begin >= tracked.deviceBegin
+					&& tracked.device + end <= tracked.deviceEnd;
+			}
+
+			copy = _state->copies.insert(_state->copies.end(), tracked);
+
+			addPages(copy->hostBegin, copy->hostEnd);
+			addPages(copy->deviceBegin, copy->deviceEnd);
+
+			report("Tracking copy of " << bytes << " bytes from " << host
+				<< " to " << device);
+		}
+		else
+		{
+			char* first = pageDown(host);
+			size_t elided = 0;
+
+			// decide before writing, writes bump the counts of pages that
+			// are shared with neighboring chunks
+			std::vector<char> dirtyChunks(copy->tracked.size());
+			for(size_t chunk = 0; chunk < dirtyChunks.size(); ++chunk)
+			{
+				dirtyChunks[chunk] = dirty(*copy, chunk);
+			}
+
+			// unprotect the destination of each dirty chunk and copy it
+			for(size_t chunk = 0; chunk < dirtyChunks.size(); ++chunk)
+			{
+				char* page = first + chunk * pageSize();
+				size_t begin = std::max(page, (char*)host) - (char*)host;
+				size_t end = std::min(page + pageSize(),
+					(char*)host + bytes) - (char*)host;
+
+				if(!dirtyChunks[chunk])
+				{
+					elided += end - begin;
+					continue;
+				}
+
+				invalidate(copy->device + begin, end - begin);
+				std::memcpy(copy->device + begin, copy->host + begin,
+					end - begin);
+				_state->statistics.copied += end - begin;
+			}
+
+			_state->statistics.elided += elided;
+
+			report("Repeated copy of " << bytes << " bytes from " << host
+				<< " to " << device << ", elided " << elided << " bytes");
+		}
+
+		// writes from here on are counted by the fault handler
+		snapshot(copy->hostWrites, copy->hostBegin, copy->hostEnd);
+		snapshot(copy->deviceWrites, copy->deviceBegin, copy->deviceEnd);
+
+		protect(copy->hostBegin, copy->hostEnd);
+		protect(copy->deviceBegin, copy->deviceEnd);
+
+		return true;
+	}
+
+	DirtyPageTracker::Statistics DirtyPageTracker::statistics()
+	{
+		boost::mutex::scoped_lock lock(_state->mutex);
+		return _state->statistics;
+	}
+}
+
+#endif
+
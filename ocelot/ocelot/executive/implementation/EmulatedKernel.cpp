@@ -23,6 +23,8 @@
 #include <ocelot/executive/interface/Device.h>
 #include <ocelot/executive/interface/RuntimeException.h>
 #include <ocelot/executive/interface/CooperativeThreadArray.h>
+#include <ocelot/executive/interface/CtaSampler.h>
+#include <ocelot/api/interface/OcelotConfiguration.h>
 #include <ocelot/ir/interface/HammockGraph.h>
 #include <ocelot/trace/interface/TraceGenerator.h>
 
@@ -58,7 +60,9 @@ executive::EmulatedKernel::EmulatedKernel(
 	bool _initialize) 
 : 
 	ExecutableKernel(*kernel, d),
-	CTA(0)
+	CTA(0),
+	_launchPlanValid(false),
+	_launches(0)
 {
 	report("Created emulated kernel " << name);
 	assertM(kernel->ISA == ir::Instruction::PTX, 
@@ -72,12 +76,16 @@ executive::EmulatedKernel::EmulatedKernel(
 }
 
 executive::EmulatedKernel::EmulatedKernel(
-	Device* d): ExecutableKernel(d), CTA(0) {
+	Device* d): ExecutableKernel(d), CTA(0), _launchPlanValid(false), 
+	_launches(0) {
 	ISA = ir::Instruction::Emulated;
+	ConstMemory = ParameterMemory = 0;
 }
 
-executive::EmulatedKernel::EmulatedKernel(): CTA(0) {
+executive::EmulatedKernel::EmulatedKernel(): CTA(0), _launchPlanValid(false),
+	_launches(0) {
 	ISA = ir::Instruction::Emulated;
+	ConstMemory = ParameterMemory = 0;
 }
 
 executive::EmulatedKernel::~EmulatedKernel() {
@@ -95,6 +103,19 @@ void executive::EmulatedKernel::launchGrid(int width, int height) {
 
 	_gridDim = ir::Dim3(width, height, 1);	
 	
+	// fast-forward launches outside of the trace window
+	if (!_generators.empty() && !_traceLaunch()) {
+		report(" fast-forwarding launch " << _launches << " of " << name);
+		TraceGeneratorVector generators = std::move(_generators);
+		_generators.clear();
+		
+		launchGrid(width, height);
+		
+		_generators = std::move(generators);
+		return;
+	}
+	++_launches;
+	
 	// notify trace generator(s)
 	for (TraceGeneratorVector::iterator it = _generators.begin(); 
 		it != _generators.end(); ++it) {
@@ -116,13 +137,22 @@ void executive::EmulatedKernel::launchGrid(int width, int height) {
 	report("  block: " << blockDim().x << ", " << blockDim().y << ", " << blockDim().z);
 #endif
 
+	CtaSampler::Mode sampling = CtaSampler::configuredMode();
+	if (sampling != CtaSampler::NoSampling) {
+		CtaSampler sampler(width * height, sampling);
+		_launchSampled(sampler);
+		return;
+	}
+
+	unsigned int ordinal = 0;
 	for (int x = 0; x < width; ++x) {
-		for (int y = 0; y < height; ++y) {
+		for (int y = 0; y < height; ++y, ++ordinal) {
 			ir::Dim3 block(x,y,0);
 			CooperativeThreadArray cta(this);
 
 			CTA = &cta;
-			cta.initialize( _gridDim, !_generators.empty() );
+			cta.initialize( _gridDim, 
+				!_generators.empty() && _traceCta(ordinal) );
 			cta.execute(block);
 		}
 	}
@@ -135,6 +165,99 @@ void executive::EmulatedKernel::launchGrid(int width, int height) {
 	CTA = 0;
 }
 
+void executive::EmulatedKernel::_launchCta(unsigned int id) {
+	ir::Dim3 block(id % _gridDim.x, id / _gridDim.x, 0);
+	CooperativeThreadArray cta(this);
+
+	CTA = &cta;
+	cta.initialize( _gridDim, !_generators.empty() );
+	cta.execute(block);
+}
+
+void executive::EmulatedKernel::_launchSampled(CtaSampler& sampler) {
+	CtaSampler::Counter counter(sampler);
+	
+	if (sampler.mode() == CtaSampler::ClusteredSampling) {
+		// profile without the other generators, the counter records the
+		//  events so that the representatives are replayed, not run again
+		TraceGeneratorVector generators = std::move(_generators);
+		_generators.clear();
+		_generators.push_back(&counter);
+		
+		const CtaSampler::IdVector& profiled = sampler.profiled();
+		for (CtaSampler::IdVector::const_iterator id = profiled.begin();
+			id != profiled.end(); ++id) {
+			_launchCta(*id);
+		}
+		
+		_generators = std::move(generators);
+		sampler.cluster();
+		
+		report("Replaying " << sampler.sampled().size() 
+			<< " representative CTAs of " << sampler.ctas());
+		
+		const CtaSampler::IdVector& sampled = sampler.sampled();
+		for (CtaSampler::IdVector::const_iterator id = sampled.begin();
+			id != sampled.end(); ++id) {
+			sampler.replay(*id, _generators);
+		}
+	}
+	else {
+		report("Running " << sampler.sampled().size() << " sampled CTAs of "
+			<< sampler.ctas());
+		
+		_generators.push_back(&counter);
+		
+		const CtaSampler::IdVector& sampled = sampler.sampled();
+		for (CtaSampler::IdVector::const_iterator id = sampled.begin();
+			id != sampled.end(); ++id) {
+			_launchCta(*id);
+		}
+		
+		_generators.pop_back();
+	}
+	
+	// notify trace generator(s)
+	for (TraceGeneratorVector::iterator it = _generators.begin(); 
+		it != _generators.end(); ++it) {
+		(*it)->sampled(sampler);
+		(*it)->finish();
+	}
+	CTA = 0;
+	
+	sampler.save(name);
+}
+
+bool executive::EmulatedKernel::_traceLaunch() const {
+	const api::OcelotConfiguration::TraceGeneration::WindowMap& windows = 
+		api::OcelotConfiguration::get().trace.windows;
+	
+	api::OcelotConfiguration::TraceGeneration::WindowMap::const_iterator
+		window = windows.find(name);
+	if (window == windows.end()) return true;
+	
+	unsigned int skip = window->second.skipLaunches;
+	unsigned int traced = window->second.traceLaunches;
+	
+	if (_launches < skip) return false;
+	return traced == 0 || _launches - skip < traced;
+}
+
+bool executive::EmulatedKernel::_traceCta(unsigned int ordinal) const {
+	const api::OcelotConfiguration::TraceGeneration::WindowMap& windows = 
+		api::OcelotConfiguration::get().trace.windows;
+	
+	api::OcelotConfiguration::TraceGeneration::WindowMap::const_iterator
+		window = windows.find(name);
+	if (window == windows.end()) return true;
+	
+	unsigned int skip = window->second.skipCtas;
+	unsigned int traced = window->second.traceCtas;
+	
+	if (ordinal < skip) return false;
+	return traced == 0 || ordinal - skip < traced;
+}
+
 void executive::EmulatedKernel::setKernelShape(int x, int y, int z) {
 	_blockDim.x = x;
 	_blockDim.y = y;
@@ -213,6 +336,9 @@ void executive::EmulatedKernel::constructInstructionSequence() {
 		ir::ControlFlowGraph::iterator> ReconvergeToBlockMap;
 	report("Constructing emulated instruction sequence.");
 
+	// symbol references are indexed by PC, so they must be found again
+	_launchPlanValid = false;
+
 	// visit basic blocks and add reconverge instructions
 	ir::ControlFlowGraph::BlockPointerVector bb_sequence = cfg()->executable_sequence();
 	
@@ -431,8 +557,10 @@ bool executive::EmulatedKernel::checkMemoryAccess(const void* base,
 void executive::EmulatedKernel::updateParameterMemory() {
 	using namespace std;
 
-	delete[] ParameterMemory;	
-	ParameterMemory = new char[_parameterMemorySize];
+	// the size only changes in initializeParameterMemory(), which frees it
+	if(ParameterMemory == 0) {
+		ParameterMemory = new char[_parameterMemorySize];
+	}
 	
 	unsigned int size = 0;
 	for(ParameterVector::iterator i_it = parameters.begin();
@@ -713,18 +841,18 @@ void executive::EmulatedKernel::initializeLocalMemory() {
 	_localMemorySize = localOffset;
 }
 
-/*! Maps identifiers to const memory allocations. */
-void executive::EmulatedKernel::initializeConstMemory() {
+void executive::EmulatedKernel::_buildLaunchPlan() {
 	using namespace std;
 	assert(module != 0);
 
-	report("Initializing constant variables for kernel " << name);
+	report("Building launch plan for kernel " << name);
 
-	unsigned int constantOffset = 0;
+	_globalReferences.clear();
+	_constantOffsets.clear();
 
-	typedef map<string, unsigned int> ConstantOffsetMap;
+	unsigned int constantOffset = 0;
+	unordered_set<string> global;
 
-	ConstantOffsetMap constant;
 	ir::Module::GlobalMap::const_iterator it = module->globals().begin();
 	for (; it != module->globals().end(); ++it) {
 		if (it->second.statement.directive == ir::PTXStatement::Const) {
@@ -734,38 +862,56 @@ void executive::EmulatedKernel::initializeConstMemory() {
 				<< it->second.statement.name);
 			_computeOffset(it->second.statement, 
 				offset, constantOffset);						
-			constant[it->second.statement.name] = offset;
+			_constantOffsets[it->second.statement.name] = offset;
+		}
+		else if (it->second.statement.directive == ir::PTXStatement::Global) {
+			report("  Found global variable " << it->second.statement.name);
+			global.insert(it->second.statement.name);
 		}
 	}
 	
 	report( "Total constant memory size is " << constantOffset );
 
+	// visit every instruction once, constant offsets never change so they
+	// are assigned here, global references are recorded to be patched
+	// with the allocation addresses on each launch
 	ir::PTXOperand ir::PTXInstruction:: *operands[] = {
 		&ir::PTXInstruction::d, &ir::PTXInstruction::a, &ir::PTXInstruction::b, 
 		&ir::PTXInstruction::c
 	};
-	PTXInstructionVector::iterator i_it = instructions.begin();
-	for (; i_it != instructions.end(); ++i_it) {
-		ir::PTXInstruction &instr = *i_it;
+	for (unsigned int pc = 0; pc < instructions.size(); ++pc) {
+		ir::PTXInstruction &instr = instructions[pc];
 
-		// look for mov instructions or ld/st instruction
-		if (instr.opcode == ir::PTXInstruction::Mov
+		// look for mov instructions or ld/st/atom instruction
+		bool constant = instr.opcode == ir::PTXInstruction::Mov
 			|| instr.opcode == ir::PTXInstruction::Ld 
-			|| instr.opcode == ir::PTXInstruction::St) {
-			for (int n = 0; n < 4; n++) {
-				if ((instr.*operands[n]).addressMode 
-					== ir::PTXOperand::Address) {
-					ConstantOffsetMap::iterator	l_it 
-						= constant.find((instr.*operands[n]).identifier);
-					if (constant.end() != l_it) {
-						report("For instruction " << instr.toString() 
-							<< ", mapping constant label " << l_it->first 
-							<< " to " << l_it->second );
-						(instr.*operands[n]).type = ir::PTXOperand::u64;
-						(instr.*operands[n]).imm_uint = l_it->second;
-					}
+			|| instr.opcode == ir::PTXInstruction::St;
+		if (!constant && instr.opcode != ir::PTXInstruction::Atom) continue;
+
+		for (int n = 0; n < 4; n++) {
+			ir::PTXOperand& operand = instr.*operands[n];
+			if (operand.addressMode != ir::PTXOperand::Address) continue;
+
+			if (constant) {
+				ConstantOffsetMap::iterator	l_it 
+					= _constantOffsets.find(operand.identifier);
+				if (_constantOffsets.end() != l_it) {
+					report("For instruction " << instr.toString() 
+						<< ", mapping constant label " << l_it->first 
+						<< " to " << l_it->second );
+					operand.type = ir::PTXOperand::u64;
+					operand.imm_uint = l_it->second;
+					continue;
 				}
 			}
+
+			if (global.count(operand.identifier) != 0) {
+				operand.type = ir::PTXOperand::u64;
+				SymbolReference reference;
+				reference.pc = pc;
+				reference.operand = operands[n];
+				_globalReferences[operand.identifier].push_back(reference);
+			}
 		}
 	}
 
@@ -780,9 +926,20 @@ void executive::EmulatedKernel::initializeConstMemory() {
 		ConstMemory = 0;
 	}
 	
+	_launchPlanValid = true;
+}
+
+/*! Maps identifiers to const memory allocations. */
+void executive::EmulatedKernel::initializeConstMemory() {
+	assert(module != 0);
+
+	if (!_launchPlanValid) _buildLaunchPlan();
+
+	report("Initializing constant variables for kernel " << name);
+
 	// copy globals into constant memory
-	for (ConstantOffsetMap::iterator l_it = constant.begin(); 
-		l_it != constant.end(); ++l_it) {
+	for (ConstantOffsetMap::iterator l_it = _constantOffsets.begin(); 
+		l_it != _constantOffsets.end(); ++l_it) {
 
 		assert(device != 0);
 		Device::MemoryAllocation* global = device->getGlobalAllocation(
@@ -800,57 +957,30 @@ void executive::EmulatedKernel::initializeConstMemory() {
 	Maps identifiers to global memory allocations.
 */
 void executive::EmulatedKernel::initializeGlobalMemory() {
-	using namespace std;
 	if(module == 0) return;
 	
-	report("Initializing global variables for kernel " << name);
+	if (!_launchPlanValid) _buildLaunchPlan();
 
-	unordered_set<string> global;
-	
-	ir::Module::GlobalMap::const_iterator it = module->globals().begin();
-	for (; it != module->globals().end(); ++it) {
-		if (it->second.statement.directive == ir::PTXStatement::Global) {
-			report(" Found global variable " << it->second.statement.name);
-			global.insert(it->second.statement.name);
-		}
-	}
-
-	// now visit every instruction and change the address mode from label 
-	// to immediate, and assign the offset as an immediate value 
-	ir::PTXOperand ir::PTXInstruction:: *operands[] = {
-		&ir::PTXInstruction::d, &ir::PTXInstruction::a, &ir::PTXInstruction::b, 
-		&ir::PTXInstruction::c };
-	PTXInstructionVector::iterator 
-		i_it = instructions.begin();
-	for (; i_it != instructions.end(); ++i_it) {
-		ir::PTXInstruction &instr = *i_it;
+	report("Initializing global variables for kernel " << name);
 
-		// look for mov instructions or ld/st/atom instruction
-		if (instr.opcode == ir::PTXInstruction::Mov
-			|| instr.opcode == ir::PTXInstruction::Ld 
-			|| instr.opcode == ir::PTXInstruction::St
-			|| instr.opcode == ir::PTXInstruction::Atom) {
-			for (int n = 0; n < 4; n++) {
-				if ((instr.*operands[n]).addressMode 
-					== ir::PTXOperand::Address) {
-					unordered_set<string>::iterator l_it = 
-						global.find((instr.*operands[n]).identifier);
-					if (global.end() != l_it) {
-						(instr.*operands[n]).type = ir::PTXOperand::u64;
-						assert( device != 0);
-						Device::MemoryAllocation* allocation = 
-							device->getGlobalAllocation(
-							module->path(), *l_it);
-						assert(allocation != 0);
-						(instr.*operands[n]).imm_uint = 
-							(ir::PTXU64)allocation->pointer();
-						report("Mapping global label " 
-							<< (instr.*operands[n]).identifier << " to " 
-							<< (void *)(instr.*operands[n]).imm_uint 
-							<< " for instruction " << instr.toString() );
-					}
-				}
-			}
+	// only the recorded references need to be updated, the allocations
+	// may have moved since the last launch
+	for (SymbolReferenceMap::iterator g_it = _globalReferences.begin(); 
+		g_it != _globalReferences.end(); ++g_it) {
+		assert( device != 0);
+		Device::MemoryAllocation* allocation = 
+			device->getGlobalAllocation(module->path(), g_it->first);
+		assert(allocation != 0);
+
+		for (SymbolReferenceVector::iterator 
+			reference = g_it->second.begin(); 
+			reference != g_it->second.end(); ++reference) {
+			ir::PTXOperand& operand = 
+				instructions[reference->pc].*reference->operand;
+			operand.imm_uint = (ir::PTXU64)allocation->pointer();
+			report("Mapping global label " << g_it->first << " to " 
+				<< (void *)operand.imm_uint << " for instruction " 
+				<< instructions[reference->pc].toString() );
 		}
 	}
 }
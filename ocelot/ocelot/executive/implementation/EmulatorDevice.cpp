@@ -11,6 +11,9 @@
 #include <ocelot/api/interface/OcelotConfiguration.h>
 #include <ocelot/executive/interface/EmulatorDevice.h>
 #include <ocelot/executive/interface/EmulatedKernel.h>
+#include <ocelot/executive/interface/NativeKernel.h>
+#include <ocelot/executive/interface/BulkTransfer.h>
+#include <ocelot/executive/interface/DirtyPageTracker.h>
 #include <ocelot/cuda/interface/cuda_runtime.h>
 
 // hydrazine includes
@@ -90,6 +93,7 @@ namespace executive
 	
 	EmulatorDevice::MemoryAllocation::~MemoryAllocation()
 	{
+		DirtyPageTracker::release(align(_pointer), _size);
 		if(!_external) std::free(_pointer);
 	}
 
@@ -113,6 +117,7 @@ namespace executive
 	{
 		if(&a == this) return *this;
 		
+		DirtyPageTracker::release(align(_pointer), _size);
 		if(!_external) std::free(_pointer);
 		
 		_global = a.global();
@@ -175,21 +180,26 @@ namespace executive
 		const void* host, size_t s)
 	{
 		assert(offset + s <= size());
-		std::memcpy((char*)pointer() + offset, host, s);
+		if((char*)pointer() + offset == host) return;
+		if(DirtyPageTracker::copy((char*)pointer() + offset, host, s)) return;
+		BulkTransfer::copy((char*)pointer() + offset, host, s);
 	}
 	
 	void EmulatorDevice::MemoryAllocation::copy(void* host, size_t offset, 
 		size_t s) const
 	{
 		assert(offset + s <= size());
-		std::memcpy(host, (char*)pointer() + offset, s);
+		if((char*)pointer() + offset == host) return;
+		DirtyPageTracker::touch(host, s);
+		BulkTransfer::copy(host, (char*)pointer() + offset, s);
 	}
 
 	void EmulatorDevice::MemoryAllocation::memset(size_t offset, 
 		int value, size_t s)
 	{
 		assert(offset + s <= size());
-		std::memset((char*)pointer() + offset, value, s);
+		DirtyPageTracker::touch((char*)pointer() + offset, s);
+		BulkTransfer::memset((char*)pointer() + offset, value, s);
 	}
 
 	void EmulatorDevice::MemoryAllocation::copy(Device::MemoryAllocation* a, 
@@ -200,7 +210,9 @@ namespace executive
 		assert(fromOffset + s <= size());
 		assert(toOffset + s <= allocation->size());
 		
-		std::memcpy((char*)allocation->pointer() + toOffset, 
+		if(allocation == this && toOffset == fromOffset) return;
+		DirtyPageTracker::touch((char*)allocation->pointer() + toOffset, s);
+		BulkTransfer::copy((char*)allocation->pointer() + toOffset, 
 			(char*)pointer() + fromOffset, s);
 	}
 
@@ -257,6 +269,16 @@ namespace executive
 			ir->kernels().find(name);
 		if(ptxKernel != ir->kernels().end())
 		{
+			NativeKernelFunction function = NativeKernel::lookup(name);
+			
+			if(function != 0)
+			{
+				kernel = kernels.insert(std::make_pair(name, 
+					new NativeKernel(*ptxKernel->second, device, 
+					function))).first;
+				return kernel->second;
+			}
+			
 			kernel = kernels.insert(std::make_pair(name, 
 				new EmulatedKernel(ptxKernel->second, device))).first;
 			return kernel->second;
@@ -284,7 +306,8 @@ namespace executive
 	}
 	
 	EmulatorDevice::EmulatorDevice( unsigned int flags) : 
-		_selected(false), _next(1)
+		_selected(false), _next(1), 
+		_zeroCopy(api::OcelotConfiguration::get().executive.zeroCopy)
 	{
 		_timer.start();
 	
@@ -344,6 +367,17 @@ namespace executive
 						allocation = alloc->second;
 						return allocation;
 					}
+					
+					// mapped host allocations share the device address space
+					if(alloc->second->host() 
+						&& (alloc->second->flags() & cudaHostAllocMapped)
+						&& (char*)address >= (char*)alloc->second->pointer()
+						&& (char*)address < (char*)alloc->second->pointer() 
+						+ alloc->second->size())
+					{
+						allocation = alloc->second;
+						return allocation;
+					}
 				}
 			}
 		}
@@ -435,9 +469,18 @@ namespace executive
 	Device::MemoryAllocation* EmulatorDevice::allocateHost(size_t size, 
 		unsigned int flags)
 	{
+		// host and device memory are the same, so a pinned allocation can be
+		//  handed to kernels directly without ever being copied
+		if(_zeroCopy) flags |= cudaHostAllocMapped;
+		
 		MemoryAllocation* allocation = new MemoryAllocation(size, flags);
 		_allocations.insert(std::make_pair(allocation->mappedPointer(), 
 			allocation));
+		
+		if(DirtyPageTracker::enabled())
+		{
+			DirtyPageTracker::registerHost(allocation->mappedPointer(), size);
+		}
 		return allocation;
 	}
 	
@@ -966,6 +1009,15 @@ namespace executive
 				<< " in module " << moduleName);
 		}
 		
+		_launchKernel(kernel, grid, block, sharedMemory, parameterBlock,
+			parameterBlockSize, traceGenerators);
+	}
+
+	void EmulatorDevice::_launchKernel(ExecutableKernel* kernel, 
+		const ir::Dim3& grid, const ir::Dim3& block, size_t sharedMemory, 
+		const void* parameterBlock, size_t parameterBlockSize, 
+		const trace::TraceGeneratorVector& traceGenerators)
+	{
 		if(kernel->sharedMemorySize() + sharedMemory > 
 			(size_t)properties().sharedMemPerBlock)
 		{
@@ -0,0 +1,245 @@
+/*! \file HybridDevice.cpp
+	\author agent
+	\date October 18, 2026
+	\brief The source file for the HybridDevice class.
+*/
+
+#ifndef HYBRID_DEVICE_CPP_INCLUDED
+#define HYBRID_DEVICE_CPP_INCLUDED
+
+// ocelot includes
+#include <ocelot/executive/interface/HybridDevice.h>
+#include <ocelot/executive/interface/LLVMExecutableKernel.h>
+#include <ocelot/api/interface/OcelotConfiguration.h>
+
+// hydrazine includes
+#include <hydrazine/implementation/Exception.h>
+#include <hydrazine/implementation/Timer.h>
+#include <hydrazine/implementation/debug.h>
+
+// Standard library includes
+#include <algorithm>
+
+#ifdef REPORT_BASE
+#undef REPORT_BASE
+#endif
+
+// Turn on report messages
+#define REPORT_BASE 0
+
+// Time this many launches on the JIT before pinning a kernel in
+// calibration mode, the launch that compiles the kernel is not timed
+#define CALIBRATION_LAUNCHES 2
+
+// Macros
+#define Throw(x) {std::stringstream s; s << x; \
+	throw hydrazine::Exception(s.str());}
+
+namespace executive
+{
+	HybridDevice::KernelState::KernelState() : launches(0), jitLaunches(0),
+		pinned(false), backend(Emulator)
+	{
+		for(unsigned int i = 0; i < Backends; ++i)
+		{
+			seconds[i] = 0.0;
+			threads[i] = 0.0;
+			timed[i] = 0;
+		}
+	}
+
+	HybridDevice::HybridDevice(unsigned int flags) : MulticoreCPUDevice(flags)
+	{
+		_properties.name = "Ocelot Hybrid CPU Backend (Emulator and LLVM-JIT)";
+	}
+
+	HybridDevice::~HybridDevice()
+	{
+		for(ModuleMap::iterator module = _emulated.begin();
+			module != _emulated.end(); ++module)
+		{
+			delete module->second;
+		}
+	}
+
+	void HybridDevice::load(const ir::Module* module)
+	{
+		MulticoreCPUDevice::load(module);
+		_emulated.insert(std::make_pair(module->path(),
+			new EmulatorDevice::Module(module, this)));
+	}
+
+	void HybridDevice::unload(const std::string& name)
+	{
+		MulticoreCPUDevice::unload(name);
+
+		ModuleMap::iterator module = _emulated.find(name);
+		if(module != _emulated.end())
+		{
+			delete module->second;
+			_emulated.erase(module);
+		}
+
+		KernelStateMap::iterator kernel = _kernels.lower_bound(
+			KernelId(name, ""));
+		while(kernel != _kernels.end() && kernel->first.first == name)
+		{
+			_kernels.erase(kernel++);
+		}
+	}
+
+	void HybridDevice::launch(const std::string& moduleName,
+		const std::string& kernelName, const ir::Dim3& grid,
+		const ir::Dim3& block, size_t sharedMemory,
+		const void* parameterBlock, size_t parameterBlockSize,
+		const trace::TraceGeneratorVector& traceGenerators)
+	{
+		if(_emulated.count(moduleName) == 0)
+		{
+			Throw("Unknown module - " << moduleName);
+		}
+
+		KernelId id(moduleName, kernelName);
+		KernelState& state = _kernels[id];
+
+		bool traced = !traceGenerators.empty();
+		Backend backend = _select(state, traced);
+
+		if(backend == JIT)
+		{
+			ExecutableKernel* kernel = getKernel(moduleName, kernelName);
+
+			if(kernel == 0)
+			{
+				Throw("Unknown kernel - " << kernelName
+					<< " in module " << moduleName);
+			}
+
+			// keep the translation out of the timed launch
+			if(kernel->ISA == ir::Instruction::LLVM)
+			{
+				static_cast<LLVMExecutableKernel*>(kernel)->translate();
+			}
+		}
+
+		hydrazine::Timer timer;
+		timer.start();
+
+		if(backend == JIT)
+		{
+			MulticoreCPUDevice::launch(moduleName, kernelName, grid, block,
+				sharedMemory, parameterBlock, parameterBlockSize);
+		}
+		else
+		{
+			_launchEmulated(moduleName, kernelName, grid, block,
+				sharedMemory, parameterBlock, parameterBlockSize,
+				traceGenerators);
+		}
+
+		timer.stop();
+
+		if(traced) return;
+
+		double threads = (double)grid.x * grid.y * block.x * block.y
+			* block.z;
+
+		_record(id, state, backend, timer.seconds(), threads);
+	}
+
+	HybridDevice::Backend HybridDevice::_select(const KernelState& state,
+		bool traced) const
+	{
+		if(traced) return Emulator;
+		if(state.pinned) return state.backend;
+
+		int promote = api::OcelotConfiguration::get(
+			).executive.hybridPromoteLaunches;
+
+		if(state.launches < (unsigned int)std::max(promote, 0))
+		{
+			return Emulator;
+		}
+
+		return JIT;
+	}
+
+	void HybridDevice::_launchEmulated(const std::string& moduleName,
+		const std::string& kernelName, const ir::Dim3& grid,
+		const ir::Dim3& block, size_t sharedMemory,
+		const void* parameterBlock, size_t parameterBlockSize,
+		const trace::TraceGeneratorVector& traceGenerators)
+	{
+		ModuleMap::iterator module = _emulated.find(moduleName);
+
+		if(module == _emulated.end())
+		{
+			Throw("Unknown module - " << moduleName);
+		}
+
+		ExecutableKernel* kernel = module->second->getKernel(kernelName);
+
+		if(kernel == 0)
+		{
+			Throw("Unknown kernel - " << kernelName
+				<< " in module " << moduleName);
+		}
+
+		_launchKernel(kernel, grid, block, sharedMemory, parameterBlock,
+			parameterBlockSize, traceGenerators);
+	}
+
+	void HybridDevice::_record(const KernelId& id, KernelState& state,
+		Backend backend, double seconds, double threads)
+	{
+		++state.launches;
+
+		// the first launch on the JIT also generates the machine code
+		if(backend == JIT && state.jitLaunches++ == 0)
+		{
+			report("Promoted kernel \"" << id.second << "\" in module \""
+				<< id.first << "\" to the JIT after " << (state.launches - 1)
+				<< " launches.");
+			return;
+		}
+
+		state.seconds[backend] += seconds;
+		state.threads[backend] += threads;
+		++state.timed[backend];
+
+		if(state.pinned || backend != JIT) return;
+
+		if(!api::OcelotConfiguration::get().executive.hybridCalibration)
+		{
+			state.pinned = true;
+			state.backend = JIT;
+			return;
+		}
+
+		if(state.timed[JIT] < CALIBRATION_LAUNCHES) return;
+
+		state.pinned = true;
+		state.backend = JIT;
+
+		// nothing to compare against if kernels start on the JIT
+		if(state.timed[Emulator] == 0 || state.threads[Emulator] == 0.0
+			|| state.threads[JIT] == 0.0)
+		{
+			return;
+		}
+
+		double emulator = state.seconds[Emulator] / state.threads[Emulator];
+		double jit = state.seconds[JIT] / state.threads[JIT];
+
+		if(emulator < jit) state.backend = Emulator;
+
+		report("Pinned kernel \"" << id.second << "\" in module \""
+			<< id.first << "\" to the " << (state.backend == JIT
+			? "JIT" : "emulator") << " (" << (emulator * 1.0e9)
+			<< " ns per thread emulated, " << (jit * 1.0e9)
+			<< " ns per thread on the JIT).");
+	}
+}
+
+#endif
+
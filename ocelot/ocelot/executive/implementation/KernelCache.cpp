@@ -0,0 +1,281 @@
+/*! \file KernelCache.cpp
+	\author agent
+	\date October 18, 2026
+	\brief The source file for the KernelCache class.
+*/
+
+#ifndef KERNEL_CACHE_CPP_INCLUDED
+#define KERNEL_CACHE_CPP_INCLUDED
+
+// ocelot includes
+#include <ocelot/executive/interface/KernelCache.h>
+#include <ocelot/api/interface/OcelotConfiguration.h>
+
+// hydrazine includes
+#include <hydrazine/implementation/debug.h>
+#include <hydrazine/interface/Version.h>
+
+// Standard library includes
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdio>
+
+// Linux includes
+#include <unistd.h>
+#include <dirent.h>
+#include <utime.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#ifdef REPORT_BASE
+#undef REPORT_BASE
+#endif
+
+// Turn on report messages
+#define REPORT_BASE 0
+
+// Files in the cache directory that hold entries end with this
+#define KERNEL_CACHE_SUFFIX ".ocelot"
+
+namespace executive
+{
+	/*! \brief A cache file and its last use */
+	class CacheFile
+	{
+		public:
+			std::string path;
+			time_t used;
+			size_t bytes;
+
+		public:
+			bool operator<(const CacheFile& file) const
+			{
+				return used < file.used;
+			}
+	};
+
+	typedef std::vector<CacheFile> CacheFileVector;
+
+	static std::string directory()
+	{
+		return api::OcelotConfiguration::get().executive.kernelCache;
+	}
+
+	static std::string versioned(const std::string& description)
+	{
+		hydrazine::Version version;
+		return version.toString() + "\n" + description;
+	}
+
+	/*! \brief 64-bit FNV-1a */
+	static unsigned long long fnv(const std::string& string)
+	{
+		unsigned long long hash = 14695981039346656037ull;
+		for(std::string::const_iterator c = string.begin();
+			c != string.end(); ++c)
+		{
+			hash ^= (unsigned char)*c;
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	/*! \brief 64-bit djb2, only used to detect collisions of fnv */
+	static unsigned long long djb2(const std::string& string)
+	{
+		unsigned long long hash = 5381;
+		for(std::string::const_iterator c = string.begin();
+			c != string.end(); ++c)
+		{
+			hash = hash * 33 + (unsigned char)*c;
+		}
+		return hash;
+	}
+
+	/*! \brief Create a directory and all of its parents */
+	static void makeDirectory(const std::string& path)
+	{
+		for(std::string::size_type slash = path.find('/', 1);
+			slash != std::string::npos; slash = path.find('/', slash + 1))
+		{
+			mkdir(path.substr(0, slash).c_str(), 0755);
+		}
+		mkdir(path.c_str(), 0755);
+	}
+
+	bool KernelCache::enabled()
+	{
+		return !directory().empty();
+	}
+
+	bool KernelCache::load(const std::string& description, std::string& data)
+	{
+		if(!enabled()) return false;
+
+		std::string path = _path(description);
+		std::ifstream file(path.c_str(), std::ios::binary);
+
+		if(!file.is_open())
+		{
+			report("Kernel cache miss for " << path);
+			return false;
+		}
+
+		std::string header;
+		std::getline(file, header);
+
+		if(header != _header(description))
+		{
+			report("Kernel cache collision for " << path);
+			return false;
+		}
+
+		std::stringstream contents;
+		contents << file.rdbuf();
+		data = contents.str();
+
+		// refresh the last use for eviction
+		utime(path.c_str(), 0);
+
+		report("Kernel cache hit for " << path << " (" << data.size()
+			<< " bytes)");
+
+		return true;
+	}
+
+	void KernelCache::store(const std::string& description,
+		const std::string& data)
+	{
+		if(!enabled()) return;
+
+		makeDirectory(directory());
+
+		std::string path = _path(description);
+
+		// kernels are stored from several translation threads at once
+		static unsigned int stores = 0;
+
+		std::stringstream temporary;
+		temporary << path << "." << getpid() << "."
+			<< __sync_fetch_and_add(&stores, 1) << ".tmp";
+
+		{
+			std::ofstream file(temporary.str().c_str(), std::ios::binary);
+
+			if(!file.is_open())
+			{
+				report("Failed to open " << temporary.str()
+					<< " for the kernel cache.");
+				return;
+			}
+
+			file << _header(description) << "\n";
+			file.write(data.data(), data.size());
+
+			if(!file.good())
+			{
+				file.close();
+				std::remove(temporary.str().c_str());
+				return;
+			}
+		}
+
+		if(std::rename(temporary.str().c_str(), path.c_str()) != 0)
+		{
+			std::remove(temporary.str().c_str());
+			return;
+		}
+
+		report("Stored " << data.size() << " bytes in kernel cache entry "
+			<< path);
+
+		_evict();
+	}
+
+	std::string KernelCache::fingerprint(const std::string& data)
+	{
+		std::stringstream stream;
+
+		stream << data.size() << "-" << std::hex << std::setw(16)
+			<< std::setfill('0') << fnv(data);
+
+		return stream.str();
+	}
+
+	std::string KernelCache::_path(const std::string& description)
+	{
+		std::stringstream path;
+
+		path << directory() << "/" << std::hex << std::setw(16)
+			<< std::setfill('0') << fnv(versioned(description))
+			<< KERNEL_CACHE_SUFFIX;
+
+		return path.str();
+	}
+
+	std::string KernelCache::_header(const std::string& description)
+	{
+		std::string versionedDescription = versioned(description);
+		std::stringstream header;
+
+		header << "ocelot-kernel-cache " << versionedDescription.size() << " "
+			<< std::hex << djb2(versionedDescription);
+
+		return header.str();
+	}
+
+	void KernelCache::_evict()
+	{
+		size_t limit = (size_t)std::max(0,
+			api::OcelotConfiguration::get().executive.kernelCacheSize)
+			* 1024 * 1024;
+
+		DIR* dir = opendir(directory().c_str());
+		if(dir == 0) return;
+
+		CacheFileVector files;
+		size_t total = 0;
+		std::string suffix = KERNEL_CACHE_SUFFIX;
+
+		for(struct dirent* entry = readdir(dir); entry != 0;
+			entry = readdir(dir))
+		{
+			std::string name = entry->d_name;
+
+			if(name.size() <= suffix.size()) continue;
+			if(name.compare(name.size() - suffix.size(), suffix.size(),
+				suffix) != 0) continue;
+
+			CacheFile file;
+			file.path = directory() + "/" + name;
+
+			struct stat status;
+			if(stat(file.path.c_str(), &status) != 0) continue;
+
+			file.used = status.st_mtime;
+			file.bytes = status.st_size;
+			total += file.bytes;
+
+			files.push_back(file);
+		}
+
+		closedir(dir);
+
+		if(total <= limit) return;
+
+		std::sort(files.begin(), files.end());
+
+		for(CacheFileVector::iterator file = files.begin();
+			file != files.end() && total > limit; ++file)
+		{
+			report("Evicting kernel cache entry " << file->path);
+			if(std::remove(file->path.c_str()) == 0) total -= file->bytes;
+		}
+	}
+}
+
+#endif
+
@@ -10,10 +10,14 @@
 #include <ocelot/executive/interface/LLVMExecutableKernel.h>
 #include <ocelot/executive/interface/TextureOperations.h>
 #include <ocelot/executive/interface/Device.h>
+#include <ocelot/executive/interface/WorkerAffinity.h>
+#include <ocelot/executive/interface/KernelCache.h>
+#include <ocelot/executive/interface/CtaSampler.h>
 #include <ocelot/translator/interface/PTXToLLVMTranslator.h>
 #include <ocelot/ir/interface/Module.h>
 #include <ocelot/analysis/interface/RemoveBarrierPass.h>
 #include <ocelot/analysis/interface/ConvertPredicationToSelectPass.h>
+#include <ocelot/api/interface/OcelotConfiguration.h>
 #include <fstream>
 
 #include <hydrazine/implementation/macros.h>
@@ -40,6 +44,23 @@
 #define DEBUG_PTX_BASIC_BLOCK_TRACE 1
 #define DEBUG_LLVM 0
 
+// A worker takes this fraction of its remaining CTAs at a time
+#define CTA_CHUNK_DIVISOR 4
+
+// Spin this many times waiting for a launch or completion before parking
+#define LAUNCH_SPIN_ITERATIONS 1024
+
+// Grids with more CTAs than this are always walked in row-major order
+#define CTA_TRAVERSAL_LIMIT ( 1 << 22 )
+
+// Stop specializing a kernel after this many distinct launch values per
+// variant without a variant being compiled
+#define SPECIALIZATION_KEY_FACTOR 4
+
+// The alignment of the shared memory that follows local memory in a
+// worker arena, the same as the alignment of a new allocation
+#define WORKER_ARENA_ALIGNMENT 16
+
 #include <configure.h>
 
 #ifdef HAVE_LLVM
@@ -59,9 +80,22 @@
 #include <llvm/Target/TargetData.h>
 #include <llvm/Target/TargetSelect.h>
 #include <llvm/Transforms/Scalar.h>
+#include <llvm/Transforms/IPO.h>
+#include <llvm/Bitcode/ReaderWriter.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Linker.h>
+#include <llvm/Support/Threading.h>
+#include <llvm/Instructions.h>
+#include <llvm/Constants.h>
+#include <llvm/Metadata.h>
 #endif
 
 #include <unordered_set>
+#include <algorithm>
+#include <cstdlib>
+#include <cxxabi.h>
 
 #include <ocelot/executive/implementation/LLVMRuntimeLibrary.inl>
 
@@ -72,9 +106,29 @@ namespace executive
 
 	LLVMExecutableKernel::ExecutionManager LLVMExecutableKernel::_manager;
 
+	LLVMExecutableKernel::ThreadState::ThreadState() : context( 0 ), 
+		runtime( 0 )
+	{
+		#ifdef HAVE_LLVM
+		context = new llvm::LLVMContext;
+		#endif
+	}
+	
+	LLVMExecutableKernel::ThreadState::~ThreadState()
+	{
+		#ifdef HAVE_LLVM
+		SerialLock serial;
+		
+		delete runtime;
+		delete context;
+		#endif
+	}
+
 	LLVMExecutableKernel::LLVMState::LLVMState()		
 	{
 		jit = 0;
+		runtime = 0;
+		multithreaded = false;
 	}
 	
 	void LLVMExecutableKernel::LLVMState::initialize()
@@ -84,6 +138,10 @@ namespace executive
 		{
 			report( "Bringing the LLVM JIT-Compiler online." );
 
+			multithreaded = llvm::llvm_start_multithreaded();
+			report( " Kernels are translated " << ( multithreaded 
+				? "concurrently." : "one at a time." ) );
+
 			module = new llvm::Module( "Ocelot-LLVM-JIT-Blank Module", 
 				llvm::getGlobalContext() );
 			assertM( module != 0, "Creating global module failed." );
@@ -94,12 +152,166 @@ namespace executive
 			llvm::DebugFlag = true;
 			#endif
 			
-			jit = llvm::EngineBuilder( module ).create();
-			jit->DisableLazyCompilation( true );
-		
+			const api::OcelotConfiguration::Executive& configuration = 
+				api::OcelotConfiguration::get().executive;
+			
+			std::string cpu = configuration.jitCpu;
+			if( cpu == "host" ) cpu = llvm::sys::getHostCPUName();
+			
+			std::vector< std::string > attributes;
+			std::stringstream attributeList( configuration.jitAttributes );
+			std::string attribute;
+			while( std::getline( attributeList, attribute, ',' ) )
+			{
+				if( !attribute.empty() ) attributes.push_back( attribute );
+			}
+			
+			llvm::CodeGenOpt::Level level = llvm::CodeGenOpt::Default;
+			switch( configuration.jitOptimizationLevel )
+			{
+				case 0: level = llvm::CodeGenOpt::None; break;
+				case 1: level = llvm::CodeGenOpt::Less; break;
+				case 2: level = llvm::CodeGenOpt::Default; break;
+				default: level = llvm::CodeGenOpt::Aggressive; break;
+			}
+			
+			report( " Generating code for cpu \"" << cpu << "\" with \"" 
+				<< configuration.jitAttributes << "\" at level " 
+				<< configuration.jitOptimizationLevel );
+			
+			llvm::EngineBuilder builder( module );
+			
+			builder.setEngineKind( llvm::EngineKind::JIT );
+			builder.setOptLevel( level );
+			builder.setMCPU( cpu );
+			builder.setMAttrs( attributes );
+			
+			jit = builder.create();
 			assertM( jit != 0, "Creating the JIT failed.");
+			
+			jit->DisableLazyCompilation( true );
 			report( " The JIT is alive." );
+			
+			_loadRuntime();
+		}
+		#endif
+	}
+	
+	void LLVMExecutableKernel::LLVMState::_loadRuntime()
+	{
+		#ifdef HAVE_LLVM
+		const api::OcelotConfiguration::Executive& configuration = 
+			api::OcelotConfiguration::get().executive;
+		
+		if( !configuration.inlineRuntime ) return;
+		
+		std::string path = configuration.runtimeLibrary;
+		#ifdef OCELOT_RUNTIME_BITCODE
+		if( path.empty() ) path = OCELOT_RUNTIME_BITCODE;
+		#endif
+		
+		if( path.empty() )
+		{
+			std::cerr << "==Ocelot== WARNING: inlineRuntime is set but the "
+				"runtime library was not compiled to bitcode, translated "
+				"kernels will call it.\n";
+			return;
+		}
+		
+		std::ifstream file( path.c_str(), std::ios::binary );
+		
+		if( !file.is_open() )
+		{
+			std::cerr << "==Ocelot== WARNING: Failed to open the runtime "
+				"library bitcode " << path 
+				<< ", translated kernels will call it.\n";
+			return;
+		}
+		
+		std::stringstream contents;
+		contents << file.rdbuf();
+		runtimeBitcode = contents.str();
+		
+		runtime = _parseRuntime( llvm::getGlobalContext() );
+		
+		if( runtime == 0 )
+		{
+			std::cerr << "==Ocelot== WARNING: Failed to parse the runtime "
+				"library bitcode " << path 
+				<< ", translated kernels will call it.\n";
+			runtimeBitcode.clear();
+			return;
+		}
+		
+		runtimeVersion = KernelCache::fingerprint( runtimeBitcode );
+		
+		report( " Loaded the runtime library bitcode " << path << " (" 
+			<< runtimeBitcode.size() << " bytes)." );
+		#endif
+	}
+	
+	llvm::Module* LLVMExecutableKernel::LLVMState::_parseRuntime( 
+		llvm::LLVMContext& context )
+	{
+		#ifdef HAVE_LLVM
+		std::string error;
+		
+		llvm::MemoryBuffer* buffer = llvm::MemoryBuffer::getMemBufferCopy( 
+			llvm::StringRef( runtimeBitcode ), "runtime" );
+		llvm::Module* library = llvm::ParseBitcodeFile( buffer, context, 
+			&error );
+		delete buffer;
+		
+		if( library == 0 )
+		{
+			report( "  Parsing the runtime library failed: " << error );
+			return 0;
 		}
+		
+		// the static constructors were already run for the copy of the 
+		//  runtime in this library
+		llvm::GlobalVariable* constructors = library->getGlobalVariable( 
+			"llvm.global_ctors" );
+		if( constructors != 0 ) constructors->eraseFromParent();
+		
+		return library;
+		#else
+		return 0;
+		#endif
+	}
+	
+	LLVMExecutableKernel::ThreadState& 
+		LLVMExecutableKernel::LLVMState::thread()
+	{
+		ThreadState* state = threads.get();
+		
+		if( state == 0 )
+		{
+			state = new ThreadState;
+			threads.reset( state );
+		}
+		
+		return *state;
+	}
+	
+	llvm::Module* LLVMExecutableKernel::LLVMState::runtimeFor( 
+		llvm::LLVMContext& context )
+	{
+		#ifdef HAVE_LLVM
+		if( &context == &llvm::getGlobalContext() ) return runtime;
+		
+		ThreadState& state = thread();
+		assertM( &context == state.context, 
+			"Module is not in the context of the translating thread." );
+		
+		if( state.runtime == 0 && !runtimeBitcode.empty() )
+		{
+			state.runtime = _parseRuntime( context );
+		}
+		
+		return state.runtime;
+		#else
+		return 0;
 		#endif
 	}
 	
@@ -117,6 +329,12 @@ namespace executive
 	
 	}
 
+	LLVMExecutableKernel::SerialLock::SerialLock() : _lock( 
+		_state.serialMutex, boost::defer_lock )
+	{
+		if( !_state.multithreaded ) _lock.lock();
+	}
+
 	void LLVMExecutableKernel::AtomicOperationCache::lock()
 	{
 		_mutex.lock();
@@ -127,552 +345,1941 @@ namespace executive
 		_mutex.unlock();
 	}
 
-	LLVMExecutableKernel::Worker::Message::Message( Type t, 
-		Function f, LLVMContext* c, unsigned int xb, unsigned int xe, 
-		unsigned int s, unsigned int rp ) : type( t ), function( f ), context( c ), 
-		begin( xb ), end( xe ), step( s ), resumePointOffset( rp )
+	LLVMExecutableKernel::WorkerStatistics::WorkerStatistics() : busy( 0.0 ),
+		idle( 0.0 ), ctas( 0 ), steals( 0 ), launches( 0 ), startLatency( 0.0 ),
+		arenaGrowths( 0 )
 	{
 	
 	}
 
-	void LLVMExecutableKernel::Worker::execute()
+	LLVMExecutableKernel::CtaScheduler::CtaScheduler() : _active( 0 ), 
+		_chunkDivisor( CTA_CHUNK_DIVISOR )
 	{
-		Message* message;
-		
-		threadReceive( message );
-		
-		while( message->type != Message::Kill )
+	
+	}
+
+	LLVMExecutableKernel::CtaScheduler::~CtaScheduler()
+	{
+		setWorkers( 0 );
+	}
+
+	bool LLVMExecutableKernel::CtaScheduler::_steal( unsigned int worker )
+	{
+		while( true )
 		{
-			if( message->type == Message::LaunchKernelWithBarriers )
+			unsigned int victim = worker;
+			unsigned int largest = 0;
+			
+			for( unsigned int i = 0; i < _ranges.size(); ++i )
 			{
-				launchKernelWithBarriers( message->function, message->context, 
-					message->begin, message->end, message->step,
-					message->resumePointOffset );
+				if( i == worker ) continue;
+				_ranges[ i ].mutex->lock();
+				unsigned int remaining = _ranges[ i ].end - _ranges[ i ].begin;
+				_ranges[ i ].mutex->unlock();
+				
+				if( remaining > largest )
+				{
+					largest = remaining;
+					victim = i;
+				}
 			}
-			else
+			
+			if( largest == 0 ) return false;
+			
+			Range& range = _ranges[ victim ];
+			range.mutex->lock();
+			
+			// the victim may have drained its range since the scan
+			if( range.begin == range.end )
 			{
-				assertM( message->type == Message::LaunchKernelWithoutBarriers,
-					"Invalid message type received by worker thread." );
-				launchKernelWithoutBarriers( message->function, 
-					message->context, message->begin, message->end,
-					message->step );				
+				range.mutex->unlock();
+				continue;
 			}
-			message->type = Message::Acknowledgement;
-			threadSend( message );
-			threadReceive( message );
+			
+			unsigned int begin = range.begin + ( range.end - range.begin ) / 2;
+			unsigned int end = range.end;
+			range.end = begin;
+			range.mutex->unlock();
+
+			reportE( REPORT_CTA_INSIDE_TRANSLATED_CODE, "  Worker " << worker 
+				<< " stole CTAs [" << begin << ", " << end 
+				<< ") from worker " << victim );
+
+			Range& own = _ranges[ worker ];
+			own.mutex->lock();
+			own.begin = begin;
+			own.end = end;
+			own.mutex->unlock();
+			
+			++_statistics[ worker ].steals;
+			return true;
 		}
-		message->type = Message::Acknowledgement;
-		threadSend( message );
 	}
 
-	void LLVMExecutableKernel::Worker::launchKernelWithBarriers( 
-		Function f, LLVMContext* c, unsigned int begin, unsigned int end, 
-		unsigned int step, unsigned int rp )
+	void LLVMExecutableKernel::CtaScheduler::setWorkers( unsigned int workers )
 	{
-		for( unsigned int i = begin; i < end; i += step )
+		for( RangeVector::iterator range = _ranges.begin(); 
+			range != _ranges.end(); ++range )
 		{
-			c->ctaid.x = i % c->nctaid.x;
-			c->ctaid.y = i / c->nctaid.x;
-			reportE( REPORT_CTA_INSIDE_TRANSLATED_CODE,
-				"  Launching CTA ( x " << (unsigned int) c->ctaid.x << ", y " 
-				<< (unsigned int) c->ctaid.y << " )" );
-			launchCtaWithBarriers( f, c, rp );
+			delete range->mutex;
 		}
-	}
-
-	void LLVMExecutableKernel::Worker::launchKernelWithoutBarriers( 
-		Function f, LLVMContext* c, unsigned int begin, 
-		unsigned int end, unsigned int step )
-	{
-		for( unsigned int i = begin; i < end; i += step )
+		
+		_ranges.resize( workers );
+		
+		for( RangeVector::iterator range = _ranges.begin(); 
+			range != _ranges.end(); ++range )
 		{
-			c->ctaid.x = i % c->nctaid.x;
-			c->ctaid.y = i / c->nctaid.x;
-			reportE( REPORT_CTA_INSIDE_TRANSLATED_CODE,
-				"  Launching CTA ( x " << (unsigned int) c->ctaid.x << ", y " 
-				<< (unsigned int) c->ctaid.y << " )" );
-			launchCtaWithoutBarriers( f, c );
+			range->mutex = new boost::mutex;
+			range->begin = 0;
+			range->end = 0;
 		}
+		
+		_statistics.assign( workers, WorkerStatistics() );
 	}
-
-	void LLVMExecutableKernel::Worker::launchCtaWithBarriers( 
-		Function function, LLVMContext* c, unsigned int resumePointOffset )
+	
+	void LLVMExecutableKernel::CtaScheduler::reset( unsigned int ctas, 
+		unsigned int workers, unsigned int chunkDivisor )
 	{
-		char* localBase = c->local;
-		bool done = false;
-		unsigned int threads = c->ntid.z * c->ntid.y * c->ntid.x;
+		_active = _ranges.size();
+		if( workers != 0 ) _active = std::min( workers, _active );
 		
-		for( unsigned int i = 0; i < threads; ++i )
-		{
-			(*(unsigned int*)(localBase
-				+ i * c->localSize + resumePointOffset)) = 0;
-		}
+		_chunkDivisor = chunkDivisor == 0 ? CTA_CHUNK_DIVISOR : chunkDivisor;
 		
-		while( !done )
+		long long unsigned int active = _active;
+		long long unsigned int total = ctas;
+		
+		for( unsigned int i = 0; i < _ranges.size(); ++i )
 		{
-			done = true;
-			for( unsigned short z = 0; z < c->ntid.z; ++z )
+			if( i < _active )
 			{
-				c->tid.z = z;
-				for( unsigned short y = 0; y < c->ntid.y; ++y )
-				{
-					c->tid.y = y;
-					for( unsigned short x = 0; x < c->ntid.x; ++x )
-					{
-						c->tid.x = x;
-						c->local = localBase + c->localSize * threadId( *c );
-						reportE( REPORT_INSIDE_TRANSLATED_CODE,
-							"  Launching thread ( x " << x << ", y " << y 
-							<< ", z " << z << " )" << " at resume point " 
-							<< *((unsigned int*)(c->local 
-							+ resumePointOffset)) );
-						unsigned int resume = function( c );
-						done &= resume == 0;
-						*((unsigned int*)(c->local 
-							+ resumePointOffset)) = resume;
-						reportE( REPORT_INSIDE_TRANSLATED_CODE, 
-							"   Thread blocked at " << resume );
-					}
-				}
+				_ranges[ i ].begin = ( total * i ) / active;
+				_ranges[ i ].end = ( total * ( i + 1 ) ) / active;
+			}
+			else
+			{
+				_ranges[ i ].begin = 0;
+				_ranges[ i ].end = 0;
 			}
 		}
-
-		c->local = localBase;
 	}
-
-	void LLVMExecutableKernel::Worker::launchCtaWithoutBarriers( 
-		Function function, LLVMContext* c )
+	
+	bool LLVMExecutableKernel::CtaScheduler::active( 
+		unsigned int worker ) const
 	{
-		char* localBase = c->local;
-		bool done = true;
-		for( unsigned short z = 0; z < c->ntid.z; ++z )
+		return worker < _active;
+	}
+	
+	bool LLVMExecutableKernel::CtaScheduler::next( unsigned int worker, 
+		unsigned int& begin, unsigned int& end )
+	{
+		Range& range = _ranges[ worker ];
+	
+		do
 		{
-			c->tid.z = z;
-			for( unsigned short y = 0; y < c->ntid.y; ++y )
+			range.mutex->lock();
+			
+			if( range.begin != range.end )
 			{
-				c->tid.y = y;
-				for( unsigned short x = 0; x < c->ntid.x; ++x )
-				{
-					c->tid.x = x;
-					reportE( REPORT_INSIDE_TRANSLATED_CODE, 
-						"  Launching thread ( x " << x << ", y " << y 
-						<< ", z " << z << " )" );
-					c->local = localBase + c->localSize * threadId( *c );
-					unsigned int resume = function( c );
-					done &= resume == 0;
-					reportE( REPORT_INSIDE_TRANSLATED_CODE, 
-						"   Thread blocked at " << resume );
-				}
+				unsigned int chunk = std::max( 
+					( range.end - range.begin ) / _chunkDivisor, 1u );
+				begin = range.begin;
+				end = begin + chunk;
+				range.begin = end;
+				range.mutex->unlock();
+				return true;
 			}
-		}	
-
-		c->local = localBase;		
-		assertM( done, 
-			"Not all threads finished in kernel with no context switches" );
+			
+			range.mutex->unlock();
+		}
+		while( _steal( worker ) );
+		
+		return false;
 	}
 	
-	LLVMExecutableKernel::ExecutionManager::ExecutionManager() 
-		: _maxThreadsPerCta( 512 )
+	LLVMExecutableKernel::WorkerStatistics& 
+		LLVMExecutableKernel::CtaScheduler::statistics( unsigned int worker )
 	{
+		return _statistics[ worker ];
+	}
 	
+	const LLVMExecutableKernel::WorkerStatisticsVector& 
+		LLVMExecutableKernel::CtaScheduler::statistics() const
+	{
+		return _statistics;
 	}
 
-	LLVMExecutableKernel::ExecutionManager::~ExecutionManager()
+	static void mortonPosition( unsigned int d, unsigned int side, 
+		unsigned int& x, unsigned int& y )
 	{
-		report( "Tearing down " << threads() << " LLVM worker threads." );
-		clear();
+		x = 0;
+		y = 0;
+		
+		for( unsigned int bit = 0; ( 1u << bit ) < side; ++bit )
+		{
+			x |= ( ( d >> ( 2 * bit ) ) & 1 ) << bit;
+			y |= ( ( d >> ( 2 * bit + 1 ) ) & 1 ) << bit;
+		}
 	}
 
-	void LLVMExecutableKernel::ExecutionManager::launch( Function f, 
-		LLVMContext* c, bool barriers, unsigned int resumePointOffset,
-		unsigned int externalSharedMemory )
+	static void hilbertPosition( unsigned int d, unsigned int side, 
+		unsigned int& x, unsigned int& y )
 	{
-		if( threads() == 0 ) setThreadCount( 1 );
-		for( ContextVector::iterator context = _contexts.begin(); 
-			context != _contexts.end(); ++context )
+		x = 0;
+		y = 0;
+		
+		for( unsigned int s = 1; s < side; s *= 2 )
 		{
-			if( c->localSize > context->localSize )
-			{
-				delete[] context->local;
-				context->localSize = c->localSize;
-				context->local 
-					= new char[ context->localSize * _maxThreadsPerCta ];
-			}
-
-			if( c->sharedSize + externalSharedMemory > context->sharedSize )
+			unsigned int rx = 1 & ( d / 2 );
+			unsigned int ry = 1 & ( d ^ rx );
+			
+			if( ry == 0 )
 			{
-				delete[] context->shared;
-				context->sharedSize = c->sharedSize + externalSharedMemory;
-				context->shared = new char[ context->sharedSize ];
+				if( rx == 1 )
+				{
+					x = s - 1 - x;
+					y = s - 1 - y;
+				}
+				std::swap( x, y );
 			}
 			
-			context->nctaid = c->nctaid;
-			context->ntid = c->ntid;
+			x += s * rx;
+			y += s * ry;
+			d /= 4;
+		}
+	}
 
-			context->constant = c->constant;
-			context->parameter = c->parameter;
-			context->constantSize = c->constantSize;
-			context->parameterSize = c->parameterSize;
+	LLVMExecutableKernel::CtaTraversal::CtaTraversal() : 
+		_order( RowMajorOrder ), _tile( 0 ), _x( 0 ), _y( 0 ), 
+		_sampled( false )
+	{
+	
+	}
 
-			context->other = c->other;
-		}
-		
-		unsigned int step = _workers.size();
-		unsigned int begin = 0;
-		
-		MessageVector::iterator message = _messages.begin();
-		for( WorkerVector::iterator worker = _workers.begin(); 
-			worker != _workers.end(); ++worker, ++message, ++begin )
+	void LLVMExecutableKernel::CtaTraversal::_buildTiled()
+	{
+		for( unsigned int ty = 0; ty < _y; ty += _tile )
 		{
-			if( barriers )
-			{
-				message->type = Worker::Message::LaunchKernelWithBarriers;
-				message->resumePointOffset = resumePointOffset;
-			}
-			else
+			for( unsigned int tx = 0; tx < _x; tx += _tile )
 			{
-				message->type = Worker::Message::LaunchKernelWithoutBarriers;
+				unsigned int yEnd = std::min( ty + _tile, _y );
+				unsigned int xEnd = std::min( tx + _tile, _x );
+				
+				for( unsigned int y = ty; y < yEnd; ++y )
+				{
+					for( unsigned int x = tx; x < xEnd; ++x )
+					{
+						Position position = { (unsigned short) x, 
+							(unsigned short) y };
+						_positions.push_back( position );
+					}
+				}
 			}
-			
-			message->function = f;
-			message->begin = begin;
-			message->end = (unsigned int) c->nctaid.x * c->nctaid.y;
-			message->step = step;
-			
-			worker->send( &(*message) );
 		}
+	}
 
-		for( WorkerVector::iterator worker = _workers.begin(); 
-			worker != _workers.end(); ++worker )
+	void LLVMExecutableKernel::CtaTraversal::_buildCurve()
+	{
+		// cut the grid into squares covering the short side and walk the
+		// squares along the long side, skipping points outside of the grid
+		bool wide = _x >= _y;
+		unsigned int shortSide = wide ? _y : _x;
+		unsigned int longSide = wide ? _x : _y;
+		
+		unsigned int side = 1;
+		while( side < shortSide ) side *= 2;
+		
+		for( unsigned int offset = 0; offset < longSide; offset += side )
 		{
-			Worker::Message* message;
-			worker->receive( message );
-			assert( message->type == Worker::Message::Acknowledgement );
+			for( unsigned int d = 0; d < side * side; ++d )
+			{
+				unsigned int a = 0;
+				unsigned int b = 0;
+				
+				if( _order == MortonOrder )
+				{
+					mortonPosition( d, side, a, b );
+				}
+				else
+				{
+					hilbertPosition( d, side, a, b );
+				}
+				
+				unsigned int x = wide ? offset + a : a;
+				unsigned int y = wide ? b : offset + b;
+				
+				if( x >= _x || y >= _y ) continue;
+				
+				Position position = { (unsigned short) x, 
+					(unsigned short) y };
+				_positions.push_back( position );
+			}
 		}
-		
 	}
-	
-	void LLVMExecutableKernel::ExecutionManager::setThreadCount( 
-		unsigned int t )
-	{
-		if( t == threads() ) return;
-		report( "Booting up " << t << " LLVM worker threads." );
-		clear();
 
-		_workers.resize( t );
-		_messages.resize( t );
-		_contexts.resize( t );
-
-		for( WorkerVector::iterator worker = _workers.begin(); 
-			worker != _workers.end(); ++worker )
+	void LLVMExecutableKernel::CtaTraversal::reset( CtaOrder order, 
+		unsigned int tile, unsigned int x, unsigned int y )
+	{
+		if( order == TiledOrder && tile == 0 ) tile = 1;
+		if( (long long unsigned int) x * y > CTA_TRAVERSAL_LIMIT )
 		{
-			worker->start();
+			order = RowMajorOrder;
 		}
 		
-		MessageVector::iterator message = _messages.begin();
-		for( ContextVector::iterator context = _contexts.begin(); 
-			context != _contexts.end(); ++context, ++message )
+		if( order == _order && tile == _tile && x == _x && y == _y 
+			&& !_sampled ) return;
+		
+		report( "Building CTA traversal table for a " << x << "x" << y 
+			<< " grid." );
+		
+		_order = order;
+		_tile = tile;
+		_x = x;
+		_y = y;
+		_sampled = false;
+		
+		_positions.clear();
+		
+		if( _order == RowMajorOrder ) return;
+		
+		_positions.reserve( _x * _y );
+		
+		if( _order == TiledOrder )
 		{
-			context->localSize = 0;
-			context->sharedSize = 0;
-			context->local = 0;
-			context->shared = 0;
-			message->context = &(*context);
+			_buildTiled();
+		}
+		else
+		{
+			_buildCurve();
 		}
+		
+		assert( _positions.size() == _x * _y );
 	}
 
-	void LLVMExecutableKernel::ExecutionManager::setMaxThreadsPerCta( 
-		unsigned int t )
+	void LLVMExecutableKernel::CtaTraversal::sample( const IdVector& ids,
+		unsigned int x, unsigned int y )
 	{
-		if( t > _maxThreadsPerCta )
+		report( "Sampling " << ids.size() << " CTAs of a " << x << "x" << y
+			<< " grid." );
+		
+		_x = x;
+		_y = y;
+		_sampled = true;
+		
+		_positions.clear();
+		_positions.reserve( ids.size() );
+		
+		for( IdVector::const_iterator id = ids.begin(); 
+			id != ids.end(); ++id )
 		{
-			for( ContextVector::iterator context = _contexts.begin(); 
-				context != _contexts.end(); ++context )
-			{
-				delete context->local;
-				context->local = new char[ context->localSize * t ];
-			}
+			Position position = { (unsigned short) ( *id % x ), 
+				(unsigned short) ( *id / x ) };
+			_positions.push_back( position );
 		}
-		_maxThreadsPerCta = t;
 	}
-	
-	void LLVMExecutableKernel::ExecutionManager::clear()
+
+	void LLVMExecutableKernel::CtaTraversal::map( unsigned int position, 
+		LLVMContext* c ) const
 	{
-		MessageVector::iterator message = _messages.begin();
-		for( WorkerVector::iterator worker = _workers.begin(); 
-			worker != _workers.end(); ++worker, ++message )
+		if( _positions.empty() )
 		{
-			message->type = Worker::Message::Kill;
-			worker->send( &(*message) );
-			Worker::Message* ack;
-			worker->receive( ack );
-			assert( ack->type == Worker::Message::Acknowledgement );
-			worker->join();
+			c->ctaid.x = position % c->nctaid.x;
+			c->ctaid.y = position / c->nctaid.x;
 		}
-		
-		_workers.clear();
-		_messages.clear();
-
-		for( ContextVector::iterator context = _contexts.begin(); 
-			context != _contexts.end(); ++context )
+		else
 		{
-			delete[] context->local;
-			delete[] context->shared;
+			c->ctaid.x = _positions[ position ].x;
+			c->ctaid.y = _positions[ position ].y;
 		}
-		_contexts.clear();
 	}
 
-	unsigned int LLVMExecutableKernel::ExecutionManager::threads() const
+	LLVMExecutableKernel::LaunchControl::LaunchControl() : _epoch( 0 ), 
+		_remaining( 0 ), _parkedWorkers( 0 ), _parkedManager( 0 )
 	{
-		return _workers.size();
-	}
 	
-	LLVMExecutableKernel::OpaqueState::OpaqueState()
+	}
+
+	unsigned int LLVMExecutableKernel::LaunchControl::epoch() const
+	{
+		return _epoch;
+	}
+
+	void LLVMExecutableKernel::LaunchControl::launch( unsigned int workers )
 	{
+		if( workers == 0 ) return;
+		
+		_remaining = workers;
 		timer.start();
+		
+		// the full barrier publishes the launch descriptors with the epoch,
+		// and orders the epoch before the check for parked workers
+		__sync_fetch_and_add( &_epoch, 1 );
+		
+		if( _parkedWorkers != 0 )
+		{
+			boost::mutex::scoped_lock lock( _mutex );
+			_launched.notify_all();
+		}
+		
+		for( unsigned int i = 0; i < LAUNCH_SPIN_ITERATIONS; ++i )
+		{
+			if( _remaining == 0 ) break;
+			boost::this_thread::yield();
+		}
+		
+		if( _remaining != 0 )
+		{
+			boost::mutex::scoped_lock lock( _mutex );
+			__sync_fetch_and_add( &_parkedManager, 1 );
+			while( _remaining != 0 ) _finished.wait( lock );
+			__sync_fetch_and_sub( &_parkedManager, 1 );
+		}
+		
+		__sync_synchronize();
+		timer.stop();
 	}
 	
-	unsigned int LLVMExecutableKernel::_pad( size_t& size, 
-		unsigned int alignment )
+	unsigned int LLVMExecutableKernel::LaunchControl::wait( unsigned int epoch )
 	{
-		unsigned int padding = alignment - ( size % alignment );
-		padding = ( alignment == padding ) ? 0 : padding;
-		size += padding;
-		return padding;
+		for( unsigned int i = 0; i < LAUNCH_SPIN_ITERATIONS; ++i )
+		{
+			if( _epoch != epoch ) break;
+			boost::this_thread::yield();
+		}
+		
+		if( _epoch == epoch )
+		{
+			boost::mutex::scoped_lock lock( _mutex );
+			__sync_fetch_and_add( &_parkedWorkers, 1 );
+			while( _epoch == epoch ) _launched.wait( lock );
+			__sync_fetch_and_sub( &_parkedWorkers, 1 );
+		}
+		
+		// do not read the launch descriptor before the epoch
+		__sync_synchronize();
+		return _epoch;
 	}
 	
-	std::string LLVMExecutableKernel::threadIdString( const LLVMContext& c )
+	void LLVMExecutableKernel::LaunchControl::finish()
 	{
-		std::stringstream stream;
+		// the full barrier orders the countdown before the check for a 
+		// parked launching thread
+		if( __sync_sub_and_fetch( &_remaining, 1 ) != 0 ) return;
 		
-		unsigned int id = threadId( c );
-		stream << id;
-		return stream.str();
+		if( _parkedManager != 0 )
+		{
+			boost::mutex::scoped_lock lock( _mutex );
+			_finished.notify_all();
+		}
 	}
 
-	unsigned int LLVMExecutableKernel::threadId( const LLVMContext& c )
+	LLVMExecutableKernel::Worker::Message::Message( Type t, 
+		Function f, LLVMContext* c, CtaScheduler* s, const CtaTraversal* o, 
+		unsigned int i, unsigned int rp ) : type( t ), function( f ), 
+		bundle( 0 ), bundleWidth( 1 ), context( c ), arena( 0 ), 
+		scheduler( s ), traversal( o ), id( i ), resumePointOffset( rp ), 
+		maxThreadsPerCta( 0 )
 	{
-		return c.ntid.x * c.ntid.y * c.tid.z + c.ntid.x * c.tid.y + c.tid.x;
+	
 	}
 
-	void LLVMExecutableKernel::_optimizePtx()
+	LLVMExecutableKernel::WorkerArena::WorkerArena() : _base( 0 ), 
+		_capacity( 0 )
 	{
-		report( " Running PTX optimizer" );
-
-		report( "  Building dataflow graph." );
-		_ptx->dfg();
+	
+	}
 
-		analysis::ConvertPredicationToSelectPass pass1;
-		report( "  Running convert predicate to conditional select" );
-		
-		pass1.initialize( *module );
-		pass1.runOnKernel( *_ptx );
-		pass1.finalize();
+	char* LLVMExecutableKernel::WorkerArena::reserve( size_t bytes )
+	{
+		if( bytes <= _capacity ) return _base;
 		
-		report( "  Running remove barrier pass." );
+		size_t capacity = std::max( bytes, 2 * _capacity );
 		
-		reportE( REPORT_ALL_PTX_SOURCE, "   Code before pass:\n" << *_ptx );
-
-		analysis::RemoveBarrierPass pass2;
+		report( "Growing worker arena from " << _capacity << " to " 
+			<< capacity << " bytes." );
 		
-		pass2.initialize( *module );
-		pass2.runOnKernel( *_ptx );
-		pass2.finalize();
+		delete[] _base;
+		_base = new char[ capacity ];
+		std::memset( _base, 0, capacity );
+		_capacity = capacity;
 		
-		_barrierSupport = pass2.barriers();
-		_resumePoint = pass2.resume();
-
-		report( "  Converting to SSA." );
-		_ptx->dfg()->toSsa();
-
-		reportE( REPORT_ALL_PTX_SOURCE, "   Code after pass:\n" << *_ptx );
+		return _base;
 	}
 
-	void LLVMExecutableKernel::_translateKernel()
+	void LLVMExecutableKernel::WorkerArena::release()
 	{
-		#ifdef HAVE_LLVM
-		if( _module == 0 )
-		{
-			report( "Translating PTX kernel \"" << name << "\" to LLVM" );
-
-			#if (PRINT_OPTIMIZED_CFG > 0) && (REPORT_BASE > 0)
-			std::ofstream file((name + "_cfg_original.dot").c_str());
-			_ptx->cfg()->write(file, _ptx->instructions);
-			file.close();
-			#endif
-			
-			_optimizePtx();
-			_buildDebuggingInformation();
-			_allocateMemory();
-
-			report( " Optimization level " << translator::Translator::toString( 
-				_optimizationLevel ) );
-			translator::PTXToLLVMTranslator translator( _optimizationLevel );
+		delete[] _base;
+		_base = 0;
+		_capacity = 0;
+	}
 
-			#if (PRINT_OPTIMIZED_CFG > 0) && (REPORT_BASE > 0)
-			file.open((name + "_cfg_optimized.dot").c_str());
-			_ptx->cfg()->write(file, _ptx->instructions);
-			file.close();
-			#endif
-							
-			report( " Running translator" );
-			ir::LLVMKernel* llvmKernel = static_cast< 
-				ir::LLVMKernel* >( translator.translate( _ptx ) );
+	size_t LLVMExecutableKernel::WorkerArena::capacity() const
+	{
+		return _capacity;
+	}
 
-			report( " Assembling llvm module" );
-			llvmKernel->assemble();
+	LLVMExecutableKernel::Worker::Worker() : _message( 0 ), _control( 0 ), 
+		_epoch( 0 )
+	{
+	
+	}
 
-			report( " Parsing llvm assembly." );
-			llvm::SMDiagnostic error;
+	void LLVMExecutableKernel::Worker::attach( Message* m, LaunchControl* c )
+	{
+		_message = m;
+		_control = c;
+		_epoch = c->epoch();
+	}
 
-			_module = new llvm::Module( name, llvm::getGlobalContext() );
-			_module = llvm::ParseAssemblyString( llvmKernel->code().c_str(), 
-				_module, error, llvm::getGlobalContext() );
+	void LLVMExecutableKernel::Worker::allocate( LLVMContext* c, 
+		WorkerArena* arena, unsigned int maxThreadsPerCta )
+	{
+		size_t local = c->localSize * maxThreadsPerCta;
+		_pad( local, WORKER_ARENA_ALIGNMENT );
+		
+		char* base = arena->reserve( local + c->sharedSize );
+		
+		c->local = base;
+		c->shared = base + local;
+	}
 
-			if( _module == 0 )
+	void LLVMExecutableKernel::Worker::execute()
+	{
+		assert( _message != 0 && _control != 0 );
+		
+		if( WorkerAffinity::enabled() )
+		{
+			WorkerAffinity::pin( _message->id );
+		}
+		
+		while( true )
+		{
+			_epoch = _control->wait( _epoch );
+			
+			Message* message = _message;
+			
+			if( message->type == Message::Kill ) break;
+			
+			assertM( message->type == Message::LaunchKernelWithBarriers 
+				|| message->type == Message::LaunchKernelWithoutBarriers
+				|| message->type == Message::LaunchKernelWithThreadLoops,
+				"Invalid message type received by worker thread." );
+			
+			CtaScheduler& scheduler = *message->scheduler;
+			
+			// workers left out of a launch still count down so that the 
+			//  launch protocol does not depend on the worker count
+			if( !scheduler.active( message->id ) )
+			{
+				_control->finish();
+				continue;
+			}
+			
+			size_t capacity = message->arena->capacity();
+			
+			allocate( message->context, message->arena, 
+				message->maxThreadsPerCta );
+			
+			WorkerStatistics& statistics = scheduler.statistics( message->id );
+			
+			if( message->arena->capacity() != capacity )
+			{
+				++statistics.arenaGrowths;
+			}
+			
+			hydrazine::Timer timer;
+			unsigned int begin = 0;
+			unsigned int end = 0;
+			bool first = true;
+			
+			++statistics.launches;
+			
+			while( scheduler.next( message->id, begin, end ) )
 			{
-				report( "  Parsing kernel failed, dumping code:\n" 
-					<< llvmKernel->numberedCode() );
-				std::string m;
-				llvm::raw_string_ostream message( m );
-				message << "LLVM Parser failed: ";
-				error.Print( name.c_str(), message );
+				if( first )
+				{
+					statistics.startLatency += _control->timer.seconds();
+					first = false;
+				}
+				
+				timer.start();
+				if( message->type == Message::LaunchKernelWithBarriers )
+				{
+					launchKernelWithBarriers( message->function, 
+						message->context, message->traversal, begin, end, 1,
+						message->resumePointOffset );
+				}
+				else if( message->type 
+					== Message::LaunchKernelWithThreadLoops )
+				{
+					launchKernelWithThreadLoops( message->function, 
+						message->context, message->traversal, begin, end, 1 );
+				}
+				else
+				{
+					launchKernelWithoutBarriers( message->function, 
+						message->context, message->traversal, begin, end, 1,
+						message->bundle, message->bundleWidth );
+				}
+				timer.stop();
 				
-				throw hydrazine::Exception( message.str() );
+				statistics.busy += timer.seconds();
+				statistics.ctas += end - begin;
 			}
+			
+			_control->finish();
+		}
+		
+		_control->finish();
+	}
 
-			#if ( REPORT_ORIGINAL_LLVM_SOURCE > 0 ) && ( REPORT_BASE > 0 )
-			std::string m;
-			llvm::raw_string_ostream code( m );
-			code << *_module;
-			report( " The initial code is:\n" << m );
-			#endif
-						
-			report( " Checking module for errors." );
-			std::string verifyError;
-			if( llvm::verifyModule( *_module, 
-				llvm::ReturnStatusAction, &verifyError ) )
-			{
-				report( "  Checking kernel failed, dumping code:\n" 
-					<< llvmKernel->numberedCode() );
-				delete llvmKernel;
+	void LLVMExecutableKernel::Worker::launchKernelWithBarriers( 
+		Function f, LLVMContext* c, const CtaTraversal* traversal, 
+		unsigned int begin, unsigned int end, unsigned int step, 
+		unsigned int rp )
+	{
+		for( unsigned int i = begin; i < end; i += step )
+		{
+			traversal->map( i, c );
+			reportE( REPORT_CTA_INSIDE_TRANSLATED_CODE,
+				"  Launching CTA ( x " << (unsigned int) c->ctaid.x << ", y " 
+				<< (unsigned int) c->ctaid.y << " )" );
+			launchCtaWithBarriers( f, c, rp );
+		}
+	}
 
-				throw hydrazine::Exception( "LLVM Verifier failed for kernel: " 
-					+ name + " : \"" + verifyError + "\"" );
-			}
+	void LLVMExecutableKernel::Worker::launchKernelWithoutBarriers( 
+		Function f, LLVMContext* c, const CtaTraversal* traversal, 
+		unsigned int begin, unsigned int end, unsigned int step,
+		Function bundle, unsigned int bundleWidth )
+	{
+		for( unsigned int i = begin; i < end; i += step )
+		{
+			traversal->map( i, c );
+			reportE( REPORT_CTA_INSIDE_TRANSLATED_CODE,
+				"  Launching CTA ( x " << (unsigned int) c->ctaid.x << ", y " 
+				<< (unsigned int) c->ctaid.y << " )" );
+			launchCtaWithoutBarriers( f, c, bundle, bundleWidth );
+		}
+	}
 
-			delete llvmKernel;
-						
-			report( " Successfully created LLVM Module from translated PTX." );
+	void LLVMExecutableKernel::Worker::launchKernelWithThreadLoops( 
+		Function f, LLVMContext* c, const CtaTraversal* traversal, 
+		unsigned int begin, unsigned int end, unsigned int step )
+	{
+		for( unsigned int i = begin; i < end; i += step )
+		{
+			traversal->map( i, c );
+			reportE( REPORT_CTA_INSIDE_TRANSLATED_CODE,
+				"  Launching CTA ( x " << (unsigned int) c->ctaid.x << ", y " 
+				<< (unsigned int) c->ctaid.y << " )" );
+			f( c );
+		}
+	}
+
+	void LLVMExecutableKernel::Worker::launchCtaWithBarriers( 
+		Function function, LLVMContext* c, unsigned int resumePointOffset )
+	{
+		char* localBase = c->local;
+		bool done = false;
+		unsigned int threads = c->ntid.z * c->ntid.y * c->ntid.x;
+		
+		for( unsigned int i = 0; i < threads; ++i )
+		{
+			(*(unsigned int*)(localBase
+				+ i * c->localSize + resumePointOffset)) = 0;
+		}
+		
+		while( !done )
+		{
+			done = true;
+			for( unsigned short z = 0; z < c->ntid.z; ++z )
+			{
+				c->tid.z = z;
+				for( unsigned short y = 0; y < c->ntid.y; ++y )
+				{
+					c->tid.y = y;
+					for( unsigned short x = 0; x < c->ntid.x; ++x )
+					{
+						c->tid.x = x;
+						c->local = localBase + c->localSize * threadId( *c );
+						reportE( REPORT_INSIDE_TRANSLATED_CODE,
+							"  Launching thread ( x " << x << ", y " << y 
+							<< ", z " << z << " )" << " at resume point " 
+							<< *((unsigned int*)(c->local 
+							+ resumePointOffset)) );
+						unsigned int resume = function( c );
+						done &= resume == 0;
+						*((unsigned int*)(c->local 
+							+ resumePointOffset)) = resume;
+						reportE( REPORT_INSIDE_TRANSLATED_CODE, 
+							"   Thread blocked at " << resume );
+					}
+				}
+			}
+		}
+
+		c->local = localBase;
+	}
+
+	void LLVMExecutableKernel::Worker::launchCtaWithoutBarriers( 
+		Function function, LLVMContext* c, Function bundle, 
+		unsigned int bundleWidth )
+	{
+		char* localBase = c->local;
+		bool done = true;
+		
+		// bundles never straddle rows, the rest of a row runs scalar
+		unsigned int bundled = bundle == 0 ? 0 
+			: c->ntid.x - c->ntid.x % bundleWidth;
+		
+		for( unsigned short z = 0; z < c->ntid.z; ++z )
+		{
+			c->tid.z = z;
+			for( unsigned short y = 0; y < c->ntid.y; ++y )
+			{
+				c->tid.y = y;
+				for( unsigned short x = 0; x < bundled; x += bundleWidth )
+				{
+					c->tid.x = x;
+					reportE( REPORT_INSIDE_TRANSLATED_CODE, 
+						"  Launching threads ( x " << x << " - " 
+						<< ( x + bundleWidth - 1 ) << ", y " << y 
+						<< ", z " << z << " )" );
+					c->local = localBase + c->localSize * threadId( *c );
+					unsigned int resume = bundle( c );
+					done &= resume == 0;
+				}
+				for( unsigned short x = bundled; x < c->ntid.x; ++x )
+				{
+					c->tid.x = x;
+					reportE( REPORT_INSIDE_TRANSLATED_CODE, 
+						"  Launching thread ( x " << x << ", y " << y 
+						<< ", z " << z << " )" );
+					c->local = localBase + c->localSize * threadId( *c );
+					unsigned int resume = function( c );
+					done &= resume == 0;
+					reportE( REPORT_INSIDE_TRANSLATED_CODE, 
+						"   Thread blocked at " << resume );
+				}
+			}
+		}	
+
+		c->local = localBase;		
+		assertM( done, 
+			"Not all threads finished in kernel with no context switches" );
+	}
+	
+	LLVMExecutableKernel::ExecutionManager::ExecutionManager() 
+		: _maxThreadsPerCta( 512 )
+	{
+	
+	}
+
+	LLVMExecutableKernel::ExecutionManager::~ExecutionManager()
+	{
+		report( "Tearing down " << threads() << " LLVM worker threads." );
+		clear();
+	}
+
+	void LLVMExecutableKernel::ExecutionManager::launch( Function f, 
+		LLVMContext* c, bool barriers, unsigned int resumePointOffset,
+		unsigned int externalSharedMemory, Function bundle, 
+		unsigned int bundleWidth, Function threadLoop, unsigned int workers,
+		unsigned int chunkDivisor, const CtaTraversal::IdVector* sample )
+	{
+		if( threads() == 0 ) setThreadCount( 1 );
+		for( ContextVector::iterator context = _contexts.begin(); 
+			context != _contexts.end(); ++context )
+		{
+			// the workers grow their own buffers to match
+			context->localSize = std::max( context->localSize, c->localSize );
+			context->sharedSize = std::max( context->sharedSize, 
+				c->sharedSize + externalSharedMemory );
+			
+			context->nctaid = c->nctaid;
+			context->ntid = c->ntid;
+
+			context->constant = c->constant;
+			context->parameter = c->parameter;
+			context->constantSize = c->constantSize;
+			context->parameterSize = c->parameterSize;
+
+			context->other = c->other;
+		}
+		
+		const api::OcelotConfiguration::Executive& configuration = 
+			api::OcelotConfiguration::get().executive;
+		
+		unsigned int ctas = c->nctaid.x * c->nctaid.y;
+		
+		if( sample != 0 )
+		{
+			_traversal.sample( *sample, c->nctaid.x, c->nctaid.y );
+			ctas = sample->size();
+		}
+		else
+		{
+			_traversal.reset( ctaOrder(), 
+				configuration.ctaTileSize, c->nctaid.x, c->nctaid.y );
+		}
+		
+		_scheduler.reset( ctas, workers, chunkDivisor );
+		
+		for( unsigned int i = 0; i < threads(); ++i )
+		{
+			_busy[ i ] = _scheduler.statistics( i ).busy;
+		}
+		
+		for( MessageVector::iterator message = _messages.begin(); 
+			message != _messages.end(); ++message )
+		{
+			message->function = f;
+			
+			if( barriers && threadLoop != 0 )
+			{
+				message->type = Worker::Message::LaunchKernelWithThreadLoops;
+				message->function = threadLoop;
+			}
+			else if( barriers )
+			{
+				message->type = Worker::Message::LaunchKernelWithBarriers;
+				message->resumePointOffset = resumePointOffset;
+			}
+			else
+			{
+				message->type = Worker::Message::LaunchKernelWithoutBarriers;
+			}
+			
+			message->bundle = bundle;
+			message->bundleWidth = bundleWidth;
+			message->maxThreadsPerCta = _maxThreadsPerCta;
+		}
+
+		_control.launch( threads() );
+		
+		const hydrazine::Timer& timer = _control.timer;
+		
+		// anything not spent running CTAs was spent waiting on the others
+		for( unsigned int i = 0; i < threads(); ++i )
+		{
+			if( !_scheduler.active( i ) ) continue;
+			
+			WorkerStatistics& statistics = _scheduler.statistics( i );
+			double launchBusy = statistics.busy - _busy[ i ];
+			statistics.idle += std::max( timer.seconds() - launchBusy, 0.0 );
+			report( " Worker " << i << " busy " << launchBusy 
+				<< "s, idle " << ( timer.seconds() - launchBusy ) << "s" );
+		}
+	}
+	
+	void LLVMExecutableKernel::ExecutionManager::setThreadCount( 
+		unsigned int t )
+	{
+		if( t == threads() ) return;
+		report( "Booting up " << t << " LLVM worker threads." );
+		clear();
+
+		_workers.resize( t );
+		_messages.resize( t );
+		_contexts.resize( t );
+		_arenas.resize( t );
+		_busy.resize( t );
+		_scheduler.setWorkers( t );
+
+		MessageVector::iterator message = _messages.begin();
+		ArenaVector::iterator arena = _arenas.begin();
+		for( ContextVector::iterator context = _contexts.begin(); 
+			context != _contexts.end(); ++context, ++message, ++arena )
+		{
+			context->localSize = 0;
+			context->sharedSize = 0;
+			context->local = 0;
+			context->shared = 0;
+			message->context = &(*context);
+			message->arena = &(*arena);
+			message->scheduler = &_scheduler;
+			message->traversal = &_traversal;
+			message->id = std::distance( _messages.begin(), message );
+		}
+
+		message = _messages.begin();
+		for( WorkerVector::iterator worker = _workers.begin(); 
+			worker != _workers.end(); ++worker, ++message )
+		{
+			worker->attach( &(*message), &_control );
+			worker->start();
+		}
+	}
+
+	void LLVMExecutableKernel::ExecutionManager::setMaxThreadsPerCta( 
+		unsigned int t )
+	{
+		// workers grow their local memory at the next launch
+		_maxThreadsPerCta = std::max( _maxThreadsPerCta, t );
+	}
+	
+	void LLVMExecutableKernel::ExecutionManager::clear()
+	{
+		for( MessageVector::iterator message = _messages.begin(); 
+			message != _messages.end(); ++message )
+		{
+			message->type = Worker::Message::Kill;
+		}
+		
+		_control.launch( threads() );
+		
+		for( WorkerVector::iterator worker = _workers.begin(); 
+			worker != _workers.end(); ++worker )
+		{
+			worker->join();
+		}
+		
+		_workers.clear();
+		_messages.clear();
+
+		for( ArenaVector::iterator arena = _arenas.begin(); 
+			arena != _arenas.end(); ++arena )
+		{
+			arena->release();
+		}
+		_arenas.clear();
+		_contexts.clear();
+		_busy.clear();
+		_scheduler.setWorkers( 0 );
+	}
+
+	unsigned int LLVMExecutableKernel::ExecutionManager::threads() const
+	{
+		return _workers.size();
+	}
+
+	const LLVMExecutableKernel::WorkerStatisticsVector& 
+		LLVMExecutableKernel::ExecutionManager::statistics() const
+	{
+		return _scheduler.statistics();
+	}
+	
+	LLVMExecutableKernel::OpaqueState::OpaqueState()
+	{
+		timer.start();
+	}
+
+	LLVMExecutableKernel::TierState::TierState() : 
+		level( translator::Translator::NoOptimization ), module( 0 ), 
+		bundleModule( 0 ), function( 0 ), bundle( 0 ), threadLoop( 0 ), 
+		launches( 0 ), seconds( 0.0 ), thread( 0 )
+	{
+	
+	}
+
+	LLVMExecutableKernel::Variant::Variant() : module( 0 ), 
+		bundleModule( 0 ), function( 0 ), bundle( 0 ), threadLoop( 0 )
+	{
+	
+	}
+	
+	unsigned int LLVMExecutableKernel::_pad( size_t& size, 
+		unsigned int alignment )
+	{
+		unsigned int padding = alignment - ( size % alignment );
+		padding = ( alignment == padding ) ? 0 : padding;
+		size += padding;
+		return padding;
+	}
+	
+	std::string LLVMExecutableKernel::threadIdString( const LLVMContext& c )
+	{
+		std::stringstream stream;
+		
+		unsigned int id = threadId( c );
+		stream << id;
+		return stream.str();
+	}
+
+	unsigned int LLVMExecutableKernel::threadId( const LLVMContext& c )
+	{
+		return c.ntid.x * c.ntid.y * c.tid.z + c.ntid.x * c.tid.y + c.tid.x;
+	}
+
+	const LLVMExecutableKernel::WorkerStatisticsVector& 
+		LLVMExecutableKernel::workerStatistics()
+	{
+		return _manager.statistics();
+	}
+
+	LLVMExecutableKernel::CtaOrder LLVMExecutableKernel::ctaOrder()
+	{
+		const std::string& name = 
+			api::OcelotConfiguration::get().executive.ctaOrder;
+		
+		if( name == "rowMajor" ) return RowMajorOrder;
+		if( name == "tiled" ) return TiledOrder;
+		if( name == "morton" ) return MortonOrder;
+		if( name == "hilbert" ) return HilbertOrder;
+		
+		report( "Unknown ctaOrder '" << name << "' - using rowMajor" );
+		return RowMajorOrder;
+	}
+
+	void LLVMExecutableKernel::_optimizePtx()
+	{
+		report( " Running PTX optimizer" );
+
+		report( "  Building dataflow graph." );
+		_ptx->dfg();
+
+		analysis::ConvertPredicationToSelectPass pass1;
+		report( "  Running convert predicate to conditional select" );
+		
+		pass1.initialize( *module );
+		pass1.runOnKernel( *_ptx );
+		pass1.finalize();
+		
+		report( "  Running remove barrier pass." );
+		
+		reportE( REPORT_ALL_PTX_SOURCE, "   Code before pass:\n" << *_ptx );
+
+		analysis::RemoveBarrierPass pass2;
+		
+		pass2.initialize( *module );
+		pass2.runOnKernel( *_ptx );
+		pass2.finalize();
+		
+		_barrierSupport = pass2.barriers();
+		_resumePoint = pass2.resume();
+
+		report( "  Converting to SSA." );
+		_ptx->dfg()->toSsa();
+
+		reportE( REPORT_ALL_PTX_SOURCE, "   Code after pass:\n" << *_ptx );
+	}
+
+	void LLVMExecutableKernel::_loadProfile()
+	{
+		const std::string& directory = 
+			api::OcelotConfiguration::get().executive.branchProfiles;
+		if( directory.empty() ) return;
+		
+		StringVector names( 1, name );
+		
+		// the profiling library names files after the demangled kernel
+		int status = 0;
+		char* demangled = abi::__cxa_demangle( name.c_str(), 0, 0, &status );
+		if( demangled != 0 )
+		{
+			std::string demangledName( demangled );
+			std::free( demangled );
+			
+			names.push_back( demangledName.substr( 0, 
+				demangledName.find( "(" ) ) );
+		}
+		
+		for( StringVector::const_iterator n = names.begin(); 
+			n != names.end(); ++n )
+		{
+			std::string path = directory + "/prof." + *n + ".txt";
+			
+			if( !std::ifstream( path.c_str() ).is_open() ) continue;
+			
+			if( !_profile.load( path, *_ptx ) )
+			{
+				std::cerr << "==Ocelot== WARNING: Branch profile " << path 
+					<< " does not match kernel " << name 
+					<< ", ignoring it.\n";
+			}
+			
+			report( " Weighted " << _profile.branches.size() 
+				<< " branches from " << path );
+			return;
+		}
+	}
+
+	void LLVMExecutableKernel::_translateKernel()
+	{
+		#ifdef HAVE_LLVM
+		if( _module != 0 ) return;
+		
+		// the JIT lock is only held to move the result into the JIT
+		SerialLock serial;
+		
+		report( "Translating PTX kernel \"" << name << "\" to LLVM" );
+
+		#if (PRINT_OPTIMIZED_CFG > 0) && (REPORT_BASE > 0)
+		std::ofstream file((name + "_cfg_original.dot").c_str());
+		_ptx->cfg()->write(file, _ptx->instructions);
+		file.close();
+		#endif
+		
+		_loadProfile();
+		
+		std::string description = _cacheDescription( _optimizationLevel );
+		if( _tiered() ) _tier.description = _cacheDescription( _tier.level );
+		
+		_optimizePtx();
+		_buildDebuggingInformation();
+		_allocateMemory();
+		
+		std::string bitcode;
+		
+		if( _tiered() && _loadCachedModules( _tier.description, bitcode ) )
+		{
+			boost::mutex::scoped_lock lock( _state.mutex );
+			if( _parseModules( bitcode, llvm::getGlobalContext(), 
+				_module, _bundleModule ) )
+			{
+				report( " Starting kernel \"" << name << "\" at " 
+					<< translator::Translator::toString( _tier.level ) 
+					<< " from the kernel cache." );
+				if( _bundleModule != 0 ) 
+				{
+					_bundleWidth = api::OcelotConfiguration::get(
+						).executive.threadBundleWidth;
+				}
+				_optimizationLevel = _tier.level;
+				return;
+			}
+		}
+		
+		if( _loadCachedModules( description, bitcode ) )
+		{
+			boost::mutex::scoped_lock lock( _state.mutex );
+			if( _parseModules( bitcode, llvm::getGlobalContext(), 
+				_module, _bundleModule ) )
+			{
+				// the first tier is not optimized, so it is also the copy
+				//  that is recompiled once the kernel is hot
+				if( _tiered() ) _tier.bitcode = bitcode;
+				if( _bundleModule != 0 ) 
+				{
+					_bundleWidth = api::OcelotConfiguration::get(
+						).executive.threadBundleWidth;
+				}
+				return;
+			}
+		}
+
+		report( " Optimization level " << translator::Translator::toString( 
+			_optimizationLevel ) );
+		translator::PTXToLLVMTranslator translator( _optimizationLevel, 1,
+			api::OcelotConfiguration::get().executive.threadLoops,
+			api::OcelotConfiguration::get().executive.fastMath );
+		translator.addProfile( _profile );
+
+		#if (PRINT_OPTIMIZED_CFG > 0) && (REPORT_BASE > 0)
+		file.open((name + "_cfg_optimized.dot").c_str());
+		_ptx->cfg()->write(file, _ptx->instructions);
+		file.close();
+		#endif
+		
+		llvm::LLVMContext& context = *_state.thread().context;
+		
+		report( " Running translator" );
+		ir::LLVMKernel* llvmKernel = static_cast< 
+			ir::LLVMKernel* >( translator.translate( _ptx ) );
+
+		report( " Assembling llvm module" );
+		llvmKernel->assemble();
+
+		report( " Parsing llvm assembly." );
+		llvm::SMDiagnostic error;
+
+		llvm::Module* module = new llvm::Module( name, context );
+
+		if( llvm::ParseAssemblyString( llvmKernel->code().c_str(), module, 
+			error, context ) == 0 )
+		{
+			report( "  Parsing kernel failed, dumping code:\n" 
+				<< llvmKernel->numberedCode() );
+			delete llvmKernel;
+			delete module;
+			std::string m;
+			llvm::raw_string_ostream message( m );
+			message << "LLVM Parser failed: ";
+			error.Print( name.c_str(), message );
+			
+			throw hydrazine::Exception( message.str() );
+		}
+
+		#if ( REPORT_ORIGINAL_LLVM_SOURCE > 0 ) && ( REPORT_BASE > 0 )
+		std::string m;
+		llvm::raw_string_ostream code( m );
+		code << *module;
+		report( " The initial code is:\n" << m );
+		#endif
+					
+		report( " Checking module for errors." );
+		std::string verifyError;
+		if( llvm::verifyModule( *module, 
+			llvm::ReturnStatusAction, &verifyError ) )
+		{
+			report( "  Checking kernel failed, dumping code:\n" 
+				<< llvmKernel->numberedCode() );
+			delete llvmKernel;
+			delete module;
+
+			throw hydrazine::Exception( "LLVM Verifier failed for kernel: " 
+				+ name + " : \"" + verifyError + "\"" );
+		}
+
+		delete llvmKernel;
+					
+		report( " Successfully created LLVM Module from translated PTX." );
+		
+		llvm::Module* bundleModule = _translateBundle( context );
+		
+		if( _tiered() )
+		{
+			report( " Keeping a copy of the module for " 
+				<< translator::Translator::toString( _tier.level ) );
+			_tier.bitcode = _writeModules( module, bundleModule );
+		}
+		
+		_optimize( module, bundleModule, _optimizationLevel );
+		
+		bitcode = _writeModules( module, bundleModule );
+		delete bundleModule;
+		delete module;
+		
+		_storeCachedModules( description, bitcode );
+		
+		report( " Moving the modules into the JIT." );
+		boost::mutex::scoped_lock lock( _state.mutex );
+		if( !_parseModules( bitcode, llvm::getGlobalContext(), 
+			_module, _bundleModule ) )
+		{
+			throw hydrazine::Exception( "Moving the translated kernel " 
+				+ name + " into the JIT failed." );
+		}
+		#else
+		assertM( false, "LLVM support not compiled into Ocelot." );
+		#endif
+	}
+
+	llvm::Module* LLVMExecutableKernel::_translateBundle( 
+		llvm::LLVMContext& context )
+	{
+		#ifdef HAVE_LLVM
+		int width = api::OcelotConfiguration::get().executive.threadBundleWidth;
+		
+		if( width < 2 || _barrierSupport ) return 0;
+		
+		report( " Translating bundles of " << width << " threads." );
+		translator::PTXToLLVMTranslator translator( _optimizationLevel, 
+			width, false, api::OcelotConfiguration::get().executive.fastMath );
+		translator.addProfile( _profile );
+		
+		llvm::Module* bundleModule = _translateModule( translator, 
+			name + "_bundle", context );
+		
+		if( bundleModule == 0 )
+		{
+			report( "  Kernel can not be bundled, running scalar threads." );
+			return 0;
+		}
+		
+		_bundleWidth = width;
+		
+		return bundleModule;
+		#else
+		return 0;
+		#endif
+	}
+
+	llvm::Module* LLVMExecutableKernel::_translateModule( 
+		translator::Translator& translator, const std::string& moduleName,
+		llvm::LLVMContext& context )
+	{
+		#ifdef HAVE_LLVM
+		ir::LLVMKernel* llvmKernel = static_cast< 
+			ir::LLVMKernel* >( translator.translate( _ptx ) );
+		
+		if( llvmKernel == 0 ) return 0;
+		
+		llvmKernel->assemble();
+		
+		llvm::SMDiagnostic error;
+		
+		llvm::Module* module = new llvm::Module( moduleName, context );
+		
+		std::string verifyError;
+		if( llvm::ParseAssemblyString( llvmKernel->code().c_str(), module, 
+			error, context ) == 0 
+			|| llvm::verifyModule( *module, llvm::ReturnStatusAction, 
+			&verifyError ) )
+		{
+			report( "  Module " << moduleName << " failed to assemble: " 
+				<< verifyError << "\n" << llvmKernel->numberedCode() );
+			delete module;
+			module = 0;
+		}
+		
+		delete llvmKernel;
+		
+		return module;
+		#else
+		return 0;
+		#endif
+	}
+
+	void LLVMExecutableKernel::_optimizeLLVMFunction( 
+		llvm::Module* module, unsigned int level, bool space )
+	{
+		#ifdef HAVE_LLVM
+		llvm::PassManager manager;
+
+		manager.add( new llvm::TargetData( *_state.jit->getTargetData() ) );
+	
+		// thread loops only pay off once the threads are inlined into them
+		manager.add( llvm::createAlwaysInlinerPass() );
+		
+		if( !_state.runtimeVersion.empty() )
+		{
+			// calls to linked runtime functions go through casts of the 
+			//  definitions until instcombine removes them
+			manager.add( llvm::createInstructionCombiningPass() );
+			manager.add( llvm::createFunctionInliningPass() );
+			manager.add( llvm::createGlobalDCEPass() );
+		}
+	
+		if( level < 2 )
+		{
+		    manager.add( llvm::createInstructionCombiningPass() );
+		    manager.add( llvm::createReassociatePass() );
+		    manager.add( llvm::createGVNPass() );
+		    manager.add( llvm::createCFGSimplificationPass() );			
+		}
+		else
+		{
+			manager.add(llvm::createSimplifyLibCallsPass());    // Library Call Optimizations
+			manager.add(llvm::createInstructionCombiningPass());  // Cleanup for scalarrepl.
+			manager.add(llvm::createJumpThreadingPass());         // Thread jumps.
+			manager.add(llvm::createCFGSimplificationPass());     // Merge & remove BBs
+			manager.add(llvm::createScalarReplAggregatesPass());  // Break up aggregate allocas
+			manager.add(llvm::createInstructionCombiningPass());  // Combine silly seq's
+			manager.add(llvm::createTailCallEliminationPass());   // Eliminate tail calls
+			manager.add(llvm::createCFGSimplificationPass());     // Merge & remove BBs
+			manager.add(llvm::createReassociatePass());           // Reassociate expressions
+			manager.add(llvm::createLoopRotatePass());            // Rotate Loop
+			manager.add(llvm::createLICMPass());                  // Hoist loop invariants
+			manager.add(llvm::createLoopUnswitchPass(space || level < 3));
+			manager.add(llvm::createInstructionCombiningPass());  
+			manager.add(llvm::createIndVarSimplifyPass());        // Canonicalize indvars
+			manager.add(llvm::createLoopDeletionPass());          // Delete dead loops
+			if( level > 2 )
+			{
+				manager.add(llvm::createLoopUnrollPass());          // Unroll small loops
+			}
+			manager.add(llvm::createInstructionCombiningPass());  // Clean up after the unroller
+			manager.add(llvm::createGVNPass());                   // Remove redundancies
+			manager.add(llvm::createMemCpyOptPass());             // Remove memcpy / form memset
+			manager.add(llvm::createSCCPPass());                  // Constant prop with SCCP
+
+			// Run instcombine after redundancy elimination to exploit opportunities
+			// opened up by them.
+			manager.add(llvm::createInstructionCombiningPass());
+			manager.add(llvm::createDeadStoreEliminationPass());  // Delete dead stores
+			manager.add(llvm::createAggressiveDCEPass());         // Delete dead instructions
+			manager.add(llvm::createCFGSimplificationPass());     // Merge & remove BBs
+
+		}
+		manager.run( *module );
+		#endif
+	}
+	
+	void LLVMExecutableKernel::_linkRuntime( llvm::Module* module )
+	{
+		#ifdef HAVE_LLVM
+		llvm::Module* library = _state.runtimeFor( module->getContext() );
+		if( library == 0 ) return;
+		
+		// skip the copy for modules that do not call the runtime
+		bool calls = false;
+		for( llvm::Module::iterator function = module->begin(); 
+			function != module->end() && !calls; ++function )
+		{
+			if( !function->isDeclaration() ) continue;
+			
+			llvm::Function* definition = library->getFunction( 
+				function->getName() );
+			calls = definition != 0 && !definition->isDeclaration();
+		}
+		
+		if( !calls ) return;
+		
+		llvm::Module* runtime = llvm::CloneModule( library );
+		std::string error;
+		
+		bool failed = llvm::Linker::LinkModules( module, runtime, &error );
+		delete runtime;
+		
+		if( failed )
+		{
+			report( "  Failed to link the runtime library: " << error );
+			return;
+		}
+		
+		// only the kernel is called from outside of the module, so every 
+		//  linked function can be inlined and then deleted
+		for( llvm::Module::iterator function = library->begin(); 
+			function != library->end(); ++function )
+		{
+			if( function->isDeclaration() ) continue;
+			
+			llvm::Function* linked = module->getFunction( 
+				function->getName() );
+			if( linked != 0 && !linked->isDeclaration() )
+			{
+				linked->setLinkage( llvm::GlobalValue::InternalLinkage );
+			}
+		}
+		
+		report( "  Linked the runtime library into " 
+			<< module->getModuleIdentifier() );
+		#endif
+	}
+	
+	#ifdef HAVE_LLVM
+	/*! \brief The heavier successor of a weighted conditional branch, or 0 
+		if the block does not end with one */
+	static llvm::BasicBlock* hotSuccessor( llvm::BasicBlock* block, 
+		unsigned int kind )
+	{
+		llvm::BranchInst* branch = llvm::dyn_cast< llvm::BranchInst >( 
+			block->getTerminator() );
+		if( branch == 0 || !branch->isConditional() ) return 0;
+		
+		llvm::MDNode* weights = branch->getMetadata( kind );
+		if( weights == 0 || weights->getNumOperands() != 3 ) return 0;
+		
+		llvm::ConstantInt* taken = llvm::dyn_cast< llvm::ConstantInt >( 
+			weights->getOperand( 1 ) );
+		llvm::ConstantInt* notTaken = llvm::dyn_cast< llvm::ConstantInt >( 
+			weights->getOperand( 2 ) );
+		if( taken == 0 || notTaken == 0 ) return 0;
+		
+		if( taken->getZExtValue() >= notTaken->getZExtValue() )
+		{
+			return branch->getSuccessor( 0 );
+		}
+		
+		return branch->getSuccessor( 1 );
+	}
+	#endif
+	
+	void LLVMExecutableKernel::_inlineThreads( llvm::Module* module )
+	{
+		#ifdef HAVE_LLVM
+		llvm::PassManager manager;
+		
+		manager.add( llvm::createAlwaysInlinerPass() );
+		
+		manager.run( *module );
+		#endif
+	}
+	
+	void LLVMExecutableKernel::_layoutHotPaths( llvm::Module* module )
+	{
+		#ifdef HAVE_LLVM
+		// the code generator keeps the order of the blocks, so this is 
+		//  what makes the weights pay off
+		unsigned int kind = module->getContext().getMDKindID( "prof" );
+		
+		typedef std::vector< llvm::BasicBlock* > BlockVector;
+		typedef std::unordered_set< llvm::BasicBlock* > BlockSet;
+		
+		for( llvm::Module::iterator function = module->begin(); 
+			function != module->end(); ++function )
+		{
+			if( function->isDeclaration() ) continue;
+			
+			BlockVector order;
+			BlockSet placed;
+			bool weighted = false;
+			
+			// follow the hot successors from each block that is not placed
+			//  yet, everything else keeps its original order
+			for( llvm::Function::iterator block = function->begin(); 
+				block != function->end(); ++block )
+			{
+				llvm::BasicBlock* next = &*block;
+				
+				while( next != 0 && placed.insert( next ).second )
+				{
+					order.push_back( next );
+					next = hotSuccessor( next, kind );
+					weighted |= next != 0;
+				}
+			}
+			
+			if( !weighted ) continue;
+			
+			for( BlockVector::iterator block = order.begin() + 1; 
+				block != order.end(); ++block )
+			{
+				(*block)->moveAfter( *(block - 1) );
+			}
+		}
+		#endif
+	}
+	
+	void LLVMExecutableKernel::_optimize( llvm::Module* module, 
+		llvm::Module* bundleModule, 
+		translator::Translator::OptimizationLevel optimizationLevel )
+	{
+		#ifdef HAVE_LLVM
+		report( "Optimizing LLVM Code" );
+	
+		unsigned int level = 0;
+		bool space = false;
+	
+		if( optimizationLevel 
+			== translator::Translator::BasicOptimization )
+		{
+			level = 1;
+		}
+		else if( optimizationLevel 
+			== translator::Translator::AggressiveOptimization )
+		{
+			level = 2;
+		}
+		else if( optimizationLevel 
+			== translator::Translator::SpaceOptimization )
+		{
+			level = 2;
+			space = true;
+		}
+		else if( optimizationLevel 
+			== translator::Translator::FullOptimization )
+		{
+			level = 3;
+		}
+		
+		if( level > 0 )
+		{
+			_linkRuntime( module );
+			if( bundleModule != 0 ) _linkRuntime( bundleModule );
+			
+			_optimizeLLVMFunction( module, level, space );
+			if( bundleModule != 0 )
+			{
+				_optimizeLLVMFunction( bundleModule, level, space );
+			}
+		}
+		else
+		{
+			// bundles never have barriers, so only the main module can 
+			//  have a thread loop
+			_inlineThreads( module );
+		}
+		
+		if( !_profile.empty() )
+		{
+			_layoutHotPaths( module );
+			if( bundleModule != 0 ) _layoutHotPaths( bundleModule );
+		}
+		#endif
+	}
+	
+	std::string LLVMExecutableKernel::_cacheDescription( 
+		translator::Translator::OptimizationLevel level ) const
+	{
+		// debugging and instrumentation embed addresses from this process
+		if( !KernelCache::enabled() 
+			|| level == translator::Translator::ReportOptimization
+			|| level == translator::Translator::DebugOptimization
+			|| level == translator::Translator::InstrumentOptimization
+			|| level == translator::Translator::MemoryCheckOptimization )
+		{
+			return "";
+		}
+		
+		const api::OcelotConfiguration::Executive& configuration = 
+			api::OcelotConfiguration::get().executive;
+		std::stringstream description;
+		
+		description << "optimization " << translator::Translator::toString( 
+			level ) << "\n";
+		description << "bundle " << configuration.threadBundleWidth << "\n";
+		description << "threadLoops " << configuration.threadLoops << "\n";
+		description << "fastMath " << configuration.fastMath << "\n";
+		description << "runtime " << _state.runtimeVersion << "\n";
+		_profile.write( description );
+		#ifdef HAVE_LLVM
+		description << "host " << llvm::sys::getHostTriple() << " " 
+			<< llvm::sys::getHostCPUName() << "\n";
+		#endif
+		
+		// the translation also depends on module level declarations
+		std::vector< std::string > globals;
+		for( ir::Module::GlobalMap::const_iterator 
+			global = module->globals().begin(); 
+			global != module->globals().end(); ++global )
+		{
+			globals.push_back( global->second.statement.toString() );
+		}
+		std::sort( globals.begin(), globals.end() );
+		
+		for( std::vector< std::string >::iterator global = globals.begin();
+			global != globals.end(); ++global )
+		{
+			description << *global << "\n";
+		}
+		
+		for( ir::Module::TextureMap::const_iterator 
+			texture = module->textures().begin(); 
+			texture != module->textures().end(); ++texture )
+		{
+			description << "texture " << texture->first << "\n";
+		}
+		
+		_ptx->write( description );
+		
+		return description.str();
+	}
+	
+	bool LLVMExecutableKernel::_loadCachedModules( 
+		const std::string& description, std::string& bitcode )
+	{
+		if( description.empty() ) return false;
+		
+		if( !KernelCache::load( description, bitcode ) ) return false;
+		
+		report( " Loaded the optimized kernel from the kernel cache." );
+		
+		return true;
+	}
+	
+	void LLVMExecutableKernel::_storeCachedModules( 
+		const std::string& description, const std::string& bitcode )
+	{
+		if( description.empty() ) return;
+		
+		KernelCache::store( description, bitcode );
+	}
+	
+	std::string LLVMExecutableKernel::_writeModules( llvm::Module* module, 
+		llvm::Module* bundleModule )
+	{
+		#ifdef HAVE_LLVM
+		std::string code;
+		llvm::raw_string_ostream mainStream( code );
+		llvm::WriteBitcodeToFile( module, mainStream );
+		mainStream.flush();
+		
+		std::string bundle;
+		if( bundleModule != 0 )
+		{
+			llvm::raw_string_ostream bundleStream( bundle );
+			llvm::WriteBitcodeToFile( bundleModule, bundleStream );
+			bundleStream.flush();
+		}
+		
+		std::stringstream data;
+		data << code.size() << "\n" << code << bundle;
+		
+		return data.str();
+		#else
+		return "";
+		#endif
+	}
+	
+	bool LLVMExecutableKernel::_parseModules( const std::string& data, 
+		llvm::LLVMContext& context, llvm::Module*& module, 
+		llvm::Module*& bundleModule )
+	{
+		#ifdef HAVE_LLVM
+		// the main module size, the main module, then the bundle module
+		std::string::size_type newline = data.find( '\n' );
+		if( newline == std::string::npos ) return false;
+		
+		size_t bytes = 0;
+		std::stringstream( data.substr( 0, newline ) ) >> bytes;
+		if( newline + 1 + bytes > data.size() ) return false;
+		
+		std::string error;
+		
+		llvm::MemoryBuffer* buffer = llvm::MemoryBuffer::getMemBufferCopy( 
+			llvm::StringRef( data.data() + newline + 1, bytes ), name );
+		llvm::Module* parsed = llvm::ParseBitcodeFile( buffer, context, 
+			&error );
+		delete buffer;
+		
+		if( parsed == 0 )
+		{
+			report( "  Discarding bitcode: " << error );
+			return false;
+		}
+		
+		llvm::Module* parsedBundle = 0;
+		size_t bundleBytes = data.size() - newline - 1 - bytes;
+		
+		if( bundleBytes > 0 )
+		{
+			buffer = llvm::MemoryBuffer::getMemBufferCopy( llvm::StringRef( 
+				data.data() + newline + 1 + bytes, bundleBytes ), 
+				name + "_bundle" );
+			parsedBundle = llvm::ParseBitcodeFile( buffer, context, &error );
+			delete buffer;
+		
+			if( parsedBundle == 0 )
+			{
+				report( "  Discarding bitcode: " << error );
+				delete parsed;
+				return false;
+			}
+		}
+		
+		module = parsed;
+		bundleModule = parsedBundle;
+		
+		return true;
+		#else
+		return false;
+		#endif
+	}
+	
+	void LLVMExecutableKernel::_compileKernel()
+	{
+		if( _function != 0 ) return;
+		
+		translate();
+		_bindTextures();
+		_updateGlobalMemory();
+		
+		SerialLock serial;
+		boost::mutex::scoped_lock lock( _state.mutex );
+		_compile();
+	}
+	
+	void LLVMExecutableKernel::_compile()
+	{
+		_mapGlobals( _module, _bundleModule, _globalAddresses );
+		_compile( _module, _bundleModule, _function, _bundle, _threadLoop );
+	}
+	
+	void LLVMExecutableKernel::_compile( llvm::Module* module, 
+		llvm::Module* bundleModule, Function& translated, Function& bundled, 
+		Function& threadLooped )
+	{
+		#ifdef HAVE_LLVM
+		_state.jit->addModule( module );
+		if( bundleModule != 0 ) _state.jit->addModule( bundleModule );
+		
+		llvm::Function* function = module->getFunction( 
+			"_Z_ocelotTranslated_" + name );
+
+		assertM( function != 0, 
+			"Could not find function _Z_ocelotTranslated_" + name );
+		translated = hydrazine::bit_cast< Function >( 
+			_state.jit->getPointerToFunction( function ) );
+		
+		llvm::Function* threadLoop = module->getFunction( 
+			"_Z_ocelotThreadLoop_" + name );
+		if( threadLoop != 0 )
+		{
+			report( " Running threads in loops between barriers." );
+			threadLooped = hydrazine::bit_cast< Function >( 
+				_state.jit->getPointerToFunction( threadLoop ) );
+		}
+		
+		if( bundleModule != 0 )
+		{
+			llvm::Function* bundle = bundleModule->getFunction( 
+				"_Z_ocelotBundle_" + name );
+			assertM( bundle != 0, 
+				"Could not find function _Z_ocelotBundle_" + name );
+			bundled = hydrazine::bit_cast< Function >( 
+				_state.jit->getPointerToFunction( bundle ) );
+		}
+
+		#if ( REPORT_OPTIMIZED_LLVM_SOURCE > 0 ) && ( REPORT_BASE > 0 )
+		std::string m;
+		llvm::raw_string_ostream code( m );
+		code << *module;
+		report( " The optimized code is:\n" << m );
+		#endif
+		
+		report( " Successfully jit compiled the kernel." );
+		#endif
+	}
+	
+	void LLVMExecutableKernel::_mapGlobals( llvm::Module* module, 
+		llvm::Module* bundleModule, const AddressMap& addresses )
+	{
+		#ifdef HAVE_LLVM
+		_state.jit->clearAllGlobalMappings();
+		
+		for( AddressMap::const_iterator global = addresses.begin(); 
+			global != addresses.end(); ++global )
+		{
+			llvm::GlobalValue* value = module->getNamedValue( global->first );
+			assertM( value != 0, "Global variable " << global->first 
+				<< " not found in llvm module." );
+			report( " Binding global variable " << global->first 
+				<< " to " << global->second );
+			_state.jit->addGlobalMapping( value, global->second );
 			
-			_optimize();
+			if( bundleModule == 0 ) continue;
 			
+			value = bundleModule->getNamedValue( global->first );
+			if( value != 0 )
+			{
+				_state.jit->addGlobalMapping( value, global->second );
+			}
 		}
-		#else
-		assertM( false, "LLVM support not compiled into Ocelot." );
 		#endif
 	}
-
-	void LLVMExecutableKernel::_optimizeLLVMFunction( 
-		llvm::Module* module, unsigned int level, bool space )
+	
+	void LLVMExecutableKernel::_releaseModule( llvm::Module* module )
 	{
 		#ifdef HAVE_LLVM
-		llvm::PassManager manager;
-
-        manager.add( new llvm::TargetData( *_state.jit->getTargetData() ) );
+		if( module == 0 ) return;
+		
+		for( llvm::Module::iterator function = module->begin(); 
+			function != module->end(); ++function )
+		{
+			if( function->isDeclaration() ) continue;
+			_state.jit->freeMachineCodeForFunction( &*function );
+		}
+		
+		_state.jit->removeModule( module );
+		delete module;
+		#endif
+	}
 	
-		if( level < 2 )
+	bool LLVMExecutableKernel::_tiered() const
+	{
+		return _tier.level != _optimizationLevel;
+	}
+	
+	void LLVMExecutableKernel::_countTierLaunch( double seconds )
+	{
+		if( !_tiered() || _tier.thread != 0 || _tier.bitcode.empty() ) return;
+		
+		++_tier.launches;
+		_tier.seconds += seconds;
+		
+		const api::OcelotConfiguration::Executive& configuration = 
+			api::OcelotConfiguration::get().executive;
+		
+		if( _tier.launches < (unsigned int)configuration.tierUpLaunches 
+			&& _tier.seconds * 1000.0 < configuration.tierUpMilliseconds )
 		{
-		    manager.add( llvm::createInstructionCombiningPass() );
-		    manager.add( llvm::createReassociatePass() );
-		    manager.add( llvm::createGVNPass() );
-		    manager.add( llvm::createCFGSimplificationPass() );			
+			return;
 		}
-		else
+		
+		report( "Kernel \"" << name << "\" is hot after " << _tier.launches 
+			<< " launches and " << _tier.seconds << " seconds, recompiling at " 
+			<< translator::Translator::toString( _tier.level ) );
+		
+		if( !_state.multithreaded )
 		{
-			manager.add(llvm::createSimplifyLibCallsPass());    // Library Call Optimizations
-			manager.add(llvm::createInstructionCombiningPass());  // Cleanup for scalarrepl.
-			manager.add(llvm::createJumpThreadingPass());         // Thread jumps.
-			manager.add(llvm::createCFGSimplificationPass());     // Merge & remove BBs
-			manager.add(llvm::createScalarReplAggregatesPass());  // Break up aggregate allocas
-			manager.add(llvm::createInstructionCombiningPass());  // Combine silly seq's
-			manager.add(llvm::createTailCallEliminationPass());   // Eliminate tail calls
-			manager.add(llvm::createCFGSimplificationPass());     // Merge & remove BBs
-			manager.add(llvm::createReassociatePass());           // Reassociate expressions
-			manager.add(llvm::createLoopRotatePass());            // Rotate Loop
-			manager.add(llvm::createLICMPass());                  // Hoist loop invariants
-			manager.add(llvm::createLoopUnswitchPass(space || level < 3));
-			manager.add(llvm::createInstructionCombiningPass());  
-			manager.add(llvm::createIndVarSimplifyPass());        // Canonicalize indvars
-			manager.add(llvm::createLoopDeletionPass());          // Delete dead loops
-			if( level > 2 )
-			{
-				manager.add(llvm::createLoopUnrollPass());          // Unroll small loops
-			}
-			manager.add(llvm::createInstructionCombiningPass());  // Clean up after the unroller
-			manager.add(llvm::createGVNPass());                   // Remove redundancies
-			manager.add(llvm::createMemCpyOptPass());             // Remove memcpy / form memset
-			manager.add(llvm::createSCCPPass());                  // Constant prop with SCCP
-
-			// Run instcombine after redundancy elimination to exploit opportunities
-			// opened up by them.
-			manager.add(llvm::createInstructionCombiningPass());
-			manager.add(llvm::createDeadStoreEliminationPass());  // Delete dead stores
-			manager.add(llvm::createAggressiveDCEPass());         // Delete dead instructions
-			manager.add(llvm::createCFGSimplificationPass());     // Merge & remove BBs
-
+			// the passes may not overlap other LLVM work on the launching
+			//  threads, so recompile in place
+			_tierUp( _globalAddresses );
+			_installTier();
+			return;
 		}
-		manager.run( *module );
-		#endif
+		
+		_tier.thread = new boost::thread( boost::bind( 
+			&LLVMExecutableKernel::_tierUp, this, _globalAddresses ) );
 	}
 	
-	void LLVMExecutableKernel::_optimize()
+	void LLVMExecutableKernel::_tierUp( AddressMap addresses )
 	{
 		#ifdef HAVE_LLVM
-		report( "Optimizing LLVM Code" );
-	
-		if( _optimizationLevel 
-			== translator::Translator::BasicOptimization )
+		SerialLock serial;
+		
+		try
 		{
-			_optimizeLLVMFunction( _module, 1, false );
+			llvm::Module* module = 0;
+			llvm::Module* bundleModule = 0;
+			
+			if( !_parseModules( _tier.bitcode, *_state.thread().context, 
+				module, bundleModule ) )
+			{
+				throw hydrazine::Exception( 
+					"The unoptimized copy could not be parsed." );
+			}
+			
+			_optimize( module, bundleModule, _tier.level );
+			
+			std::string bitcode = _writeModules( module, bundleModule );
+			delete bundleModule;
+			delete module;
+			
+			_storeCachedModules( _tier.description, bitcode );
+			
+			boost::mutex::scoped_lock lock( _state.mutex );
+			
+			if( !_parseModules( bitcode, llvm::getGlobalContext(), 
+				_tier.module, _tier.bundleModule ) )
+			{
+				throw hydrazine::Exception( 
+					"The recompiled modules could not be moved into the JIT." );
+			}
+			
+			_mapGlobals( _tier.module, _tier.bundleModule, addresses );
+			_compile( _tier.module, _tier.bundleModule, _tier.function, 
+				_tier.bundle, _tier.threadLoop );
 		}
-		else if( _optimizationLevel 
-			== translator::Translator::AggressiveOptimization )
+		catch( const std::exception& e )
 		{
-			_optimizeLLVMFunction( _module, 2, false );
+			report( "Recompiling kernel \"" << name << "\" failed: " 
+				<< e.what() );
+			_tier.function = 0;
 		}
-		else if( _optimizationLevel 
-			== translator::Translator::SpaceOptimization )
+		#endif
+	}
+	
+	void LLVMExecutableKernel::_finishTierUp()
+	{
+		if( _tier.thread == 0 ) return;
+		if( !_tier.thread->timed_join( boost::posix_time::seconds( 0 ) ) )
 		{
-			_optimizeLLVMFunction( _module, 2, true );
+			return;
 		}
-		else if( _optimizationLevel 
-			== translator::Translator::FullOptimization )
+		
+		delete _tier.thread;
+		_tier.thread = 0;
+		
+		_installTier();
+	}
+	
+	void LLVMExecutableKernel::_installTier()
+	{
+		SerialLock serial;
+		boost::mutex::scoped_lock lock( _state.mutex );
+		
+		if( _tier.function == 0 )
 		{
-			_optimizeLLVMFunction( _module, 3, false );
+			report( "Kernel \"" << name << "\" stays at " 
+				<< translator::Translator::toString( _optimizationLevel ) );
+			_releaseModule( _tier.bundleModule );
+			_releaseModule( _tier.module );
 		}
-
-		_state.jit->addModule( _module );
+		else
+		{
+			report( "Kernel \"" << name << "\" moves from " 
+				<< translator::Translator::toString( _optimizationLevel ) 
+				<< " to " << translator::Translator::toString( _tier.level ) );
 		
-		llvm::Function* function = _module->getFunction( 
-			"_Z_ocelotTranslated_" + name );
-
-		_updateGlobalMemory();
-
-		assertM( function != 0, 
-			"Could not find function _Z_ocelotTranslated_" + name );
-		_function = hydrazine::bit_cast< Function >( 
-			_state.jit->getPointerToFunction( function ) );
-
-		#if ( REPORT_OPTIMIZED_LLVM_SOURCE > 0 ) && ( REPORT_BASE > 0 )
-		std::string m;
-		llvm::raw_string_ostream code( m );
-		code << *_module;
-		report( " The optimized code is:\n" << m );
-		#endif
+			_releaseModule( _bundleModule );
+			_releaseModule( _module );
+			
+			_module = _tier.module;
+			_bundleModule = _tier.bundleModule;
+			_function = _tier.function;
+			_bundle = _tier.bundle;
+			_threadLoop = _tier.threadLoop;
+			
+			++_codeVersion;
+		}
 		
-		report( " Successfully jit compiled the kernel." );
-		#endif
+		_tier.module = 0;
+		_tier.bundleModule = 0;
+		_tier.bitcode.clear();
+		_optimizationLevel = _tier.level;
 	}
 	
 	void LLVMExecutableKernel::_allocateParameterMemory( )
@@ -913,8 +2520,6 @@ namespace executive
 	
 		report( "   Total shared memory size is " << _context.sharedSize 
 			<< " declared plus " << _externSharedMemorySize << " external." );
-		_context.shared = new char[ _context.sharedSize 
-			+ _externSharedMemorySize ];
 		_sharedMemorySize = _context.sharedSize;
 	}
 	
@@ -988,8 +2593,6 @@ namespace executive
 		report( "   Total local memory size is " << _context.localSize 
 			<< " for " << threads() << " threads." );
 
-		_context.local = new char[ threads() * _context.localSize ];		
-
 		if( _barrierSupport )
 		{
 			report( "   Adding barrier sync point mapping." );
@@ -1077,7 +2680,7 @@ namespace executive
 	void LLVMExecutableKernel::_allocateTextureMemory( )
 	{
 		report( " Allocating Texture Memory" );
-		_opaque.textures.clear();
+		_textureNames.clear();
 		
 		AllocationMap map;
 		unsigned int index = 0;
@@ -1095,22 +2698,15 @@ namespace executive
 				{
 					report("  found texture instruction: " << ptx.toString());
 
-					ir::Texture* texture = (ir::Texture*)
-						device->getTextureReference(
-						module->path(), ptx.a.identifier);
-					assert( texture != 0 );
-		
 					AllocationMap::iterator 
 						allocation = map.find( ptx.a.identifier );
 					if( allocation == map.end() )
 					{
 						report( "  Allocating texture " << ptx.a.identifier 
-							<< " to index " << index << " with data " 
-							<< texture->data << " and type " 
-							<< texture->type);
+							<< " to index " << index );
 						allocation = map.insert( 
 							std::make_pair( ptx.a.identifier, index++ ) ).first;
-						_opaque.textures.push_back( texture );
+						_textureNames.push_back( ptx.a.identifier );
 					}
 					ptx.a.reg = allocation->second;
 				}
@@ -1118,6 +2714,24 @@ namespace executive
 		}
 	}
 	
+	void LLVMExecutableKernel::_bindTextures()
+	{
+		report( " Binding Textures" );
+		_opaque.textures.clear();
+		
+		for( StringVector::const_iterator name = _textureNames.begin(); 
+			name != _textureNames.end(); ++name )
+		{
+			ir::Texture* texture = (ir::Texture*)device->getTextureReference(
+				module->path(), *name );
+			assert( texture != 0 );
+			
+			report( "  Binding texture " << *name << " with data " 
+				<< texture->data << " and type " << texture->type );
+			_opaque.textures.push_back( texture );
+		}
+	}
+	
 	void LLVMExecutableKernel::_allocateMemory()
 	{
 		report( " Allocating Memory" );
@@ -1130,11 +2744,171 @@ namespace executive
 		_allocateTextureMemory();
 	}
 
-	void LLVMExecutableKernel::_updateGlobalMemory()
+	const LLVMExecutableKernel::Variant* 
+		LLVMExecutableKernel::_selectVariant()
+	{
+		_buildVariantKey();
+		
+		VariantMap::const_iterator variant = _variants.find( _variantKey );
+		if( variant != _variants.end() ) return &variant->second;
+		
+		const api::OcelotConfiguration::Executive& configuration = 
+			api::OcelotConfiguration::get().executive;
+		
+		unsigned int& launches = _variantLaunches[ _variantKey ];
+		
+		if( ++launches < (unsigned int)configuration.specializationLaunches )
+		{
+			if( _variantLaunches.size() > SPECIALIZATION_KEY_FACTOR
+				* (unsigned int)std::max( configuration.specializationVariants,
+				1 ) )
+			{
+				report( "Launch values of kernel \"" << name 
+					<< "\" vary too much, no longer specializing." );
+				_specialize = false;
+				_variantLaunches.clear();
+			}
+			return 0;
+		}
+		
+		if( _variants.size() 
+			>= (unsigned int)configuration.specializationVariants ) return 0;
+		
+		_variantLaunches.erase( _variantKey );
+		
+		Variant& newVariant = _variants.insert( 
+			std::make_pair( _variantKey, Variant() ) ).first->second;
+		_translateVariant( newVariant );
+		
+		return &newVariant;
+	}
+	
+	void LLVMExecutableKernel::_buildVariantKey()
+	{
+		_variantKey.clear();
+		_variantParameters.clear();
+		
+		_variantKey.append( (const char*) &_context.ntid, 
+			sizeof( _context.ntid ) );
+		_variantKey.append( (const char*) &_context.nctaid, 
+			sizeof( _context.nctaid ) );
+		
+		bool previous = _previousParameters.size() == _context.parameterSize;
+		
+		for( unsigned int index = 0; 
+			previous && index < _ptx->parameters.size(); ++index )
+		{
+			const ir::Parameter& parameter = _ptx->parameters[ index ];
+			
+			if( parameter.getSize() > sizeof( long long unsigned int ) ) 
+			{
+				continue;
+			}
+			
+			const char* value = _context.parameter + parameter.offset;
+			
+			if( memcmp( value, _previousParameters.data() + parameter.offset, 
+				parameter.getSize() ) != 0 ) continue;
+			
+			_variantParameters.push_back( index );
+			_variantKey.append( (const char*) &parameter.offset, 
+				sizeof( parameter.offset ) );
+			_variantKey.append( value, parameter.getSize() );
+		}
+		
+		_previousParameters.assign( _context.parameter, 
+			_context.parameterSize );
+	}
+	
+	void LLVMExecutableKernel::_translateVariant( Variant& variant )
 	{
 		#ifdef HAVE_LLVM
+		report( "Specializing kernel \"" << name << "\" for CTAs of ( " 
+			<< _context.ntid.x << ", " << _context.ntid.y << ", " 
+			<< _context.ntid.z << " ), a grid of ( " << _context.nctaid.x 
+			<< ", " << _context.nctaid.y << " ), and " 
+			<< _variantParameters.size() << " parameters." );
+		
+		translator::PTXToLLVMTranslator::Specialization specialization;
+		
+		specialization.dimensions = true;
+		specialization.ntid = ir::Dim3( _context.ntid.x, _context.ntid.y, 
+			_context.ntid.z );
+		specialization.nctaid = ir::Dim3( _context.nctaid.x, 
+			_context.nctaid.y, _context.nctaid.z );
+		
+		for( IndexVector::const_iterator index = _variantParameters.begin(); 
+			index != _variantParameters.end(); ++index )
+		{
+			const ir::Parameter& parameter = _ptx->parameters[ *index ];
+			
+			long long unsigned int value = 0;
+			memcpy( &value, _context.parameter + parameter.offset, 
+				parameter.getSize() );
+			specialization.parameters.insert( 
+				std::make_pair( parameter.offset, value ) );
+		}
+		
+		SerialLock serial;
+		
+		const api::OcelotConfiguration::Executive& configuration = 
+			api::OcelotConfiguration::get().executive;
+		
+		llvm::LLVMContext& context = *_state.thread().context;
+		
+		translator::PTXToLLVMTranslator translator( _optimizationLevel, 1,
+			configuration.threadLoops, configuration.fastMath );
+		translator.specialize( specialization );
+		translator.addProfile( _profile );
+		
+		llvm::Module* module = _translateModule( translator, 
+			name + "_variant", context );
+		
+		if( module == 0 )
+		{
+			report( " Specializing failed, running the generic kernel." );
+			return;
+		}
+		
+		llvm::Module* bundleModule = 0;
+		
+		if( _bundleModule != 0 )
+		{
+			translator::PTXToLLVMTranslator bundleTranslator( 
+				_optimizationLevel, _bundleWidth, false, 
+				configuration.fastMath );
+			bundleTranslator.specialize( specialization );
+			bundleTranslator.addProfile( _profile );
+			
+			bundleModule = _translateModule( bundleTranslator, 
+				name + "_variant_bundle", context );
+		}
+		
+		// variants are only compiled for hot values, so skip lower tiers
+		_optimize( module, bundleModule, _tier.level );
+		
+		std::string bitcode = _writeModules( module, bundleModule );
+		delete bundleModule;
+		delete module;
+		
+		boost::mutex::scoped_lock lock( _state.mutex );
+		
+		if( !_parseModules( bitcode, llvm::getGlobalContext(), 
+			variant.module, variant.bundleModule ) )
+		{
+			report( " Specializing failed, running the generic kernel." );
+			return;
+		}
+		
+		_mapGlobals( variant.module, variant.bundleModule, _globalAddresses );
+		_compile( variant.module, variant.bundleModule, variant.function, 
+			variant.bundle, variant.threadLoop );
+		#endif
+	}
+	
+	void LLVMExecutableKernel::_updateGlobalMemory()
+	{
 		report( "Updating global memory." );
-		_state.jit->clearAllGlobalMappings();
 		for( ir::Module::GlobalMap::const_iterator 
 			global = module->globals().begin(); 
 			global != module->globals().end(); ++global ) 
@@ -1143,18 +2917,12 @@ namespace executive
 			{
 				case ir::PTXStatement::Global:
 				{
-					llvm::GlobalValue* 
-						value = _module->getNamedValue( global->first );
-					assertM( value != 0, "Global variable " << global->first 
-						<< " not found in llvm module." );
 					Device::MemoryAllocation* allocation = 
 						device->getGlobalAllocation( 
 						module->path(), global->first );
 					assert(allocation != 0);
-					report( " Binding global variable " << global->first 
-						<< " to " << allocation->pointer() );
-					_state.jit->addGlobalMapping( value, 
-						allocation->pointer() );
+					// the map keeps its nodes from the last launch
+					_globalAddresses[ global->first ] = allocation->pointer();
 					break;
 				}
 				default:
@@ -1163,7 +2931,6 @@ namespace executive
 				}
 			}
 		}
-		#endif
 	}
 	
 	void LLVMExecutableKernel::_updateConstantMemory()
@@ -1213,7 +2980,10 @@ namespace executive
 	LLVMExecutableKernel::LLVMExecutableKernel( ir::Kernel& k, 
 		executive::Device* d, 
 		translator::Translator::OptimizationLevel l ) : 
-		ExecutableKernel( k, d ), _module( 0 ), _optimizationLevel( l )
+		ExecutableKernel( k, d ), _module( 0 ), _function( 0 ), 
+		_bundleModule( 0 ), _bundle( 0 ), _bundleWidth( 1 ), 
+		_threadLoop( 0 ), _optimizationLevel( l ), _translated( false ),
+		_scheduleWorkers( 0 ), _scheduleChunkDivisor( 0 ), _codeVersion( 0 )
 	{
 		assertM( k.ISA == ir::Instruction::PTX, 
 			"LLVMExecutable kernel must be constructed from a PTXKernel" );
@@ -1236,27 +3006,94 @@ namespace executive
 		_opaque.cache = &_cache;
 		_opaque.kernel = this;
 		
+		bool instrumented = l == translator::Translator::ReportOptimization
+			|| l == translator::Translator::DebugOptimization
+			|| l == translator::Translator::InstrumentOptimization
+			|| l == translator::Translator::MemoryCheckOptimization;
+		
+		_specialize = !instrumented
+			&& api::OcelotConfiguration::get().executive.launchSpecialization;
+		
+		// start unoptimized and recompile at the requested level once hot
+		_tier.level = _optimizationLevel;
+		if( api::OcelotConfiguration::get().executive.tieredCompilation
+			&& !instrumented )
+		{
+			if( l == translator::Translator::NoOptimization )
+			{
+				_tier.level = translator::Translator::FullOptimization;
+			}
+			_optimizationLevel = translator::Translator::NoOptimization;
+		}
+		
 		_state.initialize();
 	}
 	
 	LLVMExecutableKernel::~LLVMExecutableKernel()
 	{	
+		if( _tier.thread != 0 )
+		{
+			_tier.thread->join();
+			delete _tier.thread;
+		}
+	
 		#ifdef HAVE_LLVM
+		SerialLock serial;
+		boost::mutex::scoped_lock lock( _state.mutex );
+		
+		_releaseModule( _tier.bundleModule );
+		_releaseModule( _tier.module );
+		
+		for( VariantMap::iterator variant = _variants.begin(); 
+			variant != _variants.end(); ++variant )
+		{
+			_releaseModule( variant->second.bundleModule );
+			_releaseModule( variant->second.module );
+		}
+		
 		if( _module != 0 )
 		{
 			_state.jit->removeModule( _module );
 		}
+		if( _bundleModule != 0 )
+		{
+			_state.jit->removeModule( _bundleModule );
+		}
 		#endif
-		delete[] _context.local;
 		delete[] _context.constant;
 		delete[] _context.parameter;
-		delete[] _context.shared;
 		delete _ptx;
 	}
 
+	void LLVMExecutableKernel::translate()
+	{
+		boost::mutex::scoped_lock lock( _translationMutex );
+		
+		if( !_translated )
+		{
+			_translated = true;
+			
+			try
+			{
+				_translateKernel();
+			}
+			catch( const std::exception& e )
+			{
+				_translationError = e.what();
+			}
+		}
+		
+		if( !_translationError.empty() )
+		{
+			throw hydrazine::Exception( "Translating kernel \"" + name 
+				+ "\" failed: " + _translationError );
+		}
+	}
+
 	void LLVMExecutableKernel::launchGrid( int x, int y )
 	{	
-		_translateKernel();
+		_compileKernel();
+		_finishTierUp();
 		report( "Launching kernel \"" << name << "\" on grid ( x = " 
 			<< x << ", y = " << y << " )"  );
 		
@@ -1265,15 +3102,60 @@ namespace executive
 		_gridDim.x = x;
 		_gridDim.y = y;
 
-		_manager.launch( _function, &_context, 
-			_barrierSupport, _resumePointOffset, _externSharedMemorySize );
+		Function function = _function;
+		Function bundle = _bundle;
+		Function threadLoop = _threadLoop;
+		unsigned int bundleWidth = _bundleWidth;
+		
+		const Variant* variant = _specialize ? _selectVariant() : 0;
+		
+		if( variant != 0 && variant->function != 0 )
+		{
+			function = variant->function;
+			bundle = variant->bundle;
+			threadLoop = variant->threadLoop;
+			if( bundle == 0 ) bundleWidth = 1;
+		}
+		
+		// there are no trace events to cluster on, so spread the sample
+		CtaSampler::Mode sampling = CtaSampler::configuredMode();
+		if( sampling == CtaSampler::ClusteredSampling )
+		{
+			sampling = CtaSampler::StridedSampling;
+		}
+		
+		if( sampling != CtaSampler::NoSampling )
+		{
+			CtaSampler sampler( x * y, sampling );
+			
+			report( " running " << sampler.sampled().size() << " of " 
+				<< sampler.ctas() << " CTAs" );
+			
+			_manager.launch( function, &_context, 
+				_barrierSupport, _resumePointOffset, _externSharedMemorySize,
+				bundle, bundleWidth, threadLoop, _scheduleWorkers, 
+				_scheduleChunkDivisor, &sampler.sampled() );
+			
+			sampler.save( name );
+			return;
+		}
+		
+		hydrazine::Timer timer;
+		timer.start();
+
+		_manager.launch( function, &_context, 
+			_barrierSupport, _resumePointOffset, _externSharedMemorySize,
+			bundle, bundleWidth, threadLoop, _scheduleWorkers, 
+			_scheduleChunkDivisor );
+		
+		timer.stop();
+		_countTierLaunch( timer.seconds() );
 	}
 	
 	void LLVMExecutableKernel::setKernelShape( int x, int y, int z )
 	{
 		report( "Setting CTA shape to ( x = " << x << ", y = " 
 			<< y << ", z = " << z << " ) for kernel \"" << name << "\""  );
-		unsigned int previous = threads();
 	
 		_context.ntid.x = x;
 		_context.ntid.y = y;
@@ -1281,32 +3163,17 @@ namespace executive
 		_blockDim.x = x;
 		_blockDim.y = y;
 		_blockDim.z = z;
-		
-		if( previous != threads() )
-		{
-			if( _context.local != 0 )
-			{
-				report( " Reallocating local memory of " << _context.localSize 
-					<< " bytes per thread ( " 
-					<< ( threads() * _context.localSize ) << " total )" );
-				delete[] _context.local;
-				_context.local = new char[ threads() * _context.localSize ];
-			}
-		}
 	}
 
 	void LLVMExecutableKernel::setExternSharedMemorySize( unsigned int bytes )
 	{
-		_translateKernel();
+		_compileKernel();
 		
 		if( bytes != _externSharedMemorySize )
 		{
 			report( "Setting external shared memory to " << bytes 
 				<< " total size is " << (bytes + _context.sharedSize) );
-			delete[] _context.shared;
 			_externSharedMemorySize = bytes;
-			_context.shared = new char[ _externSharedMemorySize
-				+ _context.sharedSize ];
 		}
 	}
 
@@ -1318,9 +3185,21 @@ namespace executive
 			threadLimit ) );
 	}
 	
+	void LLVMExecutableKernel::setCtaSchedule( unsigned int workers, 
+		unsigned int chunkDivisor )
+	{
+		_scheduleWorkers = workers;
+		_scheduleChunkDivisor = chunkDivisor;
+	}
+	
+	unsigned int LLVMExecutableKernel::codeVersion() const
+	{
+		return _codeVersion;
+	}
+	
 	void LLVMExecutableKernel::updateParameterMemory()
 	{
-		_translateKernel();
+		_compileKernel();
 	
 		size_t size = 0;
 		for( ParameterVector::iterator parameter = parameters.begin();
@@ -0,0 +1,38 @@
+/*! \file LLVMRuntimeLibrary.cpp
+	\date October 18, 2026
+	\author agent <agent@local>
+	\brief A source file that is compiled to LLVM bitcode and linked into
+		translated kernels so that the runtime library can be inlined.
+
+	This is not part of libocelot, which includes LLVMRuntimeLibrary.inl
+	directly.  Both copies must be built from the same source, functions
+	that are not inlined still resolve to the copy in libocelot.
+*/
+
+#ifndef LLVM_RUNTIME_LIBRARY_CPP_INCLUDED
+#define LLVM_RUNTIME_LIBRARY_CPP_INCLUDED
+
+#include <ocelot/executive/interface/LLVMExecutableKernel.h>
+#include <ocelot/executive/interface/TextureOperations.h>
+#include <ocelot/executive/interface/Device.h>
+
+#include <hydrazine/implementation/math.h>
+#include <hydrazine/implementation/debug.h>
+
+#include <iostream>
+#include <cmath>
+
+#ifdef REPORT_BASE
+#undef REPORT_BASE
+#endif
+
+#define REPORT_BASE 0
+#define DEBUG_NTH_THREAD_ONLY 0
+#define NTH_THREAD 0
+#define DEBUG_PTX_INSTRUCTION_TRACE 1
+#define DEBUG_PTX_BASIC_BLOCK_TRACE 1
+
+#include <ocelot/executive/implementation/LLVMRuntimeLibrary.inl>
+
+#endif
+
@@ -10,10 +10,32 @@
 // ocelot includes
 #include <ocelot/executive/interface/MulticoreCPUDevice.h>
 #include <ocelot/executive/interface/LLVMExecutableKernel.h>
+#include <ocelot/executive/interface/WorkerAffinity.h>
+#include <ocelot/executive/interface/DirtyPageTracker.h>
+#include <ocelot/executive/interface/NativeKernel.h>
+#include <ocelot/api/interface/OcelotConfiguration.h>
 
 // hydrazine includes
 #include <hydrazine/implementation/Exception.h>
+#include <hydrazine/implementation/debug.h>
 #include <hydrazine/interface/Casts.h>
+#include <hydrazine/implementation/Timer.h>
+
+// Standard library includes
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+#ifdef REPORT_BASE
+#undef REPORT_BASE
+#endif
+
+// Turn on report messages
+#define REPORT_BASE 0
+
+// The CTA chunk divisors tried after the worker count has been tuned with
+// the default divisor, 1 hands each worker its whole range at once
+#define AUTOTUNING_CHUNK_DIVISORS {1, 16}
 
 // Macros
 #define Throw(x) {std::stringstream s; s << x; \
@@ -28,6 +50,20 @@ namespace executive
 	}
 
 
+	MulticoreCPUDevice::PartitionedAllocation::PartitionedAllocation(
+		void* pointer, size_t size) 
+		: EmulatorDevice::MemoryAllocation(pointer, size)
+	{
+	
+	}
+
+	MulticoreCPUDevice::PartitionedAllocation::~PartitionedAllocation()
+	{
+		// stop tracking the pages before they can be mapped again
+		DirtyPageTracker::release(pointer(), size());
+		WorkerAffinity::release(pointer(), size());
+	}
+
 	ExecutableKernel* MulticoreCPUDevice::Module::getKernel(
 		const std::string& name)
 	{
@@ -44,6 +80,16 @@ namespace executive
 		
 		if(ptxKernel != ir->kernels().end())
 		{
+			NativeKernelFunction function = NativeKernel::lookup(name);
+			
+			if(function != 0)
+			{
+				kernel = kernels.insert(std::make_pair(name, 
+					new NativeKernel(*ptxKernel->second, device, 
+					function))).first;
+				return kernel->second;
+			}
+			
 			kernel = kernels.insert(std::make_pair(name, 
 				new LLVMExecutableKernel(*ptxKernel->second, device, 
 				cpu->_optimizationLevel))).first;
@@ -53,6 +99,254 @@ namespace executive
 		return 0;
 	}
 
+	MulticoreCPUDevice::TranslationQueue::TranslationQueue() 
+		: _started(false), _exit(false)
+	{
+
+	}
+
+	MulticoreCPUDevice::TranslationQueue::~TranslationQueue()
+	{
+		{
+			boost::mutex::scoped_lock lock(_mutex);
+			_kernels.clear();
+			_exit = true;
+		}
+		
+		_queued.notify_all();
+		_threads.join_all();
+	}
+
+	void MulticoreCPUDevice::TranslationQueue::push(
+		LLVMExecutableKernel* kernel)
+	{
+		boost::mutex::scoped_lock lock(_mutex);
+		
+		if(!_started)
+		{
+			_started = true;
+		
+			int threads = 
+				api::OcelotConfiguration::get().executive.translationThreads;
+			if(threads <= 0) threads = hydrazine::getHardwareThreadCount();
+			
+			report("Starting " << threads << " translation threads.");
+			
+			for(int i = 0; i < threads; ++i)
+			{
+				_threads.create_thread(
+					boost::bind(&TranslationQueue::_run, this));
+			}
+		}
+		
+		_kernels.push_back(kernel);
+		_queued.notify_one();
+	}
+
+	void MulticoreCPUDevice::TranslationQueue::remove(
+		LLVMExecutableKernel* kernel)
+	{
+		boost::mutex::scoped_lock lock(_mutex);
+		
+		KernelQueue::iterator queued = std::find(_kernels.begin(), 
+			_kernels.end(), kernel);
+		if(queued != _kernels.end()) _kernels.erase(queued);
+		
+		while(_active.count(kernel) != 0) _finished.wait(lock);
+	}
+
+	void MulticoreCPUDevice::TranslationQueue::_run()
+	{
+		boost::mutex::scoped_lock lock(_mutex);
+		
+		while(true)
+		{
+			while(_kernels.empty() && !_exit) _queued.wait(lock);
+			if(_exit) break;
+			
+			LLVMExecutableKernel* kernel = _kernels.front();
+			_kernels.pop_front();
+			_active.insert(kernel);
+			
+			lock.unlock();
+			
+			report("Translating kernel \"" << kernel->name 
+				<< "\" in the background.");
+			
+			try
+			{
+				kernel->translate();
+			}
+			catch(...)
+			{
+				// the error is rethrown when the kernel is launched
+			}
+			
+			lock.lock();
+			
+			_active.erase(kernel);
+			_finished.notify_all();
+		}
+	}
+
+	MulticoreCPUDevice::Autotuner::Schedule::Schedule(unsigned int w,
+		unsigned int c) : workers(w), chunkDivisor(c)
+	{
+	
+	}
+	
+	MulticoreCPUDevice::Autotuner::Search::Search() : next(0), seconds(0.0),
+		chunks(false), warm(false), version(0)
+	{
+	
+	}
+	
+	MulticoreCPUDevice::Autotuner::Autotuner() : _loaded(false), 
+		_modified(false)
+	{
+	
+	}
+	
+	MulticoreCPUDevice::Autotuner::~Autotuner()
+	{
+		if(_modified) _save();
+	}
+	
+	MulticoreCPUDevice::Autotuner::Schedule 
+		MulticoreCPUDevice::Autotuner::select(const std::string& module,
+		const std::string& kernel, unsigned int ctas, unsigned int workers)
+	{
+		if(!_loaded) _load();
+		
+		SearchId id(KernelId(module, kernel), ctas);
+		
+		ScheduleMap::const_iterator tuned = _tuned.find(id);
+		if(tuned != _tuned.end()) return tuned->second;
+		
+		Search& search = _searches[id];
+		
+		if(!search.warm) return Schedule();
+		
+		if(search.candidates.empty())
+		{
+			// more workers than CTAs would only wake up idle threads
+			for(unsigned int w = std::max(1u, std::min(workers, ctas)); 
+				w > 0; w /= 2)
+			{
+				search.candidates.push_back(Schedule(w, 0));
+			}
+		}
+		
+		return search.candidates[search.next];
+	}
+	
+	void MulticoreCPUDevice::Autotuner::record(const std::string& module,
+		const std::string& kernel, unsigned int ctas, 
+		const Schedule& schedule, double seconds, unsigned int version)
+	{
+		SearchId id(KernelId(module, kernel), ctas);
+		
+		SearchMap::iterator search = _searches.find(id);
+		if(search == _searches.end()) return;
+		
+		if(search->second.warm && search->second.version != version)
+		{
+			report("Restarting the search for kernel \"" << kernel 
+				<< "\" with " << ctas << " CTAs, its code was replaced.");
+			search->second = Search();
+		}
+		
+		if(!search->second.warm)
+		{
+			search->second.warm = true;
+			search->second.version = version;
+			return;
+		}
+		
+		if(search->second.next == 0 || seconds < search->second.seconds)
+		{
+			search->second.best = schedule;
+			search->second.seconds = seconds;
+		}
+		
+		if(++search->second.next < search->second.candidates.size()) return;
+		
+		if(!search->second.chunks)
+		{
+			search->second.chunks = true;
+			
+			const unsigned int divisors[] = AUTOTUNING_CHUNK_DIVISORS;
+			for(unsigned int i = 0; i < sizeof(divisors) / sizeof(unsigned int);
+				++i)
+			{
+				search->second.candidates.push_back(Schedule(
+					search->second.best.workers, divisors[i]));
+			}
+			
+			if(search->second.next < search->second.candidates.size()) return;
+		}
+		
+		report("Tuned kernel \"" << kernel << "\" with " << ctas 
+			<< " CTAs to " << search->second.best.workers 
+			<< " workers and chunk divisor " 
+			<< search->second.best.chunkDivisor << " (" 
+			<< (search->second.seconds * 1.0e3) << " ms).");
+		
+		_tuned.insert(std::make_pair(id, search->second.best));
+		_searches.erase(search);
+		
+		_modified = true;
+	}
+	
+	void MulticoreCPUDevice::Autotuner::_load()
+	{
+		_loaded = true;
+		
+		_path = api::OcelotConfiguration::get().executive.autotuningFile;
+		if(_path.empty()) return;
+		
+		std::ifstream file(_path.c_str());
+		
+		std::string kernel;
+		std::string module;
+		unsigned int ctas = 0;
+		Schedule schedule;
+		
+		// the module name ends the line because it may contain spaces
+		while(file >> kernel >> ctas >> schedule.workers 
+			>> schedule.chunkDivisor >> std::ws 
+			&& std::getline(file, module))
+		{
+			_tuned[SearchId(KernelId(module, kernel), ctas)] = schedule;
+		}
+		
+		report("Loaded " << _tuned.size() << " tuned schedules from " 
+			<< _path);
+	}
+	
+	void MulticoreCPUDevice::Autotuner::_save() const
+	{
+		if(_path.empty()) return;
+		
+		std::ofstream file(_path.c_str());
+		
+		if(!file.is_open())
+		{
+			std::cerr << "==Ocelot== WARNING: Failed to save tuned schedules"
+				<< " to " << _path << "\n";
+			return;
+		}
+		
+		for(ScheduleMap::const_iterator tuned = _tuned.begin(); 
+			tuned != _tuned.end(); ++tuned)
+		{
+			file << tuned->first.first.second << " " << tuned->first.second 
+				<< " " << tuned->second.workers << " " 
+				<< tuned->second.chunkDivisor << " " 
+				<< tuned->first.first.first << "\n";
+		}
+	}
+
 	MulticoreCPUDevice::MulticoreCPUDevice(unsigned int flags) 
 		: EmulatorDevice(flags), _workerThreads(-1),
 		_optimizationLevel(translator::Translator::NoOptimization)
@@ -69,8 +363,42 @@ namespace executive
 		{
 			Throw("Duplicate module - " << module->path());
 		}
-		_modules.insert(std::make_pair(module->path(), 
-			new Module(module, this)));	
+		Module* cpuModule = new Module(module, this);
+		_modules.insert(std::make_pair(module->path(), cpuModule));
+		
+		if(!api::OcelotConfiguration::get().executive.backgroundTranslation)
+		{
+			return;
+		}
+		
+		for(ir::Module::KernelMap::const_iterator 
+			kernel = module->kernels().begin(); 
+			kernel != module->kernels().end(); ++kernel)
+		{
+			ExecutableKernel* cpuKernel = cpuModule->getKernel(kernel->first);
+			if(cpuKernel->ISA != ir::Instruction::LLVM) continue;
+			
+			_translations.push(static_cast<LLVMExecutableKernel*>(cpuKernel));
+		}
+	}
+
+	void MulticoreCPUDevice::unload(const std::string& name)
+	{
+		ModuleMap::iterator module = _modules.find(name);
+		
+		if(module != _modules.end())
+		{
+			for(Module::KernelMap::iterator 
+				kernel = module->second->kernels.begin(); 
+				kernel != module->second->kernels.end(); ++kernel)
+			{
+				if(kernel->second->ISA != ir::Instruction::LLVM) continue;
+				_translations.remove(
+					static_cast<LLVMExecutableKernel*>(kernel->second));
+			}
+		}
+		
+		EmulatorDevice::unload(name);
 	}
 
 	ExecutableKernel* MulticoreCPUDevice::getKernel(
@@ -83,6 +411,23 @@ namespace executive
 		return module->second->getKernel(kernelName);
 	}
 	
+	Device::MemoryAllocation* MulticoreCPUDevice::allocate(size_t size)
+	{
+		// the same worker count that kernels launched on this device use
+		unsigned int workers = std::min(
+			(unsigned int)_properties.multiprocessorCount, 
+			(unsigned int)_workerThreads);
+		
+		void* pointer = WorkerAffinity::allocate(size, workers);
+		
+		if(pointer == 0) return EmulatorDevice::allocate(size);
+		
+		MemoryAllocation* allocation = new PartitionedAllocation(pointer, size);
+		_allocations.insert(std::make_pair(allocation->pointer(), allocation));
+		
+		return allocation;
+	}
+
 	void MulticoreCPUDevice::launch(const std::string& moduleName, 
 		const std::string& kernelName, const ir::Dim3& grid, 
 		const ir::Dim3& block, size_t sharedMemory, 
@@ -104,6 +449,12 @@ namespace executive
 				<< " in module " << moduleName);
 		}
 		
+		// wait for this kernel only if it is still being translated
+		if(kernel->ISA == ir::Instruction::LLVM)
+		{
+			static_cast<LLVMExecutableKernel*>(kernel)->translate();
+		}
+		
 		if(kernel->sharedMemorySize() + sharedMemory > 
 			(size_t)properties().sharedMemPerBlock)
 		{
@@ -132,7 +483,35 @@ namespace executive
 		kernel->setExternSharedMemorySize(sharedMemory);
 		kernel->setWorkerThreads(_workerThreads);
 		
+		if(kernel->ISA != ir::Instruction::LLVM 
+			|| !api::OcelotConfiguration::get().executive.autotuning)
+		{
+			kernel->launchGrid(grid.x, grid.y);
+			return;
+		}
+		
+		unsigned int ctas = grid.x * grid.y;
+		unsigned int workers = std::min(
+			(unsigned int)_properties.multiprocessorCount, 
+			(unsigned int)_workerThreads);
+		
+		LLVMExecutableKernel* llvmKernel = 
+			static_cast<LLVMExecutableKernel*>(kernel);
+		
+		Autotuner::Schedule schedule = _autotuner.select(moduleName, 
+			kernel->name, ctas, workers);
+		llvmKernel->setCtaSchedule(schedule.workers, schedule.chunkDivisor);
+		
+		hydrazine::Timer timer;
+		timer.start();
+		
 		kernel->launchGrid(grid.x, grid.y);
+		
+		timer.stop();
+		
+		// a launch that swaps in a higher tier starts the search over
+		_autotuner.record(moduleName, kernel->name, ctas, schedule, 
+			timer.seconds(), llvmKernel->codeVersion());
 	}
 
 	void MulticoreCPUDevice::limitWorkerThreads(unsigned int threads)
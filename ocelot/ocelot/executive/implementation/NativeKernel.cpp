@@ -0,0 +1,367 @@
+/*! \file NativeKernel.cpp
+	\author agent
+	\date October 18, 2026
+	\brief The source file for the NativeKernel class.
+*/
+
+#ifndef NATIVE_KERNEL_CPP_INCLUDED
+#define NATIVE_KERNEL_CPP_INCLUDED
+
+// ocelot includes
+#include <ocelot/executive/interface/NativeKernel.h>
+#include <ocelot/api/interface/OcelotConfiguration.h>
+
+// hydrazine includes
+#include <hydrazine/implementation/debug.h>
+#include <hydrazine/interface/Casts.h>
+#include <hydrazine/interface/WindowsCompatibility.h>
+
+// boost includes
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+
+// Standard library includes
+#include <unordered_map>
+#include <algorithm>
+#include <deque>
+#include <iostream>
+
+// Linux includes
+#include <dlfcn.h>
+
+#ifdef REPORT_BASE
+#undef REPORT_BASE
+#endif
+
+// Turn on report messages
+#define REPORT_BASE 0
+
+namespace executive
+{
+	/*! \brief The native kernel libraries and entry points loaded so far */
+	class NativeKernelRegistry
+	{
+		public:
+			typedef std::unordered_map<std::string, NativeKernelFunction>
+				FunctionMap;
+			typedef std::unordered_map<std::string, void*> LibraryMap;
+
+		public:
+			/*! \brief Protects the maps */
+			boost::mutex mutex;
+			/*! \brief Entry points by kernel name, 0 if loading failed */
+			FunctionMap functions;
+			/*! \brief Library handles by path, 0 if loading failed */
+			LibraryMap libraries;
+	};
+
+	static NativeKernelRegistry& registry()
+	{
+		static NativeKernelRegistry registry;
+		return registry;
+	}
+
+	/*! \brief Threads shared by all native kernels that run the CTA ranges
+		of launches, started when a launch first needs them */
+	class NativeWorkerPool
+	{
+		public:
+			typedef boost::function<void ()> Task;
+
+		private:
+			/*! \brief A range of CTAs and the launch that it belongs to */
+			class Job
+			{
+				public:
+					Job(const Task& t, unsigned int* r)
+						: task(t), remaining(r) {}
+
+				public:
+					/*! \brief Runs the range */
+					Task task;
+					/*! \brief The ranges of the launch that are not done */
+					unsigned int* remaining;
+			};
+
+			typedef std::deque<Job> JobQueue;
+
+		private:
+			/*! \brief Protects everything in the pool */
+			boost::mutex _mutex;
+			/*! \brief Signalled when jobs are queued or on exit */
+			boost::condition_variable _queued;
+			/*! \brief Signalled when a thread finishes a job */
+			boost::condition_variable _finished;
+			/*! \brief Jobs waiting for a thread */
+			JobQueue _jobs;
+			/*! \brief The worker threads */
+			boost::thread_group _threads;
+			/*! \brief The number of threads started so far */
+			unsigned int _started;
+			/*! \brief Should the threads exit? */
+			bool _exit;
+
+		public:
+			/*! \brief Create a pool without threads */
+			NativeWorkerPool() : _started(0), _exit(false) {}
+
+			/*! \brief Drop queued jobs and join the threads */
+			~NativeWorkerPool()
+			{
+				{
+					boost::mutex::scoped_lock lock(_mutex);
+					_jobs.clear();
+					_exit = true;
+				}
+
+				_queued.notify_all();
+				_threads.join_all();
+			}
+
+		public:
+			/*! \brief Run the first task on the calling thread and the
+				others on the pool, return once they have all finished */
+			void run(const std::vector<Task>& tasks)
+			{
+				unsigned int remaining = tasks.size() - 1;
+
+				{
+					boost::mutex::scoped_lock lock(_mutex);
+
+					for( ; _started < remaining; ++_started)
+					{
+						_threads.create_thread(
+							boost::bind(&NativeWorkerPool::_run, this));
+					}
+
+					for(std::vector<Task>::const_iterator
+						task = tasks.begin() + 1; task != tasks.end(); ++task)
+					{
+						_jobs.push_back(Job(*task, &remaining));
+					}
+				}
+
+				_queued.notify_all();
+
+				tasks.front()();
+
+				boost::mutex::scoped_lock lock(_mutex);
+				while(remaining != 0) _finished.wait(lock);
+			}
+
+		private:
+			/*! \brief The main loop of a worker thread */
+			void _run()
+			{
+				boost::mutex::scoped_lock lock(_mutex);
+
+				while(true)
+				{
+					while(_jobs.empty() && !_exit) _queued.wait(lock);
+					if(_exit) break;
+
+					Job job = _jobs.front();
+					_jobs.pop_front();
+
+					lock.unlock();
+
+					job.task();
+
+					lock.lock();
+
+					if(--*job.remaining == 0) _finished.notify_all();
+				}
+			}
+	};
+
+	static NativeWorkerPool& workerPool()
+	{
+		static NativeWorkerPool pool;
+		return pool;
+	}
+
+	NativeKernelFunction NativeKernel::lookup(const std::string& name)
+	{
+		const api::OcelotConfiguration::Executive::NativeKernelMap& kernels =
+			api::OcelotConfiguration::get().executive.nativeKernels;
+
+		api::OcelotConfiguration::Executive::NativeKernelMap::const_iterator
+			entry = kernels.find(name);
+		if(entry == kernels.end()) return 0;
+
+		NativeKernelRegistry& registry = executive::registry();
+		boost::mutex::scoped_lock lock(registry.mutex);
+
+		NativeKernelRegistry::FunctionMap::iterator function =
+			registry.functions.find(name);
+		if(function != registry.functions.end()) return function->second;
+
+		std::string library = entry->second;
+		std::string symbol = name;
+
+		std::string::size_type colon = library.rfind(':');
+		if(colon != std::string::npos)
+		{
+			symbol = library.substr(colon + 1);
+			library = library.substr(0, colon);
+		}
+
+		NativeKernelRegistry::LibraryMap::iterator handle =
+			registry.libraries.find(library);
+
+		if(handle == registry.libraries.end())
+		{
+			// an empty library searches the program itself
+			void* object = dlopen(library.empty() ? 0 : library.c_str(),
+				RTLD_NOW | RTLD_LOCAL);
+
+			if(object == 0)
+			{
+				std::cerr << "==Ocelot== WARNING: Failed to load native "
+					<< "kernel library " << library << ": " << dlerror()
+					<< "\n";
+			}
+
+			handle = registry.libraries.insert(
+				std::make_pair(library, object)).first;
+		}
+
+		NativeKernelFunction pointer = 0;
+
+		if(handle->second != 0)
+		{
+			hydrazine::bit_cast(pointer, dlsym(handle->second,
+				symbol.c_str()));
+
+			if(pointer == 0)
+			{
+				std::cerr << "==Ocelot== WARNING: Native kernel " << symbol
+					<< " not found in " << library << ", running the PTX "
+					<< "of " << name << " instead.\n";
+			}
+			else
+			{
+				report("Using native kernel " << symbol << " from "
+					<< library << " for " << name);
+			}
+		}
+
+		registry.functions.insert(std::make_pair(name, pointer));
+
+		return pointer;
+	}
+
+	NativeKernel::NativeKernel(const ir::Kernel& kernel, Device* d,
+		NativeKernelFunction function) : ExecutableKernel(kernel, d),
+		_function(function), _workerThreads(1)
+	{
+		ISA = ir::Instruction::External;
+		_parameterMemorySize = mapParameterOffsets();
+	}
+
+	void NativeKernel::launchGrid(int width, int height)
+	{
+		_gridDim = ir::Dim3(width, height, 1);
+
+		unsigned int ctas = width * height;
+		unsigned int workers = std::min(_workerThreads,
+			hydrazine::getHardwareThreadCount());
+		workers = std::max(1u, std::min(workers, ctas));
+
+		report("Launching native kernel " << name << " with " << ctas
+			<< " CTAs on " << workers << " workers.");
+
+		if(workers == 1)
+		{
+			_run(0, 0, ctas);
+			return;
+		}
+
+		std::vector<NativeWorkerPool::Task> tasks;
+
+		for(unsigned int worker = 0; worker < workers; ++worker)
+		{
+			tasks.push_back(boost::bind(&NativeKernel::_run, this,
+				worker, (ctas * worker) / workers,
+				(ctas * (worker + 1)) / workers));
+		}
+
+		workerPool().run(tasks);
+	}
+
+	void NativeKernel::setKernelShape(int x, int y, int z)
+	{
+		_blockDim = ir::Dim3(x, y, z);
+	}
+
+	void NativeKernel::setExternSharedMemorySize(unsigned int bytes)
+	{
+		_externSharedMemorySize = bytes;
+	}
+
+	void NativeKernel::setWorkerThreads(unsigned int limit)
+	{
+		_workerThreads = std::max(1u, limit);
+	}
+
+	void NativeKernel::updateParameterMemory()
+	{
+		_parameterMemorySize = mapParameterOffsets();
+		_parameterBlock.assign(_parameterMemorySize, 0);
+
+		if(_parameterBlock.empty()) return;
+
+		getParameterBlock((unsigned char*)&_parameterBlock[0],
+			_parameterBlock.size());
+	}
+
+	void NativeKernel::updateMemory()
+	{
+
+	}
+
+	ExecutableKernel::TextureVector NativeKernel::textureReferences() const
+	{
+		return TextureVector();
+	}
+
+	void NativeKernel::addTraceGenerator(trace::TraceGenerator* generator)
+	{
+		std::cerr << "==Ocelot== WARNING: Native kernel " << name
+			<< " cannot be traced, the trace generator is not attached.\n";
+	}
+
+	void NativeKernel::removeTraceGenerator(trace::TraceGenerator* generator)
+	{
+
+	}
+
+	void NativeKernel::_run(unsigned int worker, unsigned int begin,
+		unsigned int end)
+	{
+		std::vector<char> shared(_externSharedMemorySize);
+
+		NativeKernelContext context;
+
+		context.ntid[0] = _blockDim.x;
+		context.ntid[1] = _blockDim.y;
+		context.ntid[2] = _blockDim.z;
+		context.nctaid[0] = _gridDim.x;
+		context.nctaid[1] = _gridDim.y;
+		context.nctaid[2] = _gridDim.z;
+		context.begin = begin;
+		context.end = end;
+		context.parameters = _parameterBlock.empty()
+			? 0 : &_parameterBlock[0];
+		context.parameterSize = _parameterBlock.size();
+		context.shared = shared.empty() ? 0 : &shared[0];
+		context.sharedSize = shared.size();
+		context.worker = worker;
+
+		_function(&context);
+	}
+}
+
+#endif
+
@@ -0,0 +1,293 @@
+/*! \file WorkerAffinity.cpp
+	\author agent
+	\date October 18, 2026
+	\brief The source file for the WorkerAffinity class.
+*/
+
+#ifndef WORKER_AFFINITY_CPP_INCLUDED
+#define WORKER_AFFINITY_CPP_INCLUDED
+
+// ocelot includes
+#include <ocelot/executive/interface/WorkerAffinity.h>
+#include <ocelot/api/interface/OcelotConfiguration.h>
+
+// hydrazine includes
+#include <hydrazine/implementation/debug.h>
+#include <hydrazine/interface/WindowsCompatibility.h>
+
+// Standard library includes
+#include <vector>
+#include <sstream>
+#include <fstream>
+
+// Linux includes
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <linux/mempolicy.h>
+
+#ifdef REPORT_BASE
+#undef REPORT_BASE
+#endif
+
+// Turn on report messages
+#define REPORT_BASE 0
+
+// Allocations smaller than this many pages per worker are not partitioned
+#define MINIMUM_PARTITION_PAGES 4
+
+namespace executive
+{
+	typedef std::vector<unsigned int> CpuVector;
+	typedef std::vector<CpuVector> NodeVector;
+
+	/*! \brief The cores in each NUMA node */
+	class Topology
+	{
+		public:
+			/*! \brief The cores of each node, -1 is unknown */
+			NodeVector nodes;
+			/*! \brief The node of each core */
+			std::vector<int> cpuNodes;
+			/*! \brief Was the topology found in sysfs? */
+			bool known;
+
+		public:
+			/*! \brief Read the topology from sysfs */
+			Topology();
+
+		private:
+			/*! \brief Parse a list of cpus like "0-3,8-11" */
+			static CpuVector _parse(const std::string& list);
+	};
+
+	Topology::Topology() : known(false)
+	{
+		for(unsigned int node = 0; ; ++node)
+		{
+			std::stringstream path;
+			path << "/sys/devices/system/node/node" << node << "/cpulist";
+
+			std::ifstream file(path.str().c_str());
+			if(!file.is_open()) break;
+
+			std::string list;
+			std::getline(file, list);
+
+			nodes.push_back(_parse(list));
+
+			for(CpuVector::iterator cpu = nodes.back().begin();
+				cpu != nodes.back().end(); ++cpu)
+			{
+				if(*cpu >= cpuNodes.size()) cpuNodes.resize(*cpu + 1, -1);
+				cpuNodes[*cpu] = node;
+			}
+		}
+
+		known = !nodes.empty();
+
+		if(!known)
+		{
+			nodes.resize(1);
+			for(unsigned int cpu = 0;
+				cpu < hydrazine::getHardwareThreadCount(); ++cpu)
+			{
+				nodes.back().push_back(cpu);
+			}
+		}
+
+		report("Found " << nodes.size() << " NUMA nodes.");
+	}
+
+	CpuVector Topology::_parse(const std::string& list)
+	{
+		CpuVector cpus;
+		std::stringstream stream(list);
+		std::string range;
+
+		while(std::getline(stream, range, ','))
+		{
+			unsigned int begin = 0;
+			unsigned int end = 0;
+			char dash = 0;
+
+			std::stringstream bounds(range);
+			if(!(bounds >> begin)) continue;
+			if(!(bounds >> dash >> end)) end = begin;
+
+			for(unsigned int cpu = begin; cpu <= end; ++cpu)
+			{
+				cpus.push_back(cpu);
+			}
+		}
+
+		return cpus;
+	}
+
+	static const Topology& topology()
+	{
+		static Topology topology;
+		return topology;
+	}
+
+	/*! \brief Get the core for a worker, -1 if it is not pinned */
+	static int cpu(unsigned int worker)
+	{
+		const api::OcelotConfiguration::Executive& configuration =
+			api::OcelotConfiguration::get().executive;
+		const Topology& topology = executive::topology();
+
+		switch(WorkerAffinity::policy())
+		{
+			case WorkerAffinity::Compact:
+			{
+				unsigned int total = 0;
+				for(NodeVector::const_iterator node = topology.nodes.begin();
+					node != topology.nodes.end(); ++node)
+				{
+					total += node->size();
+				}
+
+				if(total == 0) return -1;
+				unsigned int index = worker % total;
+
+				for(NodeVector::const_iterator node = topology.nodes.begin();
+					node != topology.nodes.end(); ++node)
+				{
+					if(index < node->size()) return (*node)[index];
+					index -= node->size();
+				}
+				break;
+			}
+			case WorkerAffinity::Scatter:
+			{
+				const CpuVector& node = topology.nodes[
+					worker % topology.nodes.size()];
+				if(node.empty()) return -1;
+				return node[(worker / topology.nodes.size()) % node.size()];
+			}
+			case WorkerAffinity::Explicit:
+			{
+				const std::vector<int>& cpus = configuration.workerCpus;
+				if(cpus.empty()) return -1;
+				return cpus[worker % cpus.size()];
+			}
+			default: break;
+		}
+
+		return -1;
+	}
+
+	WorkerAffinity::Policy WorkerAffinity::policy()
+	{
+		const std::string& name =
+			api::OcelotConfiguration::get().executive.workerAffinity;
+
+		if(name == "none") return None;
+		if(name == "compact") return Compact;
+		if(name == "scatter") return Scatter;
+		if(name == "explicit") return Explicit;
+
+		report("Unknown workerAffinity '" << name << "' - using none");
+		return None;
+	}
+
+	bool WorkerAffinity::enabled()
+	{
+		return policy() != None;
+	}
+
+	void WorkerAffinity::pin(unsigned int worker)
+	{
+		int core = cpu(worker);
+		if(core < 0 || core >= CPU_SETSIZE) return;
+
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(core, &set);
+
+		if(pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &set)
+			!= 0)
+		{
+			report("Failed to pin worker " << worker << " to core " << core);
+			return;
+		}
+
+		report("Pinned worker " << worker << " to core " << core);
+	}
+
+	int WorkerAffinity::node(unsigned int worker)
+	{
+		const Topology& topology = executive::topology();
+		if(!topology.known) return -1;
+
+		int core = cpu(worker);
+		if(core < 0 || core >= (int)topology.cpuNodes.size()) return -1;
+
+		return topology.cpuNodes[core];
+	}
+
+	void* WorkerAffinity::allocate(size_t bytes, unsigned int workers)
+	{
+		if(!api::OcelotConfiguration::get().executive.partitionAllocations)
+		{
+			return 0;
+		}
+
+		const Topology& topology = executive::topology();
+		if(!topology.known || topology.nodes.size() < 2 || workers < 2)
+		{
+			return 0;
+		}
+
+		size_t page = getpagesize();
+		size_t pages = (bytes + page - 1) / page;
+
+		if(pages < MINIMUM_PARTITION_PAGES * workers) return 0;
+
+		void* pointer = mmap(0, pages * page, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if(pointer == MAP_FAILED) return 0;
+
+		size_t begin = (size_t)pointer;
+
+		const unsigned int bits = 8 * sizeof(unsigned long);
+		std::vector<unsigned long> mask(topology.nodes.size() / bits + 1);
+
+		for(unsigned int worker = 0; worker < workers; ++worker)
+		{
+			int node = WorkerAffinity::node(worker);
+			if(node < 0) continue;
+
+			size_t first = begin + ((pages * worker) / workers) * page;
+			size_t last = begin + ((pages * (worker + 1)) / workers) * page;
+
+			mask.assign(mask.size(), 0);
+			mask[node / bits] |= 1ul << (node % bits);
+
+			// nothing has been touched yet, so the policy places every page
+			//  on the first fault and nothing needs to move
+			if(syscall(SYS_mbind, first, last - first, MPOL_BIND, &mask[0],
+				mask.size() * bits + 1, 0) != 0)
+			{
+				report("Failed to bind pages [" << (void*)first << ", "
+					<< (void*)last << ") to node " << node);
+			}
+		}
+
+		return pointer;
+	}
+
+	void WorkerAffinity::release(void* pointer, size_t bytes)
+	{
+		if(pointer == 0) return;
+
+		size_t page = getpagesize();
+		munmap(pointer, ((bytes + page - 1) / page) * page);
+	}
+}
+
+#endif
+
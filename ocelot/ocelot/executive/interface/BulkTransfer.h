@@ -0,0 +1,66 @@
+/*! \file BulkTransfer.h
+	\author agent
+	\date October 18, 2026
+	\brief The header file for the BulkTransfer class.
+*/
+
+#ifndef BULK_TRANSFER_H_INCLUDED
+#define BULK_TRANSFER_H_INCLUDED
+
+// Standard library includes
+#include <cstddef>
+
+namespace executive
+{
+	/*! \brief Copies and sets large spans of memory for devices that share
+		the host address space.
+
+		Small transfers fall through to std::memcpy/std::memset.  Transfers
+		over a threshold are split across a pool of host threads that is
+		started once and reused by every transfer, and
+		transfers that are larger than the last level cache use
+		non-temporal stores so that they do not evict the working set.
+	*/
+	class BulkTransfer
+	{
+		public:
+			/*! \brief Statistics describing a single transfer */
+			class Statistics
+			{
+				public:
+					/*! \brief The number of bytes transferred */
+					size_t bytes;
+					/*! \brief The time taken by the transfer in seconds */
+					double seconds;
+					/*! \brief The number of threads used */
+					unsigned int threads;
+					/*! \brief Were non-temporal stores used? */
+					bool nonTemporal;
+
+				public:
+					/*! \brief Initialize an empty transfer */
+					Statistics();
+
+				public:
+					/*! \brief The achieved bandwidth in GB/s */
+					double bandwidth() const;
+			};
+
+		public:
+			/*! \brief Copy a span of memory, the spans must not overlap */
+			static Statistics copy(void* destination, const void* source,
+				size_t bytes);
+			/*! \brief Set a span of memory to a byte value */
+			static Statistics memset(void* destination, int value,
+				size_t bytes);
+
+		public:
+			/*! \brief The size of the last level cache in bytes */
+			static size_t cacheSize();
+			/*! \brief The number of threads that a transfer may use */
+			static unsigned int threads(size_t bytes);
+	};
+}
+
+#endif
+
@@ -0,0 +1,198 @@
+/*! \file CtaSampler.h
+	\author agent
+	\date October 18, 2026
+	\brief The header file for the CtaSampler class.
+*/
+
+#ifndef CTA_SAMPLER_H_INCLUDED
+#define CTA_SAMPLER_H_INCLUDED
+
+// ocelot includes
+#include <ocelot/trace/interface/TraceGenerator.h>
+#include <ocelot/trace/interface/TraceEvent.h>
+#include <ocelot/ir/interface/PTXOperand.h>
+
+// Standard library includes
+#include <string>
+#include <vector>
+#include <map>
+#include <ostream>
+
+namespace executive
+{
+	/*! \brief Picks the CTAs of a sampled launch and extrapolates what was
+		counted for them to the whole grid.
+
+		Sampled launches only execute a subset of the CTAs, so they are
+		only meant for analysis runs, the output of the kernel is wrong.
+		Random and strided sampling run that many CTAs of the grid.
+		Clustered sampling first profiles a few more CTAs spread over the
+		grid without the trace generators, groups them by how often each
+		instruction ran, and then replays the events of the CTA closest to
+		the center of each group to the trace generators, weighted by the
+		size of the group.  The profiled CTAs run once, so side effects of
+		the kernel, such as counters that it sums in memory, cover the
+		profiled CTAs and are scaled by scale().
+
+		The counter is a trace generator that kernels attach next to the
+		others to measure the CTAs that they run.  The totals are N times
+		the sample mean for random and strided sampling, and the weighted
+		sum of the representatives for clustered sampling.  The error is
+		an approximate 95% confidence bound.
+	*/
+	class CtaSampler
+	{
+		public:
+			/*! \brief How CTAs are picked */
+			enum Mode
+			{
+				NoSampling,
+				RandomSampling,
+				StridedSampling,
+				ClusteredSampling
+			};
+
+			/*! \brief The extrapolated value of a counter for the grid */
+			class Estimate
+			{
+				public:
+					/*! \brief Start at zero */
+					Estimate();
+
+				public:
+					/*! \brief The estimated total for the grid */
+					double total;
+					/*! \brief The half width of the 95% bound, infinite if
+						there is not enough data */
+					double error;
+			};
+
+			typedef std::map<std::string, Estimate> EstimateMap;
+			/*! \brief Linear CTA ids, x + y * width */
+			typedef std::vector<unsigned int> IdVector;
+
+			/*! \brief Counts the events of each CTA that a kernel runs */
+			class Counter : public trace::TraceGenerator
+			{
+				public:
+					/*! \brief Count into a sampler */
+					Counter(CtaSampler& sampler);
+
+				public:
+					/*! \brief Count an event */
+					void event(const trace::TraceEvent& event);
+					/*! \brief Record a committed event while profiling */
+					void postEvent(const trace::TraceEvent& event);
+
+				private:
+					/*! \brief The sampler being counted for */
+					CtaSampler& _sampler;
+			};
+
+		private:
+			/*! \brief One value for each counter */
+			typedef std::vector<double> MetricVector;
+			/*! \brief How often each PC ran */
+			typedef std::map<ir::PTXU64, double> FeatureMap;
+
+			/*! \brief An event seen while profiling */
+			class RecordedEvent
+			{
+				public:
+					/*! \brief Was it passed to postEvent()? */
+					bool post;
+					/*! \brief A copy of the event */
+					trace::TraceEvent event;
+			};
+
+			typedef std::vector<RecordedEvent> EventVector;
+
+			/*! \brief What was counted for one CTA */
+			class Cta
+			{
+				public:
+					/*! \brief The counters */
+					MetricVector metrics;
+					/*! \brief The PC histogram, only kept while profiling */
+					FeatureMap features;
+					/*! \brief The events of a profiled CTA, only kept for
+						the representatives after clustering */
+					EventVector events;
+			};
+
+			typedef std::map<unsigned int, Cta> CtaMap;
+			typedef std::vector<double> WeightVector;
+
+		public:
+			/*! \brief The sampling mode in the configuration */
+			static Mode configuredMode();
+			/*! \brief The name of a mode */
+			static std::string toString(Mode mode);
+
+		public:
+			/*! \brief Pick the CTAs of a grid with the configured sample size
+				and seed */
+			CtaSampler(unsigned int ctas, Mode mode);
+
+		public:
+			/*! \brief CTAs to run with only the counter before clustering,
+				empty unless clustering */
+			const IdVector& profiled() const;
+			/*! \brief Group the profiled CTAs and pick the sampled ones */
+			void cluster();
+			/*! \brief The CTAs to run with the trace generators, sorted */
+			const IdVector& sampled() const;
+			/*! \brief How many CTAs of the grid a sampled CTA stands for */
+			double weight(unsigned int cta) const;
+			/*! \brief How many CTAs of the grid each CTA that ran stands for,
+				to scale counters that the kernel sums over the launch */
+			double scale() const;
+			/*! \brief Pass the recorded events of a profiled CTA to trace
+				generators in the order that they happened */
+			void replay(unsigned int cta,
+				const trace::TraceGeneratorVector& generators) const;
+			/*! \brief The number of CTAs in the grid */
+			unsigned int ctas() const;
+			/*! \brief The sampling mode */
+			Mode mode() const;
+
+		public:
+			/*! \brief Extrapolate the counters to the grid */
+			EstimateMap estimates() const;
+			/*! \brief Write a line with the estimates for a launch */
+			void write(std::ostream& out, const std::string& kernel) const;
+			/*! \brief Append the line to the configured report, if any */
+			void save(const std::string& kernel) const;
+
+		private:
+			/*! \brief Count an event for the CTA that it belongs to */
+			void _count(const trace::TraceEvent& event);
+			/*! \brief Record a committed event while profiling */
+			void _post(const trace::TraceEvent& event);
+
+		private:
+			/*! \brief The number of CTAs in the grid */
+			unsigned int _ctas;
+			/*! \brief The sampling mode */
+			Mode _mode;
+			/*! \brief The seed for random sampling and clustering */
+			unsigned int _seed;
+			/*! \brief CTAs to profile before clustering */
+			IdVector _profiled;
+			/*! \brief CTAs to trace */
+			IdVector _sampled;
+			/*! \brief The weight of each sampled CTA */
+			WeightVector _weights;
+			/*! \brief Is the profile being collected? */
+			bool _profiling;
+			/*! \brief Counters of the profiled CTAs */
+			CtaMap _profile;
+			/*! \brief Counters of the sampled CTAs */
+			CtaMap _traced;
+			/*! \brief The group of each profiled CTA */
+			IdVector _clusters;
+	};
+}
+
+#endif
+
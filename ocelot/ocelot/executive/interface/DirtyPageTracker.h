@@ -0,0 +1,76 @@
+/*! \file DirtyPageTracker.h
+	\author agent
+	\date October 18, 2026
+	\brief The header file for the DirtyPageTracker class.
+*/
+
+#ifndef DIRTY_PAGE_TRACKER_H_INCLUDED
+#define DIRTY_PAGE_TRACKER_H_INCLUDED
+
+// Standard library includes
+#include <cstddef>
+
+namespace executive
+{
+	/*! \brief Elides host to device copies of pages that have not changed
+		since the last time that they were copied.
+
+		After a tracked copy, the source pages in pinned host memory and the
+		destination pages in device memory are write protected.  Any write
+		to either side raises SIGSEGV, which marks the page dirty and
+		unprotects it.  Repeating the same copy then only moves dirty pages.
+
+		Only pinned host allocations are tracked, because their lifetime is
+		known to the device.  Pages that are only partially covered by a
+		copy are never protected and are always copied.
+
+		Protected pages can not be written by system calls (read() will
+		fail with EFAULT), so this is only enabled by request.
+	*/
+	class DirtyPageTracker
+	{
+		public:
+			/*! \brief Bytes moved and skipped over the life of the program */
+			class Statistics
+			{
+				public:
+					/*! \brief Bytes that were actually copied */
+					size_t copied;
+					/*! \brief Bytes that were clean and skipped */
+					size_t elided;
+
+				public:
+					/*! \brief Start with nothing copied */
+					Statistics();
+			};
+
+		public:
+			/*! \brief Is dirty page tracking enabled in the configuration? */
+			static bool enabled();
+
+			/*! \brief Allow copies from a pinned host allocation to be
+				tracked */
+			static void registerHost(const void* pointer, size_t bytes);
+
+			/*! \brief Stop tracking all copies that touch a range, this must
+				be called before the memory is freed */
+			static void release(const void* pointer, size_t bytes);
+
+			/*! \brief Mark a range dirty before it is overwritten by the
+				runtime, avoiding one fault per page */
+			static void touch(const void* pointer, size_t bytes);
+
+			/*! \brief Copy from host to device memory, skipping clean pages.
+
+				\return false if the copy can not be tracked, in which case
+					nothing was copied
+			*/
+			static bool copy(void* device, const void* host, size_t bytes);
+
+			/*! \brief Get the total bytes copied and elided so far */
+			static Statistics statistics();
+	};
+}
+
+#endif
+
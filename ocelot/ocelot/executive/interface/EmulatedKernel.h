@@ -19,6 +19,10 @@ namespace trace {
 	class TraceGenerator;
 }
 
+namespace executive {
+	class CtaSampler;
+}
+
 namespace executive {
 		
 	class EmulatedKernel: public ExecutableKernel {
@@ -29,10 +33,44 @@ namespace executive {
 		typedef std::map< int, std::pair< int, int > > ThreadFrontierMap;
 		typedef std::vector<ir::PTXU64> RegisterFile;
 
+	private:
+		/*! \brief An operand that references a global or constant symbol */
+		class SymbolReference {
+		public:
+			/*! \brief The PC of the instruction */
+			unsigned int pc;
+			/*! \brief The operand within the instruction */
+			ir::PTXOperand ir::PTXInstruction::* operand;
+		};
+		
+		typedef std::vector<SymbolReference> SymbolReferenceVector;
+		typedef std::map<std::string, SymbolReferenceVector> SymbolReferenceMap;
+		typedef std::map<std::string, unsigned int> ConstantOffsetMap;
+
 	private:
 		static void _computeOffset(const ir::PTXStatement& it, 
 			unsigned int& offset, unsigned int& totalOffset);
 
+		/*! \brief Walk the instruction sequence once, recording every 
+			reference to a global variable and assigning offsets to 
+			constants, so that later launches only touch the references */
+		void _buildLaunchPlan();
+
+		/*! \brief Run a single CTA of the current grid by linear id */
+		void _launchCta(unsigned int id);
+		
+		/*! \brief Run only the CTAs picked by a sampler, profiling them
+			first and replaying the representatives if it clusters, and
+			report the estimates */
+		void _launchSampled(CtaSampler& sampler);
+		
+		/*! \brief Should the trace generators see this launch? */
+		bool _traceLaunch() const;
+		
+		/*! \brief Should the trace generators see the nth CTA of a traced
+			launch? */
+		bool _traceCta(unsigned int ordinal) const;
+
 	public:
 		EmulatedKernel(ir::Kernel* kernel, Device* d = 0, 
 			bool initialize = true);
@@ -161,6 +199,19 @@ namespace executive {
 		/*! A handle to the current CTA, or 0 if none is executing */
 		executive::CooperativeThreadArray* CTA;
 
+	private:
+		/*! \brief Has the launch plan been built for the instructions? */
+		bool _launchPlanValid;
+		
+		/*! \brief Operands that reference each global variable */
+		SymbolReferenceMap _globalReferences;
+		
+		/*! \brief Offsets of each constant variable in const memory */
+		ConstantOffsetMap _constantOffsets;
+		
+		/*! \brief Launches of this kernel so far */
+		unsigned int _launches;
+
 	public:
 		/*! \brief Check to see if a memory access is valid */
 		bool checkMemoryAccess(const void* base, size_t size) const;
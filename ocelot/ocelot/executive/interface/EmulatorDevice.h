@@ -185,6 +185,9 @@ namespace executive
 			
 			/*! \brief Global timer */
 			hydrazine::Timer _timer;
+			
+			/*! \brief Are pinned host allocations mapped into device space? */
+			bool _zeroCopy;
 						
 		public:
 			/*! \brief Sets the device properties, bind this to the cuda id */
@@ -322,6 +325,15 @@ namespace executive
 			/*! \brief Set the optimization level for kernels in this device */
 			virtual void setOptimizationLevel(
 				translator::Translator::OptimizationLevel level);
+
+		protected:
+			/*! \brief Check the memory limits of a kernel, then set it up 
+				and launch it with trace generators attached */
+			void _launchKernel(ExecutableKernel* kernel, 
+				const ir::Dim3& grid, const ir::Dim3& block, 
+				size_t sharedMemory, const void* parameterBlock, 
+				size_t parameterBlockSize, 
+				const trace::TraceGeneratorVector& traceGenerators);
 	};
 }
 
@@ -0,0 +1,125 @@
+/*! \file HybridDevice.h
+	\author agent
+	\date October 18, 2026
+	\brief The header file for the HybridDevice class.
+*/
+
+#ifndef HYBRID_DEVICE_H_INCLUDED
+#define HYBRID_DEVICE_H_INCLUDED
+
+// ocelot includes
+#include <ocelot/executive/interface/MulticoreCPUDevice.h>
+
+// Standard library includes
+#include <map>
+
+namespace executive
+{
+	/*! \brief A CPU device that starts every kernel on the emulator and
+		moves hot kernels to the LLVM JIT.
+
+		A kernel runs on the emulator until it has been launched a
+		configured number of times without trace generators, after that it
+		runs on the JIT unless trace generators are attached.  Both backends
+		use the memory of this device, so switching costs nothing.
+
+		In calibration mode a promoted kernel is timed on the JIT for a few
+		launches after it has been compiled, and then pinned to whichever
+		backend took less time per thread.
+	*/
+	class HybridDevice : public MulticoreCPUDevice
+	{
+		private:
+			/*! \brief The backends that a kernel can run on */
+			enum Backend
+			{
+				Emulator = 0,
+				JIT = 1,
+				Backends = 2
+			};
+
+			/*! \brief Launch counters of a kernel */
+			class KernelState
+			{
+				public:
+					/*! \brief Launches without trace generators */
+					unsigned int launches;
+					/*! \brief Launches on the JIT */
+					unsigned int jitLaunches;
+					/*! \brief Is the kernel pinned to a backend? */
+					bool pinned;
+					/*! \brief The backend that it is pinned to */
+					Backend backend;
+					/*! \brief Time of the timed launches on each backend */
+					double seconds[Backends];
+					/*! \brief Threads run by the timed launches */
+					double threads[Backends];
+					/*! \brief Number of timed launches on each backend */
+					unsigned int timed[Backends];
+
+				public:
+					/*! \brief A kernel that has not been launched */
+					KernelState();
+			};
+
+			/*! \brief A kernel identified by module and kernel name */
+			typedef std::pair<std::string, std::string> KernelId;
+			/*! \brief The counters of every launched kernel */
+			typedef std::map<KernelId, KernelState> KernelStateMap;
+
+		private:
+			/*! \brief Modules holding the emulated copies of kernels, the
+				globals and textures are only kept in the LLVM modules */
+			ModuleMap _emulated;
+			/*! \brief The counters of every launched kernel */
+			KernelStateMap _kernels;
+
+		public:
+			/*! \brief Sets the device properties */
+			HybridDevice(unsigned int flags = 0);
+			/*! \brief Delete the emulated kernels */
+			~HybridDevice();
+
+		public:
+			/*! \brief Load a module for both backends */
+			void load(const ir::Module* module);
+			/*! \brief Unload a module by name from both backends */
+			void unload(const std::string& name);
+
+		public:
+			/*! \brief Launch a kernel on the emulator or the JIT
+				\param module module name
+				\param kernel kernel name
+				\param grid grid dimensions
+				\param block block dimensions
+				\param sharedMemory shared memory size
+				\param parameterBlock array of bytes for parameter memory
+				\param parameterBlockSize number of bytes in parameter memory
+				\param traceGenerators vector of trace generators to add
+					and remove from kernel, forces the emulator
+			*/
+			void launch(const std::string& module,
+				const std::string& kernel, const ir::Dim3& grid,
+				const ir::Dim3& block, size_t sharedMemory,
+				const void* parameterBlock, size_t parameterBlockSize,
+				const trace::TraceGeneratorVector&
+				traceGenerators = trace::TraceGeneratorVector());
+
+		private:
+			/*! \brief Pick the backend for the next launch of a kernel */
+			Backend _select(const KernelState& state, bool traced) const;
+			/*! \brief Launch the emulated copy of a kernel */
+			void _launchEmulated(const std::string& module,
+				const std::string& kernel, const ir::Dim3& grid,
+				const ir::Dim3& block, size_t sharedMemory,
+				const void* parameterBlock, size_t parameterBlockSize,
+				const trace::TraceGeneratorVector& traceGenerators);
+			/*! \brief Count an untraced launch, pins the kernel once it
+				has been calibrated */
+			void _record(const KernelId& id, KernelState& state,
+				Backend backend, double seconds, double threads);
+	};
+}
+
+#endif
+
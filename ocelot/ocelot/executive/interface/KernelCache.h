@@ -0,0 +1,66 @@
+/*! \file KernelCache.h
+	\author agent
+	\date October 18, 2026
+	\brief The header file for the KernelCache class.
+*/
+
+#ifndef KERNEL_CACHE_H_INCLUDED
+#define KERNEL_CACHE_H_INCLUDED
+
+// Standard library includes
+#include <string>
+
+namespace executive
+{
+	/*! \brief An on-disk cache of translated kernels shared by processes.
+
+		Entries are addressed by the contents of a description string that
+		must include everything the translated code depends on, the Ocelot
+		version is added here.  Each entry is a single file named by a hash
+		of the description, the header also records the length and a second
+		hash of the description so that collisions are treated as misses.
+
+		Entries are written to a temporary file and renamed into place, so
+		concurrent processes never see partial entries.  Hits refresh the
+		modification time of the file, and the least recently used entries
+		are removed when the directory grows beyond the configured size.
+
+		The cache is disabled when no directory is configured.
+	*/
+	class KernelCache
+	{
+		public:
+			/*! \brief Is a cache directory set in the configuration? */
+			static bool enabled();
+
+			/*! \brief Look up an entry
+
+				\param description Everything that the entry depends on
+				\param data Set to the contents of the entry on a hit
+				\return true on a hit
+			*/
+			static bool load(const std::string& description,
+				std::string& data);
+
+			/*! \brief Add or replace an entry, evicting old entries if the
+				cache is over its size limit */
+			static void store(const std::string& description,
+				const std::string& data);
+
+			/*! \brief Get a short string identifying data that a description
+				depends on without including all of it */
+			static std::string fingerprint(const std::string& data);
+
+		private:
+			/*! \brief Get the path of the file for a description */
+			static std::string _path(const std::string& description);
+			/*! \brief Get the header identifying a description */
+			static std::string _header(const std::string& description);
+			/*! \brief Remove the least recently used entries until the
+				cache fits in its size limit */
+			static void _evict();
+	};
+}
+
+#endif
+
@@ -13,7 +13,9 @@
 #include <ocelot/executive/interface/LLVMContext.h>
 #include <ocelot/executive/interface/ExecutableKernel.h>
 #include <ocelot/translator/interface/Translator.h>
+#include <ocelot/translator/interface/ProfilingData.h>
 #include <hydrazine/interface/Thread.h>
+#include <hydrazine/implementation/Timer.h>
 
 #include <boost/thread.hpp>
 
@@ -23,7 +25,7 @@ namespace llvm
 {
 	class ExecutionEngine;
 	class Module;
-	class Context;
+	class LLVMContext;
 }
 
 namespace executive
@@ -38,8 +40,45 @@ namespace executive
 			typedef unsigned int ThreadContext;
 			/*! \brief A function pointer to the translated kernel */
 			typedef unsigned int (*Function)( LLVMContext* );
+			/*! \brief A list of variable names */
+			typedef std::vector< std::string > StringVector;
+			/*! \brief A map from a variable identifier to its address */
+			typedef std::unordered_map< std::string, void* > AddressMap;
+			/*! \brief A list of parameter indices */
+			typedef std::vector< unsigned int > IndexVector;
+			/*! \brief A count of launches for each specialization key */
+			typedef std::unordered_map< std::string, unsigned int > 
+				KeyCountMap;
 			
-			/*! \brief A class for managing global llvm state */
+			/*! \brief The LLVM context that a thread translates kernels in,
+				modules only move to the global context to be JIT compiled */
+			class ThreadState
+			{
+				public:
+					/*! \brief Owns the modules the thread is translating */
+					llvm::LLVMContext* context;
+					/*! \brief The runtime library in the context, or 0 */
+					llvm::Module* runtime;
+
+				public:
+					/*! \brief Create the context */
+					ThreadState();
+					/*! \brief Destroy the runtime and the context */
+					~ThreadState();
+			};
+
+			/*! \brief A class for managing global llvm state
+
+				The mutex guards the global context, the JIT and the 
+				modules in them.  Kernels are translated, optimized and 
+				written to bitcode in the context of the calling thread 
+				without it.  If LLVM was built without thread support none 
+				of this may overlap, so all LLVM work, including code 
+				generation in the JIT and destroying a thread's context, 
+				also holds the serialMutex through a SerialLock, taken 
+				before the mutex.  Hot kernels then tier up on the 
+				launching thread rather than in the background.
+			*/
 			class LLVMState
 			{
 				public:
@@ -47,6 +86,25 @@ namespace executive
 					llvm::Module* module;
 					/*! \brief LLVM JIT Engine */
 					llvm::ExecutionEngine* jit;
+					/*! \brief Held by any thread using the global LLVM context
+						or the JIT */
+					boost::mutex mutex;
+					/*! \brief Serializes all LLVM work if LLVM was built 
+						without thread support, taken before the mutex */
+					boost::mutex serialMutex;
+					/*! \brief Can threads translate kernels concurrently? */
+					bool multithreaded;
+					/*! \brief The runtime library bitcode linked into kernels,
+						0 if it is not used */
+					llvm::Module* runtime;
+					/*! \brief The runtime library bitcode, parsed once for 
+						each translating thread */
+					std::string runtimeBitcode;
+					/*! \brief Identifies the runtime library for the kernel
+						cache */
+					std::string runtimeVersion;
+					/*! \brief The context of each translating thread */
+					boost::thread_specific_ptr< ThreadState > threads;
 
 				public:
 					/*! \brief Build the jit */
@@ -57,6 +115,31 @@ namespace executive
 				public:
 					/*! \brief Initialize the jit */
 					void initialize();
+					/*! \brief Get the state of the calling thread */
+					ThreadState& thread();
+					/*! \brief Get the runtime library in the context of a 
+						module, the global context requires the mutex */
+					llvm::Module* runtimeFor( llvm::LLVMContext& context );
+				
+				private:
+					/*! \brief Load the runtime library bitcode if enabled */
+					void _loadRuntime();
+					/*! \brief Parse the runtime library bitcode into a 
+						context, returns 0 if it fails */
+					llvm::Module* _parseRuntime( llvm::LLVMContext& context );
+			};
+			
+			/*! \brief Holds the serialMutex while it is alive if LLVM was 
+				built without thread support */
+			class SerialLock
+			{
+				private:
+					/*! \brief Only locked if LLVM is not multithreaded */
+					boost::unique_lock< boost::mutex > _lock;
+				
+				public:
+					/*! \brief Lock the serialMutex if it is needed */
+					SerialLock();
 			};
 			
 			/*! \brief Used as a synchronization point for atomic operations */
@@ -79,6 +162,261 @@ namespace executive
 					void unlock();
 			};
 			
+		public:
+			/*! \brief Load balance counters for a single worker thread */
+			class WorkerStatistics
+			{
+				public:
+					/*! \brief Seconds spent executing CTAs */
+					double busy;
+					/*! \brief Seconds spent waiting for other workers */
+					double idle;
+					/*! \brief The number of CTAs executed */
+					unsigned int ctas;
+					/*! \brief The number of ranges stolen from other workers */
+					unsigned int steals;
+					/*! \brief The number of launches the worker took part in */
+					unsigned int launches;
+					/*! \brief Total seconds from publishing each launch until 
+						the worker started its first CTA */
+					double startLatency;
+					/*! \brief The number of launches that grew the
+						worker's arena */
+					unsigned int arenaGrowths;
+					
+				public:
+					/*! \brief Start with everything at zero */
+					WorkerStatistics();
+			};
+			
+			/*! \brief A vector of worker statistics */
+			typedef std::vector< WorkerStatistics > WorkerStatisticsVector;
+			
+			/*! \brief The order that CTAs in a grid are handed to workers */
+			enum CtaOrder
+			{
+				RowMajorOrder,
+				TiledOrder,
+				MortonOrder,
+				HilbertOrder
+			};
+
+		private:
+			/*! \brief Hands out CTAs to workers dynamically.
+			
+				Each worker starts with a contiguous range of the grid and 
+				takes chunks from the front of it, the chunk shrinks as the 
+				range empties.  A worker with an empty range steals the back
+				half of the largest remaining range.  A launch may use only
+				the first few workers, the others get no range and do not 
+				steal.
+			*/
+			class CtaScheduler
+			{
+				private:
+					/*! \brief The CTAs remaining for one worker */
+					class Range
+					{
+						public:
+							/*! \brief Protects the bounds */
+							boost::mutex* mutex;
+							/*! \brief The first remaining CTA */
+							unsigned int begin;
+							/*! \brief One past the last remaining CTA */
+							unsigned int end;
+					};
+					
+					/*! \brief A vector of ranges, one per worker */
+					typedef std::vector< Range > RangeVector;
+				
+				private:
+					/*! \brief The remaining CTAs for each worker */
+					RangeVector _ranges;
+					/*! \brief Counters for each worker */
+					WorkerStatisticsVector _statistics;
+					/*! \brief The workers taking part in this launch */
+					unsigned int _active;
+					/*! \brief A chunk is the remaining range divided by 
+						this */
+					unsigned int _chunkDivisor;
+					
+				private:
+					/*! \brief Steal half of the largest range */
+					bool _steal( unsigned int worker );
+					
+				public:
+					/*! \brief Start without workers */
+					CtaScheduler();
+					/*! \brief Destroy the range locks */
+					~CtaScheduler();
+					
+				public:
+					/*! \brief Set the number of workers, clears statistics */
+					void setWorkers( unsigned int workers );
+					/*! \brief Split a new grid evenly across some of the 
+						workers
+						
+						\param ctas The CTAs in the grid
+						\param workers The workers to use, 0 for all
+						\param chunkDivisor Chunks are the remaining range 
+							divided by this, 0 for the default
+					*/
+					void reset( unsigned int ctas, unsigned int workers, 
+						unsigned int chunkDivisor );
+					/*! \brief Does a worker take part in this launch? */
+					bool active( unsigned int worker ) const;
+					/*! \brief Get the next chunk for a worker
+					
+						\return false if there is no more work in the grid
+					*/
+					bool next( unsigned int worker, unsigned int& begin, 
+						unsigned int& end );
+					/*! \brief Get the counters for one worker */
+					WorkerStatistics& statistics( unsigned int worker );
+					/*! \brief Get the counters for all workers */
+					const WorkerStatisticsVector& statistics() const;
+			};
+			
+			/*! \brief Maps positions in the schedule to CTA ids.
+			
+				The scheduler hands out contiguous ranges of positions, so
+				walking the grid in tiles or along a space filling curve 
+				gives each worker a compact region of the grid rather than a
+				band of rows.  Non row-major orders are stored as a table 
+				that is rebuilt only when the grid or the order changes.
+			*/
+			class CtaTraversal
+			{
+				public:
+					/*! \brief The id of a single CTA */
+					class Position
+					{
+						public:
+							unsigned short x;
+							unsigned short y;
+					};
+					
+					/*! \brief A vector of CTA ids in traversal order */
+					typedef std::vector< Position > PositionVector;
+					/*! \brief Linear CTA ids, x + y * width */
+					typedef std::vector< unsigned int > IdVector;
+				
+				private:
+					/*! \brief The CTA ids, empty for row-major order */
+					PositionVector _positions;
+					/*! \brief The order used to build the table */
+					CtaOrder _order;
+					/*! \brief The tile width used to build the table */
+					unsigned int _tile;
+					/*! \brief The grid width */
+					unsigned int _x;
+					/*! \brief The grid height */
+					unsigned int _y;
+					/*! \brief Does the table hold a sample of the grid? */
+					bool _sampled;
+				
+				private:
+					/*! \brief Walk the grid in row-major square tiles */
+					void _buildTiled();
+					/*! \brief Walk the grid along a Morton or Hilbert curve */
+					void _buildCurve();
+				
+				public:
+					/*! \brief Start with an empty row-major grid */
+					CtaTraversal();
+				
+				public:
+					/*! \brief Set up the traversal for a new grid */
+					void reset( CtaOrder order, unsigned int tile, 
+						unsigned int x, unsigned int y );
+					/*! \brief Only visit a sorted subset of a grid */
+					void sample( const IdVector& ids, unsigned int x, 
+						unsigned int y );
+					/*! \brief Set the CTA id for a position in the schedule */
+					void map( unsigned int position, LLVMContext* c ) const;
+			};
+			
+			/*! \brief Publishes launches to a persistent pool of workers and
+				waits for them to finish.
+				
+				A launch is published by bumping an epoch counter, and
+				completion is an atomic countdown.  Both sides spin briefly
+				before parking on a condition variable, and the condition
+				variables are only touched if the other side is parked.
+			*/
+			class LaunchControl
+			{
+				private:
+					/*! \brief Incremented once for each published launch */
+					volatile unsigned int _epoch;
+					/*! \brief Workers that have not finished this launch */
+					volatile unsigned int _remaining;
+					/*! \brief Workers parked waiting for a launch */
+					volatile unsigned int _parkedWorkers;
+					/*! \brief Is the launching thread parked? */
+					volatile unsigned int _parkedManager;
+					/*! \brief Protects the condition variables */
+					boost::mutex _mutex;
+					/*! \brief Wakes parked workers */
+					boost::condition_variable _launched;
+					/*! \brief Wakes the parked launching thread */
+					boost::condition_variable _finished;
+				
+				public:
+					/*! \brief Measures the time since the last launch */
+					hydrazine::Timer timer;
+					
+				public:
+					/*! \brief Start with no launches */
+					LaunchControl();
+					
+				public:
+					/*! \brief The current epoch */
+					unsigned int epoch() const;
+					/*! \brief Publish a launch to a number of workers and 
+						wait for all of them to finish */
+					void launch( unsigned int workers );
+					/*! \brief Wait for the epoch to move past a value
+						
+						\return The new epoch
+					*/
+					unsigned int wait( unsigned int epoch );
+					/*! \brief Signal that a worker finished this launch */
+					void finish();
+			};
+			
+			/*! \brief The memory that a worker reuses for the local and
+				shared memory of every kernel that it runs.
+
+				The arena only grows, doubling its capacity at least, so
+				launches stop allocating once the largest kernel has run.
+				It is released explicitly when the workers are torn down.
+			*/
+			class WorkerArena
+			{
+				private:
+					/*! \brief The start of the arena */
+					char* _base;
+					/*! \brief The bytes allocated for the arena */
+					size_t _capacity;
+
+				public:
+					/*! \brief Start with nothing allocated */
+					WorkerArena();
+
+				public:
+					/*! \brief Make the arena at least this big
+
+						\return The start of the arena, it is zeroed when it
+							grows and kept as is otherwise
+					*/
+					char* reserve( size_t bytes );
+					/*! \brief Free the arena */
+					void release();
+					/*! \brief The bytes allocated for the arena */
+					size_t capacity() const;
+			};
+
 			/*! \brief A worker thread executes a subset of CTAs in a kernel */
 			class Worker : public hydrazine::Thread
 			{
@@ -94,7 +432,7 @@ namespace executive
 								Kill,
 								LaunchKernelWithBarriers,
 								LaunchKernelWithoutBarriers,
-								Acknowledgement,
+								LaunchKernelWithThreadLoops,
 								Invalid
 							};
 							
@@ -103,32 +441,64 @@ namespace executive
 							Type type;
 							/*! \brief The LLVM code being executed */
 							Function function;
+							/*! \brief Runs several threads at once, or 0 */
+							Function bundle;
+							/*! \brief The number of threads in a bundle */
+							unsigned int bundleWidth;
 							/*! \brief The context being executed */
 							LLVMContext* context;
-							/*! \brief The begining cta of the grid */
-							unsigned int begin;
-							/*! \brief The ending cta of the grid */
-							unsigned int end;
-							/*! \brief The step */
-							unsigned int step;
+							/*! \brief Holds the local and shared memory of
+								the context */
+							WorkerArena* arena;
+							/*! \brief Hands out the CTAs to execute */
+							CtaScheduler* scheduler;
+							/*! \brief Maps scheduled CTAs to CTA ids */
+							const CtaTraversal* traversal;
+							/*! \brief The index of the worker */
+							unsigned int id;
 							/*! \brief The resume point offset */
 							unsigned int resumePointOffset;
+							/*! \brief The largest CTA that local memory must
+								be sized for */
+							unsigned int maxThreadsPerCta;
 							
 						public:
 							Message( Type t = Invalid, Function f = 0,
 								LLVMContext* c = 0, 
-								unsigned int begin = 0,
-								unsigned int end = 0,
-								unsigned int step = 0,
+								CtaScheduler* s = 0,
+								const CtaTraversal* o = 0,
+								unsigned int id = 0,
 								unsigned int r = 0 );
 					};
 			
+				private:
+					/*! \brief The launch descriptor for this worker */
+					Message* _message;
+					/*! \brief Publishes launches to the worker */
+					LaunchControl* _control;
+					/*! \brief The last epoch that this worker saw */
+					unsigned int _epoch;
+			
+				public:
+					/*! \brief Create a worker that is not attached to a pool */
+					Worker();
+					
+					/*! \brief Attach the worker to a pool before starting it */
+					void attach( Message* message, LaunchControl* control );
+			
 				private:
 					/*! \brief This is the 'main' function for the worker */
 					void execute();
 					
+					/*! \brief Carve the local and shared memory of the
+						context out of the arena, growing it from the worker
+						so that it is first touched on the worker's own node */
+					void allocate( LLVMContext* c, WorkerArena* arena,
+						unsigned int maxThreadsPerCta );
+					
 					/*! \brief Launch a series of ctas with barriers */
 					void launchKernelWithBarriers( Function f, LLVMContext* c, 
+						const CtaTraversal* traversal,
 						unsigned int begin,
 						unsigned int end,
 						unsigned int step,
@@ -137,6 +507,18 @@ namespace executive
 					/*! \brief Launch a series of ctas without barriers */
 					void launchKernelWithoutBarriers( Function f, 
 						LLVMContext* c, 
+						const CtaTraversal* traversal,
+						unsigned int begin,
+						unsigned int end,
+						unsigned int step,
+						Function bundle,
+						unsigned int bundleWidth );
+					
+					/*! \brief Launch a series of ctas, each with one call 
+						to a function that loops over all threads */
+					void launchKernelWithThreadLoops( Function f, 
+						LLVMContext* c, 
+						const CtaTraversal* traversal,
 						unsigned int begin,
 						unsigned int end,
 						unsigned int step );
@@ -145,8 +527,10 @@ namespace executive
 					void launchCtaWithBarriers( Function f, LLVMContext* c, 
 						unsigned int rp );
 
-					/*! \brief Launch a specific cta without barriers */
-					void launchCtaWithoutBarriers( Function f, LLVMContext* c );
+					/*! \brief Launch a specific cta without barriers, using 
+						the bundled function for full bundles of threads */
+					void launchCtaWithoutBarriers( Function f, LLVMContext* c,
+						Function bundle, unsigned int bundleWidth );
 			};
 			
 			/*! \brief Controls the execution of worker threads */
@@ -159,17 +543,36 @@ namespace executive
 					typedef std::vector< LLVMContext > ContextVector;
 					/*! \brief A vector of messages */
 					typedef std::vector< Worker::Message > MessageVector;
-			
+					/*! \brief A vector of worker arenas */
+					typedef std::vector< WorkerArena > ArenaVector;
+
 				private:
 					/*! \brier The currently active worker threads */
 					WorkerVector _workers;
-					
+
 					/*! \brief One context for each worker */
 					ContextVector _contexts;
-					
+
+					/*! \brief One arena for each worker, reused by every
+						kernel */
+					ArenaVector _arenas;
+
+					/*! \brief The busy time of each worker before the
+						current launch */
+					std::vector< double > _busy;
+
 					/*! \brief One message for each worker */
 					MessageVector _messages;
 					
+					/*! \brief Distributes CTAs among the workers */
+					CtaScheduler _scheduler;
+					
+					/*! \brief The order that CTAs are distributed in */
+					CtaTraversal _traversal;
+					
+					/*! \brief Publishes launches to the workers */
+					LaunchControl _control;
+					
 					/*! \brief The max threads per CTA */
 					unsigned int _maxThreadsPerCta;
 			
@@ -180,10 +583,16 @@ namespace executive
 					~ExecutionManager();
 					
 				public:
-					/*! \brief Launches a kernel on a grid using a context */
+					/*! \brief Launches a kernel on a grid using a context,
+						on the first few workers if workers is not 0, and 
+						only on the sampled CTAs if sample is not 0 */
 					void launch( Function f, LLVMContext* context, 
 						bool barriers, unsigned int resumePointOffset, 
-						unsigned int externalSharedMemory );
+						unsigned int externalSharedMemory, 
+						Function bundle, unsigned int bundleWidth,
+						Function threadLoop, unsigned int workers, 
+						unsigned int chunkDivisor, 
+						const CtaTraversal::IdVector* sample = 0 );
 					
 					/*! \brief Changes the number of worker threads */
 					void setThreadCount( unsigned int threads );
@@ -196,7 +605,68 @@ namespace executive
 					
 					/*! \brief Gets the current number of threads */
 					unsigned int threads() const;
+					
+					/*! \brief Gets the load balance counters for each thread
+						since the thread count was last set */
+					const WorkerStatisticsVector& statistics() const;
 			};
+			
+			/*! \brief The state of a kernel that starts unoptimized and is 
+				recompiled at a higher level once it becomes hot */
+			class TierState
+			{
+				public:
+					/*! \brief The level that the kernel is recompiled at */
+					translator::Translator::OptimizationLevel level;
+					/*! \brief The bitcode of the unoptimized modules */
+					std::string bitcode;
+					/*! \brief The recompiled module */
+					llvm::Module* module;
+					/*! \brief The recompiled bundle module */
+					llvm::Module* bundleModule;
+					/*! \brief The recompiled function, 0 if it failed */
+					Function function;
+					/*! \brief The recompiled bundle function */
+					Function bundle;
+					/*! \brief The recompiled thread loop function */
+					Function threadLoop;
+					/*! \brief The kernel cache description at the level */
+					std::string description;
+					/*! \brief Launches at the first tier */
+					unsigned int launches;
+					/*! \brief Seconds spent in launches at the first tier */
+					double seconds;
+					/*! \brief The thread recompiling the kernel, or 0 */
+					boost::thread* thread;
+			
+				public:
+					/*! \brief Start without a higher tier */
+					TierState();
+			};
+			
+			/*! \brief A version of the kernel compiled for the dimensions and
+				parameters of a launch */
+			class Variant
+			{
+				public:
+					/*! \brief The specialized module */
+					llvm::Module* module;
+					/*! \brief The specialized bundle module, or 0 */
+					llvm::Module* bundleModule;
+					/*! \brief The specialized function, 0 if it failed */
+					Function function;
+					/*! \brief The specialized bundle function, or 0 */
+					Function bundle;
+					/*! \brief The specialized thread loop function, or 0 */
+					Function threadLoop;
+				
+				public:
+					/*! \brief Start without any modules */
+					Variant();
+			};
+			
+			/*! \brief A map from a specialization key to its variant */
+			typedef std::unordered_map< std::string, Variant > VariantMap;
 		
 		public:
 			/*! \brief A class of opaque thread visible state */
@@ -240,6 +710,14 @@ namespace executive
 			llvm::Module* _module;
 			/*! \brief The translated function */
 			Function _function;
+			/*! \brief LLVM module for the bundled function */
+			llvm::Module* _bundleModule;
+			/*! \brief The function that runs a bundle of threads, or 0 */
+			Function _bundle;
+			/*! \brief The number of threads in a bundle */
+			unsigned int _bundleWidth;
+			/*! \brief Runs every thread of a CTA with barriers, or 0 */
+			Function _threadLoop;
 			/*! \brief The stored ptx kernel used for translation */
 			ir::PTXKernel* _ptx;
 			/*! \brief Does this kernel require barrier support? */
@@ -256,52 +734,193 @@ namespace executive
 			translator::Translator::OptimizationLevel _optimizationLevel;
 			/*! \brief Cache atomics from different threads */
 			AtomicOperationCache _cache;
+			/*! \brief Held while the kernel is being translated */
+			boost::mutex _translationMutex;
+			/*! \brief Has the kernel been translated, or failed to be? */
+			bool _translated;
+			/*! \brief The reason that translation failed, or empty */
+			std::string _translationError;
+			/*! \brief The textures referenced by the kernel by index */
+			StringVector _textureNames;
+			/*! \brief The addresses of global variables on the device */
+			AddressMap _globalAddresses;
+			/*! \brief The next tier for this kernel, if it is compiled in 
+				tiers */
+			TierState _tier;
+			/*! \brief Compile variants for common launch values? */
+			bool _specialize;
+			/*! \brief Variants by the launch values they were compiled for */
+			VariantMap _variants;
+			/*! \brief Launches with values that do not have a variant yet */
+			KeyCountMap _variantLaunches;
+			/*! \brief The launch values of the current launch */
+			std::string _variantKey;
+			/*! \brief The parameters in the current key */
+			IndexVector _variantParameters;
+			/*! \brief The parameter memory of the previous launch */
+			std::string _previousParameters;
+			/*! \brief The workers used by a launch, 0 for all */
+			unsigned int _scheduleWorkers;
+			/*! \brief The CTA chunk divisor of a launch, 0 for the 
+				default */
+			unsigned int _scheduleChunkDivisor;
+			/*! \brief Counts the times that the code was replaced */
+			unsigned int _codeVersion;
+			/*! \brief The branch weights from a profile of the kernel */
+			translator::ProfilingData _profile;
 		
 		private:
 			/*! \brief Determine the padding required to satisfy alignment */
 			static unsigned int _pad( size_t& size, unsigned int alignment );
+			/*! \brief Optimize an llvm module using standard passes */
+			static void _optimizeLLVMFunction( llvm::Module* module, 
+				unsigned int level, bool space );
+			/*! \brief Inline the per-thread function into the thread loop 
+				without running any other pass */
+			static void _inlineThreads( llvm::Module* module );
+			/*! \brief Link the definitions of the runtime library functions
+				that a module calls into it */
+			static void _linkRuntime( llvm::Module* module );
+			/*! \brief Place the heavier successor of each weighted branch 
+				right after it so that the hot path falls through */
+			static void _layoutHotPaths( llvm::Module* module );
 
 		public:
 			/*! \brief Get a string representation of a thread id */
 			static std::string threadIdString( const LLVMContext& c );
 			/*! \brief Get a string representation of a thread id */
 			static unsigned int threadId( const LLVMContext& c );
-			/*! \brief Optimize an llvm module using standard passes */
-			static void _optimizeLLVMFunction( llvm::Module* module, 
-				unsigned int level, bool space );
+			/*! \brief Get the load balance counters for each worker thread
+				shared by all LLVM kernels */
+			static const WorkerStatisticsVector& workerStatistics();
+			/*! \brief Get the CTA order named in the configuration */
+			static CtaOrder ctaOrder();
 			
 		private:
 			/*! \brief Run various PTX optimizer passes on the kernel */
 			void _optimizePtx();
 			
+			/*! \brief Load the branch profile of the kernel if there is 
+				one, before the PTX passes change the blocks */
+			void _loadProfile();
+			
 			/*! \brief Create the LLVM module from the code */
 			void _translateKernel();
 			
-			/*! \brief Run various LLVM optimizer passes on the kernel */
-			void _optimize();
+			/*! \brief Translate the kernel if needed and JIT compile it on
+				the first launch */
+			void _compileKernel();
+			
+			/*! \brief Try to create a module that runs bundles of threads,
+				returns 0 to leave the kernel scalar if it can not be 
+				bundled */
+			llvm::Module* _translateBundle( llvm::LLVMContext& context );
+			
+			/*! \brief Translate the kernel into a new module, returns 0 if 
+				the translation fails or can not be assembled */
+			llvm::Module* _translateModule( 
+				translator::Translator& translator, 
+				const std::string& moduleName, llvm::LLVMContext& context );
+			
+			/*! \brief Run the LLVM optimizer passes for a level on modules */
+			void _optimize( llvm::Module* module, llvm::Module* bundleModule,
+				translator::Translator::OptimizationLevel level );
+			
+			/*! \brief Get everything the translated code at a level depends 
+				on for the kernel cache, empty if it can not be cached */
+			std::string _cacheDescription( 
+				translator::Translator::OptimizationLevel level ) const;
+			
+			/*! \brief Try to load the bitcode of the optimized modules from 
+				the kernel cache */
+			bool _loadCachedModules( const std::string& description,
+				std::string& bitcode );
+			
+			/*! \brief Save the bitcode of optimized modules in the kernel 
+				cache */
+			void _storeCachedModules( const std::string& description,
+				const std::string& bitcode );
+			
+			/*! \brief Write modules as bitcode, the main module size, the 
+				main module, then the bundle module */
+			std::string _writeModules( llvm::Module* module, 
+				llvm::Module* bundleModule );
+			
+			/*! \brief Parse modules written by _writeModules into a context,
+				the global context requires the JIT lock */
+			bool _parseModules( const std::string& bitcode, 
+				llvm::LLVMContext& context, llvm::Module*& module, 
+				llvm::Module*& bundleModule );
+			
+			/*! \brief JIT compile the modules and find the functions */
+			void _compile();
+			
+			/*! \brief JIT compile modules and find their functions */
+			void _compile( llvm::Module* module, llvm::Module* bundleModule,
+				Function& function, Function& bundle, Function& threadLoop );
+			
+			/*! \brief Bind the global variables of modules in the JIT */
+			void _mapGlobals( llvm::Module* module, llvm::Module* bundleModule,
+				const AddressMap& addresses );
+			
+			/*! \brief Remove a module and its machine code from the JIT */
+			void _releaseModule( llvm::Module* module );
+			
+			/*! \brief Is the kernel waiting to be recompiled at a higher 
+				tier? */
+			bool _tiered() const;
+			
+			/*! \brief Count a launch at the first tier, starts recompiling 
+				the kernel once it is hot */
+			void _countTierLaunch( double seconds );
+			
+			/*! \brief Recompile the kernel at the higher tier, run on a 
+				background thread if LLVM is multithreaded and on the 
+				launching thread otherwise */
+			void _tierUp( AddressMap addresses );
+			
+			/*! \brief Swap in the higher tier if it has finished compiling */
+			void _finishTierUp();
+			
+			/*! \brief Swap in the higher tier once it is compiled */
+			void _installTier();
+			
+			/*! \brief Get the variant for the values of this launch, or 0 
+				to run the generic kernel */
+			const Variant* _selectVariant();
+			
+			/*! \brief Compute the key of the launch values, only parameters
+				that did not change since the last launch are included */
+			void _buildVariantKey();
+			
+			/*! \brief Compile a variant for the values of this launch */
+			void _translateVariant( Variant& variant );
 						
 			/*! \brief Allocate parameter memory */
 			void _allocateParameterMemory( );
 
-			/*! \brief Allocate shared memory */
+			/*! \brief Lay out shared memory, the workers hold the memory */
 			void _allocateSharedMemory( );
 			
 			/*! \brief Allocate global memory */
 			void _allocateGlobalMemory( );
 			
-			/*! \brief Allocate local memory */
+			/*! \brief Lay out local memory, the workers hold the memory */
 			void _allocateLocalMemory( );
 			
 			/*! \brief Allocate constant memory */
 			void _allocateConstantMemory( );
 			
-			/*! \brief Allocate texture memory */
+			/*! \brief Assign an index to each texture */
 			void _allocateTextureMemory( );
 			
+			/*! \brief Look up the texture for each index on the device */
+			void _bindTextures( );
+			
 			/*! \brief Scan the kernel and determine memory requirements */
 			void _allocateMemory( );
 
-			/*! \brief Reload global memory */
+			/*! \brief Find the addresses of global variables */
 			void _updateGlobalMemory( );
 
 			/*! \brief Reload constant memory */
@@ -320,6 +939,12 @@ namespace executive
 			/*! \brief Clean up the runtime */
 			~LLVMExecutableKernel();
 
+		public:
+			/*! \brief Translate and optimize the kernel if that has not been
+				done yet, may be called from any thread.  A failure is
+				rethrown from every later call. */
+			void translate();
+			
 		public:
 			/*! \brief Launch a kernel on a 2D grid */
 			void launchGrid( int width, int height );
@@ -329,6 +954,14 @@ namespace executive
 			void setExternSharedMemorySize( unsigned int bytes );
 			/*! \brief Describes the device used to execute the kernel */
 			void setWorkerThreads( unsigned int threadLimit );
+			/*! \brief Run the next launches on the first few workers and 
+				hand out CTAs in chunks of the remaining range divided by 
+				chunkDivisor, 0 keeps the defaults */
+			void setCtaSchedule( unsigned int workers, 
+				unsigned int chunkDivisor );
+			/*! \brief Changes whenever a higher tier replaces the code, 
+				launches with different versions are not comparable */
+			unsigned int codeVersion() const;
 			/*! \brief Reload parameter memory */
 			void updateParameterMemory();
 			/*! \brief Indicate that other memory has been updated */
@@ -10,8 +10,18 @@
 // ocelot includes
 #include <ocelot/executive/interface/EmulatorDevice.h>
 
+// boost includes
+#include <boost/thread.hpp>
+
+// Standard library includes
+#include <deque>
+#include <unordered_set>
+#include <map>
+
 namespace executive
 {
+	class LLVMExecutableKernel;
+
 	/*! \brief A device to control all of the cores in a single CPU */
 	class MulticoreCPUDevice : public EmulatorDevice
 	{
@@ -28,23 +38,199 @@ namespace executive
 					ExecutableKernel* getKernel(const std::string& name);
 			};
 
+			/*! \brief A device allocation mapped with one chunk on the
+				NUMA node of each worker */
+			class PartitionedAllocation : 
+				public EmulatorDevice::MemoryAllocation
+			{
+				public:
+					/*! \brief Take ownership of memory from 
+						WorkerAffinity::allocate */
+					PartitionedAllocation(void* pointer, size_t size);
+					/*! \brief Unmap the memory */
+					~PartitionedAllocation();
+			};
+
+			/*! \brief Translates kernels on a pool of background threads 
+				in the order that they are queued */
+			class TranslationQueue
+			{
+				private:
+					typedef std::deque<LLVMExecutableKernel*> KernelQueue;
+					typedef std::unordered_set<LLVMExecutableKernel*> 
+						KernelSet;
+
+				private:
+					/*! \brief Protects everything in the queue */
+					boost::mutex _mutex;
+					/*! \brief Signalled when kernels are queued or on exit */
+					boost::condition_variable _queued;
+					/*! \brief Signalled when a thread finishes a kernel */
+					boost::condition_variable _finished;
+					/*! \brief Kernels waiting for a thread */
+					KernelQueue _kernels;
+					/*! \brief Kernels being translated right now */
+					KernelSet _active;
+					/*! \brief The translation threads, started lazily */
+					boost::thread_group _threads;
+					/*! \brief Have the threads been started? */
+					bool _started;
+					/*! \brief Should the threads exit? */
+					bool _exit;
+
+				public:
+					/*! \brief Create an empty queue without threads */
+					TranslationQueue();
+					/*! \brief Drop queued kernels and join the threads */
+					~TranslationQueue();
+
+				public:
+					/*! \brief Queue a kernel to be translated */
+					void push(LLVMExecutableKernel* kernel);
+					/*! \brief Remove a kernel from the queue, waits for it
+						to finish if it is being translated */
+					void remove(LLVMExecutableKernel* kernel);
+
+				private:
+					/*! \brief The main loop of a translation thread */
+					void _run();
+			};
+
+			/*! \brief Times worker counts and CTA chunk sizes over the 
+				first launches of each kernel and grid size, and keeps the
+				fastest.
+				
+				The worker count is halved from the whole pool down to one
+				with the default chunk size, then the other chunk sizes are
+				tried with the fastest worker count.  The first launch of a
+				grid size only warms up and is not timed.  A search starts 
+				over when a higher tier replaces the code of the kernel.  
+				Tuned schedules are saved by module, kernel name and grid 
+				size when the device is destroyed.
+			*/
+			class Autotuner
+			{
+				public:
+					/*! \brief How a launch is spread over the workers */
+					class Schedule
+					{
+						public:
+							/*! \brief The default schedule */
+							Schedule(unsigned int workers = 0, 
+								unsigned int chunkDivisor = 0);
+						
+						public:
+							/*! \brief The workers to use, 0 for all */
+							unsigned int workers;
+							/*! \brief Divides the remaining CTAs of a 
+								worker into chunks, 0 for the default */
+							unsigned int chunkDivisor;
+					};
+				
+				private:
+					typedef std::vector<Schedule> ScheduleVector;
+					
+					/*! \brief The search for one kernel and grid size */
+					class Search
+					{
+						public:
+							/*! \brief Start before the warm up launch */
+							Search();
+						
+						public:
+							/*! \brief The schedules to time in order */
+							ScheduleVector candidates;
+							/*! \brief The next candidate to time */
+							unsigned int next;
+							/*! \brief The fastest schedule so far */
+							Schedule best;
+							/*! \brief Seconds taken by the fastest schedule */
+							double seconds;
+							/*! \brief Have the chunk sizes been queued? */
+							bool chunks;
+							/*! \brief Has the warm up launch run? */
+							bool warm;
+							/*! \brief The code version that was timed */
+							unsigned int version;
+					};
+					
+					/*! \brief A module and kernel name */
+					typedef std::pair<std::string, std::string> KernelId;
+					/*! \brief A kernel and the CTAs in its grid */
+					typedef std::pair<KernelId, unsigned int> SearchId;
+					typedef std::map<SearchId, Search> SearchMap;
+					typedef std::map<SearchId, Schedule> ScheduleMap;
+				
+				private:
+					/*! \brief Searches that are still running */
+					SearchMap _searches;
+					/*! \brief Finished searches, including saved ones */
+					ScheduleMap _tuned;
+					/*! \brief Has the file been read? */
+					bool _loaded;
+					/*! \brief Have schedules been tuned since the file was 
+						read? */
+					bool _modified;
+					/*! \brief The file that the schedules were read from */
+					std::string _path;
+				
+				public:
+					/*! \brief Start without any schedules */
+					Autotuner();
+					/*! \brief Save the schedules tuned by this device */
+					~Autotuner();
+				
+				public:
+					/*! \brief Pick the schedule for the next launch of a 
+						kernel on a pool of workers */
+					Schedule select(const std::string& module, 
+						const std::string& kernel, unsigned int ctas, 
+						unsigned int workers);
+					/*! \brief Record the time taken by a launch that used 
+						the selected schedule and ran the given code 
+						version */
+					void record(const std::string& module, 
+						const std::string& kernel, unsigned int ctas,
+						const Schedule& schedule, double seconds, 
+						unsigned int version);
+				
+				private:
+					/*! \brief Read the schedules saved by earlier runs */
+					void _load();
+					/*! \brief Write every tuned schedule */
+					void _save() const;
+			};
+
 		private:
 			/*! \brief Number of worker threads to launch */
 			unsigned int _workerThreads;
 			/*! \brief The optimization level to use when translating kernels */
 			translator::Translator::OptimizationLevel _optimizationLevel;
+			/*! \brief Kernels of loaded modules waiting to be translated */
+			TranslationQueue _translations;
+			/*! \brief Schedules for launches of kernels on the JIT */
+			Autotuner _autotuner;
 
 		public:
 			/*! \brief Sets the device properties */
 			MulticoreCPUDevice(unsigned int flags = 0);
 
 		public:
-			/*! \brief Load a module, must have a unique name */
+			/*! \brief Load a module, must have a unique name.  Starts 
+				translating all of its kernels in the background if enabled */
 			void load(const ir::Module* module);
+			/*! \brief Unload a module by name, waits for any of its kernels
+				that are being translated */
+			void unload(const std::string& name);
 			/*! \brief Get a translated kernel from the device */
 			ExecutableKernel* getKernel(const std::string& module, 
 				const std::string& kernel);
 			
+		public:
+			/*! \brief Allocate device memory, split across the NUMA nodes
+				of the workers if enabled */
+			Device::MemoryAllocation* allocate(size_t size);
+			
 		public:
 			/*! \brief helper function for launching a kernel
 				\param module module name
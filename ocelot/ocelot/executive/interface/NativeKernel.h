@@ -0,0 +1,89 @@
+/*! \file NativeKernel.h
+	\author agent
+	\date October 18, 2026
+	\brief The header file for the NativeKernel class.
+*/
+
+#ifndef NATIVE_KERNEL_H_INCLUDED
+#define NATIVE_KERNEL_H_INCLUDED
+
+// ocelot includes
+#include <ocelot/executive/interface/ExecutableKernel.h>
+#include <ocelot/executive/interface/NativeKernelContext.h>
+
+// Standard library includes
+#include <vector>
+
+namespace executive
+{
+	/*! \brief A kernel that runs a hand written native implementation from
+		a shared library instead of its PTX.
+
+		The registry is the nativeKernels object of the configuration, it
+		maps a kernel name (the mangled PTX entry) to "library:symbol".  The
+		symbol defaults to the kernel name, and an empty library searches
+		the program itself.  Devices that find a kernel in the registry
+		create one of these for it instead of emulating or translating the
+		PTX.
+
+		Ocelot packs the parameters, allocates dynamic shared memory for
+		each worker, and splits the grid into one contiguous range of CTAs
+		per worker.  The workers after the first are threads shared by all
+		native kernels, the launching thread runs the first range itself.
+		Globals and textures of the module are not passed to the native
+		code, and trace generators cannot be attached.
+	*/
+	class NativeKernel : public ExecutableKernel
+	{
+		public:
+			/*! \brief Find the native implementation of a kernel, loading
+				its library on first use
+
+				\param name The name of the kernel
+				\return The entry point, or 0 if the kernel is not in the
+					registry or could not be loaded
+			*/
+			static NativeKernelFunction lookup(const std::string& name);
+
+		public:
+			/*! \brief Build the kernel from its PTX and native entry point */
+			NativeKernel(const ir::Kernel& kernel, Device* device,
+				NativeKernelFunction function);
+
+		public:
+			/*! \brief Run every CTA of the grid on the native code */
+			void launchGrid(int width, int height);
+			/*! \brief Sets the shape of a CTA */
+			void setKernelShape(int x, int y, int z);
+			/*! \brief Changes the amount of dynamic shared memory */
+			void setExternSharedMemorySize(unsigned int bytes);
+			/*! \brief Sets the max number of worker threads to use */
+			void setWorkerThreads(unsigned int limit);
+			/*! \brief Pack the parameters for the native code */
+			void updateParameterMemory();
+			/*! \brief Nothing to do, the native code owns its memory */
+			void updateMemory();
+			/*! \brief Native kernels do not reference textures */
+			TextureVector textureReferences() const;
+			/*! \brief Warns that a trace generator is not attached */
+			void addTraceGenerator(trace::TraceGenerator* generator);
+			/*! \brief Nothing to remove, generators are never attached */
+			void removeTraceGenerator(trace::TraceGenerator* generator);
+
+		private:
+			/*! \brief Run a range of CTAs on a worker */
+			void _run(unsigned int worker, unsigned int begin,
+				unsigned int end);
+
+		private:
+			/*! \brief The native implementation */
+			NativeKernelFunction _function;
+			/*! \brief The packed parameter block */
+			std::vector<char> _parameterBlock;
+			/*! \brief The maximum number of worker threads */
+			unsigned int _workerThreads;
+	};
+}
+
+#endif
+
@@ -0,0 +1,55 @@
+/*! \file NativeKernelContext.h
+	\author agent
+	\date October 18, 2026
+	\brief The header file for the NativeKernelContext class.
+
+	This is the only header that a library of native kernels needs, it
+	does not depend on the rest of Ocelot.
+*/
+
+#ifndef NATIVE_KERNEL_CONTEXT_H_INCLUDED
+#define NATIVE_KERNEL_CONTEXT_H_INCLUDED
+
+namespace executive
+{
+	/*! \brief Everything that a native kernel needs to run a range of CTAs
+
+		CTAs are numbered in row major order, x then y, so the CTA id of
+		a linear index i is (i % nctaid[0], i / nctaid[0]).
+	*/
+	class NativeKernelContext
+	{
+		public:
+			/*! \brief The CTA dimensions in threads */
+			unsigned int ntid[3];
+			/*! \brief The grid dimensions in CTAs */
+			unsigned int nctaid[3];
+			/*! \brief The linear index of the first CTA to run */
+			unsigned int begin;
+			/*! \brief One past the linear index of the last CTA to run */
+			unsigned int end;
+			/*! \brief The parameters packed at their PTX offsets */
+			const char* parameters;
+			/*! \brief Bytes in the parameter block */
+			unsigned int parameterSize;
+			/*! \brief The dynamic shared memory of a CTA, it is reused by
+				every CTA in the range and is not cleared between them */
+			char* shared;
+			/*! \brief Bytes of dynamic shared memory */
+			unsigned int sharedSize;
+			/*! \brief The index of the worker thread running the range */
+			unsigned int worker;
+	};
+
+	/*! \brief The entry point that a native kernel library exports for
+		each kernel, define it with OCELOT_NATIVE_KERNEL */
+	typedef void (*NativeKernelFunction)(const NativeKernelContext* context);
+}
+
+/*! \brief Defines a native kernel entry point with C linkage, so that the
+	registry finds it by its plain name */
+#define OCELOT_NATIVE_KERNEL(symbol) extern "C" void symbol( \
+	const executive::NativeKernelContext* context)
+
+#endif
+
@@ -0,0 +1,77 @@
+/*! \file WorkerAffinity.h
+	\author agent
+	\date October 18, 2026
+	\brief The header file for the WorkerAffinity class.
+*/
+
+#ifndef WORKER_AFFINITY_H_INCLUDED
+#define WORKER_AFFINITY_H_INCLUDED
+
+// Standard library includes
+#include <cstddef>
+
+namespace executive
+{
+	/*! \brief Places CPU device worker threads and their memory on cores
+		and NUMA nodes.
+
+		Workers are pinned to cores by a policy from the configuration:
+		compact fills the cores of one node before moving to the next,
+		scatter deals workers round robin across nodes, and an explicit
+		list names the core for each worker.
+
+		Device allocations may also be mapped as one contiguous chunk per
+		worker, each bound to the node of its worker before any page is
+		touched.  Workers start with
+		contiguous, evenly sized CTA ranges, so kernels that index memory by
+		CTA id mostly touch the chunk on their own node.
+
+		The topology is read from sysfs, everything is a no-op on systems
+		without it.
+	*/
+	class WorkerAffinity
+	{
+		public:
+			/*! \brief The policy for pinning workers to cores */
+			enum Policy
+			{
+				None,
+				Compact,
+				Scatter,
+				Explicit
+			};
+
+		public:
+			/*! \brief Get the policy named in the configuration */
+			static Policy policy();
+
+			/*! \brief Is worker pinning enabled in the configuration? */
+			static bool enabled();
+
+			/*! \brief Pin the calling thread to the core for a worker
+
+				\param worker The index of the worker
+			*/
+			static void pin(unsigned int worker);
+
+			/*! \brief Get the NUMA node that a worker is pinned to,
+				-1 if unknown */
+			static int node(unsigned int worker);
+
+			/*! \brief Map memory with one chunk bound to the node of each
+				worker, if partitioning is enabled in the configuration
+
+				\param bytes The size of the allocation
+				\param workers The number of workers that will touch it
+				\return The page aligned memory, or 0 if the allocation
+					should not be partitioned
+			*/
+			static void* allocate(size_t bytes, unsigned int workers);
+
+			/*! \brief Unmap memory returned by allocate() */
+			static void release(void* pointer, size_t bytes);
+	};
+}
+
+#endif
+
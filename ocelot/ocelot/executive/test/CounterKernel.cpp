@@ -0,0 +1,88 @@
+/*!
+	\file CounterKernel.cpp
+	\date October 18, 2026
+	\author agent <agent@local>
+	\brief The source file for the CounterKernel test helper.
+*/
+
+#ifndef COUNTER_KERNEL_CPP_INCLUDED
+#define COUNTER_KERNEL_CPP_INCLUDED
+
+// Ocelot Includes
+#include <ocelot/executive/test/CounterKernel.h>
+#include <ocelot/executive/interface/LLVMExecutableKernel.h>
+
+namespace test
+{
+	const std::string CounterKernel::module(
+		"ocelot/executive/test/kernels.ptx" );
+	const std::string CounterKernel::kernel( "_Z5countPj" );
+
+	CounterKernel::CounterKernel( executive::Device& device )
+		: _device( device )
+	{
+		_counter = _device.allocate( sizeof( unsigned int ) );
+		_parameter = (long long unsigned int) _counter->pointer();
+
+		reset();
+	}
+
+	CounterKernel::~CounterKernel()
+	{
+		_device.free( _counter->pointer() );
+	}
+
+	void CounterKernel::launch( unsigned int ctas,
+		const trace::TraceGeneratorVector& generators )
+	{
+		_device.launch( module, kernel, ir::Dim3( ctas, 1, 1 ),
+			ir::Dim3( 1, 1, 1 ), 0, &_parameter,
+			sizeof( long long unsigned int ), generators );
+	}
+
+	unsigned int CounterKernel::count() const
+	{
+		unsigned int result = 0;
+		_counter->copy( &result, 0, sizeof( unsigned int ) );
+
+		return result;
+	}
+
+	void CounterKernel::reset()
+	{
+		unsigned int zero = 0;
+		_counter->copy( 0, &zero, sizeof( unsigned int ) );
+	}
+
+	std::vector< unsigned int > CounterKernel::workerCtas()
+	{
+		const executive::LLVMExecutableKernel::WorkerStatisticsVector&
+			statistics = executive::LLVMExecutableKernel::workerStatistics();
+
+		std::vector< unsigned int > ctas( statistics.size() );
+
+		for( unsigned int i = 0; i < statistics.size(); ++i )
+		{
+			ctas[ i ] = statistics[ i ].ctas;
+		}
+
+		return ctas;
+	}
+
+	unsigned int CounterKernel::jitCtas()
+	{
+		std::vector< unsigned int > ctas = workerCtas();
+
+		unsigned int total = 0;
+
+		for( unsigned int i = 0; i < ctas.size(); ++i )
+		{
+			total += ctas[ i ];
+		}
+
+		return total;
+	}
+}
+
+#endif
+
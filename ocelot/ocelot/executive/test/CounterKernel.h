@@ -0,0 +1,65 @@
+/*!
+	\file CounterKernel.h
+	\date October 18, 2026
+	\author agent <agent@local>
+	\brief The header file for the CounterKernel test helper.
+*/
+
+#ifndef COUNTER_KERNEL_H_INCLUDED
+#define COUNTER_KERNEL_H_INCLUDED
+
+#include <ocelot/executive/interface/Device.h>
+#include <ocelot/trace/interface/TraceGenerator.h>
+
+#include <vector>
+
+namespace test
+{
+	/*!
+		\brief Launches the kernel in kernels.ptx that adds one to a counter
+			for every CTA, so tests can check that all of a grid ran.
+	*/
+	class CounterKernel
+	{
+		public:
+			/*! \brief The module holding the kernel, relative to the
+				directory that the tests run from */
+			static const std::string module;
+			/*! \brief The name of the kernel */
+			static const std::string kernel;
+
+		private:
+			/*! \brief The device that the kernel runs on */
+			executive::Device& _device;
+			/*! \brief The counter on the device */
+			executive::Device::MemoryAllocation* _counter;
+			/*! \brief The parameter block, the address of the counter */
+			long long unsigned int _parameter;
+
+		public:
+			/*! \brief Allocate a counter that starts at zero on a selected
+				device that has the module loaded */
+			CounterKernel( executive::Device& device );
+			/*! \brief Free the counter */
+			~CounterKernel();
+
+		public:
+			/*! \brief Launch the kernel with single thread CTAs */
+			void launch( unsigned int ctas,
+				const trace::TraceGeneratorVector& generators =
+				trace::TraceGeneratorVector() );
+			/*! \brief The number of CTAs that ran so far */
+			unsigned int count() const;
+			/*! \brief Set the counter back to zero */
+			void reset();
+
+		public:
+			/*! \brief The CTAs that each LLVM worker has run so far */
+			static std::vector< unsigned int > workerCtas();
+			/*! \brief The CTAs that all LLVM workers have run so far */
+			static unsigned int jitCtas();
+	};
+}
+
+#endif
+
@@ -0,0 +1,251 @@
+/*!
+	\file TestAutotuner.cpp
+	\date October 18, 2026
+	\author agent <agent@local>
+	\brief The source file for the TestAutotuner unit test.
+*/
+
+#ifndef TEST_AUTOTUNER_CPP_INCLUDED
+#define TEST_AUTOTUNER_CPP_INCLUDED
+
+// Ocelot Includes
+#include <ocelot/executive/test/TestAutotuner.h>
+#include <ocelot/executive/test/CounterKernel.h>
+#include <ocelot/executive/interface/MulticoreCPUDevice.h>
+#include <ocelot/api/interface/OcelotConfiguration.h>
+
+// Hydrazine Includes
+#include <hydrazine/implementation/ArgumentParser.h>
+
+// Standard Library Includes
+#include <sstream>
+#include <fstream>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+
+// Linux Includes
+#include <unistd.h>
+
+namespace test
+{
+	std::string TestAutotuner::_saved() const
+	{
+		std::ifstream file( _path.c_str() );
+
+		std::stringstream contents;
+		contents << file.rdbuf();
+
+		return contents.str();
+	}
+
+	bool TestAutotuner::_launch( unsigned int launches,
+		unsigned int& busyWorkers, std::string& savedWhileAlive )
+	{
+		executive::MulticoreCPUDevice* device =
+			new executive::MulticoreCPUDevice;
+
+		device->select();
+		device->load( &_module );
+		device->limitWorkerThreads( threads );
+
+		CounterKernel* kernel = new CounterKernel( *device );
+
+		std::vector< unsigned int > before = CounterKernel::workerCtas();
+
+		bool pass = true;
+
+		for( unsigned int i = 0; i < launches && pass; ++i )
+		{
+			kernel->launch( ctas );
+
+			unsigned int result = kernel->count();
+
+			if( result != ( i + 1 ) * ctas )
+			{
+				status << " Launch " << i << " ran "
+					<< ( result - i * ctas ) << " of " << ctas << " CTAs.\n";
+				pass = false;
+			}
+		}
+
+		std::vector< unsigned int > after = CounterKernel::workerCtas();
+
+		busyWorkers = 0;
+
+		for( unsigned int i = 0; i < after.size(); ++i )
+		{
+			unsigned int previous = i < before.size() ? before[ i ] : 0;
+			if( after[ i ] != previous ) ++busyWorkers;
+		}
+
+		savedWhileAlive = _saved();
+
+		delete kernel;
+		device->unselect();
+
+		delete device;
+
+		return pass;
+	}
+
+	bool TestAutotuner::testSearch()
+	{
+		std::remove( _path.c_str() );
+
+		unsigned int busyWorkers = 0;
+		std::string savedWhileAlive;
+
+		// a warm up, one launch per worker count, and two chunk divisors
+		if( !_launch( 16, busyWorkers, savedWhileAlive ) )
+		{
+			status << "Test Point 1 FAILED.\n";
+			return false;
+		}
+
+		if( !savedWhileAlive.empty() )
+		{
+			status << "Test Point 1 FAILED: schedules were saved while the "
+				<< "device was alive:\n" << savedWhileAlive;
+			return false;
+		}
+
+		std::stringstream saved( _saved() );
+
+		std::string kernel;
+		std::string module;
+		unsigned int savedCtas = 0;
+		unsigned int workers = 0;
+		unsigned int divisor = 0;
+
+		saved >> kernel >> savedCtas >> workers >> divisor >> std::ws;
+		std::getline( saved, module );
+
+		if( kernel != CounterKernel::kernel || module != CounterKernel::module
+			|| savedCtas != ctas )
+		{
+			status << "Test Point 1 FAILED: expected a schedule for kernel "
+				<< CounterKernel::kernel << " in module "
+				<< CounterKernel::module << " with " << ctas
+				<< " CTAs, the file holds:\n" << _saved();
+			return false;
+		}
+
+		if( workers == 0 || workers > threads )
+		{
+			status << "Test Point 1 FAILED: the schedule uses " << workers
+				<< " workers, the pool has " << threads << ".\n";
+			return false;
+		}
+
+		status << "Test Point 1 Passed\n";
+		return true;
+	}
+
+	bool TestAutotuner::testLoad()
+	{
+		{
+			std::ofstream file( _path.c_str() );
+			file << CounterKernel::kernel << " " << ctas << " " << threads
+				<< " 0 other module\n";
+			file << CounterKernel::kernel << " " << ctas << " 1 0 "
+				<< CounterKernel::module << "\n";
+		}
+
+		unsigned int busyWorkers = 0;
+		std::string savedWhileAlive;
+
+		if( !_launch( 4, busyWorkers, savedWhileAlive ) )
+		{
+			status << "Test Point 2 FAILED.\n";
+			return false;
+		}
+
+		if( busyWorkers != 1 )
+		{
+			status << "Test Point 2 FAILED: " << busyWorkers << " workers "
+				<< "ran CTAs, the saved schedule uses one.\n";
+			return false;
+		}
+
+		status << "Test Point 2 Passed\n";
+		return true;
+	}
+
+	bool TestAutotuner::doTest()
+	{
+		if( executive::Device::deviceCount( ir::Instruction::LLVM ) == 0 )
+		{
+			status << "No LLVM device present.\n";
+			return true;
+		}
+
+		char path[] = "/tmp/TestAutotunerXXXXXX";
+		int file = mkstemp( path );
+
+		if( file == -1 )
+		{
+			status << "Failed to create a temporary schedule file.\n";
+			return false;
+		}
+
+		close( file );
+		_path = path;
+
+		std::stringstream configuration;
+		configuration << "{ executive: { autotuning: true, autotuningFile: \""
+			<< _path << "\" } }";
+
+		api::OcelotConfiguration::set(
+			new api::OcelotConfiguration( configuration ) );
+
+		_module.load( CounterKernel::module );
+
+		bool result = testSearch() && testLoad();
+
+		std::remove( _path.c_str() );
+
+		api::OcelotConfiguration::destroy();
+
+		return result;
+	}
+
+	TestAutotuner::TestAutotuner()
+	{
+		name = "TestAutotuner";
+
+		description = "A unit test for the schedules that the multicore ";
+		description += "CPU device tunes for each kernel and grid size. Test ";
+		description += "Points: 1) Launch a kernel with autotuning until its ";
+		description += "search is done, check that every launch ran all of ";
+		description += "its CTAs, that nothing is saved while the device is ";
+		description += "alive, and that destroying the device saves one ";
+		description += "schedule for the module, kernel and grid. 2) Save ";
+		description += "schedules for kernels with the same name in two ";
+		description += "modules, only the one for the loaded module uses a ";
+		description += "single worker. Launch on a new device and check that ";
+		description += "only one worker ran CTAs.";
+	}
+}
+
+int main( int argc, char** argv )
+{
+	hydrazine::ArgumentParser parser( argc, argv );
+	test::TestAutotuner test;
+
+	parser.description( test.testDescription() );
+
+	parser.parse( "-t", test.threads, 4, "The number of worker threads." );
+	parser.parse( "-c", test.ctas, 16, "The number of CTAs in every launch." );
+	parser.parse( "-s", test.seed, 0,
+		"Set the random seed, 0 implies seed with time." );
+	parser.parse( "-v", test.verbose, false, "Print out info after the test." );
+	parser.parse();
+
+	test.test();
+
+	return test.passed();
+}
+
+#endif
+
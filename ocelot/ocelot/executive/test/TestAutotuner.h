@@ -0,0 +1,62 @@
+/*!
+	\file TestAutotuner.h
+	\date October 18, 2026
+	\author agent <agent@local>
+	\brief The header file for the TestAutotuner unit test.
+*/
+
+#ifndef TEST_AUTOTUNER_H_INCLUDED
+#define TEST_AUTOTUNER_H_INCLUDED
+
+#include <hydrazine/interface/Test.h>
+#include <ocelot/ir/interface/Module.h>
+
+namespace test
+{
+	/*!
+		\brief A unit test for the schedules that the multicore CPU device
+			tunes for each kernel and grid size.
+
+		Test Points:
+			1) Launch a kernel with autotuning until its search is done,
+				check that every launch ran all of its CTAs, that nothing
+				is saved while the device is alive, and that destroying the
+				device saves one schedule for the module, kernel and grid.
+			2) Save schedules for kernels with the same name in two
+				modules, only the one for the loaded module uses a single
+				worker.  Launch on a new device and check that only one
+				worker ran CTAs.
+	*/
+	class TestAutotuner : public Test
+	{
+		private:
+			/*! \brief The module holding the kernel */
+			ir::Module _module;
+			/*! \brief The file that schedules are saved to */
+			std::string _path;
+
+		private:
+			std::string _saved() const;
+			bool _launch( unsigned int launches, unsigned int& busyWorkers,
+				std::string& savedWhileAlive );
+
+			bool testSearch();
+			bool testLoad();
+
+			bool doTest();
+
+		public:
+			TestAutotuner();
+
+		public:
+			/*! \brief The number of worker threads */
+			unsigned int threads;
+			/*! \brief The number of CTAs in every launch */
+			unsigned int ctas;
+	};
+}
+
+int main( int argc, char** argv );
+
+#endif
+
@@ -0,0 +1,225 @@
+/*!
+	\file TestBulkTransfer.cpp
+	\date October 18, 2026
+	\author agent <agent@local>
+	\brief The source file for the TestBulkTransfer unit test.
+*/
+
+#ifndef TEST_BULK_TRANSFER_CPP_INCLUDED
+#define TEST_BULK_TRANSFER_CPP_INCLUDED
+
+// Ocelot Includes
+#include <ocelot/executive/test/TestBulkTransfer.h>
+#include <ocelot/executive/interface/BulkTransfer.h>
+
+// Hydrazine Includes
+#include <hydrazine/implementation/ArgumentParser.h>
+
+// Boost Includes
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+
+// Standard Library Includes
+#include <vector>
+#include <algorithm>
+
+// Bytes checked on either side of a transfer
+#define GUARD 64
+
+namespace test
+{
+	typedef std::vector< unsigned char > ByteVector;
+	typedef std::vector< size_t > SizeVector;
+
+	/*! \brief Spans that take each path through the engine */
+	static SizeVector sizes()
+	{
+		SizeVector spans;
+		
+		spans.push_back( 1 );
+		spans.push_back( 4099 );
+		spans.push_back( ( 1 << 22 ) + 13 );
+		spans.push_back( std::max( 2 * executive::BulkTransfer::cacheSize(),
+			(size_t) 1 << 24 ) + 77 );
+		
+		return spans;
+	}
+
+	static void fill( ByteVector& bytes, unsigned int seed )
+	{
+		for( size_t i = 0; i < bytes.size(); ++i )
+		{
+			bytes[ i ] = ( i * 31 + seed ) & 0xff;
+		}
+	}
+	
+	/*! \brief Copy one span at an unaligned offset and check it */
+	static bool copyAndCheck( size_t bytes, unsigned int seed )
+	{
+		ByteVector source( bytes + 2 * GUARD );
+		ByteVector destination( bytes + 2 * GUARD, 0xcd );
+		
+		fill( source, seed );
+		
+		executive::BulkTransfer::copy( &destination[ GUARD + 3 ], 
+			&source[ GUARD ], bytes );
+		
+		for( size_t i = 0; i < GUARD + 3; ++i )
+		{
+			if( destination[ i ] != 0xcd ) return false;
+		}
+		
+		for( size_t i = 0; i < bytes; ++i )
+		{
+			if( destination[ GUARD + 3 + i ] != source[ GUARD + i ] )
+			{
+				return false;
+			}
+		}
+		
+		for( size_t i = GUARD + 3 + bytes; i < destination.size(); ++i )
+		{
+			if( destination[ i ] != 0xcd ) return false;
+		}
+		
+		return true;
+	}
+	
+	static void copyWorker( size_t bytes, unsigned int seed, bool* result )
+	{
+		*result = true;
+		for( unsigned int i = 0; i < 4; ++i )
+		{
+			*result = copyAndCheck( bytes, seed + i ) && *result;
+		}
+	}
+
+	bool TestBulkTransfer::testCopy()
+	{
+		SizeVector spans = sizes();
+		
+		for( SizeVector::iterator span = spans.begin(); 
+			span != spans.end(); ++span )
+		{
+			if( !copyAndCheck( *span, *span ) )
+			{
+				status << "Test Point 1 FAILED:\n";
+				status << " Copy of " << *span << " bytes was wrong.\n";
+				return false;
+			}
+		}
+		
+		status << "Test Point 1 Passed\n";
+		return true;
+	}
+	
+	bool TestBulkTransfer::testSet()
+	{
+		SizeVector spans = sizes();
+		
+		for( SizeVector::iterator span = spans.begin(); 
+			span != spans.end(); ++span )
+		{
+			ByteVector bytes( *span + 2 * GUARD, 0xcd );
+			
+			executive::BulkTransfer::Statistics statistics = 
+				executive::BulkTransfer::memset( &bytes[ GUARD + 5 ], 0x5a,
+				*span );
+			
+			bool correct = statistics.bytes == *span;
+			
+			for( size_t i = 0; i < bytes.size(); ++i )
+			{
+				bool inside = i >= GUARD + 5 && i < GUARD + 5 + *span;
+				if( bytes[ i ] != ( inside ? 0x5a : 0xcd ) ) correct = false;
+			}
+			
+			if( !correct )
+			{
+				status << "Test Point 2 FAILED:\n";
+				status << " Set of " << *span << " bytes with " 
+					<< statistics.threads << " threads was wrong.\n";
+				return false;
+			}
+		}
+		
+		status << "Test Point 2 Passed\n";
+		return true;
+	}
+	
+	bool TestBulkTransfer::testConcurrent()
+	{
+		size_t bytes = ( 1 << 23 ) + 29;
+		
+		boost::thread_group group;
+		bool* results = new bool[ threads ];
+		
+		for( unsigned int i = 0; i < threads; ++i )
+		{
+			group.create_thread( boost::bind( copyWorker, bytes, i, 
+				results + i ) );
+		}
+		
+		group.join_all();
+		
+		bool correct = true;
+		for( unsigned int i = 0; i < threads; ++i )
+		{
+			correct = correct && results[ i ];
+		}
+		
+		delete[] results;
+		
+		if( !correct )
+		{
+			status << "Test Point 3 FAILED:\n";
+			status << " Concurrent copies from " << threads 
+				<< " threads were wrong.\n";
+			return false;
+		}
+		
+		status << "Test Point 3 Passed\n";
+		return true;
+	}
+
+	bool TestBulkTransfer::doTest()
+	{
+		return testCopy() && testSet() && testConcurrent();
+	}
+
+	TestBulkTransfer::TestBulkTransfer()
+	{
+		name = "TestBulkTransfer";
+
+		description = "A unit test for the BulkTransfer copy and set ";
+		description += "engine. Test Points: 1) Copy spans below the ";
+		description += "parallel threshold, above it, and larger than the ";
+		description += "last level cache, at unaligned offsets. Check every ";
+		description += "byte and that the bytes around the span are ";
+		description += "untouched. 2) Do the same for memset. 3) Copy large ";
+		description += "spans from several host threads at once so that ";
+		description += "they share the transfer pool, check every byte.";
+	}
+}
+
+int main( int argc, char** argv )
+{
+	hydrazine::ArgumentParser parser( argc, argv );
+	test::TestBulkTransfer test;
+
+	parser.description( test.testDescription() );
+
+	parser.parse( "-t", test.threads, 4, 
+		"The number of host threads transferring at once." );
+	parser.parse( "-s", test.seed, 0,
+		"Set the random seed, 0 implies seed with time." );
+	parser.parse( "-v", test.verbose, false, "Print out info after the test." );
+	parser.parse();
+
+	test.test();
+
+	return test.passed();
+}
+
+#endif
+
@@ -0,0 +1,48 @@
+/*!
+	\file TestBulkTransfer.h
+	\date October 18, 2026
+	\author agent <agent@local>
+	\brief The header file for the TestBulkTransfer unit test.
+*/
+
+#ifndef TEST_BULK_TRANSFER_H_INCLUDED
+#define TEST_BULK_TRANSFER_H_INCLUDED
+
+#include <hydrazine/interface/Test.h>
+
+namespace test
+{
+	/*!
+		\brief A unit test for the BulkTransfer copy and set engine.
+		
+		Test Points:
+			1) Copy spans below the parallel threshold, above it, and
+				larger than the last level cache, at unaligned offsets.
+				Check every byte and that the bytes around the span are
+				untouched.
+			2) Do the same for memset.
+			3) Copy large spans from several host threads at once so that
+				they share the transfer pool, check every byte.
+	*/
+	class TestBulkTransfer : public Test
+	{
+		private:
+			bool testCopy();
+			bool testSet();
+			bool testConcurrent();
+			
+			bool doTest();
+		
+		public:
+			TestBulkTransfer();
+			
+		public:
+			/*! \brief The number of host threads in test point 3 */
+			unsigned int threads;
+	};
+}
+
+int main( int argc, char** argv );
+
+#endif
+
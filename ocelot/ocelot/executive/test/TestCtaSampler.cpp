@@ -0,0 +1,451 @@
+/*!
+	\file TestCtaSampler.cpp
+	\date October 18, 2026
+	\author agent <agent@local>
+	\brief The source file for the TestCtaSampler unit test.
+*/
+
+#ifndef TEST_CTA_SAMPLER_CPP_INCLUDED
+#define TEST_CTA_SAMPLER_CPP_INCLUDED
+
+// Ocelot Includes
+#include <ocelot/executive/test/TestCtaSampler.h>
+#include <ocelot/trace/interface/TraceEvent.h>
+#include <ocelot/api/interface/OcelotConfiguration.h>
+
+// Hydrazine Includes
+#include <hydrazine/implementation/ArgumentParser.h>
+
+// Standard Library Includes
+#include <sstream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+namespace test
+{
+	/*! \brief Instructions run by a CTA of the scaling test */
+	static unsigned int instructions( unsigned int cta )
+	{
+		return 1 + cta % 7;
+	}
+
+	/*! \brief Remembers the events replayed to it */
+	class EventRecorder : public trace::TraceGenerator
+	{
+		public:
+			/*! \brief The PC of each event, in order */
+			std::vector< ir::PTXU64 > pcs;
+			/*! \brief Was each event a committed event? */
+			std::vector< bool > posts;
+
+		public:
+			void event( const trace::TraceEvent& event )
+			{
+				pcs.push_back( event.PC );
+				posts.push_back( false );
+			}
+
+			void postEvent( const trace::TraceEvent& event )
+			{
+				pcs.push_back( event.PC );
+				posts.push_back( true );
+			}
+	};
+
+	void TestCtaSampler::_configure( unsigned int samples )
+	{
+		std::stringstream configuration;
+		configuration << "{ executive: { ctaSamples: " << samples
+			<< ", ctaSamplingSeed: 7 } }";
+
+		api::OcelotConfiguration::set(
+			new api::OcelotConfiguration( configuration ) );
+	}
+
+	void TestCtaSampler::_run( executive::CtaSampler::Counter& counter,
+		unsigned int cta, unsigned int count, ir::PTXU64 pc,
+		unsigned int threads )
+	{
+		trace::TraceEvent::BitMask active( threads );
+		active.set();
+
+		trace::TraceEvent event( ir::Dim3( cta, 0, 0 ), pc, 0, active,
+			trace::TraceEvent::U64Vector(), 0 );
+		event.gridDim = ir::Dim3( ctas, 1, 1 );
+
+		for( unsigned int i = 0; i < count; ++i )
+		{
+			counter.event( event );
+			counter.postEvent( event );
+		}
+	}
+
+	bool TestCtaSampler::testSelection()
+	{
+		const unsigned int samples = std::min( 10u, ctas );
+		_configure( samples );
+
+		executive::CtaSampler strided( ctas,
+			executive::CtaSampler::StridedSampling );
+		const executive::CtaSampler::IdVector& picks = strided.sampled();
+
+		if( picks.size() != samples )
+		{
+			status << "Test Point 1 FAILED: strided sampling picked "
+				<< picks.size() << " of " << samples << " CTAs.\n";
+			return false;
+		}
+
+		for( unsigned int i = 0; i < picks.size(); ++i )
+		{
+			long long unsigned int middle =
+				( ( 2 * i + 1 ) * (long long unsigned int) ctas )
+				/ ( 2 * samples );
+
+			if( picks[ i ] != middle )
+			{
+				status << "Test Point 1 FAILED: strided pick " << i
+					<< " is CTA " << picks[ i ] << ", expected " << middle
+					<< ".\n";
+				return false;
+			}
+		}
+
+		executive::CtaSampler random( ctas,
+			executive::CtaSampler::RandomSampling );
+		executive::CtaSampler again( ctas,
+			executive::CtaSampler::RandomSampling );
+
+		if( random.sampled() != again.sampled() )
+		{
+			status << "Test Point 1 FAILED: the same seed picked different "
+				<< "CTAs.\n";
+			return false;
+		}
+
+		const executive::CtaSampler::IdVector& randomPicks = random.sampled();
+
+		if( randomPicks.size() != samples )
+		{
+			status << "Test Point 1 FAILED: random sampling picked "
+				<< randomPicks.size() << " of " << samples << " CTAs.\n";
+			return false;
+		}
+
+		for( unsigned int i = 0; i < randomPicks.size(); ++i )
+		{
+			if( randomPicks[ i ] >= ctas
+				|| ( i > 0 && randomPicks[ i ] <= randomPicks[ i - 1 ] ) )
+			{
+				status << "Test Point 1 FAILED: random pick " << i
+					<< " is CTA " << randomPicks[ i ]
+					<< ", picks must be sorted, distinct and below " << ctas
+					<< ".\n";
+				return false;
+			}
+		}
+
+		const executive::CtaSampler* samplers[] = { &strided, &random };
+		double weight = (double) ctas / samples;
+
+		for( unsigned int s = 0; s < 2; ++s )
+		{
+			const executive::CtaSampler& sampler = *samplers[ s ];
+
+			for( unsigned int i = 0; i < sampler.sampled().size(); ++i )
+			{
+				if( sampler.weight( sampler.sampled()[ i ] ) != weight )
+				{
+					status << "Test Point 1 FAILED: a "
+						<< executive::CtaSampler::toString( sampler.mode() )
+						<< " pick stands for "
+						<< sampler.weight( sampler.sampled()[ i ] )
+						<< " CTAs, expected " << weight << ".\n";
+					return false;
+				}
+			}
+
+			if( sampler.scale() != weight )
+			{
+				status << "Test Point 1 FAILED: counters of a "
+					<< executive::CtaSampler::toString( sampler.mode() )
+					<< " launch are scaled by " << sampler.scale()
+					<< ", expected " << weight << ".\n";
+				return false;
+			}
+		}
+
+		if( samples < ctas && strided.weight( picks[ 0 ] + 1 ) != 0.0 )
+		{
+			status << "Test Point 1 FAILED: a CTA that was not picked stands "
+				<< "for " << strided.weight( picks[ 0 ] + 1 ) << " CTAs.\n";
+			return false;
+		}
+
+		status << "Test Point 1 Passed\n";
+		return true;
+	}
+
+	bool TestCtaSampler::testScaling()
+	{
+		const unsigned int samples = std::min( 10u, ctas );
+		const unsigned int threads = 4;
+		_configure( samples );
+
+		executive::CtaSampler sampler( ctas,
+			executive::CtaSampler::StridedSampling );
+		executive::CtaSampler::Counter counter( sampler );
+
+		double mean = 0.0;
+
+		for( unsigned int i = 0; i < sampler.sampled().size(); ++i )
+		{
+			// vary by position, strides can hit the same CTA pattern
+			_run( counter, sampler.sampled()[ i ], 1 + i, 0, threads );
+			mean += 1 + i;
+		}
+
+		mean /= sampler.sampled().size();
+
+		executive::CtaSampler::EstimateMap estimates = sampler.estimates();
+
+		const executive::CtaSampler::Estimate& estimate =
+			estimates[ "instructions" ];
+
+		if( std::fabs( estimate.total - ctas * mean ) > 1e-6 * ctas * mean )
+		{
+			status << "Test Point 2 FAILED: estimated " << estimate.total
+				<< " instructions, expected " << ( ctas * mean ) << ".\n";
+			return false;
+		}
+
+		if( samples < ctas
+			&& ( !( estimate.error > 0.0 ) || std::isinf( estimate.error ) ) )
+		{
+			status << "Test Point 2 FAILED: the bound of a varying sample is "
+				<< estimate.error << ".\n";
+			return false;
+		}
+
+		if( std::fabs( estimates[ "threadInstructions" ].total
+			- threads * estimate.total ) > 1e-6 * threads * estimate.total )
+		{
+			status << "Test Point 2 FAILED: estimated "
+				<< estimates[ "threadInstructions" ].total
+				<< " thread instructions, expected "
+				<< ( threads * estimate.total ) << ".\n";
+			return false;
+		}
+
+		_configure( ctas );
+
+		executive::CtaSampler everything( ctas,
+			executive::CtaSampler::StridedSampling );
+		executive::CtaSampler::Counter everythingCounter( everything );
+
+		double total = 0.0;
+
+		for( unsigned int cta = 0; cta < ctas; ++cta )
+		{
+			_run( everythingCounter, cta, instructions( cta ), 0, threads );
+			total += instructions( cta );
+		}
+
+		executive::CtaSampler::EstimateMap exactEstimates =
+			everything.estimates();
+		const executive::CtaSampler::Estimate& exact =
+			exactEstimates[ "instructions" ];
+
+		if( std::fabs( exact.total - total ) > 1e-6 * total
+			|| exact.error != 0.0 )
+		{
+			status << "Test Point 2 FAILED: sampling every CTA estimated "
+				<< exact.total << " +/- " << exact.error
+				<< " instructions, expected exactly " << total << ".\n";
+			return false;
+		}
+
+		status << "Test Point 2 Passed\n";
+		return true;
+	}
+
+	bool TestCtaSampler::testClustering()
+	{
+		const unsigned int shortCta = 3;
+		const unsigned int longCta = 5;
+
+		_configure( 2 );
+
+		executive::CtaSampler sampler( ctas,
+			executive::CtaSampler::ClusteredSampling );
+		executive::CtaSampler::Counter counter( sampler );
+
+		const executive::CtaSampler::IdVector& profiled = sampler.profiled();
+
+		if( profiled.size() < 2 )
+		{
+			status << "Test Point 3 FAILED: only " << profiled.size()
+				<< " CTAs were profiled.\n";
+			return false;
+		}
+
+		// alternate the kinds so both halves of the grid hold each kind
+		for( unsigned int i = 0; i < profiled.size(); ++i )
+		{
+			if( i % 2 == 0 ) _run( counter, profiled[ i ], shortCta, 0, 1 );
+			else _run( counter, profiled[ i ], longCta, 1, 1 );
+		}
+
+		sampler.cluster();
+
+		const executive::CtaSampler::IdVector& sampled = sampler.sampled();
+
+		if( sampled.size() != 2 )
+		{
+			status << "Test Point 3 FAILED: expected two representatives, "
+				<< "found " << sampled.size() << ".\n";
+			return false;
+		}
+
+		unsigned int longIndex = profiled.size();
+		unsigned int shortIndex = profiled.size();
+
+		for( unsigned int i = 0; i < profiled.size(); ++i )
+		{
+			if( profiled[ i ] != sampled[ 0 ] && profiled[ i ] != sampled[ 1 ] )
+			{
+				continue;
+			}
+
+			if( i % 2 == 0 ) shortIndex = i;
+			else longIndex = i;
+		}
+
+		if( longIndex == profiled.size() || shortIndex == profiled.size() )
+		{
+			status << "Test Point 3 FAILED: the representatives " << sampled[ 0 ]
+				<< " and " << sampled[ 1 ] << " are of the same kind.\n";
+			return false;
+		}
+
+		unsigned int longCtas = profiled.size() / 2;
+		unsigned int shortCtas = profiled.size() - longCtas;
+
+		double longWeight = (double) ctas * longCtas / profiled.size();
+		double shortWeight = (double) ctas * shortCtas / profiled.size();
+
+		if( sampler.weight( profiled[ longIndex ] ) != longWeight
+			|| sampler.weight( profiled[ shortIndex ] ) != shortWeight )
+		{
+			status << "Test Point 3 FAILED: the representatives stand for "
+				<< sampler.weight( profiled[ shortIndex ] ) << " and "
+				<< sampler.weight( profiled[ longIndex ] ) << " CTAs, expected "
+				<< shortWeight << " and " << longWeight << ".\n";
+			return false;
+		}
+
+		double total = shortWeight * shortCta + longWeight * longCta;
+		executive::CtaSampler::EstimateMap estimates = sampler.estimates();
+		const executive::CtaSampler::Estimate& estimate =
+			estimates[ "instructions" ];
+
+		if( std::fabs( estimate.total - total ) > 1e-6 * total )
+		{
+			status << "Test Point 3 FAILED: estimated " << estimate.total
+				<< " instructions, expected " << total << ".\n";
+			return false;
+		}
+
+		if( sampler.scale() != (double) ctas / profiled.size() )
+		{
+			status << "Test Point 3 FAILED: counters of a clustered launch "
+				<< "are scaled by " << sampler.scale() << ", expected "
+				<< ( (double) ctas / profiled.size() ) << ".\n";
+			return false;
+		}
+
+		EventRecorder recorder;
+		trace::TraceGeneratorVector generators( 1, &recorder );
+
+		sampler.replay( profiled[ longIndex ], generators );
+
+		if( recorder.pcs.size() != 2 * longCta )
+		{
+			status << "Test Point 3 FAILED: replaying the representative "
+				<< "passed " << recorder.pcs.size() << " events, expected "
+				<< ( 2 * longCta ) << ".\n";
+			return false;
+		}
+
+		for( unsigned int i = 0; i < recorder.pcs.size(); ++i )
+		{
+			if( recorder.pcs[ i ] != 1 || recorder.posts[ i ] != ( i % 2 == 1 ) )
+			{
+				status << "Test Point 3 FAILED: replayed event " << i
+					<< " has PC " << recorder.pcs[ i ] << " and is "
+					<< ( recorder.posts[ i ] ? "" : "not " )
+					<< "a committed event.\n";
+				return false;
+			}
+		}
+
+		status << "Test Point 3 Passed\n";
+		return true;
+	}
+
+	bool TestCtaSampler::doTest()
+	{
+		bool result = testSelection() && testScaling() && testClustering();
+
+		api::OcelotConfiguration::destroy();
+
+		return result;
+	}
+
+	TestCtaSampler::TestCtaSampler()
+	{
+		name = "TestCtaSampler";
+
+		description = "A unit test for the CTAs that sampled launches pick ";
+		description += "and the way that their counts are extrapolated to ";
+		description += "the grid. Events are made up and passed to the ";
+		description += "counter the way that a kernel would, so no kernel ";
+		description += "runs. Test Points: 1) Pick CTAs with strided and ";
+		description += "random sampling, check that the picks are sorted, ";
+		description += "distinct and inside the grid, that strided picks are ";
+		description += "the middles of equal strides, that the same seed ";
+		description += "picks the same CTAs, and that every picked CTA stands ";
+		description += "for the same number of CTAs. 2) Count a different ";
+		description += "number of instructions for each sampled CTA, check ";
+		description += "that the estimate is the grid size times the sample ";
+		description += "mean with a finite bound, and that sampling every CTA ";
+		description += "gives the exact total without error. 3) Profile CTAs ";
+		description += "of two kinds for clustering, check that one ";
+		description += "representative of each kind is picked with half of ";
+		description += "the grid each, that the estimate is exact, and that ";
+		description += "replaying a representative passes its events and ";
+		description += "committed events to a generator in order.";
+	}
+}
+
+int main( int argc, char** argv )
+{
+	hydrazine::ArgumentParser parser( argc, argv );
+	test::TestCtaSampler test;
+
+	parser.description( test.testDescription() );
+
+	parser.parse( "-c", test.ctas, 1000, "The number of CTAs in the grids." );
+	parser.parse( "-s", test.seed, 0,
+		"Set the random seed, 0 implies seed with time." );
+	parser.parse( "-v", test.verbose, false, "Print out info after the test." );
+	parser.parse();
+
+	test.test();
+
+	return test.passed();
+}
+
+#endif
+
@@ -0,0 +1,67 @@
+/*!
+	\file TestCtaSampler.h
+	\date October 18, 2026
+	\author agent <agent@local>
+	\brief The header file for the TestCtaSampler unit test.
+*/
+
+#ifndef TEST_CTA_SAMPLER_H_INCLUDED
+#define TEST_CTA_SAMPLER_H_INCLUDED
+
+#include <hydrazine/interface/Test.h>
+#include <ocelot/executive/interface/CtaSampler.h>
+
+namespace test
+{
+	/*!
+		\brief A unit test for the CTAs that sampled launches pick and the
+			way that their counts are extrapolated to the grid.
+
+		Events are made up and passed to the counter the way that a kernel
+		would, so no kernel runs.
+
+		Test Points:
+			1) Pick CTAs with strided and random sampling, check that the
+				picks are sorted, distinct and inside the grid, that strided
+				picks are the middles of equal strides, that the same seed
+				picks the same CTAs, and that every picked CTA stands for
+				the same number of CTAs.
+			2) Count a different number of instructions for each sampled
+				CTA, check that the estimate is the grid size times the
+				sample mean with a finite bound, and that sampling every CTA
+				gives the exact total without error.
+			3) Profile CTAs of two kinds for clustering, check that one
+				representative of each kind is picked with half of the grid
+				each, that the estimate is exact, and that replaying a
+				representative passes its events and committed events to a
+				generator in order.
+	*/
+	class TestCtaSampler : public Test
+	{
+		private:
+			/*! \brief Set the sampling options */
+			void _configure( unsigned int samples );
+			/*! \brief Pass the events of a CTA to a counter */
+			void _run( executive::CtaSampler::Counter& counter,
+				unsigned int cta, unsigned int count,
+				ir::PTXU64 pc, unsigned int threads );
+
+			bool testSelection();
+			bool testScaling();
+			bool testClustering();
+
+			bool doTest();
+
+		public:
+			TestCtaSampler();
+
+		public:
+			/*! \brief The number of CTAs in the sampled grids */
+			unsigned int ctas;
+	};
+}
+
+int main( int argc, char** argv );
+
+#endif
+
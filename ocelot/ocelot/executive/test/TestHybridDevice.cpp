@@ -0,0 +1,203 @@
+/*!
+	\file TestHybridDevice.cpp
+	\date October 18, 2026
+	\author agent <agent@local>
+	\brief The source file for the TestHybridDevice unit test.
+*/
+
+#ifndef TEST_HYBRID_DEVICE_CPP_INCLUDED
+#define TEST_HYBRID_DEVICE_CPP_INCLUDED
+
+// Ocelot Includes
+#include <ocelot/executive/test/TestHybridDevice.h>
+#include <ocelot/trace/interface/TraceGenerator.h>
+#include <ocelot/api/interface/OcelotConfiguration.h>
+#include <ocelot/ir/interface/Module.h>
+
+// Hydrazine Includes
+#include <hydrazine/implementation/ArgumentParser.h>
+
+// Standard Library Includes
+#include <sstream>
+
+namespace test
+{
+	/*! \brief Counts the events of traced launches */
+	class EventCounter : public trace::TraceGenerator
+	{
+		public:
+			unsigned int events;
+
+		public:
+			EventCounter() : events( 0 ) {}
+
+			void event( const trace::TraceEvent& event )
+			{
+				++events;
+			}
+	};
+
+	bool TestHybridDevice::_launch( bool traced, bool jit )
+	{
+		EventCounter generator;
+		trace::TraceGeneratorVector generators;
+		if( traced ) generators.push_back( &generator );
+
+		unsigned int before = _kernel->count();
+		unsigned int jitBefore = CounterKernel::jitCtas();
+
+		_kernel->launch( ctas, generators );
+
+		unsigned int after = _kernel->count();
+		unsigned int jitRan = CounterKernel::jitCtas() - jitBefore;
+
+		if( after - before != ctas )
+		{
+			status << " Expected " << ctas << " CTAs to run, but "
+				<< ( after - before ) << " did.\n";
+			return false;
+		}
+
+		if( jit && jitRan != ctas )
+		{
+			status << " Expected the launch to run on the JIT, but it ran "
+				<< jitRan << " of " << ctas << " CTAs there.\n";
+			return false;
+		}
+
+		if( !jit && jitRan != 0 )
+		{
+			status << " Expected the launch to run on the emulator, but "
+				<< jitRan << " CTAs ran on the JIT.\n";
+			return false;
+		}
+
+		if( traced && generator.events == 0 )
+		{
+			status << " The trace generator saw no events.\n";
+			return false;
+		}
+
+		return true;
+	}
+
+	bool TestHybridDevice::testTraced()
+	{
+		for( unsigned int i = 0; i < promote + 2; ++i )
+		{
+			if( !_launch( true, false ) )
+			{
+				status << "Test Point 1 FAILED on traced launch " << i
+					<< ".\n";
+				return false;
+			}
+		}
+
+		status << "Test Point 1 Passed\n";
+		return true;
+	}
+
+	bool TestHybridDevice::testPromotion()
+	{
+		for( unsigned int i = 0; i < promote + 2; ++i )
+		{
+			if( !_launch( false, i >= promote ) )
+			{
+				status << "Test Point 2 FAILED on launch " << i << ".\n";
+				return false;
+			}
+		}
+
+		status << "Test Point 2 Passed\n";
+		return true;
+	}
+
+	bool TestHybridDevice::testTracedAfterPromotion()
+	{
+		if( !_launch( true, false ) || !_launch( false, true ) )
+		{
+			status << "Test Point 3 FAILED.\n";
+			return false;
+		}
+
+		status << "Test Point 3 Passed\n";
+		return true;
+	}
+
+	bool TestHybridDevice::doTest()
+	{
+		if( executive::Device::deviceCount( ir::Instruction::LLVM ) == 0 )
+		{
+			status << "No LLVM device present.\n";
+			return true;
+		}
+
+		std::stringstream configuration;
+		configuration << "{ executive: { hybridExecution: true, "
+			<< "hybridPromoteLaunches: " << promote
+			<< ", hybridCalibration: false } }";
+
+		api::OcelotConfiguration::set(
+			new api::OcelotConfiguration( configuration ) );
+
+		ir::Module module( CounterKernel::module );
+
+		_device = new executive::HybridDevice;
+
+		_device->select();
+		_device->load( &module );
+
+		_kernel = new CounterKernel( *_device );
+
+		bool result = testTraced() && testPromotion()
+			&& testTracedAfterPromotion();
+
+		delete _kernel;
+		_device->unselect();
+
+		delete _device;
+
+		api::OcelotConfiguration::destroy();
+
+		return result;
+	}
+
+	TestHybridDevice::TestHybridDevice()
+	{
+		name = "TestHybridDevice";
+
+		description = "A unit test for the device that moves hot kernels ";
+		description += "from the emulator to the LLVM JIT. Test Points: 1) ";
+		description += "Launch a kernel with a trace generator attached more ";
+		description += "times than the promotion threshold, check that every ";
+		description += "launch ran on the emulator and was traced. 2) Launch ";
+		description += "the kernel without trace generators, check that the ";
+		description += "launches below the threshold run on the emulator, the ";
+		description += "rest on the JIT, and that every CTA ran. 3) Attach a ";
+		description += "trace generator to the promoted kernel, check that ";
+		description += "the launch goes back to the emulator and is traced.";
+	}
+}
+
+int main( int argc, char** argv )
+{
+	hydrazine::ArgumentParser parser( argc, argv );
+	test::TestHybridDevice test;
+
+	parser.description( test.testDescription() );
+
+	parser.parse( "-p", test.promote, 2,
+		"Launches on the emulator before moving to the JIT." );
+	parser.parse( "-c", test.ctas, 4, "The number of CTAs in every launch." );
+	parser.parse( "-s", test.seed, 0,
+		"Set the random seed, 0 implies seed with time." );
+	parser.parse( "-v", test.verbose, false, "Print out info after the test." );
+	parser.parse();
+
+	test.test();
+
+	return test.passed();
+}
+
+#endif
+
@@ -0,0 +1,62 @@
+/*!
+	\file TestHybridDevice.h
+	\date October 18, 2026
+	\author agent <agent@local>
+	\brief The header file for the TestHybridDevice unit test.
+*/
+
+#ifndef TEST_HYBRID_DEVICE_H_INCLUDED
+#define TEST_HYBRID_DEVICE_H_INCLUDED
+
+#include <hydrazine/interface/Test.h>
+#include <ocelot/executive/interface/HybridDevice.h>
+#include <ocelot/executive/test/CounterKernel.h>
+
+namespace test
+{
+	/*!
+		\brief A unit test for the device that moves hot kernels from the
+			emulator to the LLVM JIT.
+
+		Test Points:
+			1) Launch a kernel with a trace generator attached more times
+				than the promotion threshold, check that every launch ran on
+				the emulator and was traced.
+			2) Launch the kernel without trace generators, check that the
+				launches below the threshold run on the emulator, the rest
+				on the JIT, and that every CTA ran.
+			3) Attach a trace generator to the promoted kernel, check that
+				the launch goes back to the emulator and is traced.
+	*/
+	class TestHybridDevice : public Test
+	{
+		private:
+			/*! \brief The device under test */
+			executive::HybridDevice* _device;
+			/*! \brief Counts the CTAs that ran on either backend */
+			CounterKernel* _kernel;
+
+		private:
+			bool _launch( bool traced, bool jit );
+
+			bool testTraced();
+			bool testPromotion();
+			bool testTracedAfterPromotion();
+
+			bool doTest();
+
+		public:
+			TestHybridDevice();
+
+		public:
+			/*! \brief Launches on the emulator before moving to the JIT */
+			unsigned int promote;
+			/*! \brief The number of CTAs in every launch */
+			unsigned int ctas;
+	};
+}
+
+int main( int argc, char** argv );
+
+#endif
+
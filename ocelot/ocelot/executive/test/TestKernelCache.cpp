@@ -0,0 +1,334 @@
+/*!
+	\file TestKernelCache.cpp
+	\date October 18, 2026
+	\author agent <agent@local>
+	\brief The source file for the TestKernelCache unit test.
+*/
+
+#ifndef TEST_KERNEL_CACHE_CPP_INCLUDED
+#define TEST_KERNEL_CACHE_CPP_INCLUDED
+
+// Ocelot Includes
+#include <ocelot/executive/test/TestKernelCache.h>
+#include <ocelot/executive/interface/KernelCache.h>
+#include <ocelot/api/interface/OcelotConfiguration.h>
+
+// Hydrazine Includes
+#include <hydrazine/implementation/ArgumentParser.h>
+
+// Standard Library Includes
+#include <set>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+// Linux Includes
+#include <unistd.h>
+#include <dirent.h>
+#include <utime.h>
+
+// Entries in test point 3, three of them do not fit in the 1MB limit
+#define ENTRY_BYTES ( 400 * 1024 )
+
+namespace test
+{
+	typedef std::set< std::string > StringSet;
+
+	/*! \brief Get the paths of all entries in a cache directory */
+	static StringSet entries( const std::string& directory )
+	{
+		StringSet paths;
+
+		DIR* dir = opendir( directory.c_str() );
+		if( dir == 0 ) return paths;
+
+		for( struct dirent* entry = readdir( dir ); entry != 0;
+			entry = readdir( dir ) )
+		{
+			std::string name = entry->d_name;
+			if( name.find( ".ocelot" ) == std::string::npos ) continue;
+
+			paths.insert( directory + "/" + name );
+		}
+
+		closedir( dir );
+
+		return paths;
+	}
+
+	/*! \brief Get the path of the one entry that is not in a set */
+	static std::string added( const std::string& directory,
+		const StringSet& before )
+	{
+		StringSet after = entries( directory );
+
+		for( StringSet::iterator path = after.begin();
+			path != after.end(); ++path )
+		{
+			if( before.count( *path ) == 0 ) return *path;
+		}
+
+		return "";
+	}
+
+	static std::string entryData( unsigned int seed )
+	{
+		std::string data( ENTRY_BYTES, '\0' );
+
+		for( size_t i = 0; i < data.size(); ++i )
+		{
+			data[ i ] = ( i * 13 + seed ) & 0xff;
+		}
+
+		return data;
+	}
+
+	void TestKernelCache::_configure( const std::string& directory )
+	{
+		std::stringstream stream;
+
+		stream << "{ executive: { kernelCache: \"" << directory
+			<< "\", kernelCacheSize: 1 } }";
+
+		api::OcelotConfiguration::set(
+			new api::OcelotConfiguration( stream ) );
+	}
+
+	void TestKernelCache::_age( const std::string& path, int seconds ) const
+	{
+		struct utimbuf times;
+
+		times.actime = std::time( 0 ) - seconds;
+		times.modtime = times.actime;
+
+		utime( path.c_str(), &times );
+	}
+
+	void TestKernelCache::_clear() const
+	{
+		StringSet paths = entries( _directory );
+
+		for( StringSet::iterator path = paths.begin();
+			path != paths.end(); ++path )
+		{
+			std::remove( path->c_str() );
+		}
+	}
+
+	bool TestKernelCache::testHitMiss()
+	{
+		std::string data( "bitcode\0with\0nulls", 18 );
+		std::string result;
+
+		if( executive::KernelCache::load( "kernel a", result ) )
+		{
+			status << " An empty cache hit.\n";
+			return false;
+		}
+
+		executive::KernelCache::store( "kernel a", data );
+
+		if( !executive::KernelCache::load( "kernel a", result ) )
+		{
+			status << " A stored entry missed.\n";
+			return false;
+		}
+
+		if( result != data )
+		{
+			status << " A hit returned " << result.size()
+				<< " bytes that do not match the " << data.size()
+				<< " bytes stored.\n";
+			return false;
+		}
+
+		if( executive::KernelCache::load( "kernel b", result ) )
+		{
+			status << " A different description hit.\n";
+			return false;
+		}
+
+		_configure( "" );
+
+		bool disabled = !executive::KernelCache::enabled()
+			&& !executive::KernelCache::load( "kernel a", result );
+
+		_configure( _directory );
+
+		if( !disabled )
+		{
+			status << " The cache hit without a directory.\n";
+			return false;
+		}
+
+		status << "Test Point 1 Passed\n";
+		return true;
+	}
+
+	bool TestKernelCache::testCollision()
+	{
+		std::string data( "bitcode\0with\0nulls", 18 );
+		std::string result;
+
+		StringSet paths = entries( _directory );
+
+		if( paths.size() != 1 )
+		{
+			status << " Expected one entry, found " << paths.size()
+				<< ".\n";
+			return false;
+		}
+
+		// the same file name with the header of another description
+		{
+			std::ofstream file( paths.begin()->c_str(), std::ios::binary );
+			file << "ocelot-kernel-cache 0 0\n";
+			file.write( data.data(), data.size() );
+		}
+
+		if( executive::KernelCache::load( "kernel a", result ) )
+		{
+			status << " An entry with the wrong header hit.\n";
+			return false;
+		}
+
+		executive::KernelCache::store( "kernel a", data );
+
+		if( !executive::KernelCache::load( "kernel a", result )
+			|| result != data )
+		{
+			status << " Replacing an entry with the wrong header failed.\n";
+			return false;
+		}
+
+		status << "Test Point 2 Passed\n";
+		return true;
+	}
+
+	bool TestKernelCache::testEviction()
+	{
+		_clear();
+
+		std::string result;
+
+		StringSet before = entries( _directory );
+		executive::KernelCache::store( "entry 1", entryData( 1 ) );
+		std::string first = added( _directory, before );
+
+		before = entries( _directory );
+		executive::KernelCache::store( "entry 2", entryData( 2 ) );
+		std::string second = added( _directory, before );
+
+		if( first.empty() || second.empty() )
+		{
+			status << " Storing entries under the size limit failed.\n";
+			return false;
+		}
+
+		// modification times have a resolution of a second
+		_age( first, 300 );
+		_age( second, 200 );
+
+		// a hit makes the first entry the most recently used
+		if( !executive::KernelCache::load( "entry 1", result ) )
+		{
+			status << " Entry 1 was evicted before the limit.\n";
+			return false;
+		}
+
+		executive::KernelCache::store( "entry 3", entryData( 3 ) );
+
+		if( executive::KernelCache::load( "entry 2", result ) )
+		{
+			status << " The least recently used entry was not evicted.\n";
+			return false;
+		}
+
+		for( unsigned int seed = 1; seed <= 3; seed += 2 )
+		{
+			std::stringstream description;
+			description << "entry " << seed;
+
+			if( !executive::KernelCache::load( description.str(), result )
+				|| result != entryData( seed ) )
+			{
+				status << " " << description.str()
+					<< " was evicted or damaged.\n";
+				return false;
+			}
+		}
+
+		if( entries( _directory ).size() != 2 )
+		{
+			status << " Expected two entries after eviction, found "
+				<< entries( _directory ).size() << ".\n";
+			return false;
+		}
+
+		status << "Test Point 3 Passed\n";
+		return true;
+	}
+
+	bool TestKernelCache::doTest()
+	{
+		char path[] = "/tmp/TestKernelCacheXXXXXX";
+
+		if( mkdtemp( path ) == 0 )
+		{
+			status << "Failed to create a temporary directory.\n";
+			return false;
+		}
+
+		// the cache creates missing parent directories
+		_directory = std::string( path ) + "/kernels";
+		_configure( _directory );
+
+		bool result = testHitMiss() && testCollision() && testEviction();
+
+		_clear();
+		rmdir( _directory.c_str() );
+		rmdir( path );
+
+		api::OcelotConfiguration::destroy();
+
+		return result;
+	}
+
+	TestKernelCache::TestKernelCache()
+	{
+		name = "TestKernelCache";
+
+		description = "A unit test for the on-disk cache of translated ";
+		description += "kernels. Test Points: 1) Look up an empty cache, ";
+		description += "store an entry with embedded nulls, then check that ";
+		description += "the same description hits with the same data, a ";
+		description += "different description misses, and nothing hits once ";
+		description += "the cache is disabled. 2) Overwrite the header of an ";
+		description += "entry and check that it is treated as a miss. 3) Fill ";
+		description += "the cache past its size limit after using the oldest ";
+		description += "entry again, check that the least recently used ";
+		description += "entry is evicted and the others still hit.";
+	}
+}
+
+int main( int argc, char** argv )
+{
+	hydrazine::ArgumentParser parser( argc, argv );
+	test::TestKernelCache test;
+
+	parser.description( test.testDescription() );
+
+	parser.parse( "-s", test.seed, 0,
+		"Set the random seed, 0 implies seed with time." );
+	parser.parse( "-v", test.verbose, false, "Print out info after the test." );
+	parser.parse();
+
+	test.test();
+
+	return test.passed();
+}
+
+#endif
+
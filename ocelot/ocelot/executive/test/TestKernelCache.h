@@ -0,0 +1,54 @@
+/*!
+	\file TestKernelCache.h
+	\date October 18, 2026
+	\author agent <agent@local>
+	\brief The header file for the TestKernelCache unit test.
+*/
+
+#ifndef TEST_KERNEL_CACHE_H_INCLUDED
+#define TEST_KERNEL_CACHE_H_INCLUDED
+
+#include <hydrazine/interface/Test.h>
+
+namespace test
+{
+	/*!
+		\brief A unit test for the on-disk cache of translated kernels.
+
+		Test Points:
+			1) Look up an empty cache, store an entry with embedded nulls,
+				then check that the same description hits with the same
+				data, a different description misses, and nothing hits
+				once the cache is disabled.
+			2) Overwrite the header of an entry and check that it is
+				treated as a miss.
+			3) Fill the cache past its size limit after using the oldest
+				entry again, check that the least recently used entry is
+				evicted and the others still hit.
+	*/
+	class TestKernelCache : public Test
+	{
+		private:
+			/*! \brief The cache directory for this run */
+			std::string _directory;
+
+		private:
+			void _configure( const std::string& directory );
+			void _age( const std::string& path, int seconds ) const;
+			void _clear() const;
+
+			bool testHitMiss();
+			bool testCollision();
+			bool testEviction();
+
+			bool doTest();
+
+		public:
+			TestKernelCache();
+	};
+}
+
+int main( int argc, char** argv );
+
+#endif
+
@@ -11,12 +11,15 @@
 // Ocelot Includes
 #include <ocelot/executive/test/TestLLVMKernels.h>
 #include <ocelot/executive/interface/Device.h>
+#include <ocelot/api/interface/OcelotConfiguration.h>
 
 // Hydrazine Includes
 #include <hydrazine/implementation/ArgumentParser.h>
 
 // Standard Library Includes
 #include <cmath>
+#include <cstring>
+#include <sstream>
 
 namespace test
 {
@@ -86,6 +89,58 @@ namespace test
 		return true;
 	}
 
+	bool TestLLVMKernels::_launchBundled( const std::string& kernelName, 
+		int bundleWidth, unsigned int threads, void* data )
+	{
+		std::stringstream stream;
+		stream << "{ executive: { threadBundleWidth: " << bundleWidth 
+			<< " } }";
+		api::OcelotConfiguration::set( 
+			new api::OcelotConfiguration( stream ) );
+		
+		ir::Kernel* ptx = _module.getKernel( kernelName );
+		if( !ptx )
+		{
+			status << "Failed to get kernel " << kernelName << "\n";
+			return false;
+		}
+		
+		// translated at the first launch, under the configuration above
+		executive::LLVMExecutableKernel kernel( *ptx, 0, 
+			translator::Translator::BasicOptimization );
+		
+		ir::Parameter& param = *kernel.getParameter( 
+			"__cudaparm_" + kernelName + "_ptr" );
+		
+		param.arrayValues.resize( 1 );
+		param.arrayValues[ 0 ].val_u64 = ( ir::PTXU64 ) data;
+		kernel.updateParameterMemory();
+		
+		kernel.setKernelShape( threads, 1, 1 );
+		kernel.launchGrid( 1, 1 );
+		
+		return true;
+	}
+
+	bool TestLLVMKernels::_checkSequence( const float* sequence, 
+		unsigned int N )
+	{
+		for( unsigned int i = 0; i < N; ++i ) 
+		{
+			float w = i * 0.0625f;
+			float expected = ( i % 2 ) ? cos( w ) : sin( w );
+			
+			if( fabs( expected - sequence[ i ] ) > 0.001f ) 
+			{
+				status << "error on element " << i << " - expected " 
+					<< expected << ", encountered " << sequence[ i ] << "\n";
+				return false;
+			}
+		}
+		
+		return true;
+	}
+
 	bool TestLLVMKernels::testDivergent()
 	{
 		executive::LLVMExecutableKernel* kernel = _divergentKernel;
@@ -337,6 +392,193 @@ namespace test
 		return true;
 	}
 	
+	bool TestLLVMKernels::testBundles()
+	{
+		// k_sequence is uniform and runs bundled, k_sequenceDivergent
+		//  branches on tid.x and falls back to scalar threads.  10 threads
+		//  leave a partial bundle that runs scalar either way.
+		const char* kernels[] = { "_Z10k_sequencePi", 
+			"_Z19k_sequenceDivergentPf" };
+		const unsigned int threads = 10;
+		
+		bool pass = true;
+		
+		for( unsigned int k = 0; k < 2 && pass; ++k )
+		{
+			int scalar[ threads ];
+			int bundled[ threads ];
+			
+			for( unsigned int i = 0; i < threads; ++i )
+			{
+				scalar[ i ] = -2;
+				bundled[ i ] = -2;
+			}
+			
+			if( !_launchBundled( kernels[ k ], 1, threads, scalar ) 
+				|| !_launchBundled( kernels[ k ], 4, threads, bundled ) )
+			{
+				pass = false;
+				break;
+			}
+			
+			// the lanes run the same scalar instructions as a thread
+			if( std::memcmp( scalar, bundled, sizeof( scalar ) ) != 0 )
+			{
+				status << "Bundled results of " << kernels[ k ] 
+					<< " do not match scalar results.\n";
+				for( unsigned int i = 0; i < threads; ++i )
+				{
+					status << " [" << i << "] scalar " << scalar[ i ] 
+						<< ", bundled " << bundled[ i ] << "\n";
+				}
+				pass = false;
+			}
+		}
+		
+		// go back to the configuration file for the rest of the tests
+		api::OcelotConfiguration::destroy();
+		
+		return pass;
+	}
+	
+	bool TestLLVMKernels::testThreadLoops()
+	{
+		std::stringstream stream( "{ executive: { threadLoops: true } }" );
+		api::OcelotConfiguration::set( 
+			new api::OcelotConfiguration( stream ) );
+		
+		ir::Kernel* ptx = _module.getKernel( "_Z13barrierExitedPiS_" );
+		if( !ptx )
+		{
+			status << "Failed to get kernel _Z13barrierExitedPiS_\n";
+			api::OcelotConfiguration::destroy();
+			return false;
+		}
+		
+		// without optimization only the inliner runs on the thread loops
+		const translator::Translator::OptimizationLevel levels[] = {
+			translator::Translator::NoOptimization, 
+			translator::Translator::BasicOptimization };
+		
+		const unsigned int N = 8;
+		const unsigned int half = N / 2;
+		
+		bool pass = true;
+		
+		for( unsigned int l = 0; l < 2 && pass; ++l )
+		{
+			int in[ N ];
+			int out[ N ];
+		
+			for( unsigned int i = 0; i < N; ++i ) 
+			{
+				in[ i ] = i;
+				out[ i ] = -2;
+			}
+			
+			executive::LLVMExecutableKernel kernel( *ptx, 0, levels[ l ] );
+			
+			ir::Parameter& param_A = *kernel.getParameter(
+				"__cudaparm__Z13barrierExitedPiS__in" );
+			ir::Parameter& param_B = *kernel.getParameter(
+				"__cudaparm__Z13barrierExitedPiS__out" );
+
+			param_A.arrayValues.resize( 1 );
+			param_A.arrayValues[ 0 ].val_u64 = ( ir::PTXU64 ) in;
+			param_B.arrayValues.resize( 1 );
+			param_B.arrayValues[ 0 ].val_u64 = ( ir::PTXU64 ) out;
+			kernel.updateParameterMemory();
+
+			kernel.setKernelShape( N, 1, 1 );
+			kernel.launchGrid( 1, 1 );
+			
+			for( unsigned int i = 0; i < N; ++i ) 
+			{
+				// the values are rotated by one thread twice
+				int expected = i < half ? in[ ( i + 2 ) % half ] : -2;
+				
+				if( out[ i ] != expected )
+				{
+					status << "At level " << translator::Translator::toString(
+						levels[ l ] ) << ", index " << i << " expected " 
+						<< expected << ", encountered " << out[ i ] << "\n";
+					pass = false;
+					break;
+				}
+			}
+		}
+		
+		api::OcelotConfiguration::destroy();
+		
+		return pass;
+	}
+	
+	bool TestLLVMKernels::testSpecialization()
+	{
+		std::stringstream stream( "{ executive: { launchSpecialization: true,"
+			" specializationVariants: 2, specializationLaunches: 2 } }" );
+		api::OcelotConfiguration::set( 
+			new api::OcelotConfiguration( stream ) );
+		
+		ir::Kernel* ptx = _module.getKernel( "_Z17k_sequenceLoopingPfi" );
+		if( !ptx )
+		{
+			status << "Failed to get kernel _Z17k_sequenceLoopingPfi\n";
+			api::OcelotConfiguration::destroy();
+			return false;
+		}
+		
+		executive::LLVMExecutableKernel kernel( *ptx, 0, 
+			translator::Translator::BasicOptimization );
+		
+		ir::Parameter& param_A = *kernel.getParameter(
+			"__cudaparm__Z17k_sequenceLoopingPfi_ptr" );
+		ir::Parameter& param_B = *kernel.getParameter(
+			"__cudaparm__Z17k_sequenceLoopingPfi_N" );
+		
+		const unsigned int maxN = 8 * 7;
+		float sequence[ maxN ];
+		
+		// the second launch with the same values compiles a variant and 
+		//  the third reuses it, a new N starts over with the generic code
+		const unsigned int sizes[] = { 40, 40, 40, 56, 56, 56, 40 };
+		
+		bool pass = true;
+		
+		for( unsigned int launch = 0; launch < 7 && pass; ++launch )
+		{
+			unsigned int N = sizes[ launch ];
+			
+			for( unsigned int i = 0; i < maxN; ++i ) sequence[ i ] = -2;
+			
+			param_A.arrayValues.resize( 1 );
+			param_A.arrayValues[ 0 ].val_u64 = ( ir::PTXU64 ) sequence;
+			param_B.arrayValues.resize( 1 );
+			param_B.arrayValues[ 0 ].val_u64 = ( ir::PTXU64 ) N;
+			kernel.updateParameterMemory();
+			
+			kernel.setKernelShape( 8, 1, 1 );
+			kernel.launchGrid( 1, 1 );
+			
+			if( !_checkSequence( sequence, N ) )
+			{
+				status << " launch " << launch << " with N = " << N 
+					<< " was wrong.\n";
+				pass = false;
+			}
+			else if( N < maxN && sequence[ N ] != -2 )
+			{
+				status << " launch " << launch << " with N = " << N 
+					<< " wrote past the end.\n";
+				pass = false;
+			}
+		}
+		
+		api::OcelotConfiguration::destroy();
+		
+		return pass;
+	}
+	
 	bool TestLLVMKernels::doTest()
 	{
 		if( executive::Device::deviceCount( ir::Instruction::LLVM ) == 0 )
@@ -349,7 +591,10 @@ namespace test
 		
 		return result && testDivergent() && testLooping()
 			&& testBarrier() 
-			&& testMatrixMultiply();
+			&& testMatrixMultiply()
+			&& testBundles()
+			&& testThreadLoops()
+			&& testSpecialization();
 	}
 	
 	TestLLVMKernels::TestLLVMKernels()
@@ -359,7 +604,16 @@ namespace test
 		description = "A unit test for the LLVM executive runtime.";
 		description += " Test Points: 1) Execute a kernel with divergent ";
 		description += "control flow. 2) Execute a kernel with a loop. ";
-		description += "3) Execute a matrix multiply kernel.";
+		description += "3) Execute a matrix multiply kernel. ";
+		description += "4) Run kernels in bundles of threads and compare ";
+		description += "the results against the same kernels run one ";
+		description += "thread at a time. 5) Run a kernel with barriers, ";
+		description += "where half of the threads exit before the first ";
+		description += "one, as loops over threads with and without ";
+		description += "optimization. 6) Launch a kernel with launch ";
+		description += "specialization enabled, first with the same values ";
+		description += "until a specialized variant is used, then with ";
+		description += "other values, and check every result.";
 
 		_divergentKernel = 0;
 		_loopingKernel = 0;
@@ -21,6 +21,14 @@ namespace test
 			1) Execute a kernel with divergent control flow.
 			2) Execute a kernel with a loop.
 			3) Execute a matrix multiply kernel.
+			4) Run kernels in bundles of threads and compare the results
+				against the same kernels run one thread at a time.
+			5) Run a kernel with barriers, where half of the threads exit
+				before the first one, as loops over threads with and
+				without optimization.
+			6) Launch a kernel with launch specialization enabled, first
+				with the same values until a specialized variant is used,
+				then with other values, and check every result.
 	*/
 	class TestLLVMKernels : public Test
 	{
@@ -33,11 +41,17 @@ namespace test
 
 		private:
 			bool _loadKernels();
+			bool _launchBundled( const std::string& kernelName, 
+				int bundleWidth, unsigned int threads, void* data );
+			bool _checkSequence( const float* sequence, unsigned int N );
 		
 			bool testDivergent();
 			bool testLooping();
 			bool testBarrier();
 			bool testMatrixMultiply();
+			bool testBundles();
+			bool testThreadLoops();
+			bool testSpecialization();
 			
 			bool doTest();
 		
@@ -0,0 +1,223 @@
+/*!
+	\file TestLLVMLaunchLatency.cpp
+	\date October 18, 2026
+	\author agent <agent@local>
+	\brief The source file for the TestLLVMLaunchLatency benchmark.
+*/
+
+#ifndef TEST_LLVM_LAUNCH_LATENCY_CPP_INCLUDED
+#define TEST_LLVM_LAUNCH_LATENCY_CPP_INCLUDED
+
+// Ocelot Includes
+#include <ocelot/executive/test/TestLLVMLaunchLatency.h>
+#include <ocelot/executive/test/CounterKernel.h>
+#include <ocelot/executive/interface/LLVMExecutableKernel.h>
+#include <ocelot/executive/interface/Device.h>
+#include <ocelot/ir/interface/Module.h>
+
+// Hydrazine Includes
+#include <hydrazine/implementation/ArgumentParser.h>
+#include <hydrazine/implementation/Timer.h>
+
+// Standard Library Includes
+#include <cstdlib>
+#include <new>
+
+// Allocations made through operator new by every thread in the program
+static volatile long long unsigned int allocations = 0;
+
+void* operator new( size_t bytes )
+{
+	__sync_fetch_and_add( &allocations, 1 );
+	
+	void* pointer = std::malloc( bytes == 0 ? 1 : bytes );
+	if( pointer == 0 ) throw std::bad_alloc();
+	
+	return pointer;
+}
+
+void* operator new[]( size_t bytes )
+{
+	return operator new( bytes );
+}
+
+void operator delete( void* pointer ) throw()
+{
+	std::free( pointer );
+}
+
+void operator delete[]( void* pointer ) throw()
+{
+	std::free( pointer );
+}
+
+namespace test
+{
+	bool TestLLVMLaunchLatency::testLatency()
+	{
+		executive::DeviceVector devices = executive::Device::createDevices(
+			ir::Instruction::LLVM, 0 );
+
+		if( devices.empty() )
+		{
+			status << "No LLVM device present.\n";
+			return true;
+		}
+
+		executive::Device& device = *devices.front();
+
+		ir::Module module( CounterKernel::module );
+
+		device.select();
+		device.load( &module );
+		device.limitWorkerThreads( threads );
+
+		CounterKernel* kernel = new CounterKernel( device );
+
+		// the first launch pays for translation and starting the workers
+		kernel->launch( threads );
+
+		executive::LLVMExecutableKernel::WorkerStatisticsVector before =
+			executive::LLVMExecutableKernel::workerStatistics();
+
+		hydrazine::Timer timer;
+		timer.start();
+
+		for( unsigned int i = 0; i < launches; ++i )
+		{
+			kernel->launch( threads );
+		}
+
+		timer.stop();
+		
+		// the timed launches also warmed up any specialized variants
+		executive::LLVMExecutableKernel::WorkerStatisticsVector warm =
+			executive::LLVMExecutableKernel::workerStatistics();
+		long long unsigned int allocationsBefore = allocations;
+		
+		for( unsigned int i = 0; i < launches; ++i )
+		{
+			kernel->launch( threads );
+		}
+		
+		long long unsigned int launchAllocations = 
+			allocations - allocationsBefore;
+
+		const executive::LLVMExecutableKernel::WorkerStatisticsVector& after =
+			executive::LLVMExecutableKernel::workerStatistics();
+
+		double latency = 0.0;
+		unsigned int started = 0;
+
+		for( unsigned int i = 0; i < after.size() && i < before.size(); ++i )
+		{
+			latency += after[ i ].startLatency - before[ i ].startLatency;
+			started += after[ i ].launches - before[ i ].launches;
+		}
+
+		unsigned int arenaGrowths = 0;
+
+		for( unsigned int i = 0; i < after.size() && i < warm.size(); ++i )
+		{
+			arenaGrowths += after[ i ].arenaGrowths - warm[ i ].arenaGrowths;
+		}
+
+		unsigned int result = kernel->count();
+
+		delete kernel;
+		device.unselect();
+
+		for( executive::DeviceVector::iterator d = devices.begin();
+			d != devices.end(); ++d )
+		{
+			delete *d;
+		}
+
+		unsigned int expected = ( 2 * launches + 1 ) * threads;
+
+		if( result != expected )
+		{
+			status << "Test Point 1 FAILED:\n";
+			status << " Expected " << expected << " CTAs to run, but "
+				<< result << " did.\n";
+			return false;
+		}
+
+		status << " " << after.size() << " workers, " << launches
+			<< " launches\n";
+		status << "  " << ( launches > 0
+			? timer.seconds() * 1.0e6 / launches : 0.0 )
+			<< " us per launch\n";
+		status << "  " << ( started > 0 ? latency * 1.0e6 / started : 0.0 )
+			<< " us from launch to first CTA\n";
+
+		status << "Test Point 1 Passed\n";
+		
+		status << "  " << ( launches > 0 
+			? (double) launchAllocations / launches : 0.0 )
+			<< " heap allocations per launch\n";
+		
+		if( arenaGrowths != 0 )
+		{
+			status << "Test Point 2 FAILED:\n";
+			status << " " << launches << " launches grew the worker arenas "
+				<< arenaGrowths << " times, expected none.\n";
+			return false;
+		}
+		
+		if( launchAllocations != 0 )
+		{
+			status << "Test Point 2 FAILED:\n";
+			status << " " << launches << " launches made " 
+				<< launchAllocations << " heap allocations, expected none.\n";
+			return false;
+		}
+		
+		status << "Test Point 2 Passed\n";
+		return true;
+	}
+
+	bool TestLLVMLaunchLatency::doTest()
+	{
+		return testLatency();
+	}
+
+	TestLLVMLaunchLatency::TestLLVMLaunchLatency()
+	{
+		name = "TestLLVMLaunchLatency";
+
+		description = "A benchmark for the cost of handing tiny kernels to ";
+		description += "the LLVM worker threads. Test Points: 1) Launch a ";
+		description += "kernel with one trivial CTA per worker many times in ";
+		description += "a row.  Check that every CTA ran, and report the ";
+		description += "average time per launch and the average time from ";
+		description += "publishing a launch until a worker starts its first ";
+		description += "CTA. 2) Launch the same kernel many more times once ";
+		description += "it has been translated and specialized. Check that ";
+		description += "no worker grew its arena and that no thread ";
+		description += "allocated through operator new.";
+	}
+}
+
+int main( int argc, char** argv )
+{
+	hydrazine::ArgumentParser parser( argc, argv );
+	test::TestLLVMLaunchLatency test;
+
+	parser.description( test.testDescription() );
+
+	parser.parse( "-t", test.threads, 4, "The number of worker threads." );
+	parser.parse( "-l", test.launches, 10000,
+		"The number of back to back launches." );
+	parser.parse( "-s", test.seed, 0,
+		"Set the random seed, 0 implies seed with time." );
+	parser.parse( "-v", test.verbose, false, "Print out info after the test." );
+	parser.parse();
+
+	test.test();
+
+	return test.passed();
+}
+
+#endif
+
@@ -0,0 +1,49 @@
+/*!
+	\file TestLLVMLaunchLatency.h
+	\date October 18, 2026
+	\author agent <agent@local>
+	\brief The header file for the TestLLVMLaunchLatency benchmark.
+*/
+
+#ifndef TEST_LLVM_LAUNCH_LATENCY_H_INCLUDED
+#define TEST_LLVM_LAUNCH_LATENCY_H_INCLUDED
+
+#include <hydrazine/interface/Test.h>
+
+namespace test
+{
+	/*!
+		\brief A benchmark for the cost of handing tiny kernels to the LLVM
+			worker threads.
+		
+		Test Points:
+			1) Launch a kernel with one trivial CTA per worker many times
+				in a row.  Check that every CTA ran, and report the average
+				time per launch and the average time from publishing a 
+				launch until a worker starts its first CTA.
+			2) Launch the same kernel many more times once it has been
+				translated and specialized.  Check that no worker grew its
+				arena and that no thread allocated through operator new.
+	*/
+	class TestLLVMLaunchLatency : public Test
+	{
+		private:
+			bool testLatency();
+			
+			bool doTest();
+		
+		public:
+			TestLLVMLaunchLatency();
+			
+		public:
+			/*! \brief The number of worker threads */
+			unsigned int threads;
+			/*! \brief The number of back to back launches */
+			unsigned int launches;
+	};
+}
+
+int main( int argc, char** argv );
+
+#endif
+
@@ -0,0 +1,269 @@
+/*!
+	\file TestNativeKernel.cpp
+	\date October 18, 2026
+	\author agent <agent@local>
+	\brief The source file for the TestNativeKernel unit test.
+*/
+
+#ifndef TEST_NATIVE_KERNEL_CPP_INCLUDED
+#define TEST_NATIVE_KERNEL_CPP_INCLUDED
+
+// Ocelot Includes
+#include <ocelot/executive/test/TestNativeKernel.h>
+#include <ocelot/trace/interface/TraceGenerator.h>
+#include <ocelot/api/interface/OcelotConfiguration.h>
+#include <ocelot/ir/interface/Module.h>
+
+// Hydrazine Includes
+#include <hydrazine/implementation/ArgumentParser.h>
+
+// Standard Library Includes
+#include <sstream>
+#include <vector>
+
+// Threads in every CTA
+#define THREADS 32
+
+namespace test
+{
+	/*! \brief Counts the calls made to a trace generator */
+	class CallCounter : public trace::TraceGenerator
+	{
+		public:
+			unsigned int calls;
+
+		public:
+			CallCounter() : calls( 0 ) {}
+
+			void initialize( const executive::ExecutableKernel& kernel )
+			{
+				++calls;
+			}
+
+			void event( const trace::TraceEvent& event )
+			{
+				++calls;
+			}
+	};
+
+	/*! \brief The parameters of the test kernels as packed by Ocelot */
+	class ScaleParameters
+	{
+		public:
+			long long unsigned int data;
+			unsigned int factor;
+	};
+
+	static std::string kernelSource()
+	{
+		std::string ptx = ".version 1.4\n";
+		ptx += ".target sm_13, sm_10\n\n";
+		ptx += ".entry scale( .param .u64 data, .param .u32 factor )\n";
+		ptx += "{\n";
+		ptx += "	Exit:\n";
+		ptx += "		exit;\n";
+		ptx += "}\n\n";
+		ptx += ".entry missing( .param .u64 data, .param .u32 factor )\n";
+		ptx += "{\n";
+		ptx += "	Exit:\n";
+		ptx += "		exit;\n";
+		ptx += "}\n";
+
+		return ptx;
+	}
+
+	bool TestNativeKernel::_launch( executive::Device& device,
+		const std::string& kernel, bool traced, bool native )
+	{
+		const unsigned int factor = 3;
+		const unsigned int elements = ctas * THREADS;
+
+		std::vector< unsigned int > values( elements );
+		for( unsigned int i = 0; i < elements; ++i ) values[ i ] = i;
+
+		CallCounter generator;
+		trace::TraceGeneratorVector generators;
+		if( traced ) generators.push_back( &generator );
+
+		device.select();
+
+		executive::Device::MemoryAllocation* data =
+			device.allocate( elements * sizeof( unsigned int ) );
+		data->copy( 0, &values[ 0 ], elements * sizeof( unsigned int ) );
+
+		ScaleParameters parameters;
+		parameters.data = ( long long unsigned int ) data->pointer();
+		parameters.factor = factor;
+
+		device.launch( "nativeKernels", kernel, ir::Dim3( ctas, 1, 1 ),
+			ir::Dim3( THREADS, 1, 1 ), 0, &parameters,
+			sizeof( ScaleParameters ), generators );
+
+		data->copy( &values[ 0 ], 0, elements * sizeof( unsigned int ) );
+
+		device.free( data->pointer() );
+		device.unselect();
+
+		for( unsigned int i = 0; i < elements; ++i )
+		{
+			unsigned int expected = native ? i * factor : i;
+
+			if( values[ i ] != expected )
+			{
+				status << " " << kernel << " on " << device.properties().name
+					<< ": expected " << expected << " at element " << i
+					<< ", encountered " << values[ i ] << ".\n";
+				return false;
+			}
+		}
+
+		if( generator.calls != 0 )
+		{
+			status << " " << kernel << " on " << device.properties().name
+				<< ": the trace generator was called " << generator.calls
+				<< " times.\n";
+			return false;
+		}
+
+		return true;
+	}
+
+	bool TestNativeKernel::testNative()
+	{
+		for( executive::DeviceVector::iterator device = _devices.begin();
+			device != _devices.end(); ++device )
+		{
+			if( !_launch( **device, "scale", false, true ) )
+			{
+				status << "Test Point 1 FAILED.\n";
+				return false;
+			}
+		}
+
+		status << "Test Point 1 Passed\n";
+		return true;
+	}
+
+	bool TestNativeKernel::testTraced()
+	{
+		for( executive::DeviceVector::iterator device = _devices.begin();
+			device != _devices.end(); ++device )
+		{
+			if( !_launch( **device, "scale", true, true ) )
+			{
+				status << "Test Point 2 FAILED.\n";
+				return false;
+			}
+		}
+
+		status << "Test Point 2 Passed\n";
+		return true;
+	}
+
+	bool TestNativeKernel::testMissing()
+	{
+		for( executive::DeviceVector::iterator device = _devices.begin();
+			device != _devices.end(); ++device )
+		{
+			if( !_launch( **device, "missing", false, false ) )
+			{
+				status << "Test Point 3 FAILED.\n";
+				return false;
+			}
+		}
+
+		status << "Test Point 3 Passed\n";
+		return true;
+	}
+
+	bool TestNativeKernel::doTest()
+	{
+		std::stringstream configuration;
+		configuration << "{ executive: { nativeKernels: { scale: \""
+			<< library << ":nativeScale\", missing: \"" << library
+			<< ":doesNotExist\" } } }";
+
+		api::OcelotConfiguration::set(
+			new api::OcelotConfiguration( configuration ) );
+
+		std::stringstream stream( kernelSource() );
+		ir::Module module( stream, "nativeKernels" );
+
+		const ir::Instruction::Architecture isas[] = {
+			ir::Instruction::Emulated, ir::Instruction::LLVM };
+
+		for( unsigned int i = 0; i < 2; ++i )
+		{
+			if( executive::Device::deviceCount( isas[ i ] ) == 0 ) continue;
+
+			executive::DeviceVector devices =
+				executive::Device::createDevices( isas[ i ], 0 );
+
+			for( executive::DeviceVector::iterator device = devices.begin();
+				device != devices.end(); ++device )
+			{
+				( *device )->select();
+				( *device )->load( &module );
+				( *device )->limitWorkerThreads( threads );
+				( *device )->unselect();
+
+				_devices.push_back( *device );
+			}
+		}
+
+		bool result = testNative() && testTraced() && testMissing();
+
+		for( executive::DeviceVector::iterator device = _devices.begin();
+			device != _devices.end(); ++device )
+		{
+			delete *device;
+		}
+
+		_devices.clear();
+
+		api::OcelotConfiguration::destroy();
+
+		return result;
+	}
+
+	TestNativeKernel::TestNativeKernel()
+	{
+		name = "TestNativeKernel";
+
+		description = "A unit test for kernels replaced by native code from ";
+		description += "a shared library. The PTX of every kernel in the ";
+		description += "test only exits, so a launch that changes memory ran ";
+		description += "the native code. Test Points: 1) Map a kernel to a ";
+		description += "function of the example library and launch it on ";
+		description += "every CPU device, check that every element was ";
+		description += "scaled by the native code. 2) Launch the same kernel ";
+		description += "with a trace generator, check that the generator is ";
+		description += "not attached and the native code still runs. 3) Map ";
+		description += "a kernel to a symbol that the library does not ";
+		description += "export, check that its PTX runs instead.";
+	}
+}
+
+int main( int argc, char** argv )
+{
+	hydrazine::ArgumentParser parser( argc, argv );
+	test::TestNativeKernel test;
+
+	parser.description( test.testDescription() );
+
+	parser.parse( "-l", test.library, ".libs/TestNativeKernelLibrary.so",
+		"The path of the example native kernel library." );
+	parser.parse( "-t", test.threads, 4, "The number of worker threads." );
+	parser.parse( "-c", test.ctas, 8, "The number of CTAs in every launch." );
+	parser.parse( "-s", test.seed, 0,
+		"Set the random seed, 0 implies seed with time." );
+	parser.parse( "-v", test.verbose, false, "Print out info after the test." );
+	parser.parse();
+
+	test.test();
+
+	return test.passed();
+}
+
+#endif
+
@@ -0,0 +1,64 @@
+/*!
+	\file TestNativeKernel.h
+	\date October 18, 2026
+	\author agent <agent@local>
+	\brief The header file for the TestNativeKernel unit test.
+*/
+
+#ifndef TEST_NATIVE_KERNEL_H_INCLUDED
+#define TEST_NATIVE_KERNEL_H_INCLUDED
+
+#include <hydrazine/interface/Test.h>
+#include <ocelot/executive/interface/Device.h>
+
+namespace test
+{
+	/*!
+		\brief A unit test for kernels replaced by native code from a
+			shared library.
+
+		The PTX of every kernel in the test only exits, so a launch that
+		changes memory ran the native code.
+
+		Test Points:
+			1) Map a kernel to a function of the example library and launch
+				it on every CPU device, check that every element was scaled
+				by the native code.
+			2) Launch the same kernel with a trace generator, check that the
+				generator is not attached and the native code still runs.
+			3) Map a kernel to a symbol that the library does not export,
+				check that its PTX runs instead.
+	*/
+	class TestNativeKernel : public Test
+	{
+		private:
+			/*! \brief The CPU devices with the test module loaded */
+			executive::DeviceVector _devices;
+
+		private:
+			bool _launch( executive::Device& device, const std::string& kernel,
+				bool traced, bool native );
+
+			bool testNative();
+			bool testTraced();
+			bool testMissing();
+
+			bool doTest();
+
+		public:
+			TestNativeKernel();
+
+		public:
+			/*! \brief The path of the example native kernel library */
+			std::string library;
+			/*! \brief The number of worker threads */
+			unsigned int threads;
+			/*! \brief The number of CTAs in every launch */
+			unsigned int ctas;
+	};
+}
+
+int main( int argc, char** argv );
+
+#endif
+
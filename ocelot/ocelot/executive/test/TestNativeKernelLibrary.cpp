@@ -0,0 +1,46 @@
+/*!
+	\file TestNativeKernelLibrary.cpp
+	\date October 18, 2026
+	\author agent <agent@local>
+	\brief An example library of native kernels, loaded by the
+		TestNativeKernel unit test.
+
+	It only includes NativeKernelContext.h, a native library does not
+	need the rest of Ocelot.
+*/
+
+#ifndef TEST_NATIVE_KERNEL_LIBRARY_CPP_INCLUDED
+#define TEST_NATIVE_KERNEL_LIBRARY_CPP_INCLUDED
+
+// Ocelot Includes
+#include <ocelot/executive/interface/NativeKernelContext.h>
+
+// Standard Library Includes
+#include <cstring>
+
+/*! \brief Multiplies one element per thread by a factor, the native version
+	of the scale kernel in TestNativeKernel.  The parameters are a .u64
+	pointer at offset 0 and a .u32 factor at offset 8.
+*/
+OCELOT_NATIVE_KERNEL( nativeScale )
+{
+	unsigned int* data = 0;
+	unsigned int factor = 0;
+
+	std::memcpy( &data, context->parameters, sizeof( data ) );
+	std::memcpy( &factor, context->parameters + 8, sizeof( factor ) );
+
+	unsigned int threads = context->ntid[ 0 ] * context->ntid[ 1 ]
+		* context->ntid[ 2 ];
+
+	for( unsigned int cta = context->begin; cta != context->end; ++cta )
+	{
+		for( unsigned int thread = 0; thread < threads; ++thread )
+		{
+			data[ cta * threads + thread ] *= factor;
+		}
+	}
+}
+
+#endif
+
@@ -0,0 +1,275 @@
+/*!
+	\file TestTraceWindow.cpp
+	\date October 18, 2026
+	\author agent <agent@local>
+	\brief The source file for the TestTraceWindow unit test.
+*/
+
+#ifndef TEST_TRACE_WINDOW_CPP_INCLUDED
+#define TEST_TRACE_WINDOW_CPP_INCLUDED
+
+// Ocelot Includes
+#include <ocelot/executive/test/TestTraceWindow.h>
+#include <ocelot/executive/test/CounterKernel.h>
+#include <ocelot/executive/interface/EmulatorDevice.h>
+#include <ocelot/trace/interface/TraceGenerator.h>
+#include <ocelot/trace/interface/TraceEvent.h>
+#include <ocelot/api/interface/OcelotConfiguration.h>
+
+// Hydrazine Includes
+#include <hydrazine/implementation/ArgumentParser.h>
+
+// Standard Library Includes
+#include <sstream>
+#include <vector>
+#include <set>
+
+namespace test
+{
+	/*! \brief Remembers the launches and CTAs that it was attached to */
+	class WindowRecorder : public trace::TraceGenerator
+	{
+		public:
+			/*! \brief The launch that runs next, set by the test */
+			unsigned int launch;
+			/*! \brief The launches that were initialized */
+			std::vector< unsigned int > launches;
+			/*! \brief The CTAs that produced events */
+			std::set< unsigned int > ctas;
+
+		public:
+			WindowRecorder() : launch( 0 ) {}
+
+			void initialize( const executive::ExecutableKernel& kernel )
+			{
+				launches.push_back( launch );
+			}
+
+			void event( const trace::TraceEvent& event )
+			{
+				ctas.insert( event.blockId.x );
+			}
+	};
+
+	bool TestTraceWindow::_launch( const std::string& window,
+		unsigned int launches, std::vector< unsigned int >& tracedLaunches,
+		std::vector< unsigned int >& tracedCtas )
+	{
+		std::stringstream configuration;
+		configuration << "{ trace: { windows: { " << window << " } } }";
+
+		api::OcelotConfiguration::set(
+			new api::OcelotConfiguration( configuration ) );
+
+		// launches are counted per device, so each window starts afresh
+		executive::Device* device = new executive::EmulatorDevice;
+
+		device->select();
+		device->load( &_module );
+
+		CounterKernel* kernel = new CounterKernel( *device );
+
+		WindowRecorder recorder;
+		trace::TraceGeneratorVector generators( 1, &recorder );
+
+		bool pass = true;
+
+		for( unsigned int i = 0; i < launches && pass; ++i )
+		{
+			recorder.launch = i;
+
+			kernel->launch( ctas, generators );
+
+			unsigned int result = kernel->count();
+
+			if( result != ( i + 1 ) * ctas )
+			{
+				status << " Launch " << i << " ran " << ( result - i * ctas )
+					<< " of " << ctas << " CTAs.\n";
+				pass = false;
+			}
+		}
+
+		delete kernel;
+		device->unselect();
+
+		delete device;
+
+		api::OcelotConfiguration::destroy();
+
+		tracedLaunches = recorder.launches;
+		tracedCtas.assign( recorder.ctas.begin(), recorder.ctas.end() );
+
+		return pass;
+	}
+
+	/*! \brief Is a vector first, first + 1, ..., first + count - 1? */
+	static bool isRange( const std::vector< unsigned int >& values,
+		unsigned int first, unsigned int count )
+	{
+		if( values.size() != count ) return false;
+
+		for( unsigned int i = 0; i < count; ++i )
+		{
+			if( values[ i ] != first + i ) return false;
+		}
+
+		return true;
+	}
+
+	/*! \brief Write the values of a vector */
+	static std::string listString( const std::vector< unsigned int >& values )
+	{
+		std::stringstream stream;
+
+		for( unsigned int i = 0; i < values.size(); ++i )
+		{
+			if( i != 0 ) stream << ", ";
+			stream << values[ i ];
+		}
+
+		return stream.str();
+	}
+
+	bool TestTraceWindow::testLaunchWindow()
+	{
+		std::vector< unsigned int > launches;
+		std::vector< unsigned int > tracedCtas;
+
+		if( !_launch( "\"" + CounterKernel::kernel
+			+ "\": { skipLaunches: 2, traceLaunches: 3 }", 7,
+			launches, tracedCtas ) )
+		{
+			status << "Test Point 1 FAILED.\n";
+			return false;
+		}
+
+		if( !isRange( launches, 2, 3 ) )
+		{
+			status << "Test Point 1 FAILED: expected launches 2, 3, 4 to be "
+				<< "traced, traced " << listString( launches ) << ".\n";
+			return false;
+		}
+
+		if( !isRange( tracedCtas, 0, ctas ) )
+		{
+			status << "Test Point 1 FAILED: expected every CTA of the traced "
+				<< "launches to be traced, traced " << listString( tracedCtas )
+				<< ".\n";
+			return false;
+		}
+
+		status << "Test Point 1 Passed\n";
+		return true;
+	}
+
+	bool TestTraceWindow::testCtaWindow()
+	{
+		std::vector< unsigned int > launches;
+		std::vector< unsigned int > tracedCtas;
+
+		if( !_launch( "\"" + CounterKernel::kernel
+			+ "\": { skipCtas: 2, traceCtas: 3 }", 1,
+			launches, tracedCtas ) )
+		{
+			status << "Test Point 2 FAILED.\n";
+			return false;
+		}
+
+		if( !isRange( launches, 0, 1 ) )
+		{
+			status << "Test Point 2 FAILED: expected the launch to be "
+				<< "traced, traced " << listString( launches ) << ".\n";
+			return false;
+		}
+
+		if( !isRange( tracedCtas, 2, 3 ) )
+		{
+			status << "Test Point 2 FAILED: expected CTAs 2, 3, 4 to be "
+				<< "traced, traced " << listString( tracedCtas ) << ".\n";
+			return false;
+		}
+
+		status << "Test Point 2 Passed\n";
+		return true;
+	}
+
+	bool TestTraceWindow::testNoWindow()
+	{
+		std::vector< unsigned int > launches;
+		std::vector< unsigned int > tracedCtas;
+
+		// a window for another kernel in the module leaves this one alone
+		if( !_launch( "_Z10k_sequencePi: { skipLaunches: 1, skipCtas: 1 }",
+			2, launches, tracedCtas ) )
+		{
+			status << "Test Point 3 FAILED.\n";
+			return false;
+		}
+
+		if( !isRange( launches, 0, 2 ) || !isRange( tracedCtas, 0, ctas ) )
+		{
+			status << "Test Point 3 FAILED: expected every launch and CTA to "
+				<< "be traced, traced launches " << listString( launches )
+				<< " and CTAs " << listString( tracedCtas ) << ".\n";
+			return false;
+		}
+
+		status << "Test Point 3 Passed\n";
+		return true;
+	}
+
+	bool TestTraceWindow::doTest()
+	{
+		if( ctas < 5 )
+		{
+			status << "The CTA window needs at least 5 CTAs.\n";
+			return false;
+		}
+
+		_module.load( CounterKernel::module );
+
+		return testLaunchWindow() && testCtaWindow() && testNoWindow();
+	}
+
+	TestTraceWindow::TestTraceWindow()
+	{
+		name = "TestTraceWindow";
+
+		description = "A unit test for the windows that limit trace ";
+		description += "generators to some launches and CTAs of a kernel on ";
+		description += "the emulator. The kernel adds one to a counter for ";
+		description += "each CTA, so launches outside of a window can be ";
+		description += "checked to still run. Test Points: 1) Skip two ";
+		description += "launches of a kernel and trace three, launch it ";
+		description += "seven times with a trace generator, check that only ";
+		description += "the third to fifth launches were traced and that ";
+		description += "every launch ran all of its CTAs. 2) Skip two CTAs of ";
+		description += "the kernel and trace three, check that the ";
+		description += "generator only saw events of the third to fifth ";
+		description += "CTAs. 3) Launch the kernel twice with a window set ";
+		description += "only for another kernel, check that both launches ";
+		description += "and all of their CTAs were traced.";
+	}
+}
+
+int main( int argc, char** argv )
+{
+	hydrazine::ArgumentParser parser( argc, argv );
+	test::TestTraceWindow test;
+
+	parser.description( test.testDescription() );
+
+	parser.parse( "-c", test.ctas, 8, "The number of CTAs in every launch." );
+	parser.parse( "-s", test.seed, 0,
+		"Set the random seed, 0 implies seed with time." );
+	parser.parse( "-v", test.verbose, false, "Print out info after the test." );
+	parser.parse();
+
+	test.test();
+
+	return test.passed();
+}
+
+#endif
+
@@ -0,0 +1,67 @@
+/*!
+	\file TestTraceWindow.h
+	\date October 18, 2026
+	\author agent <agent@local>
+	\brief The header file for the TestTraceWindow unit test.
+*/
+
+#ifndef TEST_TRACE_WINDOW_H_INCLUDED
+#define TEST_TRACE_WINDOW_H_INCLUDED
+
+#include <hydrazine/interface/Test.h>
+#include <ocelot/ir/interface/Module.h>
+
+#include <vector>
+
+namespace test
+{
+	/*!
+		\brief A unit test for the windows that limit trace generators to
+			some launches and CTAs of a kernel on the emulator.
+
+		The kernel adds one to a counter for each CTA, so launches
+		outside of a window can be checked to still run.
+
+		Test Points:
+			1) Skip two launches of a kernel and trace three, launch it
+				seven times with a trace generator, check that only the
+				third to fifth launches were traced and that every launch
+				ran all of its CTAs.
+			2) Skip two CTAs of the kernel and trace three, check that the
+				generator only saw events of the third to fifth CTAs.
+			3) Launch the kernel twice with a window set only for another
+				kernel, check that both launches and all of their CTAs
+				were traced.
+	*/
+	class TestTraceWindow : public Test
+	{
+		private:
+			/*! \brief The module holding the kernel */
+			ir::Module _module;
+
+		private:
+			/*! \brief Set a window, then launch the kernel on a new
+				emulator */
+			bool _launch( const std::string& window, unsigned int launches,
+				std::vector< unsigned int >& tracedLaunches,
+				std::vector< unsigned int >& tracedCtas );
+
+			bool testLaunchWindow();
+			bool testCtaWindow();
+			bool testNoWindow();
+
+			bool doTest();
+
+		public:
+			TestTraceWindow();
+
+		public:
+			/*! \brief The number of CTAs in every launch */
+			unsigned int ctas;
+	};
+}
+
+int main( int argc, char** argv );
+
+#endif
+
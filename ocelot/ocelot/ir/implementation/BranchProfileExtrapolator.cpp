@@ -0,0 +1,74 @@
+#include <ocelot/ir/interface/BranchProfileExtrapolator.h>
+#include <ocelot/ir/interface/Module.h>
+#include <ocelot/executive/interface/ExecutableKernel.h>
+#include <ocelot/executive/interface/CtaSampler.h>
+
+// Scales the part of a counter that was added by the launch.
+static ir::PTXU64 extrapolate(ir::PTXU64 before, ir::PTXU64 after,
+	double scale) {
+	if (after < before) return after;
+	return before + (ir::PTXU64)((after - before) * scale + 0.5);
+}
+
+void ir::BranchProfileExtrapolator::initialize(
+	const executive::ExecutableKernel& kernel) {
+	finish();
+
+	if (kernel.device == NULL || kernel.module == NULL) return;
+
+	// kernels that were not instrumented do not have the pointer
+	executive::Device::MemoryAllocation* global =
+		kernel.device->getGlobalAllocation(kernel.module->path(),
+		"prof_data_pt");
+	if (global == NULL) return;
+
+	PTXU64 pointer = 0;
+	global->copy(&pointer, 0, sizeof(PTXU64));
+
+	executive::Device::MemoryAllocation* allocation =
+		kernel.device->getMemoryAllocation((const void*)pointer,
+		executive::Device::AnyAllocation);
+	if (allocation == NULL) return;
+
+	size_t offset = (char*)pointer - (char*)allocation->pointer();
+	if ((char*)pointer < (char*)allocation->pointer()
+		|| offset >= allocation->size()) return;
+
+	// the array is assumed to run until the end of the allocation
+	initialCounters.resize((allocation->size() - offset) / sizeof(PTXU64));
+	if (initialCounters.empty()) return;
+
+	allocation->copy(&initialCounters[0], offset,
+		initialCounters.size() * sizeof(PTXU64));
+
+	results = allocation;
+	resultsOffset = offset;
+}
+
+void ir::BranchProfileExtrapolator::sampled(
+	const executive::CtaSampler& sampler) {
+	if (results == NULL) return;
+
+	std::vector<PTXU64> counters(initialCounters.size());
+	results->copy(&counters[0], resultsOffset,
+		counters.size() * sizeof(PTXU64));
+
+	double scale = sampler.scale();
+
+	// the block ids are left alone
+	for (unsigned int i = 0; i + 2 < counters.size(); i += 3) {
+		counters[i + 1] = extrapolate(initialCounters[i + 1],
+			counters[i + 1], scale);
+		counters[i + 2] = extrapolate(initialCounters[i + 2],
+			counters[i + 2], scale);
+	}
+
+	results->copy(resultsOffset, &counters[0],
+		counters.size() * sizeof(PTXU64));
+}
+
+void ir::BranchProfileExtrapolator::finish() {
+	results = NULL;
+	resultsOffset = 0;
+	initialCounters.clear();
+}
@@ -785,7 +785,8 @@ namespace ir
 		return new LLVMBitcast( *this );
 	}
 
-	LLVMBr::LLVMBr() : LLVMInstruction( Br )
+	LLVMBr::LLVMBr() : LLVMInstruction( Br ), iftrueWeight( 0 ), 
+		iffalseWeight( 0 )
 	{
 	
 	}
@@ -796,7 +797,17 @@ namespace ir
 		if( condition.valid() ) result += condition.type.toString() + " " 
 			+ condition.toString() + ", ";
 		result += "label " + iftrue;
-		if( condition.valid() ) result += ", label " + iffalse;
+		if( condition.valid() ) 
+		{
+			result += ", label " + iffalse;
+			if( iftrueWeight != 0 || iffalseWeight != 0 )
+			{
+				std::stringstream weights;
+				weights << ", !prof !{metadata !\"branch_weights\", i32 " 
+					<< iftrueWeight << ", i32 " << iffalseWeight << "}";
+				result += weights.str();
+			}
+		}
 		return result;		
 	}
 	
@@ -0,0 +1,51 @@
+#ifndef BRANCHPROFILEEXTRAPOLATOR_H_
+#define BRANCHPROFILEEXTRAPOLATOR_H_
+
+#include <vector>
+#include <ocelot/ir/interface/PTXOperand.h>
+#include <ocelot/trace/interface/TraceGenerator.h>
+#include <ocelot/executive/interface/Device.h>
+
+namespace ir {
+
+	// The branch profilers count visits and divergences in the array that
+	// prof_data_pt points to, as one (block id, visits, divergences) triple
+	// of 64 bit values per branch. A sampled launch only runs some of the
+	// CTAs, so attaching a profiler to the launch of a kernel it instrumented
+	// scales what the launch added to the counters up to the whole grid.
+	class BranchProfileExtrapolator : public trace::TraceGenerator {
+	private:
+		// The allocation holding the counters of the kernel being launched,
+		// or NULL if the kernel was not instrumented.
+		executive::Device::MemoryAllocation* results;
+
+		// The offset of the counters in that allocation.
+		size_t resultsOffset;
+
+		// The counters before the launch, so that only the visits and
+		// divergences of this launch are scaled.
+		std::vector<PTXU64> initialCounters;
+
+	public:
+		BranchProfileExtrapolator()
+			: results(NULL)
+			, resultsOffset(0)
+		{}
+
+		virtual ~BranchProfileExtrapolator() {
+		}
+
+		/// Finds the counters of an instrumented kernel before it is
+		/// launched and saves them.
+		virtual void initialize(const executive::ExecutableKernel& kernel);
+
+		/// Scales the counts that a sampled launch added by the number of
+		/// CTAs that each CTA that ran stands for.
+		virtual void sampled(const executive::CtaSampler& sampler);
+
+		virtual void finish();
+	};
+
+}
+
+#endif /*BRANCHPROFILEEXTRAPOLATOR_H_*/
@@ -565,6 +565,13 @@ namespace ir
 			
 			/*! \brief The iffalse label */
 			std::string iffalse;
+			
+			/*! \brief The profiled weight of the iftrue label, the branch
+				is not weighted if both weights are zero */
+			LLVMI32 iftrueWeight;
+			
+			/*! \brief The profiled weight of the iffalse label */
+			LLVMI32 iffalseWeight;
 	
 		public:
 			/*! \brief The default constructor sets the opcode */
@@ -5,6 +5,7 @@
 #include <vector>
 #include <ocelot/ir/interface/PTXOperand.h>
 #include "ocelot/ir/interface/Worker.h"
+#include "ocelot/ir/interface/BranchProfileExtrapolator.h"
 
 namespace ir {
 	
@@ -13,8 +14,10 @@ namespace ir {
 		ir::ControlFlowGraph::iterator bb;
 	} BasicBlockInfo;
 	
-	// This class instruments the kernel, to build the thread map.
-	class PrecBranchProfiler : public Worker {
+	// This class instruments the kernel, to build the thread map. Attached
+	// as a trace generator to the launch of an instrumented kernel, it
+	// extrapolates the counters of a sampled launch to the whole grid.
+	class PrecBranchProfiler : public Worker, public BranchProfileExtrapolator {
 	private:
 		// We need this to create unique labels among all kernels in this module. 
 		std::string kernelName;
@@ -7,6 +7,7 @@
 
 #include <ocelot/trace/interface/TraceGenerator.h>
 #include <ocelot/executive/interface/EmulatedKernel.h>
+#include <ocelot/executive/interface/CtaSampler.h>
 #include <hydrazine/implementation/debug.h>
 
 #ifdef REPORT_BASE
@@ -48,6 +49,12 @@ void trace::TraceGenerator::postEvent(const TraceEvent & event) {
 	report( "Default PostEvent(): " << event.toString() );
 }
 
+void trace::TraceGenerator::sampled(
+	const executive::CtaSampler& sampler) {
+	report( "Sampled " << sampler.sampled().size() << " of "
+		<< sampler.ctas() << " CTAs" );
+}
+
 void trace::TraceGenerator::finish() {
 }
 
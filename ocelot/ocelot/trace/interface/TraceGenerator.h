@@ -21,6 +21,7 @@ namespace trace {
 // forward declare EmulatedKernel
 namespace executive {
 	class ExecutableKernel;
+	class CtaSampler;
 }
 
 namespace trace {
@@ -74,6 +75,12 @@ namespace trace {
 		*/
 		virtual void postEvent(const TraceEvent & event);
 		
+		/*! \brief Called before finish() when the launch only ran a sample
+				of the CTAs, the sampler knows how many CTAs each traced
+				CTA stands for.
+		*/
+		virtual void sampled(const executive::CtaSampler& sampler);
+		
 		/*! \brief Called when a kernel is finished. There will be no more 
 				events for this kernel.
 		*/
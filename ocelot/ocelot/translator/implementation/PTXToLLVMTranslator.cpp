@@ -14,8 +14,10 @@
 #include <ocelot/ir/interface/PTXKernel.h>
 #include <ocelot/ir/interface/PTXInstruction.h>
 #include <ocelot/ir/interface/Module.h>
+#include <ocelot/analysis/interface/RemoveBarrierPass.h>
 
 #include <climits>
+#include <algorithm>
 
 #include <hydrazine/implementation/debug.h>
 
@@ -765,6 +767,210 @@ namespace translator
 		_llvmKernel->_statements.push_front( instruction );
 	}
 			
+	bool PTXToLLVMTranslator::_computeVaryingRegisters()
+	{
+		_varying.clear();
+		
+		if( optimizationLevel == DebugOptimization 
+			|| optimizationLevel == ReportOptimization
+			|| optimizationLevel == InstrumentOptimization
+			|| optimizationLevel == MemoryCheckOptimization )
+		{
+			report( " Bundles are not supported with instrumentation." );
+			return false;
+		}
+		
+		bool changed = true;
+		
+		while( changed )
+		{
+			changed = false;
+			
+			for( analysis::DataflowGraph::const_iterator 
+				block = _ptx->dfg()->begin(); 
+				block != _ptx->dfg()->end(); ++block )
+			{
+				for( analysis::DataflowGraph::PhiInstructionVector::
+					const_iterator phi = block->phis().begin(); 
+					phi != block->phis().end(); ++phi )
+				{
+					if( _varying.count( phi->d.id ) ) continue;
+					
+					for( analysis::DataflowGraph::RegisterVector::
+						const_iterator s = phi->s.begin(); 
+						s != phi->s.end(); ++s )
+					{
+						if( _varying.count( s->id ) )
+						{
+							_varying.insert( phi->d.id );
+							changed = true;
+							break;
+						}
+					}
+				}
+				
+				for( analysis::DataflowGraph::InstructionVector::
+					const_iterator instruction = block->instructions().begin();
+					instruction != block->instructions().end(); 
+					++instruction )
+				{
+					if( !_isVarying( *instruction ) ) continue;
+					
+					for( analysis::DataflowGraph::RegisterPointerVector::
+						const_iterator d = instruction->d.begin(); 
+						d != instruction->d.end(); ++d )
+					{
+						changed |= _varying.insert( *d->pointer ).second;
+					}
+				}
+			}
+		}
+		
+		for( analysis::DataflowGraph::const_iterator 
+			block = _ptx->dfg()->begin(); 
+			block != _ptx->dfg()->end(); ++block )
+		{
+			for( analysis::DataflowGraph::InstructionVector::const_iterator 
+				instruction = block->instructions().begin();
+				instruction != block->instructions().end(); ++instruction )
+			{
+				const ir::PTXInstruction& ptx = 
+					static_cast< const ir::PTXInstruction& >( 
+					*instruction->i );
+				
+				switch( ptx.opcode )
+				{
+					case ir::PTXInstruction::Bar:     /* fall through */
+					case ir::PTXInstruction::Call:    /* fall through */
+					case ir::PTXInstruction::Vote:    /* fall through */
+					case ir::PTXInstruction::Trap:    /* fall through */
+					case ir::PTXInstruction::Brkpt:   /* fall through */
+					case ir::PTXInstruction::Pmevent:
+					{
+						report( " Can not bundle kernel with " 
+							<< ptx.toString() );
+						return false;
+					}
+					case ir::PTXInstruction::Bra:  /* fall through */
+					case ir::PTXInstruction::Exit: /* fall through */
+					case ir::PTXInstruction::Ret:
+					{
+						if( ptx.pg.addressMode == ir::PTXOperand::Register
+							&& ptx.pg.condition != ir::PTXOperand::PT
+							&& _varying.count( ptx.pg.reg ) )
+						{
+							report( " Can not bundle kernel with divergent "
+								<< ptx.toString() );
+							return false;
+						}
+						break;
+					}
+					default: break;
+				}
+			}
+		}
+		
+		report( " " << _varying.size() << " registers vary across lanes." );
+		
+		return true;
+	}
+	
+	bool PTXToLLVMTranslator::_isVarying( 
+		const analysis::DataflowGraph::Instruction& i ) const
+	{
+		if( _bundleWidth < 2 ) return false;
+		
+		const ir::PTXInstruction& ptx = 
+			static_cast< const ir::PTXInstruction& >( *i.i );
+		
+		switch( ptx.opcode )
+		{
+			case ir::PTXInstruction::Ld:
+			{
+				if( ptx.addressSpace != ir::PTXInstruction::Param 
+					&& ptx.addressSpace != ir::PTXInstruction::Const )
+				{
+					return true;
+				}
+				break;
+			}
+			case ir::PTXInstruction::St:   /* fall through */
+			case ir::PTXInstruction::Atom: /* fall through */
+			case ir::PTXInstruction::Red:  /* fall through */
+			case ir::PTXInstruction::Tex:
+			{
+				return true;
+			}
+			default:
+			{
+				// addresses of local variables differ for each lane
+				if( ptx.a.addressMode == ir::PTXOperand::Address 
+					|| ptx.b.addressMode == ir::PTXOperand::Address
+					|| ptx.c.addressMode == ir::PTXOperand::Address )
+				{
+					return true;
+				}
+				break;
+			}
+		}
+		
+		const ir::PTXOperand* operands[] = { &ptx.a, &ptx.b, &ptx.c };
+		
+		// tid.x is the only special register that _loadSpecialRegister
+		//  offsets by the lane
+		for( unsigned int o = 0; o < 3; ++o )
+		{
+			if( operands[ o ]->addressMode == ir::PTXOperand::Special
+				&& operands[ o ]->special == ir::PTXOperand::tidX )
+			{
+				return true;
+			}
+		}
+		
+		for( analysis::DataflowGraph::RegisterPointerVector::const_iterator 
+			s = i.s.begin(); s != i.s.end(); ++s )
+		{
+			if( _varying.count( *s->pointer ) ) return true;
+		}
+		
+		return false;
+	}
+	
+	std::string PTXToLLVMTranslator::_registerName( 
+		analysis::DataflowGraph::RegisterId r ) const
+	{
+		std::stringstream stream;
+		stream << "%r" << r;
+		
+		if( _varying.count( r ) ) stream << "." << _lane;
+		
+		return stream.str();
+	}
+
+	bool PTXToLLVMTranslator::_approximate( 
+		const ir::PTXInstruction& i ) const
+	{
+		if( !_fastMath || i.type != ir::PTXOperand::f32 ) return false;
+		
+		// .ftz only flushes denormals, .rn results must stay exact
+		if( i.modifier & ir::PTXInstruction::approx ) return true;
+		
+		return i.opcode == ir::PTXInstruction::Div && i.divideFull;
+	}
+	
+	void PTXToLLVMTranslator::_translateApproximate( 
+		const ir::PTXInstruction& i, const std::string& intrinsic )
+	{
+		ir::LLVMCall call;
+		
+		call.name = intrinsic;
+		call.d = _destination( i );
+		call.parameters.resize( 1 );
+		call.parameters[0] = _translate( i.a );
+		
+		_add( call );
+	}
+
 	void PTXToLLVMTranslator::_yield( unsigned int continuation )
 	{
 		ir::LLVMRet ret;
@@ -775,6 +981,8 @@ namespace translator
 		ret.d.i32 = continuation;
 		
 		_add( ret );
+		
+		_resumePoints = std::max( _resumePoints, continuation );
 	}
 
 	ir::LLVMInstruction::Operand PTXToLLVMTranslator::_translate( 
@@ -799,9 +1007,7 @@ namespace translator
 			case ir::PTXOperand::Register: /* fall through */
 			case ir::PTXOperand::Indirect:
 			{
-				std::stringstream stream;
-				stream << "%r" << o.reg;
-				op.name = stream.str();
+				op.name = _registerName( o.reg );
 				break;
 			}
 			case ir::PTXOperand::Immediate:
@@ -866,6 +1072,7 @@ namespace translator
 			{
 				std::stringstream stream;
 				stream << "%r_" << o.reg;
+				if( _bundleWidth > 1 ) stream << "." << _lane;
 				op.name = stream.str();
 				break;
 			}
@@ -900,58 +1107,59 @@ namespace translator
 				phi = block->phis().begin(); 
 				phi != block->phis().end(); ++phi )
 			{
-				ir::LLVMPhi p;
-				analysis::DataflowGraph::RegisterVector::const_iterator 
-					s = phi->s.begin();
-				for( ; s != phi->s.end(); ++s )
-				{			
-					ir::LLVMPhi::Node node;
+				unsigned int lanes = _varying.count( phi->d.id ) 
+					? _bundleWidth : 1;
+				for( _lane = 0; _lane < lanes; ++_lane )
+				{
+					ir::LLVMPhi p;
+					analysis::DataflowGraph::RegisterVector::const_iterator 
+						s = phi->s.begin();
+					for( ; s != phi->s.end(); ++s )
+					{			
+						ir::LLVMPhi::Node node;
+					
+						try
+						{
+							node.label = "%" + block->producer( *s );
+						}
+						catch( analysis::DataflowGraph::NoProducerException& )
+						{
+							node.label = "%$OcelotRegisterInitializerBlock";
+							if( _lane == 0 ) _uninitialized.push_back( *s );
+							node.reg = s->id;
+
+							std::stringstream stream;
+							stream << "%ri" << s->id;
+					
+							node.operand.name = stream.str();
+							node.operand.type.category 
+								= ir::LLVMInstruction::Type::Element;
+							node.operand.type.type = _translate( s->type );
+					
+							p.nodes.push_back( node );
+							continue;
+						}
 					
-					try
-					{
-						node.label = "%" + block->producer( *s );
-					}
-					catch( analysis::DataflowGraph::NoProducerException& )
-					{
-						node.label = "%$OcelotRegisterInitializerBlock";
-						_uninitialized.push_back( *s );
 						node.reg = s->id;
-
-						std::stringstream stream;
-						stream << "%ri" << s->id;
 					
-						node.operand.name = stream.str();
+						node.operand.name = _registerName( s->id );
 						node.operand.type.category 
 							= ir::LLVMInstruction::Type::Element;
 						node.operand.type.type = _translate( s->type );
 					
 						p.nodes.push_back( node );
-						continue;
 					}
-					
-					node.reg = s->id;
-
-					std::stringstream stream;
-					stream << "%r" << s->id;
-					
-					node.operand.name = stream.str();
-					node.operand.type.category 
-						= ir::LLVMInstruction::Type::Element;
-					node.operand.type.type = _translate( s->type );
-					
-					p.nodes.push_back( node );
-				}
 
-				assert( !p.nodes.empty() );
+					assert( !p.nodes.empty() );
 				
-				std::stringstream stream;
-				stream << "%r" << phi->d.id;
-				p.d.name = stream.str();
-				p.d.type.category = ir::LLVMInstruction::Type::Element;
-				p.d.type.type = _translate( phi->d.type );
+					p.d.name = _registerName( phi->d.id );
+					p.d.type.category = ir::LLVMInstruction::Type::Element;
+					p.d.type.type = _translate( phi->d.type );
 				
-				_add( p );
+					_add( p );
+				}
 			}
+			_lane = 0;
 
 			_debug( *block );
 
@@ -960,7 +1168,17 @@ namespace translator
 				instruction = block->instructions().begin();
 				instruction != block->instructions().end(); ++instruction )
 			{
-				_translate( *instruction, *block );
+				if( !_isVarying( *instruction ) )
+				{
+					_translate( *instruction, *block );
+					continue;
+				}
+				
+				for( _lane = 0; _lane < _bundleWidth; ++_lane )
+				{
+					_translate( *instruction, *block );
+				}
+				_lane = 0;
 			}
 			
 			if( block->targets().empty() )
@@ -1677,10 +1895,19 @@ namespace translator
 						}
 					}
 					branch.iffalse = "%" + block.fallthrough()->label();
+					
+					ProfilingData::BranchMap::const_iterator weights 
+						= _profile.branches.find( block.label() );
+					if( weights != _profile.branches.end() )
+					{
+						branch.iftrueWeight = weights->second.taken;
+						branch.iffalseWeight = weights->second.fallthrough;
+					}
 				}
 				if( i.pg.condition == ir::PTXOperand::InvPred )
 				{
 					std::swap( branch.iftrue, branch.iffalse );
+					std::swap( branch.iftrueWeight, branch.iffalseWeight );
 				}
 			}
 			
@@ -1720,6 +1947,12 @@ namespace translator
 
 	void PTXToLLVMTranslator::_translateCos( const ir::PTXInstruction& i )
 	{
+		if( _approximate( i ) )
+		{
+			_translateApproximate( i, "@llvm.cos.f32" );
+			return;
+		}
+	
 		ir::LLVMCall call;
 		
 		if( i.modifier & ir::PTXInstruction::ftz )
@@ -1765,7 +1998,29 @@ namespace translator
 
 	void PTXToLLVMTranslator::_translateDiv( const ir::PTXInstruction& i )
 	{
-		if( ir::PTXOperand::isFloat( i.type ) )
+		if( _approximate( i ) )
+		{
+			// multiply by the reciprocal, which may be hoisted out of loops
+			ir::LLVMFdiv reciprocal;
+			
+			reciprocal.d = _destination( i );
+			reciprocal.d.name = _tempRegister();
+			reciprocal.b = _translate( i.b );
+			reciprocal.a = reciprocal.b;
+			reciprocal.a.constant = true;
+			reciprocal.a.f32 = 1.0;
+			
+			_add( reciprocal );
+			
+			ir::LLVMFmul multiply;
+			
+			multiply.d = _destination( i );
+			multiply.a = _translate( i.a );
+			multiply.b = reciprocal.d;
+			
+			_add( multiply );
+		}
+		else if( ir::PTXOperand::isFloat( i.type ) )
 		{
 			ir::LLVMFdiv div;
 			
@@ -1799,6 +2054,12 @@ namespace translator
 
 	void PTXToLLVMTranslator::_translateEx2( const ir::PTXInstruction& i )
 	{
+		if( _approximate( i ) )
+		{
+			_translateApproximate( i, "@llvm.exp2.f32" );
+			return;
+		}
+	
 		ir::LLVMCall call;
 		
 		if( i.modifier & ir::PTXInstruction::ftz )
@@ -1822,8 +2083,46 @@ namespace translator
 		_yield( 0 );
 	}
 
+	bool PTXToLLVMTranslator::_translateSpecializedLd( 
+		const ir::PTXInstruction& i )
+	{
+		if( i.addressSpace != ir::PTXInstruction::Param ) return false;
+		if( i.a.addressMode != ir::PTXOperand::Address ) return false;
+		if( !i.d.array.empty() ) return false;
+		
+		Specialization::ParameterMap::const_iterator 
+			parameter = _specialization.parameters.find( i.a.offset );
+		if( parameter == _specialization.parameters.end() ) return false;
+		
+		ir::LLVMBitcast cast;
+		
+		cast.d = _destination( i );
+		cast.d.type.type = _translate( i.type );
+		cast.a.type.category = ir::LLVMInstruction::Type::Element;
+		cast.a.type.type = cast.d.type.type;
+		cast.a.constant = true;
+		cast.a.i64 = parameter->second;
+		
+		if( _translate( i.d.type ) != _translate( i.type ) )
+		{
+			ir::LLVMInstruction::Operand temp = cast.d;
+			temp.type.type = _translate( i.d.type );
+			cast.d.name = _tempRegister();
+			_add( cast );
+			_convert( temp, i.d.type, cast.d, i.type );
+		}
+		else
+		{
+			_add( cast );
+		}
+		
+		return true;
+	}
+	
 	void PTXToLLVMTranslator::_translateLd( const ir::PTXInstruction& i )
 	{
+		if( _translateSpecializedLd( i ) ) return;
+	
 		#if(USE_VECTOR_INSTRUCTIONS == 1)
 		ir::LLVMLoad load;
 		
@@ -1982,6 +2281,12 @@ namespace translator
 
 	void PTXToLLVMTranslator::_translateLg2( const ir::PTXInstruction& i )
 	{
+		if( _approximate( i ) )
+		{
+			_translateApproximate( i, "@llvm.log2.f32" );
+			return;
+		}
+	
 		ir::LLVMCall call;
 		
 		if( i.modifier & ir::PTXInstruction::ftz )
@@ -3267,6 +3572,30 @@ namespace translator
 
 	void PTXToLLVMTranslator::_translateRsqrt( const ir::PTXInstruction& i )
 	{
+		if( _approximate( i ) )
+		{
+			ir::LLVMCall call;
+		
+			call.name = "@llvm.sqrt.f32";
+			call.d = _destination( i );
+			call.d.name = _tempRegister();
+			call.parameters.resize( 1 );
+			call.parameters[0] = _translate( i.a );
+		
+			_add( call );
+			
+			ir::LLVMFdiv div;
+			
+			div.d = _destination( i );
+			div.b = call.d;
+			div.a = call.d;
+			div.a.constant = true;
+			div.a.f32 = 1.0;
+			
+			_add( div );
+			return;
+		}
+	
 		ir::LLVMCall call;
 		
 		if( i.modifier & ir::PTXInstruction::ftz )
@@ -3707,6 +4036,12 @@ namespace translator
 
 	void PTXToLLVMTranslator::_translateSin( const ir::PTXInstruction& i )
 	{
+		if( _approximate( i ) )
+		{
+			_translateApproximate( i, "@llvm.sin.f32" );
+			return;
+		}
+	
 		ir::LLVMCall call;
 		
 		if( i.modifier & ir::PTXInstruction::ftz )
@@ -3772,6 +4107,12 @@ namespace translator
 
 	void PTXToLLVMTranslator::_translateSqrt( const ir::PTXInstruction& i )
 	{
+		if( _approximate( i ) )
+		{
+			_translateApproximate( i, "@llvm.sqrt.f32" );
+			return;
+		}
+	
 		ir::LLVMCall call;
 		
 		if( i.modifier & ir::PTXInstruction::ftz )
@@ -5472,10 +5813,58 @@ namespace translator
 		return stream.str();
 	}
 
+	bool PTXToLLVMTranslator::_isSpecialized( 
+		ir::PTXOperand::SpecialRegister s, unsigned int& value ) const
+	{
+		if( !_specialization.dimensions ) return false;
+		
+		switch( s )
+		{
+			case ir::PTXOperand::ntidX: value = _specialization.ntid.x; break;
+			case ir::PTXOperand::ntidY: value = _specialization.ntid.y; break;
+			case ir::PTXOperand::ntidZ: value = _specialization.ntid.z; break;
+			case ir::PTXOperand::nctaIdX: 
+			{
+				value = _specialization.nctaid.x;
+				break;
+			}
+			case ir::PTXOperand::nctaIdY: 
+			{
+				value = _specialization.nctaid.y;
+				break;
+			}
+			case ir::PTXOperand::nctaIdZ: 
+			{
+				value = _specialization.nctaid.z;
+				break;
+			}
+			default: return false;
+		}
+		
+		return true;
+	}
+
 	std::string PTXToLLVMTranslator::_loadSpecialRegister( 
 		ir::PTXOperand::SpecialRegister s )
 	{
 		std::string reg;
+		
+		unsigned int value = 0;
+		if( _isSpecialized( s, value ) )
+		{
+			ir::LLVMBitcast cast;
+			
+			cast.d.name = _tempRegister();
+			cast.d.type.category = ir::LLVMInstruction::Type::Element;
+			cast.d.type.type = ir::LLVMInstruction::I16;
+			cast.a.type = cast.d.type;
+			cast.a.constant = true;
+			cast.a.i64 = value;
+			
+			_add( cast );
+			
+			return cast.d.name;
+		}
 
 		ir::LLVMGetelementptr get;
 			
@@ -5651,6 +6040,22 @@ namespace translator
 		
 		_add( load );
 		
+		if( s == ir::PTXOperand::tidX && _lane != 0 )
+		{
+			ir::LLVMAdd add;
+			
+			add.d = load.d;
+			add.d.name = _tempRegister();
+			add.a = load.d;
+			add.b = load.d;
+			add.b.constant = true;
+			add.b.i64 = _lane;
+			
+			_add( add );
+			
+			return add.d.name;
+		}
+		
 		return load.d.name;
 	}
 	
@@ -5708,7 +6113,66 @@ namespace translator
 		
 		_add( load );
 		
-		return load.d;
+		if( space != ir::PTXInstruction::Local || _lane == 0 ) return load.d;
+		
+		// each lane of a bundle has its own local memory
+		ir::LLVMGetelementptr getSize;
+		
+		getSize.d.name = _tempRegister();
+		getSize.d.type.category = ir::LLVMInstruction::Type::Pointer;
+		getSize.d.type.type = ir::LLVMInstruction::I64;
+		getSize.a = _context();
+		getSize.indices.push_back( 0 );
+		getSize.indices.push_back( 8 );
+		
+		_add( getSize );
+		
+		ir::LLVMLoad size;
+		
+		size.d.name = _tempRegister();
+		size.d.type.category = ir::LLVMInstruction::Type::Element;
+		size.d.type.type = ir::LLVMInstruction::I64;
+		size.a = getSize.d;
+		
+		_add( size );
+		
+		ir::LLVMMul offset;
+		
+		offset.d = size.d;
+		offset.d.name = _tempRegister();
+		offset.a = size.d;
+		offset.b = size.d;
+		offset.b.constant = true;
+		offset.b.i64 = _lane;
+		
+		_add( offset );
+		
+		ir::LLVMPtrtoint base;
+		
+		base.d = size.d;
+		base.d.name = _tempRegister();
+		base.a = load.d;
+		
+		_add( base );
+		
+		ir::LLVMAdd add;
+		
+		add.d = base.d;
+		add.d.name = _tempRegister();
+		add.a = base.d;
+		add.b = offset.d;
+		
+		_add( add );
+		
+		ir::LLVMInttoptr pointer;
+		
+		pointer.d = load.d;
+		pointer.d.name = _tempRegister();
+		pointer.a = add.d;
+		
+		_add( pointer );
+		
+		return pointer.d;
 	}
 			
 	ir::LLVMInstruction::Operand 
@@ -6371,6 +6835,32 @@ namespace translator
 		mul.label = "__ocelot_mul_hi_s64";
 		
 		_llvmKernel->_statements.push_front( mul );
+		
+		if( !_fastMath ) return;
+		
+		const char* intrinsics[] = { "llvm.sqrt.f32", "llvm.sin.f32", 
+			"llvm.cos.f32", "llvm.exp2.f32", "llvm.log2.f32" };
+		
+		ir::LLVMStatement intrinsic( ir::LLVMStatement::FunctionDeclaration );
+
+		intrinsic.linkage = ir::LLVMStatement::InvalidLinkage;
+		intrinsic.convention = ir::LLVMInstruction::DefaultCallingConvention;
+		intrinsic.visibility = ir::LLVMStatement::Default;
+		
+		intrinsic.operand.type.category = ir::LLVMInstruction::Type::Element;
+		intrinsic.operand.type.type = ir::LLVMInstruction::F32;
+		
+		intrinsic.parameters.resize( 1 );
+		intrinsic.parameters[0].type.category 
+			= ir::LLVMInstruction::Type::Element;
+		intrinsic.parameters[0].type.type = ir::LLVMInstruction::F32;
+		
+		for( unsigned int index = 0; 
+			index < sizeof( intrinsics ) / sizeof( intrinsics[0] ); ++index )
+		{
+			intrinsic.label = intrinsics[ index ];
+			_llvmKernel->_statements.push_front( intrinsic );
+		}
 	}
 	
 	void PTXToLLVMTranslator::_addKernelPrefix()
@@ -6380,11 +6870,23 @@ namespace translator
 
 		ir::LLVMStatement kernel( ir::LLVMStatement::FunctionDefinition );
 
-		kernel.label = "_Z_ocelotTranslated_" + _llvmKernel->name;
+		if( _bundleWidth > 1 )
+		{
+			kernel.label = "_Z_ocelotBundle_" + _llvmKernel->name;
+		}
+		else
+		{
+			kernel.label = "_Z_ocelotTranslated_" + _llvmKernel->name;
+		}
 		kernel.linkage = ir::LLVMStatement::InvalidLinkage;
 		kernel.convention = ir::LLVMInstruction::DefaultCallingConvention;
 		kernel.visibility = ir::LLVMStatement::Default;
 		kernel.functionAttributes = ir::LLVMInstruction::NoUnwind;
+		
+		if( _threadLoops && _resumePoints > 0 )
+		{
+			kernel.functionAttributes |= ir::LLVMInstruction::AlwaysInline;
+		}
 	
 		kernel.operand.type.category = ir::LLVMInstruction::Type::Element;
 		kernel.operand.type.type = ir::LLVMInstruction::I32;
@@ -6619,10 +7121,524 @@ namespace translator
 			ir::LLVMStatement( ir::LLVMStatement::EndFunctionBody ) );	
 	}
 
-	PTXToLLVMTranslator::PTXToLLVMTranslator( OptimizationLevel l ) 
+	void PTXToLLVMTranslator::_addThreadLoop()
+	{
+		typedef ir::LLVMInstruction::Type Type;
+		typedef ir::LLVMInstruction::Operand Operand;
+		
+		report( " Adding thread loops for " << _resumePoints 
+			<< " barriers." );
+		
+		// find where the barrier pass keeps each thread's resume point
+		analysis::RemoveBarrierPass barrierPass;
+		int resumePointOffset = -1;
+		
+		for( analysis::DataflowGraph::const_iterator 
+			block = _ptx->dfg()->begin(); 
+			block != _ptx->dfg()->end(); ++block )
+		{
+			for( analysis::DataflowGraph::InstructionVector::const_iterator 
+				instruction = block->instructions().begin(); 
+				instruction != block->instructions().end(); ++instruction )
+			{
+				const ir::PTXInstruction& ptx = static_cast< 
+					const ir::PTXInstruction& >( *instruction->i );
+				if( ptx.opcode == ir::PTXInstruction::Mov 
+					&& ptx.a.addressMode == ir::PTXOperand::Address 
+					&& ptx.a.identifier == barrierPass.resume() )
+				{
+					resumePointOffset = ptx.a.offset;
+				}
+			}
+		}
+		
+		assertM( resumePointOffset >= 0, "Kernel " << _ptx->name 
+			<< " has barriers but no resume point." );
+		
+		ir::LLVMStatement loop( ir::LLVMStatement::FunctionDefinition );
+
+		loop.label = "_Z_ocelotThreadLoop_" + _llvmKernel->name;
+		loop.linkage = ir::LLVMStatement::InvalidLinkage;
+		loop.convention = ir::LLVMInstruction::DefaultCallingConvention;
+		loop.visibility = ir::LLVMStatement::Default;
+		loop.functionAttributes = ir::LLVMInstruction::NoUnwind;
+	
+		loop.operand.type.category = Type::Element;
+		loop.operand.type.type = ir::LLVMInstruction::I32;
+		
+		loop.parameters.resize( 1 );
+		loop.parameters[ 0 ].attribute = ir::LLVMInstruction::NoAlias;
+		loop.parameters[ 0 ].type.label = "%LLVMContext";
+		loop.parameters[ 0 ].type.category = Type::Pointer;
+		loop.parameters[ 0 ].name = "%__ctaContext";
+
+		_llvmKernel->_statements.push_back( 
+			ir::LLVMStatement( ir::LLVMStatement::NewLine ) );
+		_llvmKernel->_statements.push_back( loop );
+		_llvmKernel->_statements.push_back( 
+			ir::LLVMStatement( ir::LLVMStatement::BeginFunctionBody ) );
+		
+		_newBlock( "$OcelotThreadLoopEntry" );
+		
+		// pointers into the context
+		ir::LLVMGetelementptr getLocal;
+		
+		getLocal.d.name = _tempRegister();
+		getLocal.d.type.category = Type::Pointer;
+		getLocal.d.type.members.resize( 1 );
+		getLocal.d.type.members[0].category = Type::Pointer;
+		getLocal.d.type.members[0].type = ir::LLVMInstruction::I8;
+		getLocal.a = _context();
+		getLocal.indices.push_back( 0 );
+		getLocal.indices.push_back( 4 );
+		
+		_add( getLocal );
+		
+		ir::LLVMLoad localBase;
+		
+		localBase.d.name = _tempRegister();
+		localBase.d.type = Type( ir::LLVMInstruction::I8, Type::Pointer );
+		localBase.a = getLocal.d;
+		
+		_add( localBase );
+		
+		ir::LLVMPtrtoint localAddress;
+		
+		localAddress.d = Operand( _tempRegister(), 
+			Type( ir::LLVMInstruction::I64, Type::Element ) );
+		localAddress.a = localBase.d;
+		
+		_add( localAddress );
+		
+		ir::LLVMGetelementptr getSize;
+		
+		getSize.d.name = _tempRegister();
+		getSize.d.type = Type( ir::LLVMInstruction::I64, Type::Pointer );
+		getSize.a = _context();
+		getSize.indices.push_back( 0 );
+		getSize.indices.push_back( 8 );
+		
+		_add( getSize );
+		
+		ir::LLVMLoad localSize;
+		
+		localSize.d = Operand( _tempRegister(), 
+			Type( ir::LLVMInstruction::I64, Type::Element ) );
+		localSize.a = getSize.d;
+		
+		_add( localSize );
+		
+		Operand tid[3];
+		Operand ntid[3];
+		
+		const ir::PTXOperand::SpecialRegister ntidRegisters[] = { 
+			ir::PTXOperand::ntidX, ir::PTXOperand::ntidY, 
+			ir::PTXOperand::ntidZ };
+		
+		for( unsigned int dimension = 0; dimension < 3; ++dimension )
+		{
+			ir::LLVMGetelementptr getTid;
+			
+			getTid.d.name = _tempRegister();
+			getTid.d.type = Type( ir::LLVMInstruction::I16, Type::Pointer );
+			getTid.a = _context();
+			getTid.indices.push_back( 0 );
+			getTid.indices.push_back( 0 );
+			getTid.indices.push_back( dimension );
+			
+			_add( getTid );
+			
+			tid[ dimension ] = getTid.d;
+			
+			// known CTA dimensions give the loops constant trip counts
+			unsigned int value = 0;
+			if( _isSpecialized( ntidRegisters[ dimension ], value ) )
+			{
+				ntid[ dimension ] = Operand( "", 
+					Type( ir::LLVMInstruction::I16, Type::Element ) );
+				ntid[ dimension ].constant = true;
+				ntid[ dimension ].i16 = value;
+				continue;
+			}
+			
+			ir::LLVMGetelementptr getNtid = getTid;
+			
+			getNtid.d.name = _tempRegister();
+			getNtid.indices[ 1 ] = 1;
+			
+			_add( getNtid );
+			
+			ir::LLVMLoad load;
+			
+			load.d = Operand( _tempRegister(), 
+				Type( ir::LLVMInstruction::I16, Type::Element ) );
+			load.a = getNtid.d;
+			
+			_add( load );
+			
+			ntid[ dimension ] = load.d;
+		}
+		
+		ir::LLVMBr enter;
+		
+		enter.iftrue = "%$OcelotThreadLoopBegin0";
+		
+		_add( enter );
+		
+		Operand zero16( "", Type( ir::LLVMInstruction::I16, 
+			Type::Element ) );
+		zero16.constant = true;
+		zero16.i16 = 0;
+		
+		Operand one16 = zero16;
+		one16.i16 = 1;
+		
+		// one loop over all threads for each region between barriers
+		for( unsigned int region = 0; region <= _resumePoints; ++region )
+		{
+			std::stringstream stream;
+			stream << region;
+			
+			std::string begin = "$OcelotThreadLoopBegin" + stream.str();
+			std::string body = "$OcelotThreadLoopBody" + stream.str();
+			std::string run = "$OcelotThreadLoopCall" + stream.str();
+			std::string latch = "$OcelotThreadLoopLatch" + stream.str();
+			std::string dispatch = "$OcelotThreadLoopDispatch" 
+				+ stream.str();
+			
+			_newBlock( begin );
+			
+			ir::LLVMBr start;
+			
+			start.iftrue = "%" + body;
+			
+			_add( start );
+			
+			_newBlock( body );
+			
+			std::string next[5];
+			for( unsigned int i = 0; i < 5; ++i ) next[ i ] = _tempRegister();
+			
+			ir::LLVMPhi position[3];
+			ir::LLVMPhi::Node node;
+			
+			for( unsigned int dimension = 0; dimension < 3; ++dimension )
+			{
+				position[ dimension ].d = Operand( _tempRegister(), 
+					zero16.type );
+				
+				node.operand = zero16;
+				node.label = "%" + begin;
+				position[ dimension ].nodes.push_back( node );
+				
+				node.operand = Operand( next[ dimension ], zero16.type );
+				node.label = "%" + latch;
+				position[ dimension ].nodes.push_back( node );
+				
+				_add( position[ dimension ] );
+			}
+			
+			ir::LLVMPhi local;
+			
+			local.d = Operand( _tempRegister(), localAddress.d.type );
+			
+			node.operand = localAddress.d;
+			node.label = "%" + begin;
+			local.nodes.push_back( node );
+			
+			node.operand = Operand( next[ 3 ], localAddress.d.type );
+			node.label = "%" + latch;
+			local.nodes.push_back( node );
+			
+			_add( local );
+			
+			ir::LLVMPhi resume;
+			
+			resume.d = Operand( _tempRegister(), 
+				Type( ir::LLVMInstruction::I32, Type::Element ) );
+			
+			node.operand = Operand( (ir::LLVMI32) 0 );
+			node.label = "%" + begin;
+			resume.nodes.push_back( node );
+			
+			node.operand = Operand( next[ 4 ], resume.d.type );
+			node.label = "%" + latch;
+			resume.nodes.push_back( node );
+			
+			_add( resume );
+			
+			for( unsigned int dimension = 0; dimension < 3; ++dimension )
+			{
+				ir::LLVMStore store;
+				
+				store.d = tid[ dimension ];
+				store.a = position[ dimension ].d;
+				
+				_add( store );
+			}
+			
+			ir::LLVMInttoptr localPointer;
+			
+			localPointer.d = Operand( _tempRegister(), localBase.d.type );
+			localPointer.a = local.d;
+			
+			_add( localPointer );
+			
+			ir::LLVMStore setLocal;
+			
+			setLocal.d = getLocal.d;
+			setLocal.a = localPointer.d;
+			
+			_add( setLocal );
+			
+			ir::LLVMAdd resumeAddress;
+			
+			resumeAddress.d = Operand( _tempRegister(), local.d.type );
+			resumeAddress.a = local.d;
+			resumeAddress.b = Operand( (ir::LLVMI64) resumePointOffset );
+			
+			_add( resumeAddress );
+			
+			ir::LLVMInttoptr resumePointer;
+			
+			resumePointer.d = Operand( _tempRegister(), 
+				Type( ir::LLVMInstruction::I32, Type::Pointer ) );
+			resumePointer.a = resumeAddress.d;
+			
+			_add( resumePointer );
+			
+			// threads that exited in an earlier region left 0 in their 
+			//  resume point and must not run again
+			if( region == 0 )
+			{
+				ir::LLVMBr enterThread;
+				
+				enterThread.iftrue = "%" + run;
+				
+				_add( enterThread );
+			}
+			else
+			{
+				ir::LLVMLoad previous;
+				
+				previous.d = Operand( _tempRegister(), resume.d.type );
+				previous.a = resumePointer.d;
+				
+				_add( previous );
+				
+				ir::LLVMIcmp exited;
+				
+				exited.comparison = ir::LLVMInstruction::Eq;
+				exited.d = Operand( _tempRegister(), 
+					Type( ir::LLVMInstruction::I1, Type::Element ) );
+				exited.a = previous.d;
+				exited.b = Operand( (ir::LLVMI32) 0 );
+				
+				_add( exited );
+				
+				ir::LLVMBr skip;
+				
+				skip.condition = exited.d;
+				skip.iftrue = "%" + latch;
+				skip.iffalse = "%" + run;
+				
+				_add( skip );
+			}
+			
+			_newBlock( run );
+			
+			ir::LLVMStore setResume;
+			
+			setResume.d = resumePointer.d;
+			setResume.a = Operand( (ir::LLVMI32) region );
+			
+			_add( setResume );
+			
+			ir::LLVMCall call;
+			
+			call.name = "@_Z_ocelotTranslated_" + _llvmKernel->name;
+			call.d = Operand( _tempRegister(), resume.d.type );
+			call.parameters.resize( 1 );
+			call.parameters[ 0 ] = _context();
+			
+			_add( call );
+			
+			ir::LLVMStore setExited;
+			
+			setExited.d = resumePointer.d;
+			setExited.a = call.d;
+			
+			_add( setExited );
+			
+			ir::LLVMBr leave;
+			
+			leave.iftrue = "%" + latch;
+			
+			_add( leave );
+			
+			_newBlock( latch );
+			
+			ir::LLVMPhi called;
+			
+			called.d = Operand( _tempRegister(), resume.d.type );
+			
+			node.operand = call.d;
+			node.label = "%" + run;
+			called.nodes.push_back( node );
+			
+			if( region != 0 )
+			{
+				node.operand = Operand( (ir::LLVMI32) 0 );
+				node.label = "%" + body;
+				called.nodes.push_back( node );
+			}
+			
+			_add( called );
+			
+			// every thread should reach the same barrier, keep the last one
+			ir::LLVMIcmp blocked;
+			
+			blocked.comparison = ir::LLVMInstruction::Ne;
+			blocked.d = Operand( _tempRegister(), 
+				Type( ir::LLVMInstruction::I1, Type::Element ) );
+			blocked.a = called.d;
+			blocked.b = Operand( (ir::LLVMI32) 0 );
+			
+			_add( blocked );
+			
+			ir::LLVMSelect nextResume;
+			
+			nextResume.d = Operand( next[ 4 ], resume.d.type );
+			nextResume.condition = blocked.d;
+			nextResume.a = called.d;
+			nextResume.b = resume.d;
+			
+			_add( nextResume );
+			
+			ir::LLVMAdd nextLocal;
+			
+			nextLocal.d = Operand( next[ 3 ], local.d.type );
+			nextLocal.a = local.d;
+			nextLocal.b = localSize.d;
+			
+			_add( nextLocal );
+			
+			// step x, carrying into y and z
+			Operand carry;
+			
+			for( unsigned int dimension = 0; dimension < 3; ++dimension )
+			{
+				ir::LLVMAdd increment;
+				
+				increment.d = Operand( _tempRegister(), zero16.type );
+				increment.a = position[ dimension ].d;
+				increment.b = one16;
+				
+				if( dimension != 0 )
+				{
+					ir::LLVMZext extend;
+					
+					extend.d = Operand( _tempRegister(), zero16.type );
+					extend.a = carry;
+					
+					_add( extend );
+					
+					increment.b = extend.d;
+				}
+				
+				if( dimension == 2 )
+				{
+					increment.d.name = next[ dimension ];
+					_add( increment );
+					break;
+				}
+				
+				_add( increment );
+				
+				ir::LLVMIcmp wrap;
+				
+				wrap.comparison = ir::LLVMInstruction::Eq;
+				wrap.d = Operand( _tempRegister(), blocked.d.type );
+				wrap.a = increment.d;
+				wrap.b = ntid[ dimension ];
+				
+				_add( wrap );
+				
+				ir::LLVMSelect select;
+				
+				select.d = Operand( next[ dimension ], zero16.type );
+				select.condition = wrap.d;
+				select.a = zero16;
+				select.b = increment.d;
+				
+				_add( select );
+				
+				carry = wrap.d;
+			}
+			
+			ir::LLVMIcmp finished;
+			
+			finished.comparison = ir::LLVMInstruction::Eq;
+			finished.d = Operand( _tempRegister(), blocked.d.type );
+			finished.a = Operand( next[ 2 ], zero16.type );
+			finished.b = ntid[ 2 ];
+			
+			_add( finished );
+			
+			ir::LLVMBr branch;
+			
+			branch.condition = finished.d;
+			branch.iftrue = "%" + dispatch;
+			branch.iffalse = "%" + body;
+			
+			_add( branch );
+			
+			_newBlock( dispatch );
+			
+			ir::LLVMSwitch select;
+			
+			select.comparison = nextResume.d;
+			select.defaultTarget = "%$OcelotThreadLoopExit";
+			
+			for( unsigned int target = 1; target <= _resumePoints; ++target )
+			{
+				std::stringstream label;
+				label << "%$OcelotThreadLoopBegin" << target;
+				
+				ir::LLVMSwitch::Node node;
+				
+				node.operand = Operand( (ir::LLVMI32) target );
+				node.label = label.str();
+				
+				select.targets.push_back( node );
+			}
+			
+			_add( select );
+		}
+		
+		_newBlock( "$OcelotThreadLoopExit" );
+		
+		ir::LLVMStore restore;
+		
+		restore.d = getLocal.d;
+		restore.a = localBase.d;
+		
+		_add( restore );
+		
+		_yield( 0 );
+		
+		_llvmKernel->_statements.push_back( 
+			ir::LLVMStatement( ir::LLVMStatement::EndFunctionBody ) );
+	}
+
+	PTXToLLVMTranslator::PTXToLLVMTranslator( OptimizationLevel l, 
+		unsigned int bundleWidth, bool threadLoops, bool fastMath ) 
 		: Translator( ir::Instruction::PTX, ir::Instruction::LLVM, l ),
 		_tempRegisterCount( 0 ), _tempCCRegisterCount( 0 ),
-		_tempBlockCount( 0 ), _usesTextures( false )
+		_tempBlockCount( 0 ), _usesTextures( false ), 
+		_bundleWidth( std::max( bundleWidth, 1u ) ), _lane( 0 ),
+		_threadLoops( threadLoops ), _resumePoints( 0 ), 
+		_fastMath( fastMath )
 	{
 	
 	}
@@ -6640,27 +7656,44 @@ namespace translator
 			"Kernel must a PTXKernel to translate to an LLVMKernel" );
 		
 		_ptx = static_cast< const ir::PTXKernel* >( k );
-		_llvmKernel = new ir::LLVMKernel( *k );
 				
 		assert(_ptx->dfg()->ssa());
+		
+		if( _bundleWidth > 1 && !_computeVaryingRegisters() ) return 0;
+		
+		_llvmKernel = new ir::LLVMKernel( *k );
 		_translateInstructions();
 		_initializeRegisters();
 		_addStackAllocations();
 		_addKernelPrefix();
 		_addKernelSuffix();
+		if( _threadLoops && _resumePoints > 0 ) _addThreadLoop();
 		_addGlobalDeclarations();
 		
 		_tempRegisterCount = 0;
 		_tempBlockCount = 0;
 		_uninitialized.clear();
 		_usesTextures = false;
+		_varying.clear();
+		_resumePoints = 0;
 				
 		return _llvmKernel;
 	}
 	
 	void PTXToLLVMTranslator::addProfile( const ProfilingData& d )
 	{
-		// profiling not yet implemented
+		_profile = d;
+	}
+	
+	void PTXToLLVMTranslator::specialize( const Specialization& s )
+	{
+		_specialization = s;
+	}
+	
+	PTXToLLVMTranslator::Specialization::Specialization() 
+		: dimensions( false )
+	{
+	
 	}
 }
 
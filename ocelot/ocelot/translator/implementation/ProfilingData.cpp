@@ -0,0 +1,178 @@
+/*! \file ProfilingData.cpp
+	\date October 18, 2026
+	\author agent <agent@local>
+	\brief The source file for the ProfilingData class
+*/
+
+#ifndef PROFILING_DATA_CPP_INCLUDED
+#define PROFILING_DATA_CPP_INCLUDED
+
+#include <ocelot/translator/interface/ProfilingData.h>
+#include <ocelot/ir/interface/PTXKernel.h>
+
+#include <hydrazine/implementation/debug.h>
+
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+#ifdef REPORT_BASE
+#undef REPORT_BASE
+#endif
+
+#define REPORT_BASE 0
+
+// Weights are scaled down until the heavier edge fits in this many bits
+#define BRANCH_WEIGHT_BITS 20
+
+namespace translator
+{
+	ProfilingData::Branch::Branch( unsigned int t, unsigned int f )
+		: taken( t ), fallthrough( f )
+	{
+
+	}
+
+	/*! \brief One line of a branch profile */
+	class ProfiledBlock
+	{
+		public:
+			long long unsigned int id;
+			long long unsigned int visits;
+			long long unsigned int divergences;
+	};
+
+	typedef std::map< ir::ControlFlowGraph::BasicBlock::Id,
+		ProfiledBlock > ProfiledBlockMap;
+
+	static bool visits( const ProfiledBlockMap& blocks,
+		ir::ControlFlowGraph::const_iterator block,
+		long long unsigned int& count )
+	{
+		ProfiledBlockMap::const_iterator profiled = blocks.find( block->id );
+		if( profiled == blocks.end() ) return false;
+
+		count = profiled->second.visits;
+		return true;
+	}
+
+	bool ProfilingData::load( const std::string& path, ir::PTXKernel& kernel )
+	{
+		branches.clear();
+
+		std::ifstream file( path.c_str() );
+		if( !file.is_open() ) return false;
+
+		typedef std::vector< ProfiledBlock > ProfiledBlockVector;
+
+		ProfiledBlockVector lines;
+		ProfiledBlock line;
+
+		while( file >> line.id >> line.visits >> line.divergences )
+		{
+			lines.push_back( line );
+		}
+
+		ir::ControlFlowGraph* cfg = kernel.cfg();
+		ir::ControlFlowGraph::BlockPointerVector sequence
+			= cfg->executable_sequence();
+
+		ProfiledBlockMap profiled;
+		ProfiledBlockVector::const_iterator next = lines.begin();
+
+		for( ir::ControlFlowGraph::BlockPointerVector::iterator
+			block = sequence.begin(); block != sequence.end(); ++block )
+		{
+			if( *block == cfg->get_entry_block()
+				|| *block == cfg->get_exit_block() ) continue;
+			if( !(*block)->endsWithConditionalBranch() ) continue;
+
+			if( next == lines.end() || next->id != (*block)->id )
+			{
+				report( "Profile " << path << " does not belong to kernel "
+					<< kernel.name );
+				return false;
+			}
+
+			profiled.insert( std::make_pair( (*block)->id, *next++ ) );
+		}
+
+		if( next != lines.end() )
+		{
+			report( "Profile " << path << " has more branches than kernel "
+				<< kernel.name );
+			return false;
+		}
+
+		for( ir::ControlFlowGraph::BlockPointerVector::iterator
+			block = sequence.begin(); block != sequence.end(); ++block )
+		{
+			ProfiledBlockMap::const_iterator branch
+				= profiled.find( (*block)->id );
+			if( branch == profiled.end() ) continue;
+
+			if( !(*block)->has_branch_edge()
+				|| !(*block)->has_fallthrough_edge() ) continue;
+
+			ir::ControlFlowGraph::const_iterator target
+				= (*block)->get_branch_edge()->tail;
+			ir::ControlFlowGraph::const_iterator fallthrough
+				= (*block)->get_fallthrough_edge()->tail;
+
+			if( target == fallthrough ) continue;
+
+			long long unsigned int total = branch->second.visits;
+			long long unsigned int taken = 0;
+			long long unsigned int notTaken = 0;
+
+			bool knownTaken = visits( profiled, target, taken );
+			bool knownNotTaken = visits( profiled, fallthrough, notTaken );
+
+			if( !knownTaken && !knownNotTaken ) continue;
+
+			// other predecessors of the successors also add visits
+			taken = std::min( taken, total );
+			notTaken = std::min( notTaken, total );
+
+			if( !knownTaken ) taken = total - notTaken;
+			if( !knownNotTaken ) notTaken = total - taken;
+
+			taken = std::max( taken, branch->second.divergences );
+			notTaken = std::max( notTaken, branch->second.divergences );
+
+			while( std::max( taken, notTaken )
+				>= ( 1ULL << BRANCH_WEIGHT_BITS ) )
+			{
+				taken >>= 1;
+				notTaken >>= 1;
+			}
+
+			// never claim that an edge is impossible
+			branches.insert( std::make_pair( (*block)->label,
+				Branch( taken + 1, notTaken + 1 ) ) );
+		}
+
+		report( "Loaded " << branches.size() << " branch weights for kernel "
+			<< kernel.name << " from " << path );
+
+		return true;
+	}
+
+	bool ProfilingData::empty() const
+	{
+		return branches.empty();
+	}
+
+	void ProfilingData::write( std::ostream& out ) const
+	{
+		for( BranchMap::const_iterator branch = branches.begin();
+			branch != branches.end(); ++branch )
+		{
+			out << "branch " << branch->first << " " << branch->second.taken
+				<< " " << branch->second.fallthrough << "\n";
+		}
+	}
+}
+
+#endif
+
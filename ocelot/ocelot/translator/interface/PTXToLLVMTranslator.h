@@ -8,9 +8,14 @@
 #define PTX_TO_LLVM_TRANSLATOR_H_INCLUDED
 
 #include <ocelot/translator/interface/Translator.h>
+#include <ocelot/translator/interface/ProfilingData.h>
 #include <ocelot/ir/interface/LLVMInstruction.h>
 #include <ocelot/ir/interface/PTXKernel.h>
 #include <ocelot/analysis/interface/DataflowGraph.h>
+#include <ocelot/ir/interface/Dim3.h>
+
+#include <unordered_set>
+#include <map>
 
 namespace ir
 {
@@ -22,13 +27,68 @@ namespace ir
 
 namespace translator
 {
-	/*! \brief A translator from PTX to LLVM */
+	/*! \brief A translator from PTX to LLVM 
+	
+		With a bundle width greater than one, the translator instead emits
+		a function that runs that many consecutive threads in x.  Values 
+		that are the same for every thread in the bundle are computed once, 
+		all other instructions are emitted once per lane in lockstep.  Only
+		kernels whose branches are uniform and that do not use barriers, 
+		votes, or calls can be bundled.
+		
+		The lanes are separate scalar instructions, not <N x T> vector 
+		operations.  A bundle saves the call and the uniform work of the 
+		threads after the first, any SIMD code is left to the LLVM 
+		optimizer, which has no vectorizer in the supported releases.
+		
+		With thread loops enabled, kernels with barriers also get a function
+		that runs a whole CTA.  It loops over every thread for one barrier
+		region at a time and only dispatches on the resume point once per
+		region.  The per-thread function is inlined into each loop, where
+		the known resume point folds away its entry dispatch.  Threads that
+		exit leave a zero resume point and are skipped by later loops.
+		
+		A translator may also be specialized for one launch, the CTA and 
+		grid dimensions and parameters that it is given are translated as
+		constants rather than loads from the context.
+		
+		With fast math, single precision instructions marked .approx, .full
+		or .ftz are lowered to LLVM intrinsics and reciprocal multiplies 
+		rather than calls to exact library functions.  Other instructions
+		keep their IEEE lowering.
+	*/
 	class PTXToLLVMTranslator : public Translator
 	{
+		public:
+			/*! \brief Values that are the same for every thread in a launch */
+			class Specialization
+			{
+				public:
+					/*! \brief A map from a parameter offset to its bytes */
+					typedef std::map< unsigned int, long long unsigned int >
+						ParameterMap;
+				
+				public:
+					/*! \brief Are the dimensions known? */
+					bool dimensions;
+					/*! \brief The CTA dimensions */
+					ir::Dim3 ntid;
+					/*! \brief The grid dimensions */
+					ir::Dim3 nctaid;
+					/*! \brief Known parameters by offset */
+					ParameterMap parameters;
+				
+				public:
+					/*! \brief Nothing is known by default */
+					Specialization();
+			};
+	
 		private:
 			typedef std::vector< analysis::DataflowGraph::Register > 
 				RegisterVector;
 			typedef std::vector< std::string > StringVector;
+			typedef std::unordered_set< analysis::DataflowGraph::RegisterId >
+				RegisterSet;
 		
 		private:
 			ir::LLVMKernel* _llvmKernel;
@@ -38,6 +98,14 @@ namespace translator
 			bool _usesTextures;
 			RegisterVector _uninitialized;
 			const ir::PTXKernel* _ptx;
+			unsigned int _bundleWidth;
+			unsigned int _lane;
+			RegisterSet _varying;
+			bool _threadLoops;
+			unsigned int _resumePoints;
+			Specialization _specialization;
+			ProfilingData _profile;
+			bool _fastMath;
 		
 		private:
 			static ir::LLVMInstruction::DataType _translate( 
@@ -60,6 +128,18 @@ namespace translator
 			void _addMemoryCheckingDeclarations();
 			void _insertDebugSymbols();
 			
+		private:
+			bool _computeVaryingRegisters();
+			bool _isVarying( const analysis::DataflowGraph::Instruction& i ) 
+				const;
+			std::string _registerName( 
+				analysis::DataflowGraph::RegisterId r ) const;
+			
+		private:
+			bool _approximate( const ir::PTXInstruction& i ) const;
+			void _translateApproximate( const ir::PTXInstruction& i,
+				const std::string& intrinsic );
+		
 		private:
 			void _yield( unsigned int continuation );
 
@@ -90,6 +170,7 @@ namespace translator
 			void _translateEx2( const ir::PTXInstruction& i );
 			void _translateExit( const ir::PTXInstruction& i );
 			void _translateLd( const ir::PTXInstruction& i );
+			bool _translateSpecializedLd( const ir::PTXInstruction& i );
 			void _translateLg2( const ir::PTXInstruction& i );
 			void _translateMad24( const ir::PTXInstruction& i );
 			void _translateMad( const ir::PTXInstruction& i );
@@ -137,6 +218,8 @@ namespace translator
 			std::string _tempRegister();
 			std::string _loadSpecialRegister( 
 				ir::PTXOperand::SpecialRegister s );
+			bool _isSpecialized( ir::PTXOperand::SpecialRegister s, 
+				unsigned int& value ) const;
 			ir::LLVMInstruction::Operand 
 				_getMemoryBasePointer( ir::PTXInstruction::AddressSpace space );
 			ir::LLVMInstruction::Operand _getAddressableVariablePointer( 
@@ -167,14 +250,22 @@ namespace translator
 			void _addKernelPrefix();
 			void _addGlobalDeclarations();
 			void _addKernelSuffix();
+			void _addThreadLoop();
 
 		public:
-			PTXToLLVMTranslator( OptimizationLevel l = NoOptimization );
+			PTXToLLVMTranslator( OptimizationLevel l = NoOptimization, 
+				unsigned int bundleWidth = 1, bool threadLoops = false,
+				bool fastMath = false );
 			~PTXToLLVMTranslator();
 			
 		public:
+			/*! \brief Translate a kernel, returns 0 if a bundle width was 
+				requested and the kernel can not be bundled */
 			ir::Kernel* translate( const ir::Kernel* i );
+			/*! \brief Weight conditional branches with profiled counts */
 			void addProfile( const ProfilingData& d );
+			/*! \brief Translate values known for a launch as constants */
+			void specialize( const Specialization& s );
 	};
 }
 
@@ -0,0 +1,74 @@
+/*! \file ProfilingData.h
+	\date October 18, 2026
+	\author agent <agent@local>
+	\brief The header file for the ProfilingData class
+*/
+
+#ifndef PROFILING_DATA_H_INCLUDED
+#define PROFILING_DATA_H_INCLUDED
+
+#include <string>
+#include <ostream>
+#include <map>
+
+namespace ir
+{
+	class PTXKernel;
+}
+
+namespace translator
+{
+	/*! \brief Branch weights of a kernel measured by a branch profile
+
+		The profiles written by the SimpleBranchProfiler and the
+		PrecBranchProfiler (prof.<kernel>.txt) hold one line of "block id,
+		visits, divergences" for every block that ends with a conditional
+		branch, in the order of the executable sequence of the CFG.  They do
+		not record which way a branch went, so the weight of an edge is
+		taken from the visits of the block that it leads to when that block
+		is also profiled.  A divergent visit runs both sides of a branch, so
+		neither edge weighs less than the divergences.
+	*/
+	class ProfilingData
+	{
+		public:
+			/*! \brief The weights of the two edges of a conditional branch */
+			class Branch
+			{
+				public:
+					Branch( unsigned int taken = 0,
+						unsigned int fallthrough = 0 );
+
+				public:
+					/*! \brief The weight of the edge to the branch target */
+					unsigned int taken;
+					/*! \brief The weight of the fallthrough edge */
+					unsigned int fallthrough;
+			};
+
+			/*! \brief Branches by the label of the block that they end */
+			typedef std::map< std::string, Branch > BranchMap;
+
+		public:
+			/*! \brief Derive the branch weights of a kernel from a profile
+
+				\param path The profile file
+				\param kernel The kernel that was profiled, it must not have
+					been transformed yet so that the block ids match
+				\return False if the file could not be read or does not
+					belong to the kernel, no weights are kept in that case
+			*/
+			bool load( const std::string& path, ir::PTXKernel& kernel );
+			/*! \brief Are there any weights? */
+			bool empty() const;
+			/*! \brief Write the weights, this identifies a profile */
+			void write( std::ostream& out ) const;
+
+		public:
+			/*! \brief The weighted branches */
+			BranchMap branches;
+	};
+}
+
+#endif
+
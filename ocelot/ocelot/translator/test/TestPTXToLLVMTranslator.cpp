@@ -11,6 +11,7 @@
 #include "boost/filesystem.hpp"
 #include <queue>
 #include <fstream>
+#include <sstream>
 
 #include <ocelot/translator/interface/PTXToLLVMTranslator.h>
 #include <ocelot/translator/test/TestPTXToLLVMTranslator.h>
@@ -152,6 +153,97 @@ namespace test
 		return true;	
 	}
 	
+	static unsigned int count( const std::string& code, 
+		const std::string& token )
+	{
+		unsigned int occurrences = 0;
+		
+		for( std::string::size_type position = code.find( token ); 
+			position != std::string::npos; 
+			position = code.find( token, position + 1 ) )
+		{
+			++occurrences;
+		}
+		
+		return occurrences;
+	}
+	
+	std::string TestPTXToLLVMTranslator::_translateDivide( 
+		const std::string& modifier, bool fastMath )
+	{
+		std::stringstream ptx;
+		
+		ptx << ".version 1.4\n";
+		ptx << ".target sm_10\n";
+		ptx << ".entry divide( .param .u64 out, .param .f32 a, "
+			".param .f32 b )\n";
+		ptx << "{\n";
+		ptx << "\t.reg .u64 %rd<2>;\n";
+		ptx << "\t.reg .f32 %f<4>;\n";
+		ptx << "\tld.param.u64 %rd1, [out];\n";
+		ptx << "\tld.param.f32 %f1, [a];\n";
+		ptx << "\tld.param.f32 %f2, [b];\n";
+		ptx << "\tdiv." << modifier << ".f32 %f3, %f1, %f2;\n";
+		ptx << "\tst.global.f32 [%rd1], %f3;\n";
+		ptx << "\texit;\n";
+		ptx << "}\n";
+		
+		ir::Module module( ptx, "divide.ptx" );
+		ir::Kernel* kernel = module.getKernel( "divide" );
+		
+		kernel->dfg()->toSsa();
+		
+		translator::PTXToLLVMTranslator translator( 
+			translator::Translator::NoOptimization, 1, false, fastMath );
+		
+		ir::LLVMKernel* translatedKernel = dynamic_cast< ir::LLVMKernel* >( 
+			translator.translate( kernel ) );
+		translatedKernel->assemble();
+		
+		std::string code = translatedKernel->code();
+		
+		delete translatedKernel;
+		
+		return code;
+	}
+	
+	bool TestPTXToLLVMTranslator::_testFastMath()
+	{
+		const char* modifiers[] = { "rn.ftz", "full", "approx" };
+		
+		for( unsigned int i = 0; i < 3; ++i )
+		{
+			std::string modifier = modifiers[ i ];
+		
+			unsigned int exact = count( 
+				_translateDivide( modifier, false ), "fmul" );
+			unsigned int fast = count( 
+				_translateDivide( modifier, true ), "fmul" );
+			
+			report( " div." << modifier << " has " << exact 
+				<< " multiplies without and " << fast 
+				<< " with fast math." );
+			
+			bool approximate = modifier != "rn.ftz";
+			
+			if( approximate && fast <= exact )
+			{
+				status << "div." << modifier << ".f32 was not lowered to a "
+					"multiply by the reciprocal with fast math.\n";
+				return false;
+			}
+			
+			if( !approximate && fast != exact )
+			{
+				status << "div." << modifier << ".f32 did not keep an exact "
+					"fdiv with fast math.\n";
+				return false;
+			}
+		}
+		
+		return true;
+	}
+	
 	bool TestPTXToLLVMTranslator::doTest()
 	{
 		StringVector files = _getFileNames();
@@ -174,6 +266,14 @@ namespace test
 			status << "For file " << ptxFile 
 				<< ", Test Point 1 (Translate): Passed\n";
 		}
+		
+		if( !_testFastMath() )
+		{
+			status << "Test Point 2 (Fast Math): Failed\n";
+			return false;
+		}
+		
+		status << "Test Point 2 (Fast Math): Passed\n";
 			
 		return true;	
 	}
@@ -185,7 +285,10 @@ namespace test
 		description = "This is a basic test that just tries to get through a";
 		description += " translation successfully of as many PTX programs as";
 		description += " possible Test Points: 1) Scan for all PTX files in a";
-		description += " directory, try to translate them.";
+		description += " directory, try to translate them. 2) Translate";
+		description += " div.rn.ftz, div.full and div.approx with and without";
+		description += " fast math, only div.full and div.approx may become a";
+		description += " multiply by the reciprocal.";
 	}
 }
 
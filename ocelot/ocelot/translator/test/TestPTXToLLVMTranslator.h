@@ -19,6 +19,9 @@ namespace test
 			
 		Test Points:
 			1) Scan for all PTX files in a directory, try to translate them. 
+			2) Translate div.rn.ftz, div.full and div.approx with and without
+				fast math, only div.full and div.approx may become a multiply
+				by the reciprocal.
 	*/
 	class TestPTXToLLVMTranslator : public Test
 	{
@@ -31,6 +34,9 @@ namespace test
 		private:
 			StringVector _getFileNames() const;
 			bool _testTranslate();
+			std::string _translateDivide( const std::string& modifier, 
+				bool fastMath );
+			bool _testFastMath();
 			bool doTest();
 		
 		public:
@@ -0,0 +1,320 @@
+/*!
+	\file TestProfilingData.cpp
+	\date October 18, 2026
+	\author agent <agent@local>
+	\brief The source file for the TestProfilingData unit test.
+*/
+
+#ifndef TEST_PROFILING_DATA_CPP_INCLUDED
+#define TEST_PROFILING_DATA_CPP_INCLUDED
+
+// Ocelot Includes
+#include <ocelot/translator/test/TestProfilingData.h>
+#include <ocelot/translator/interface/ProfilingData.h>
+#include <ocelot/translator/interface/PTXToLLVMTranslator.h>
+#include <ocelot/ir/interface/PTXKernel.h>
+#include <ocelot/ir/interface/LLVMKernel.h>
+
+// Hydrazine Includes
+#include <hydrazine/implementation/ArgumentParser.h>
+
+// Standard Library Includes
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+
+// Linux Includes
+#include <unistd.h>
+
+namespace test
+{
+	static std::string kernelSource()
+	{
+		std::string ptx = ".version 1.4\n";
+		ptx += ".target sm_10\n\n";
+		ptx += ".entry branches( .param .u32 n )\n";
+		ptx += "{\n";
+		ptx += "	.reg .u32 %r<2>;\n";
+		ptx += "	.reg .pred %p<2>;\n";
+		ptx += "	Entry:\n";
+		ptx += "		ld.param.u32 %r0, [n];\n";
+		ptx += "		setp.eq.u32 %p0, %r0, 0;\n";
+		ptx += "		@%p0 bra Done;\n";
+		ptx += "	Second:\n";
+		ptx += "		setp.eq.u32 %p1, %r0, 1;\n";
+		ptx += "		@%p1 bra Done;\n";
+		ptx += "	Work:\n";
+		ptx += "		add.u32 %r1, %r0, 1;\n";
+		ptx += "	Done:\n";
+		ptx += "		exit;\n";
+		ptx += "}\n";
+
+		return ptx;
+	}
+
+	std::vector< unsigned int > TestProfilingData::_branchIds()
+	{
+		std::vector< unsigned int > ids;
+
+		ir::ControlFlowGraph* cfg = _module.getKernel( "branches" )->cfg();
+		ir::ControlFlowGraph::BlockPointerVector sequence
+			= cfg->executable_sequence();
+
+		for( ir::ControlFlowGraph::BlockPointerVector::iterator
+			block = sequence.begin(); block != sequence.end(); ++block )
+		{
+			if( *block == cfg->get_entry_block()
+				|| *block == cfg->get_exit_block() ) continue;
+			if( !( *block )->endsWithConditionalBranch() ) continue;
+
+			ids.push_back( ( *block )->id );
+		}
+
+		return ids;
+	}
+
+	void TestProfilingData::_write( const std::string& profile ) const
+	{
+		std::ofstream file( _path.c_str() );
+		file << profile;
+	}
+
+	bool TestProfilingData::testFallthrough()
+	{
+		std::vector< unsigned int > ids = _branchIds();
+
+		if( ids.size() != 2 )
+		{
+			status << "Test Point 1 FAILED: expected two conditional "
+				<< "branches, found " << ids.size() << ".\n";
+			return false;
+		}
+
+		std::stringstream profile;
+		profile << ids[ 0 ] << " 100 0\n";
+		profile << ids[ 1 ] << " 30 0\n";
+		_write( profile.str() );
+
+		translator::ProfilingData data;
+
+		if( !data.load( _path, *_module.getKernel( "branches" ) ) )
+		{
+			status << "Test Point 1 FAILED: a matching profile was "
+				<< "rejected.\n";
+			return false;
+		}
+
+		// the second branch jumps to or falls through to unprofiled blocks
+		if( data.branches.size() != 1 )
+		{
+			status << "Test Point 1 FAILED: expected one weighted branch, "
+				<< "found " << data.branches.size() << ".\n";
+			return false;
+		}
+
+		const translator::ProfilingData::Branch& branch
+			= data.branches.begin()->second;
+
+		// weights are one more than the visits so no edge is impossible
+		if( branch.taken != 71 || branch.fallthrough != 31 )
+		{
+			status << "Test Point 1 FAILED: expected weights 71 and 31, "
+				<< "found " << branch.taken << " and " << branch.fallthrough
+				<< ".\n";
+			return false;
+		}
+
+		status << "Test Point 1 Passed\n";
+		return true;
+	}
+
+	bool TestProfilingData::testDivergence()
+	{
+		std::vector< unsigned int > ids = _branchIds();
+
+		std::stringstream profile;
+		profile << ids[ 0 ] << " 100 60\n";
+		profile << ids[ 1 ] << " 90 0\n";
+		_write( profile.str() );
+
+		translator::ProfilingData data;
+
+		if( !data.load( _path, *_module.getKernel( "branches" ) )
+			|| data.branches.size() != 1 )
+		{
+			status << "Test Point 2 FAILED: the profile was not loaded.\n";
+			return false;
+		}
+
+		const translator::ProfilingData::Branch& branch
+			= data.branches.begin()->second;
+
+		if( branch.taken != 61 || branch.fallthrough != 91 )
+		{
+			status << "Test Point 2 FAILED: expected weights 61 and 91, "
+				<< "found " << branch.taken << " and " << branch.fallthrough
+				<< ".\n";
+			return false;
+		}
+
+		status << "Test Point 2 Passed\n";
+		return true;
+	}
+
+	bool TestProfilingData::testMismatch()
+	{
+		std::vector< unsigned int > ids = _branchIds();
+
+		std::stringstream wrongId;
+		wrongId << ids[ 0 ] << " 100 0\n";
+		wrongId << ( ids[ 0 ] + ids[ 1 ] + 1 ) << " 30 0\n";
+
+		std::stringstream extraLine;
+		extraLine << ids[ 0 ] << " 100 0\n";
+		extraLine << ids[ 1 ] << " 30 0\n";
+		extraLine << ids[ 1 ] << " 30 0\n";
+
+		std::string profiles[] = { wrongId.str(), extraLine.str() };
+
+		for( unsigned int i = 0; i < 2; ++i )
+		{
+			_write( profiles[ i ] );
+
+			translator::ProfilingData data;
+
+			if( data.load( _path, *_module.getKernel( "branches" ) ) )
+			{
+				status << "Test Point 3 FAILED: a mismatched profile was "
+					<< "accepted:\n" << profiles[ i ];
+				return false;
+			}
+
+			if( !data.empty() )
+			{
+				status << "Test Point 3 FAILED: a mismatched profile left "
+					<< data.branches.size() << " weights.\n";
+				return false;
+			}
+		}
+
+		status << "Test Point 3 Passed\n";
+		return true;
+	}
+
+	bool TestProfilingData::testTranslate()
+	{
+		std::vector< unsigned int > ids = _branchIds();
+
+		std::stringstream profile;
+		profile << ids[ 0 ] << " 100 0\n";
+		profile << ids[ 1 ] << " 30 0\n";
+		_write( profile.str() );
+
+		ir::PTXKernel* kernel = _module.getKernel( "branches" );
+
+		// weights must be derived before the kernel is transformed
+		translator::ProfilingData data;
+		data.load( _path, *kernel );
+
+		kernel->dfg()->toSsa();
+
+		std::string code[ 2 ];
+
+		for( unsigned int weighted = 0; weighted < 2; ++weighted )
+		{
+			translator::PTXToLLVMTranslator translator;
+			if( weighted ) translator.addProfile( data );
+
+			ir::LLVMKernel* translatedKernel = dynamic_cast<
+				ir::LLVMKernel* >( translator.translate( kernel ) );
+			translatedKernel->assemble();
+
+			code[ weighted ] = translatedKernel->code();
+
+			delete translatedKernel;
+		}
+
+		if( code[ 0 ].find( "branch_weights" ) != std::string::npos )
+		{
+			status << "Test Point 4 FAILED: the unweighted translation has "
+				<< "branch weights.\n";
+			return false;
+		}
+
+		if( code[ 1 ].find( "branch_weights" ) == std::string::npos )
+		{
+			status << "Test Point 4 FAILED: the weighted translation has no "
+				<< "branch weights.\n";
+			return false;
+		}
+
+		status << "Test Point 4 Passed\n";
+		return true;
+	}
+
+	bool TestProfilingData::doTest()
+	{
+		std::stringstream stream( kernelSource() );
+		_module.load( stream, "profilingData" );
+
+		char path[] = "/tmp/TestProfilingDataXXXXXX";
+		int file = mkstemp( path );
+
+		if( file == -1 )
+		{
+			status << "Failed to create a temporary profile.\n";
+			return false;
+		}
+
+		close( file );
+		_path = path;
+
+		bool result = testFallthrough() && testDivergence()
+			&& testMismatch() && testTranslate();
+
+		std::remove( _path.c_str() );
+
+		return result;
+	}
+
+	TestProfilingData::TestProfilingData()
+	{
+		name = "TestProfilingData";
+
+		description = "A unit test for branch weights derived from branch ";
+		description += "profiles. The kernel has two conditional branches, ";
+		description += "the first falls through into the second and both ";
+		description += "jump to the exit. Test Points: 1) Load a profile of ";
+		description += "both branches, check that only the first one is ";
+		description += "weighted, with the visits of the second branch on ";
+		description += "its fallthrough edge and the rest on the taken edge. ";
+		description += "2) Load a profile where most visits diverge, check ";
+		description += "that neither edge weighs less than the divergences. ";
+		description += "3) Load profiles with a wrong block id and with an ";
+		description += "extra line, check that both are rejected and leave ";
+		description += "no weights. 4) Translate the kernel with and without ";
+		description += "the weights, check that only the weighted ";
+		description += "translation has branch_weights metadata.";
+	}
+}
+
+int main( int argc, char** argv )
+{
+	hydrazine::ArgumentParser parser( argc, argv );
+	test::TestProfilingData test;
+
+	parser.description( test.testDescription() );
+
+	parser.parse( "-s", test.seed, 0,
+		"Set the random seed, 0 implies seed with time." );
+	parser.parse( "-v", test.verbose, false, "Print out info after the test." );
+	parser.parse();
+
+	test.test();
+
+	return test.passed();
+}
+
+#endif
+
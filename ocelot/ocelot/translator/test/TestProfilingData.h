@@ -0,0 +1,65 @@
+/*!
+	\file TestProfilingData.h
+	\date October 18, 2026
+	\author agent <agent@local>
+	\brief The header file for the TestProfilingData unit test.
+*/
+
+#ifndef TEST_PROFILING_DATA_H_INCLUDED
+#define TEST_PROFILING_DATA_H_INCLUDED
+
+#include <hydrazine/interface/Test.h>
+#include <ocelot/ir/interface/Module.h>
+
+#include <vector>
+
+namespace test
+{
+	/*!
+		\brief A unit test for branch weights derived from branch profiles.
+
+		The kernel has two conditional branches, the first falls through
+		into the second and both jump to the exit.
+
+		Test Points:
+			1) Load a profile of both branches, check that only the first
+				one is weighted, with the visits of the second branch on its
+				fallthrough edge and the rest on the taken edge.
+			2) Load a profile where most visits diverge, check that neither
+				edge weighs less than the divergences.
+			3) Load profiles with a wrong block id and with an extra line,
+				check that both are rejected and leave no weights.
+			4) Translate the kernel with and without the weights, check
+				that only the weighted translation has branch_weights
+				metadata.
+	*/
+	class TestProfilingData : public Test
+	{
+		private:
+			/*! \brief The module holding the kernel */
+			ir::Module _module;
+			/*! \brief The path of the profile file */
+			std::string _path;
+
+		private:
+			/*! \brief Get the ids of the conditional branch blocks in the
+				order that the profilers write them */
+			std::vector< unsigned int > _branchIds();
+			void _write( const std::string& profile ) const;
+
+			bool testFallthrough();
+			bool testDivergence();
+			bool testMismatch();
+			bool testTranslate();
+
+			bool doTest();
+
+		public:
+			TestProfilingData();
+	};
+}
+
+int main( int argc, char** argv );
+
+#endif
+